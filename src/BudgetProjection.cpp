@@ -0,0 +1,296 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "BudgetProjection.h"
+#include "LineItemTransaction.h"
+#include "TransactionAlgorithmStaticPointers.h"
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+	int64_t InterpolatePopulation(int64_t start, int64_t end, uint32_t month, uint32_t monthCount)
+	{
+		return start + (((end - start) * static_cast<int64_t>(month)) / static_cast<int64_t>(monthCount));
+	}
+
+	int32_t ClampCityPopulation(int64_t value)
+	{
+		// The game reports the city populations as 32-bit values.
+		return static_cast<int32_t>(std::clamp<int64_t>(
+			value,
+			std::numeric_limits<int32_t>::min(),
+			std::numeric_limits<int32_t>::max()));
+	}
+}
+
+BudgetProjection::BudgetProjection()
+	: monthCount(0),
+	  departments(),
+	  departmentIndexes(),
+	  fixedTotals(),
+	  lineItems(),
+	  buildingInstanceCosts(),
+	  projectedTotals(),
+	  sharedValues(),
+	  population(),
+	  pHistoryProvider(nullptr),
+	  cachedStatistics()
+{
+}
+
+bool BudgetProjection::Begin(uint32_t monthCount)
+{
+	bool result = false;
+
+	// The buffers are cleared instead of released, so repeated projections reuse their memory.
+	departments.clear();
+	departmentIndexes.clear();
+	fixedTotals.clear();
+	lineItems.clear();
+	buildingInstanceCosts.clear();
+	projectedTotals.clear();
+
+	if (monthCount >= 1 && monthCount <= MaxMonthCount)
+	{
+		this->monthCount = monthCount;
+		result = true;
+	}
+	else
+	{
+		this->monthCount = 0;
+	}
+
+	return result;
+}
+
+void BudgetProjection::AddFixedLineItem(uint32_t department, int64_t expenses, int64_t income)
+{
+	BudgetTotals& totals = fixedTotals[GetDepartmentIndex(department)];
+
+	totals.expenses += expenses;
+	totals.income += income;
+}
+
+void BudgetProjection::AddLineItem(
+	uint32_t department,
+	const LineItemTransaction& transaction,
+	int64_t buildingCount,
+	int64_t expenses,
+	int64_t income)
+{
+	const size_t departmentIndex = GetDepartmentIndex(department);
+	const bool isIncome = transaction.IsIncome();
+
+	// The monthly update only sets the line item's expenses or its income, the other value does not change.
+	if (isIncome)
+	{
+		fixedTotals[departmentIndex].expenses += expenses;
+	}
+	else
+	{
+		fixedTotals[departmentIndex].income += income;
+	}
+
+	lineItems.push_back(ProjectedLineItem{ &transaction, departmentIndex, buildingCount, isIncome });
+
+	const size_t offset = buildingInstanceCosts.size();
+	buildingInstanceCosts.resize(offset + monthCount);
+
+	transaction.CalculateProjectedBuildingInstanceCosts(monthCount, buildingInstanceCosts.data() + offset);
+}
+
+void BudgetProjection::Project(const CustomBudgetPopulationTrajectory& trajectory, IHistoryProvider& historyProvider)
+{
+	IPopulationProvider* const pGamePopulationProvider = spPopulationProvider;
+	IHistoryProvider* const pGameHistoryProvider = spHistoryProvider;
+
+	spPopulationProvider = this;
+	spHistoryProvider = this;
+	pHistoryProvider = &historyProvider;
+
+	const size_t departmentCount = departments.size();
+	const size_t lineItemCount = lineItems.size();
+
+	projectedTotals.resize(departmentCount * monthCount);
+
+	for (uint32_t i = 0; i < monthCount; i++)
+	{
+		SetMonthPopulation(trajectory, i + 1);
+		// The shared values depend on the population, each algorithm instance is evaluated once per month.
+		sharedValues.Clear();
+
+		BudgetTotals* const pMonthTotals = projectedTotals.data() + (static_cast<size_t>(i) * departmentCount);
+
+		std::copy(fixedTotals.begin(), fixedTotals.end(), pMonthTotals);
+
+		for (size_t j = 0; j < lineItemCount; j++)
+		{
+			const ProjectedLineItem& item = lineItems[j];
+
+			const int64_t total = item.pTransaction->CalculateProjectedTotal(
+				item.buildingCount,
+				buildingInstanceCosts[(j * monthCount) + i],
+				sharedValues);
+
+			if (item.isIncome)
+			{
+				pMonthTotals[item.departmentIndex].income += total;
+			}
+			else
+			{
+				pMonthTotals[item.departmentIndex].expenses += total;
+			}
+		}
+	}
+
+	spPopulationProvider = pGamePopulationProvider;
+	spHistoryProvider = pGameHistoryProvider;
+	pHistoryProvider = nullptr;
+
+	// The transactions are only valid for the duration of the projection.
+	lineItems.clear();
+	sharedValues.Clear();
+}
+
+size_t BudgetProjection::Copy(CustomBudgetProjectedTotals* pBuffer, size_t capacity) const
+{
+	const size_t departmentCount = departments.size();
+	const size_t count = std::min(projectedTotals.size(), capacity);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const BudgetTotals& totals = projectedTotals[i];
+
+		CustomBudgetProjectedTotals& value = pBuffer[i];
+		value.department = departments[i % departmentCount];
+		value.month = static_cast<uint32_t>(i / departmentCount) + 1;
+		value.expenses = totals.expenses;
+		value.income = totals.income;
+	}
+
+	return count;
+}
+
+void BudgetProjection::InvalidateHistory()
+{
+	cachedStatistics.clear();
+}
+
+void BudgetProjection::Clear()
+{
+	Begin(0);
+	cachedStatistics.clear();
+}
+
+size_t BudgetProjection::GetDepartmentIndex(uint32_t department)
+{
+	const auto pair = departmentIndexes.try_emplace(department, departments.size());
+
+	if (pair.second)
+	{
+		departments.push_back(department);
+		fixedTotals.push_back(BudgetTotals{});
+	}
+
+	return pair.first->second;
+}
+
+void BudgetProjection::SetMonthPopulation(const CustomBudgetPopulationTrajectory& trajectory, uint32_t month)
+{
+	const CustomBudgetPopulation& start = trajectory.start;
+	const CustomBudgetPopulation& end = trajectory.end;
+
+	population.city = InterpolatePopulation(start.city, end.city, month, monthCount);
+	population.cityLowWealth = InterpolatePopulation(start.cityLowWealth, end.cityLowWealth, month, monthCount);
+	population.cityMediumWealth = InterpolatePopulation(start.cityMediumWealth, end.cityMediumWealth, month, monthCount);
+	population.cityHighWealth = InterpolatePopulation(start.cityHighWealth, end.cityHighWealth, month, monthCount);
+	population.region = InterpolatePopulation(start.region, end.region, month, monthCount);
+	population.regionLowWealth = InterpolatePopulation(start.regionLowWealth, end.regionLowWealth, month, monthCount);
+	population.regionMediumWealth = InterpolatePopulation(start.regionMediumWealth, end.regionMediumWealth, month, monthCount);
+	population.regionHighWealth = InterpolatePopulation(start.regionHighWealth, end.regionHighWealth, month, monthCount);
+}
+
+int32_t BudgetProjection::GetCityResidentialPopulation()
+{
+	return ClampCityPopulation(population.city);
+}
+
+int32_t BudgetProjection::GetCityPopulation(uint32_t demandId)
+{
+	int64_t value = 0;
+
+	switch (demandId)
+	{
+	case 0x1010:
+		value = population.cityLowWealth;
+		break;
+	case 0x1020:
+		value = population.cityMediumWealth;
+		break;
+	case 0x1030:
+		value = population.cityHighWealth;
+		break;
+	}
+
+	return ClampCityPopulation(value);
+}
+
+int64_t BudgetProjection::GetRegionResidentialPopulation()
+{
+	return population.region;
+}
+
+int64_t BudgetProjection::GetRegionPopulation(uint32_t demandId)
+{
+	int64_t value = 0;
+
+	switch (demandId)
+	{
+	case 0x1010:
+		value = population.regionLowWealth;
+		break;
+	case 0x1020:
+		value = population.regionMediumWealth;
+		break;
+	case 0x1030:
+		value = population.regionHighWealth;
+		break;
+	}
+
+	return value;
+}
+
+bool BudgetProjection::GetStatistics(uint32_t historyType, uint32_t monthCount, HistoryStatistics& statistics)
+{
+	// The game history is only queried the first time that a statistic is used in the current
+	// simulation month, later projections use the cached value.
+	const uint64_t key = (static_cast<uint64_t>(historyType) << 32) | monthCount;
+
+	auto item = cachedStatistics.find(key);
+
+	if (item == cachedStatistics.end())
+	{
+		CachedStatistics value{};
+
+		if (pHistoryProvider)
+		{
+			value.valid = pHistoryProvider->GetStatistics(historyType, monthCount, value.statistics);
+		}
+
+		item = cachedStatistics.emplace(key, value).first;
+	}
+
+	statistics = item->second.statistics;
+	return item->second.valid;
+}
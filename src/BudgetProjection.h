@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cICustomBudgetDepartmentQuery.h"
+#include "AlgorithmSharedValueCache.h"
+#include "CustomBudgetTotals.h"
+#include "IHistoryProvider.h"
+#include "IPopulationProvider.h"
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+class LineItemTransaction;
+
+/**
+ * @brief Projects the custom budget department totals for the following months.
+ *
+ * The line item totals are calculated by the same transaction algorithms as the monthly update. While the
+ * projection runs the class replaces the population and history providers that the algorithms use, so the
+ * algorithms read the projected populations and the loop over the months and line items does not call the game.
+ * The building instance costs are calculated for all of the months when a line item is added.
+ */
+class BudgetProjection final : private IPopulationProvider, private IHistoryProvider
+{
+public:
+	static constexpr uint32_t MaxMonthCount = 120;
+
+	BudgetProjection();
+
+	/**
+	 * @brief Starts a new projection.
+	 * @param monthCount The number of months to project, 1 to MaxMonthCount.
+	 * @return True if the month count is valid; otherwise, false.
+	 */
+	bool Begin(uint32_t monthCount);
+
+	/**
+	 * @brief Adds a line item that keeps its current totals, e.g. a fixed cost line item.
+	 */
+	void AddFixedLineItem(uint32_t department, int64_t expenses, int64_t income);
+
+	/**
+	 * @brief Adds a line item whose total is recalculated for every projected month.
+	 * @param department The department id.
+	 * @param transaction The line item transaction, it must not be modified or destroyed before Project is called.
+	 * @param buildingCount The number of buildings that use the line item.
+	 * @param expenses The current line item expenses.
+	 * @param income The current line item income.
+	 */
+	void AddLineItem(
+		uint32_t department,
+		const LineItemTransaction& transaction,
+		int64_t buildingCount,
+		int64_t expenses,
+		int64_t income);
+
+	/**
+	 * @brief Calculates the department totals of every projected month.
+	 * @param trajectory The population trajectory.
+	 * @param historyProvider Provides the city history statistics, the statistics keep their current values.
+	 */
+	void Project(const CustomBudgetPopulationTrajectory& trajectory, IHistoryProvider& historyProvider);
+
+	/**
+	 * @brief Copies the projected department totals into the buffer, ordered by month.
+	 * @param pBuffer The buffer that receives the department totals.
+	 * @param capacity The number of values that the buffer can hold.
+	 * @return The number of values that were copied.
+	 */
+	size_t Copy(CustomBudgetProjectedTotals* pBuffer, size_t capacity) const;
+
+	/**
+	 * @brief Discards the cached history statistics, they must be queried again after the simulation month changes.
+	 */
+	void InvalidateHistory();
+	void Clear();
+
+private:
+	struct ProjectedLineItem
+	{
+		const LineItemTransaction* pTransaction;
+		size_t departmentIndex;
+		int64_t buildingCount;
+		bool isIncome;
+	};
+
+	struct CachedStatistics
+	{
+		HistoryStatistics statistics;
+		bool valid;
+	};
+
+	size_t GetDepartmentIndex(uint32_t department);
+	void SetMonthPopulation(const CustomBudgetPopulationTrajectory& trajectory, uint32_t month);
+
+	int32_t GetCityResidentialPopulation() override;
+	int32_t GetCityPopulation(uint32_t demandId) override;
+	int64_t GetRegionResidentialPopulation() override;
+	int64_t GetRegionPopulation(uint32_t demandId) override;
+
+	bool GetStatistics(uint32_t historyType, uint32_t monthCount, HistoryStatistics& statistics) override;
+
+	uint32_t monthCount;
+	std::vector<uint32_t> departments;
+	std::unordered_map<uint32_t, size_t> departmentIndexes;
+	// The totals that do not change during the projection, indexed by department.
+	std::vector<BudgetTotals> fixedTotals;
+	std::vector<ProjectedLineItem> lineItems;
+	// The building instance costs of each line item, monthCount values per line item.
+	std::vector<int64_t> buildingInstanceCosts;
+	// The department totals, the departments of each month are stored together.
+	std::vector<BudgetTotals> projectedTotals;
+	AlgorithmSharedValueCache sharedValues;
+	CustomBudgetPopulation population;
+	IHistoryProvider* pHistoryProvider;
+	std::unordered_map<uint64_t, CachedStatistics> cachedStatistics;
+};
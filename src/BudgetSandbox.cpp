@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "BudgetSandbox.h"
+
+BudgetSandbox::BudgetSandbox(uint64_t version)
+	: departments(),
+	  version(version)
+{
+}
+
+uint64_t BudgetSandbox::GetVersion() const
+{
+	return version;
+}
+
+BudgetSandbox::LineItem* BudgetSandbox::FindLineItem(uint32_t department, uint32_t lineNumber)
+{
+	LineItem* result = nullptr;
+
+	const auto departmentItem = departments.find(department);
+
+	if (departmentItem != departments.end())
+	{
+		const auto lineItem = departmentItem->second.lineItems.find(lineNumber);
+
+		if (lineItem != departmentItem->second.lineItems.end())
+		{
+			result = &lineItem->second;
+		}
+	}
+
+	return result;
+}
+
+BudgetSandbox::LineItem& BudgetSandbox::AddLineItem(
+	uint32_t department,
+	uint32_t lineNumber,
+	const LineItem& lineItem,
+	const BudgetTotals& departmentTotals)
+{
+	const auto departmentItem = departments.try_emplace(department);
+
+	if (departmentItem.second)
+	{
+		departmentItem.first->second.totals = departmentTotals;
+	}
+
+	return departmentItem.first->second.lineItems.try_emplace(lineNumber, lineItem).first->second;
+}
+
+void BudgetSandbox::SetLineItemTotals(uint32_t department, LineItem& lineItem, int64_t expenses, int64_t income)
+{
+	BudgetTotals& totals = departments[department].totals;
+
+	totals.expenses += expenses - lineItem.expenses;
+	totals.income += income - lineItem.income;
+
+	lineItem.expenses = expenses;
+	lineItem.income = income;
+}
+
+bool BudgetSandbox::GetDepartmentTotals(uint32_t department, BudgetTotals& totals) const
+{
+	bool result = false;
+
+	const auto departmentItem = departments.find(department);
+
+	if (departmentItem != departments.end())
+	{
+		totals = departmentItem->second.totals;
+		result = true;
+	}
+
+	return result;
+}
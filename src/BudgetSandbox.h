@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "CustomBudgetTotals.h"
+#include <cstdint>
+#include <unordered_map>
+
+class LineItemTransaction;
+
+/**
+ * @brief Holds the hypothetical building changes of a what-if budget calculation.
+ *
+ * The sandbox does not copy the city state when it is created, the departments that it has not changed
+ * are read from the live state. The first change to a department copies the department totals, and the
+ * first change to a line item copies its building count and totals. The line item transactions are shared
+ * with the live state, so the sandbox is only valid until the live line items change.
+ */
+class BudgetSandbox
+{
+public:
+	struct LineItem
+	{
+		// Null if the line item transaction could not be created.
+		const LineItemTransaction* pTransaction;
+		int64_t buildingCount;
+		int64_t expenses;
+		int64_t income;
+		bool isIncome;
+	};
+
+	BudgetSandbox(uint64_t version);
+
+	/**
+	 * @brief Gets the version of the live state that the sandbox was created from.
+	 */
+	uint64_t GetVersion() const;
+
+	/**
+	 * @brief Gets the sandbox copy of a line item.
+	 * @return The line item, or null if the sandbox has not changed it.
+	 */
+	LineItem* FindLineItem(uint32_t department, uint32_t lineNumber);
+
+	/**
+	 * @brief Adds the sandbox copy of a line item.
+	 * @param department The department id.
+	 * @param lineNumber The line item id.
+	 * @param lineItem The current state of the line item.
+	 * @param departmentTotals The current department totals, only used for the first line item of the department.
+	 * @return The sandbox copy of the line item.
+	 */
+	LineItem& AddLineItem(
+		uint32_t department,
+		uint32_t lineNumber,
+		const LineItem& lineItem,
+		const BudgetTotals& departmentTotals);
+
+	/**
+	 * @brief Sets the totals of a line item that the sandbox has copied and updates its department totals.
+	 */
+	void SetLineItemTotals(uint32_t department, LineItem& lineItem, int64_t expenses, int64_t income);
+
+	/**
+	 * @brief Gets the totals of a department that the sandbox has changed.
+	 * @return True if the sandbox has changed the department; otherwise, false.
+	 */
+	bool GetDepartmentTotals(uint32_t department, BudgetTotals& totals) const;
+
+private:
+	struct Department
+	{
+		BudgetTotals totals;
+		std::unordered_map<uint32_t, LineItem> lineItems;
+	};
+
+	std::unordered_map<uint32_t, Department> departments;
+	uint64_t version;
+};
@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "BuildingInstanceArray.h"
+#include "cIGZIStream.h"
+#include "cIGZOStream.h"
+#include <algorithm>
+#include <cstring>
+
+BuildingInstanceArray::BuildingInstanceArray(uint32_t maxAge)
+	: keys(),
+	  ages(),
+	  indices(),
+	  maxAge(maxAge),
+	  ageTotal(0)
+{
+}
+
+uint64_t BuildingInstanceArray::CreateKey(float x, float z)
+{
+	uint32_t xBits = 0;
+	uint32_t zBits = 0;
+	std::memcpy(&xBits, &x, sizeof(xBits));
+	std::memcpy(&zBits, &z, sizeof(zBits));
+
+	return (static_cast<uint64_t>(xBits) << 32) | zBits;
+}
+
+void BuildingInstanceArray::GetKeyPosition(uint64_t key, float& x, float& z)
+{
+	const uint32_t xBits = static_cast<uint32_t>(key >> 32);
+	const uint32_t zBits = static_cast<uint32_t>(key);
+	std::memcpy(&x, &xBits, sizeof(x));
+	std::memcpy(&z, &zBits, sizeof(z));
+}
+
+void BuildingInstanceArray::Insert(uint64_t key, int32_t age)
+{
+	const uint32_t clampedAge = ClampAge(age);
+
+	auto result = indices.try_emplace(key, static_cast<uint32_t>(keys.size()));
+
+	if (result.second)
+	{
+		keys.push_back(key);
+		ages.push_back(clampedAge);
+	}
+	else
+	{
+		// The building was already in the array, it is treated as a new building.
+		uint32_t& existingAge = ages[result.first->second];
+
+		ageTotal -= existingAge;
+		existingAge = clampedAge;
+	}
+
+	ageTotal += clampedAge;
+}
+
+bool BuildingInstanceArray::Remove(uint64_t key)
+{
+	const auto& item = indices.find(key);
+
+	if (item == indices.end())
+	{
+		return false;
+	}
+
+	const uint32_t index = item->second;
+	const uint32_t lastIndex = static_cast<uint32_t>(keys.size() - 1);
+
+	ageTotal -= ages[index];
+	indices.erase(item);
+
+	if (index != lastIndex)
+	{
+		keys[index] = keys[lastIndex];
+		ages[index] = ages[lastIndex];
+		indices[keys[index]] = index;
+	}
+
+	keys.pop_back();
+	ages.pop_back();
+
+	return true;
+}
+
+void BuildingInstanceArray::AdvanceMonth()
+{
+	int64_t newAgeTotal = 0;
+
+	for (uint32_t& age : ages)
+	{
+		age += age < maxAge ? 1 : 0;
+		newAgeTotal += age;
+	}
+
+	ageTotal = newAgeTotal;
+}
+
+void BuildingInstanceArray::GetProjectedAgeTotals(uint32_t monthCount, int64_t* ageTotals) const
+{
+	// A building stops aging after (maxAge - age) months, so the age total after m months is the
+	// current total plus m for each building that is still aging and the remaining months of the
+	// buildings that have reached the maximum age. Counting the buildings by their remaining months
+	// makes this a single pass over the ages instead of one pass per month.
+	std::vector<uint32_t> remainingMonthCounts(monthCount, 0);
+
+	for (uint32_t age : ages)
+	{
+		const uint32_t remainingMonths = maxAge - age;
+
+		if (remainingMonths < monthCount)
+		{
+			remainingMonthCounts[remainingMonths]++;
+		}
+	}
+
+	const int64_t buildingCount = static_cast<int64_t>(ages.size());
+	int64_t maxAgeBuildingCount = 0;
+	int64_t maxAgeBuildingMonths = 0;
+
+	for (uint32_t i = 0; i < monthCount; i++)
+	{
+		const int64_t month = static_cast<int64_t>(i) + 1;
+
+		maxAgeBuildingCount += remainingMonthCounts[i];
+		maxAgeBuildingMonths += static_cast<int64_t>(remainingMonthCounts[i]) * i;
+
+		ageTotals[i] = ageTotal + maxAgeBuildingMonths + (month * (buildingCount - maxAgeBuildingCount));
+	}
+}
+
+size_t BuildingInstanceArray::GetCount() const
+{
+	return keys.size();
+}
+
+const std::vector<uint64_t>& BuildingInstanceArray::GetKeys() const
+{
+	return keys;
+}
+
+int64_t BuildingInstanceArray::GetAgeTotal() const
+{
+	return ageTotal;
+}
+
+bool BuildingInstanceArray::Read(cIGZIStream& stream)
+{
+	uint32_t count = 0;
+
+	if (!stream.GetUint32(count) || count > MaxBuildingCount)
+	{
+		return false;
+	}
+
+	keys.clear();
+	ages.clear();
+	indices.clear();
+	ageTotal = 0;
+
+	keys.reserve(count);
+	ages.reserve(count);
+	indices.reserve(count);
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint64_t key = 0;
+		uint32_t age = 0;
+
+		if (!stream.GetUint64(key)
+			|| !stream.GetUint32(age)
+			|| !indices.try_emplace(key, i).second)
+		{
+			return false;
+		}
+
+		const uint32_t clampedAge = ClampAge(age);
+
+		keys.push_back(key);
+		ages.push_back(clampedAge);
+		ageTotal += clampedAge;
+	}
+
+	return true;
+}
+
+bool BuildingInstanceArray::Write(cIGZOStream& stream) const
+{
+	if (!stream.SetUint32(static_cast<uint32_t>(keys.size())))
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		if (!stream.SetUint64(keys[i]) || !stream.SetUint32(ages[i]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+uint32_t BuildingInstanceArray::ClampAge(int64_t age) const
+{
+	return static_cast<uint32_t>(std::clamp<int64_t>(age, 0, maxAge));
+}
@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class cIGZIStream;
+class cIGZOStream;
+
+/**
+ * @brief Tracks the individual buildings that use a line item.
+ *
+ * The building keys and ages are stored in parallel arrays, removing a building moves the
+ * last building into its slot so the arrays stay dense and the monthly update is a single
+ * linear pass over the ages.
+ * The ages are in months and stop increasing once they reach the maximum age.
+ */
+class BuildingInstanceArray
+{
+public:
+	static constexpr uint32_t MaxBuildingCount = 1 << 24;
+
+	BuildingInstanceArray(uint32_t maxAge);
+
+	/**
+	 * @brief Creates the key for a building at the specified position.
+	 * The key holds the exact position values, so it can be converted back to the position.
+	 */
+	static uint64_t CreateKey(float x, float z);
+	static void GetKeyPosition(uint64_t key, float& x, float& z);
+
+	void Insert(uint64_t key, int32_t age);
+	bool Remove(uint64_t key);
+
+	/**
+	 * @brief Increments the age of every building by one month.
+	 */
+	void AdvanceMonth();
+
+	/**
+	 * @brief Gets the sum of the building ages for each of the following months, without changing the ages.
+	 * @param monthCount The number of months.
+	 * @param ageTotals Receives the age total after 1 to monthCount calls to AdvanceMonth.
+	 */
+	void GetProjectedAgeTotals(uint32_t monthCount, int64_t* ageTotals) const;
+
+	size_t GetCount() const;
+	const std::vector<uint64_t>& GetKeys() const;
+
+	/**
+	 * @brief Gets the sum of the building ages.
+	 */
+	int64_t GetAgeTotal() const;
+
+	bool Read(cIGZIStream& stream);
+	bool Write(cIGZOStream& stream) const;
+
+private:
+	uint32_t ClampAge(int64_t age) const;
+
+	std::vector<uint64_t> keys;
+	std::vector<uint32_t> ages;
+	std::unordered_map<uint64_t, uint32_t> indices;
+	uint32_t maxAge;
+	int64_t ageTotal;
+};
@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "ConditionPredicateTable.h"
+#include "cISC4App.h"
+#include "cISC4BudgetSimulator.h"
+#include "cISC4City.h"
+#include "cISC4OrdinanceSimulator.h"
+#include "GZServPtrs.h"
+#include <cmath>
+
+namespace
+{
+	uint64_t GetPredicateKey(const ConditionPredicate& predicate)
+	{
+		return (static_cast<uint64_t>(predicate.id) << 32)
+			| (static_cast<uint64_t>(predicate.type) << 16)
+			| predicate.threshold;
+	}
+}
+
+ConditionPredicateTable::ConditionPredicateTable()
+	: pBudgetSimulator(nullptr),
+	  pOrdinanceSimulator(nullptr),
+	  predicates(),
+	  bitIndexes(),
+	  words()
+{
+}
+
+bool ConditionPredicateTable::Init()
+{
+	bool result = false;
+
+	cISC4AppPtr pSC4App;
+
+	if (pSC4App)
+	{
+		cISC4City* pCity = pSC4App->GetCity();
+
+		if (pCity)
+		{
+			pBudgetSimulator = pCity->GetBudgetSimulator();
+			pOrdinanceSimulator = pCity->GetOrdinanceSimulator();
+
+			result = pBudgetSimulator && pOrdinanceSimulator;
+		}
+	}
+
+	return result;
+}
+
+bool ConditionPredicateTable::Shutdown()
+{
+	pBudgetSimulator = nullptr;
+	pOrdinanceSimulator = nullptr;
+
+	return true;
+}
+
+uint32_t ConditionPredicateTable::Register(const ConditionPredicate& predicate)
+{
+	const uint64_t key = GetPredicateKey(predicate);
+
+	const auto& item = bitIndexes.find(key);
+
+	if (item != bitIndexes.end())
+	{
+		return item->second;
+	}
+
+	if (predicates.size() >= MaxPredicateCount)
+	{
+		return InvalidBitIndex;
+	}
+
+	const uint32_t bitIndex = static_cast<uint32_t>(predicates.size());
+
+	predicates.push_back(predicate);
+	bitIndexes.emplace(key, bitIndex);
+	words.resize((predicates.size() + 63) / 64);
+
+	// The new predicate is evaluated immediately so that its bit is valid before the next monthly update.
+	SetBit(bitIndex, Evaluate(predicate));
+
+	return bitIndex;
+}
+
+void ConditionPredicateTable::Update()
+{
+	for (size_t i = 0; i < predicates.size(); i++)
+	{
+		SetBit(static_cast<uint32_t>(i), Evaluate(predicates[i]));
+	}
+}
+
+void ConditionPredicateTable::Clear()
+{
+	predicates.clear();
+	bitIndexes.clear();
+	words.clear();
+}
+
+bool ConditionPredicateTable::IsSet(uint32_t wordIndex, uint64_t mask) const
+{
+	return (words[wordIndex] & mask) != 0;
+}
+
+size_t ConditionPredicateTable::GetPredicateCount() const
+{
+	return predicates.size();
+}
+
+bool ConditionPredicateTable::Evaluate(const ConditionPredicate& predicate) const
+{
+	switch (predicate.type)
+	{
+	case ConditionPredicateType::OrdinanceOn:
+		return pOrdinanceSimulator && pOrdinanceSimulator->IsOrdinanceOn(predicate.id);
+	case ConditionPredicateType::OrdinanceOff:
+		return pOrdinanceSimulator && !pOrdinanceSimulator->IsOrdinanceOn(predicate.id);
+	case ConditionPredicateType::TaxRateAtLeast:
+	case ConditionPredicateType::TaxRateBelow:
+		if (pBudgetSimulator)
+		{
+			// The tax rate is a percentage, it is compared in tenths of a percent.
+			const long taxRate = std::lround(pBudgetSimulator->GetTaxRate(predicate.id) * 10.0f);
+			const bool atLeast = taxRate >= static_cast<long>(predicate.threshold);
+
+			return predicate.type == ConditionPredicateType::TaxRateAtLeast ? atLeast : !atLeast;
+		}
+		return false;
+	default:
+		return false;
+	}
+}
+
+void ConditionPredicateTable::SetBit(uint32_t bitIndex, bool value)
+{
+	const uint64_t mask = uint64_t(1) << (bitIndex % 64);
+	uint64_t& word = words[bitIndex / 64];
+
+	word = value ? (word | mask) : (word & ~mask);
+}
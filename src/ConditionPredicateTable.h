@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class cISC4BudgetSimulator;
+class cISC4OrdinanceSimulator;
+
+enum class ConditionPredicateType : uint32_t
+{
+	OrdinanceOn = 0,
+	OrdinanceOff = 1,
+	TaxRateAtLeast = 2,
+	TaxRateBelow = 3,
+	Count
+};
+
+struct ConditionPredicate
+{
+	ConditionPredicateType type;
+	// The ordinance id or the tax group id.
+	uint32_t id;
+	// The tax rate threshold in tenths of a percent, unused for the ordinance predicates.
+	uint32_t threshold;
+};
+
+/**
+ * @brief Evaluates the predicates used by the line item conditions.
+ *
+ * Each distinct predicate is assigned a bit in a bitset, the bits are updated once per
+ * simulation month so the line item conditions only need to test a mask instead of
+ * querying the game.
+ */
+class ConditionPredicateTable
+{
+public:
+	static constexpr uint32_t MaxTaxRateThreshold = 1000;
+	static constexpr uint32_t MaxPredicateCount = 4096;
+	static constexpr uint32_t InvalidBitIndex = UINT32_MAX;
+
+	ConditionPredicateTable();
+
+	bool Init();
+	bool Shutdown();
+
+	/**
+	 * @brief Gets the bit index of the predicate, adding it to the table if necessary.
+	 * @param predicate The predicate.
+	 * @return The bit index, or InvalidBitIndex if the table is full.
+	 */
+	uint32_t Register(const ConditionPredicate& predicate);
+
+	/**
+	 * @brief Evaluates all of the registered predicates.
+	 */
+	void Update();
+
+	/**
+	 * @brief Removes all of the predicates, the existing bit indexes are no longer valid.
+	 */
+	void Clear();
+
+	bool IsSet(uint32_t wordIndex, uint64_t mask) const;
+	size_t GetPredicateCount() const;
+
+private:
+	bool Evaluate(const ConditionPredicate& predicate) const;
+	void SetBit(uint32_t bitIndex, bool value);
+
+	cISC4BudgetSimulator* pBudgetSimulator;
+	cISC4OrdinanceSimulator* pOrdinanceSimulator;
+	std::vector<ConditionPredicate> predicates;
+	std::unordered_map<uint64_t, uint32_t> bitIndexes;
+	std::vector<uint64_t> words;
+};
@@ -13,11 +13,17 @@
 
 #include "CustomBudgetDepartmentManager.h"
 #include "Logger.h"
+#include "MemoryStream.h"
+#include "MessageStreamRecorder.h"
 #include "cGZPersistResourceKey.h"
 #include "cIGZMessage2Standard.h"
 #include "cIGZMessageServer2.h"
 #include "cIGZPersistDBSegment.h"
+#include "cIGZPersistResourceKeyFilter.h"
+#include "cIGZPersistResourceKeyList.h"
+#include "cIGZPersistResourceManager.h"
 #include "cIGZVariant.h"
+#include "cISC4App.h"
 #include "cISC4BudgetSimulator.h"
 #include "cISC4BuildingOccupant.h"
 #include "cISC4City.h"
@@ -27,16 +33,29 @@
 #include "cISC4DepartmentBudget.h"
 #include "cISC4LineItem.h"
 #include "cISC4Occupant.h"
+#include "cISC4OccupantFilter.h"
+#include "cISC4OccupantManager.h"
+#include "cISC4RegionalCity.h"
+#include "cISC4ResidentialSimulator.h"
 #include "cISCProperty.h"
 #include "cISCPropertyHolder.h"
 #include "cRZAutoRefCount.h"
+#include "cRZBaseString.h"
+#include "cS3DVector3.h"
 #include "GZCLSIDDefs.h"
 #include "GZServPtrs.h"
+#include "HistoryAlgorithm.h"
 #include "SCPropertyUtil.h"
 #include "StringResourceKey.h"
+#include "TraceEventRecorder.h"
 #include "TransactionAlgorithmFactory.h"
 #include "TransactionAlgorithmStaticPointers.h"
+#include <algorithm>
 #include <array>
+#include <cinttypes>
+#include <cmath>
+#include <limits>
+#include <string_view>
 
 static constexpr uint32_t kSC4MessagePostCityInit = 0x26D31EC1;
 static constexpr uint32_t kSC4MessagePostCityShutdown = 0x26D31EC3;
@@ -57,289 +76,347 @@ static const std::array<uint32_t, 7> MessageIds =
 	kSC4MessageSimNewMonth,
 };
 
-static constexpr uint32_t kBudgetGroupBusinessDeals = 0xA5A72D1;
-static constexpr uint32_t kBudgetGroupCityBeautification = 0x6A357B96;
-static constexpr uint32_t kBudgetGroupGovernmentBuildings = 0xEA597195;
-static constexpr uint32_t kBudgetGroupHealthAndEducation = 0x6A357B7F;
-static constexpr uint32_t kBudgetGroupPublicSafety = 0x4A357B40;
-static constexpr uint32_t kBudgetGroupTransportation = 0xAA369059;
-static constexpr uint32_t kBudgetGroupUtilities = 0x4A357EAF;
-
 static constexpr uint32_t kOccupantType_Building = 0x278128A0;
 
-static constexpr uint32_t kBudgetItemDepartmentProperty = 0xEA54D283;
-static constexpr uint32_t kBudgetItemLineProperty = 0xEA54D284;
-static constexpr uint32_t kBudgetItemPurpose = 0xEA54D285;
-static constexpr uint32_t kBudgetItemCostProperty = 0xEA54D286;
-
-static constexpr uint32_t kCustomBudgetDepartmentBudgetGroupProperty = 0x90222B81;
-static constexpr uint32_t kCustomBudgetDepartmentNameKeyProperty = 0x4252085F;
-static constexpr uint32_t kCustomBudgetLineItemAlgorithm = 0x9EE1240F;
-// See TransactionAlgorithmFactory.cpp for the custom budget line item algorithm
-// tuning property ids, each custom budget line item algorithm that takes tuning
-// parameters has expense and income tuning properties defined for that purpose.
-
-static constexpr uint32_t kCustomBudgetDepartmentExpensePurposeId = 0x87BD3990;
-static constexpr uint32_t kCustomBudgetDepartmentIncomePurposeId = 0x46261226;
-
 static constexpr uint32_t CustomBudgetDepartmentManagerTypeId = 0xFE005706;
 static constexpr uint32_t CustomBudgetDepartmentManagerGroupId = 0xFE005707;
 static constexpr uint32_t CustomBudgetDepartmentManagerInstanceId = 0;
+// The city's custom budget totals for the region scanner, older plugin versions ignore the record.
+static constexpr uint32_t CustomBudgetCitySummaryInstanceId = 1;
+// Marks a city whose legacy line items have been migrated, older plugin versions ignore the record.
+static constexpr uint32_t CustomBudgetMigrationInstanceId = 2;
+static constexpr uint32_t MigrationRecordVersion = 1;
 
+static constexpr std::string_view RegionalBudgetSummaryFileName = "SC4CustomBudgetDepartments.region.bin";
+
+// The limits of the exemplar-derived data that is kept for the next city when a city is unloaded.
+static constexpr size_t MaxRetainedBuildingTypeInfoBytes = 8 * 1024 * 1024;
+static constexpr size_t MaxRetainedAlgorithmInstances = 4096;
+
+ConditionPredicateTable* spConditionPredicateTable;
+IHistoryProvider* spHistoryProvider;
 IPopulationProvider* spPopulationProvider;
+IRegionalBudgetProvider* spRegionalBudgetProvider;
+IResidentialCatchmentProvider* spResidentialCatchmentProvider;
 
 namespace
 {
-	bool IsValidBudgetGroup(uint32_t budgetGroup)
+	const char* GetMessageName(uint32_t messageType)
 	{
-		switch (budgetGroup)
+		switch (messageType)
 		{
-		case kBudgetGroupBusinessDeals:
-		case kBudgetGroupCityBeautification:
-		case kBudgetGroupGovernmentBuildings:
-		case kBudgetGroupHealthAndEducation:
-		case kBudgetGroupPublicSafety:
-		case kBudgetGroupTransportation:
-		case kBudgetGroupUtilities:
-			return true;
+		case kSC4MessagePostCityInit:
+			return "PostCityInit";
+		case kSC4MessagePostCityShutdown:
+			return "PostCityShutdown";
+		case kSC4MessageInsertOccupant:
+			return "InsertOccupant";
+		case kSC4MessageRemoveOccupant:
+			return "RemoveOccupant";
+		case kSC4MessageLoad:
+			return "Load";
+		case kSC4MessageSave:
+			return "Save";
+		case kSC4MessageSimNewMonth:
+			return "SimNewMonth";
 		default:
-			return false;
+			return "Unknown";
 		}
 	}
 
-	bool GetPropertyValue(const cISCPropertyHolder* pPropertyHolder, uint32_t id, std::vector<uint32_t>& values)
+	class LoggerExemplarErrorReporter final : public ICustomBudgetExemplarErrorReporter
 	{
-		if (pPropertyHolder)
+	public:
+		void ReportError(const char* message) override
 		{
-			const cISCProperty* property = pPropertyHolder->GetProperty(id);
-
-			if (property)
-			{
-				const cIGZVariant* pVariant = property->GetPropertyValue();
+			Logger::GetInstance().WriteLine(LogLevel::Error, message);
+		}
+	};
 
-				if (pVariant)
-				{
-					if (pVariant->GetType() == cIGZVariant::Type::Uint32Array)
-					{
-						const uint32_t count = pVariant->GetCount();
-						values.reserve(count);
+	class DepartmentDefinitionKeyFilter final : public cIGZPersistResourceKeyFilter
+	{
+	public:
+		DepartmentDefinitionKeyFilter() : refCount(0)
+		{
+		}
 
-						const uint32_t* pData = pVariant->RefUint32();
+		bool QueryInterface(uint32_t riid, void** ppvObj) override
+		{
+			if (riid == GZIID_cIGZPersistResourceKeyFilter)
+			{
+				*ppvObj = static_cast<cIGZPersistResourceKeyFilter*>(this);
+				AddRef();
 
-						for (uint32_t i = 0; i < count; i++)
-						{
-							values.push_back(pData[i]);
-						}
+				return true;
+			}
+			else if (riid == GZIID_cIGZUnknown)
+			{
+				*ppvObj = static_cast<cIGZUnknown*>(this);
+				AddRef();
 
-						return true;
-					}
-				}
+				return true;
 			}
-		}
 
-		return false;
-	}
+			return false;
+		}
 
-	bool GetPropertyValue(const cISCPropertyHolder* pPropertyHolder, uint32_t id, std::vector<int64_t>& values)
-	{
-		if (pPropertyHolder)
+		uint32_t AddRef() override
 		{
-			const cISCProperty* property = pPropertyHolder->GetProperty(id);
+			return ++refCount;
+		}
 
-			if (property)
+		uint32_t Release() override
+		{
+			if (refCount > 0)
 			{
-				const cIGZVariant* pVariant = property->GetPropertyValue();
-
-				if (pVariant)
-				{
-					if (pVariant->GetType() == cIGZVariant::Type::Sint64Array)
-					{
-						const uint32_t count = pVariant->GetCount();
-						values.reserve(count);
-
-						const int64_t* pData = pVariant->RefSint64();
+				--refCount;
+			}
 
-						for (uint32_t i = 0; i < count; i++)
-						{
-							values.push_back(pData[i]);
-						}
+			return refCount;
+		}
 
-						return true;
-					}
-				}
-			}
+		bool IsKeyIncluded(cGZPersistResourceKey const& key) override
+		{
+			return key.type == ExemplarTypeId && key.group == CustomBudgetExemplarReader::DepartmentDefinitionExemplarGroup;
 		}
 
-		return false;
-	}
+	private:
+		static constexpr uint32_t ExemplarTypeId = 0x6534284A;
 
-	bool GetPropertyValue(
-		const cISCPropertyHolder* pPropertyHolder,
-		uint32_t id,
-		std::unordered_map<uint32_t, uint32_t>& values)
+		uint32_t refCount;
+	};
+
+	// Selects the building occupants, the filter is passed to the occupant manager instead of
+	// the occupant type value because the meaning of that parameter is not known.
+	class BuildingOccupantFilter final : public cISC4OccupantFilter
 	{
-		if (pPropertyHolder)
+	public:
+		BuildingOccupantFilter() : refCount(0)
 		{
-			const cISCProperty* property = pPropertyHolder->GetProperty(id);
+		}
 
-			if (property)
+		bool QueryInterface(uint32_t riid, void** ppvObj) override
+		{
+			if (riid == GZIID_cIGZUnknown)
 			{
-				const cIGZVariant* pVariant = property->GetPropertyValue();
+				*ppvObj = static_cast<cIGZUnknown*>(this);
+				AddRef();
 
-				if (pVariant)
-				{
-					if (pVariant->GetType() == cIGZVariant::Type::Uint32Array)
-					{
-						const uint32_t count = pVariant->GetCount();
+				return true;
+			}
 
-						// The values are an array of 2 items each.
-						if (count >= 2 && (count % 2) == 0)
-						{
-							const uint32_t* pData = pVariant->RefUint32();
-							values.reserve(count / 2);
+			return false;
+		}
 
-							for (uint32_t i = 0; i < count; i += 2)
-							{
-								values.try_emplace(pData[i], pData[i + 1]);
-							}
+		uint32_t AddRef() override
+		{
+			return ++refCount;
+		}
 
-							return true;
-						}
-					}
-				}
+		uint32_t Release() override
+		{
+			if (refCount > 0)
+			{
+				--refCount;
 			}
+
+			return refCount;
 		}
 
-		return false;
-	}
+		bool IsOccupantIncluded(cISC4Occupant* pOccupant) override
+		{
+			return pOccupant && pOccupant->GetType() == kOccupantType_Building;
+		}
 
-	bool GetBudgetDepartmentNameProperty(
-		const cISCPropertyHolder* pPropertyHolder,
-		uint32_t id,
-		std::unordered_map<uint32_t, StringResourceKey>& values)
-	{
-		if (pPropertyHolder)
+		bool IsOccupantTypeIncluded(uint32_t dwType) override
 		{
-			const cISCProperty* property = pPropertyHolder->GetProperty(id);
+			return dwType == kOccupantType_Building;
+		}
 
-			if (property)
-			{
-				const cIGZVariant* pVariant = property->GetPropertyValue();
+		bool IsPropertyHolderIncluded(cISCPropertyHolder* pProperties) override
+		{
+			return true;
+		}
 
-				if (pVariant)
-				{
-					if (pVariant->GetType() == cIGZVariant::Type::Uint32Array)
-					{
-						const uint32_t count = pVariant->GetCount();
+	private:
+		uint32_t refCount;
+	};
 
-						// The values are an array of 3 items each.
-						// The format is: <department id> <department name key group id> <department name key instance id>
-						if (count >= 3 && (count % 3) == 0)
-						{
-							const uint32_t* pData = pVariant->RefUint32();
-							values.reserve(count / 3);
+	std::unique_ptr<LineItemTransaction> ReadIndexTransaction(std::span<const uint8_t> indexTransaction)
+	{
+		std::unique_ptr<LineItemTransaction> result;
 
-							for (uint32_t i = 0; i < count; i += 3)
-							{
-								values.try_emplace(pData[i], StringResourceKey(pData[i + 1], pData[i + 2]));
-							}
+		if (!indexTransaction.empty())
+		{
+			std::unique_ptr<LineItemTransaction> transaction = std::make_unique<LineItemTransaction>();
+			MemoryIStream stream(indexTransaction.data(), indexTransaction.size());
 
-							return true;
-						}
-					}
+			try
+			{
+				if (transaction->Read(stream) && stream.IsAtEnd())
+				{
+					result = std::move(transaction);
 				}
 			}
+			catch (const CreateTransactionAlgorithmException&)
+			{
+				// The line item transaction is created from the exemplar.
+			}
 		}
 
-		return false;
+		return result;
 	}
 
-	bool CreateLineItemTransactionCore(
+	bool CreateLineItemTransaction(
 		const cISCPropertyHolder* pPropertyHolder,
-		TransactionAlgorithmType type,
+		std::span<const uint8_t> indexTransaction,
 		uint32_t lineNumber,
 		int64_t cost,
 		bool isIncome,
 		std::unordered_map<uint32_t, std::unique_ptr<LineItemTransaction>>& destination)
 	{
+		TraceScope traceScope("CreateLineItemTransaction", "exemplar");
+
 		bool result = false;
 
-		try
+		// The index stores the transactions that were created from the exemplar in a previous session,
+		// the exemplar is only used if the building type is not in the index or its transaction is not valid.
+		std::unique_ptr<LineItemTransaction> transaction = ReadIndexTransaction(indexTransaction);
+
+		if (transaction)
 		{
-			auto pair = destination.emplace(lineNumber, std::make_unique<LineItemTransaction>(pPropertyHolder, type, cost, lineNumber, isIncome));
+			auto pair = destination.emplace(lineNumber, std::move(transaction));
 			result = pair.second;
 		}
-		catch (const CreateTransactionAlgorithmException& e)
+		else if (pPropertyHolder)
 		{
-			Logger::GetInstance().WriteLine(LogLevel::Error, e.what());
-			result = false;
+			const TransactionAlgorithmType type = CustomBudgetExemplarReader::GetLineItemAlgorithmType(pPropertyHolder, lineNumber);
+
+			try
+			{
+				auto pair = destination.emplace(lineNumber, std::make_unique<LineItemTransaction>(pPropertyHolder, type, cost, lineNumber, isIncome));
+				result = pair.second;
+			}
+			catch (const CreateTransactionAlgorithmException& e)
+			{
+				Logger::GetInstance().WriteLine(LogLevel::Error, e.what());
+				result = false;
+			}
 		}
 
 		return result;
 	}
 
-	bool CreateLineItemTransaction(
+	std::vector<uint8_t> SerializeLineItemTransaction(
 		const cISCPropertyHolder* pPropertyHolder,
-		uint32_t lineNumber,
-		int64_t cost,
-		bool isIncome,
-		std::unordered_map<uint32_t, std::unique_ptr<LineItemTransaction>>& destination)
+		const CustomBudgetDepartmentInfo& item)
 	{
-		bool result = false;
+		std::vector<uint8_t> result;
 
-		std::unordered_map<uint32_t, uint32_t> lineItemTransactionAlgorithms;
+		const TransactionAlgorithmType type = CustomBudgetExemplarReader::GetLineItemAlgorithmType(pPropertyHolder, item.lineNumber);
 
-		if (GetPropertyValue(pPropertyHolder, kCustomBudgetLineItemAlgorithm, lineItemTransactionAlgorithms))
+		try
 		{
-			const auto& item = lineItemTransactionAlgorithms.find(lineNumber);
+			MemoryOStream stream;
 
-			if (item != lineItemTransactionAlgorithms.end())
-			{
-				result = CreateLineItemTransactionCore(
-					pPropertyHolder,
-					static_cast<TransactionAlgorithmType>(item->second),
-					lineNumber,
-					cost,
-					isIncome,
-					destination);
-			}
-			else
+			if (LineItemTransaction::WriteFromExemplar(
+				pPropertyHolder,
+				type,
+				item.cost,
+				item.lineNumber,
+				item.type == CustomBudgetDepartmentItemType::Income,
+				stream))
 			{
-				result = CreateLineItemTransactionCore(
-					pPropertyHolder,
-					TransactionAlgorithmType::Fixed,
-					lineNumber,
-					cost,
-					isIncome,
-					destination);
+				result = stream.GetData();
 			}
 		}
-		else
+		catch (const CreateTransactionAlgorithmException&)
 		{
-			result = CreateLineItemTransactionCore(
-				pPropertyHolder,
-				TransactionAlgorithmType::Fixed,
-				lineNumber,
-				cost,
-				isIncome,
-				destination);
+			// The index stores an empty transaction, the error is logged when
+			// the line item transaction is created from the exemplar.
 		}
 
 		return result;
 	}
 
-	bool ContainsCustomBudgetDepartmentPurposeId(const std::vector<uint32_t>& purposeIds)
+	bool ReadLineItemTransactions(
+		cISC4DBSegmentIStream& stream,
+		std::unordered_map<uint32_t, std::unordered_map<uint32_t, std::unique_ptr<LineItemTransaction>>>& destination)
 	{
-		for (const uint32_t& item : purposeIds)
+		// The counts are only used as a capacity hint, a corrupt save game
+		// could otherwise make us reserve an arbitrarily large amount of memory.
+		constexpr uint32_t MaxReservedItemCount = 4096;
+
+		uint32_t departmentCount = 0;
+
+		if (!stream.GetUint32(departmentCount))
+		{
+			return false;
+		}
+
+		destination.reserve(std::min(departmentCount, MaxReservedItemCount));
+
+		for (uint32_t i = 0; i < departmentCount; i++)
 		{
-			if (item == kCustomBudgetDepartmentExpensePurposeId
-				|| item == kCustomBudgetDepartmentIncomePurposeId)
+			uint32_t departmentId = 0;
+			uint32_t lineItemCount = 0;
+
+			if (!stream.GetUint32(departmentId) || !stream.GetUint32(lineItemCount))
 			{
-				return true;
+				return false;
+			}
+
+			std::unordered_map<uint32_t, std::unique_ptr<LineItemTransaction>> lineItems;
+			lineItems.reserve(std::min(lineItemCount, MaxReservedItemCount));
+
+			for (uint32_t j = 0; j < lineItemCount; j++)
+			{
+				uint32_t lineItemId = 0;
+
+				if (!stream.GetUint32(lineItemId))
+				{
+					return false;
+				}
+
+				std::unique_ptr<LineItemTransaction> transaction = std::make_unique<LineItemTransaction>();
+
+				try
+				{
+					if (!transaction->Read(stream))
+					{
+						return false;
+					}
+				}
+				catch (const CreateTransactionAlgorithmException& e)
+				{
+					Logger::GetInstance().WriteLine(LogLevel::Error, e.what());
+					return false;
+				}
+
+				lineItems.emplace(lineItemId, std::move(transaction));
 			}
+
+			destination.emplace(departmentId, std::move(lineItems));
 		}
 
-		return false;
+		return true;
+	}
+
+	uint64_t GetBuildingInstanceKey(cISC4Occupant* pOccupant)
+	{
+		// The buildings are identified by their position, which is
+		// unique for each building and is kept in the save game.
+		cS3DVector3 position;
+		pOccupant->GetPosition(&position);
+
+		return BuildingInstanceArray::CreateKey(position.fX, position.fZ);
+	}
+
+	bool AddBuildingOccupant(cISC4Occupant* pOccupant, void* pContext)
+	{
+		static_cast<std::vector<cISC4Occupant*>*>(pContext)->push_back(pOccupant);
+
+		return true;
 	}
 
 	LineItemTransaction* GetLineItemTransactionPtr(
@@ -358,237 +435,430 @@ namespace
 		return result;
 	}
 
-	bool GetExemplarName(const cISCPropertyHolder* pPropertyHolder, cRZBaseString& value)
+}
+
+CustomBudgetDepartmentManager::CustomBudgetDepartmentManager()
+	: refCount(0),
+	  pBudgetSim(nullptr),
+	  legacyLineItemsMigrated(false),
+	  buildingTypeInfoUseCounter(0),
+	  lineItemVersion(0),
+	  indexPluginFingerprint(0)
+{
+}
+
+bool CustomBudgetDepartmentManager::Init()
+{
+	cIGZMessageServer2Ptr pMsgServ;
+
+	if (pMsgServ)
 	{
-		bool result = false;
+		for (uint32_t messageID : MessageIds)
+		{
+			pMsgServ->AddNotification(this, messageID);
+		}
+	}
+
+	spConditionPredicateTable = &conditionPredicates;
+	spHistoryProvider = &historyProvider;
+	spPopulationProvider = &populationProvider;
+	spRegionalBudgetProvider = &regionalBudgetSummary;
+	spResidentialCatchmentProvider = &residentialCatchmentProvider;
+
+	MessageStreamRecorder::GetInstance().SetDepartmentDefinitions(&departmentDefinitions);
+
+	return true;
+}
+
+bool CustomBudgetDepartmentManager::Shutdown()
+{
+	lineItemChangeNotifier.RemoveAllListeners();
+
+	// The cached building types reference the mapped index.
+	buildingTypeInfoCache.clear();
+	WriteIndex();
+	regionalBudgetSummary.Clear();
+
+	cIGZMessageServer2Ptr pMsgServ;
+
+	if (pMsgServ)
+	{
+		for (uint32_t messageID : MessageIds)
+		{
+			pMsgServ->RemoveNotification(this, messageID);
+		}
+	}
+
+	return true;
+}
+
+void CustomBudgetDepartmentManager::LoadDepartmentDefinitions()
+{
+	TraceScope traceScope("LoadDepartmentDefinitions", "exemplar");
 
-		if (pPropertyHolder)
+	std::vector<DepartmentDefinition> definitions;
+
+	cIGZPersistResourceManagerPtr pResourceManager;
+
+	if (pResourceManager)
+	{
+		// The filter is owned by this function, the resource manager does not keep a reference.
+		DepartmentDefinitionKeyFilter filter;
+		cRZAutoRefCount<cIGZPersistResourceKeyList> pKeyList;
+
+		if (pResourceManager->GetAvailableResourceList(pKeyList.AsPPObj(), &filter) > 0 && pKeyList)
 		{
-			constexpr uint32_t kExemplarNameProperty = 0x20;
+			LoggerExemplarErrorReporter errorReporter;
 
-			const cISCProperty* pExemplarNameProperty = pPropertyHolder->GetProperty(kExemplarNameProperty);
+			const uint32_t keyCount = pKeyList->Size();
 
-			if (pExemplarNameProperty)
+			for (uint32_t i = 0; i < keyCount; i++)
 			{
-				const cIGZVariant* pVariant = pExemplarNameProperty->GetPropertyValue();
+				cRZAutoRefCount<cISCPropertyHolder> pPropertyHolder;
 
-				if (pVariant)
+				if (pResourceManager->GetResource(pKeyList->GetKey(i), GZIID_cISCPropertyHolder, pPropertyHolder.AsPPVoid(), 0, nullptr))
 				{
-					if (pVariant->GetValString(value))
-					{
-						result = value.Strlen() > 0;
-					}
+					const std::vector<DepartmentDefinition> exemplarDefinitions = CustomBudgetExemplarReader::ReadDepartmentDefinitions(
+						pPropertyHolder,
+						errorReporter);
+
+					definitions.insert(definitions.end(), exemplarDefinitions.begin(), exemplarDefinitions.end());
 				}
 			}
 		}
-
-		return result;
 	}
 
-	void LogBudgetPropertyNotFound(
-		const cISCPropertyHolder* pPropertyHolder,
-		const char* propertyName)
+	departmentDefinitions = DepartmentDefinitionTable(std::move(definitions));
+	// The cached building types were read without the definitions.
+	buildingTypeInfoCache.clear();
+
+	if (!departmentDefinitions.IsEmpty())
 	{
-		Logger& logger = Logger::GetInstance();
+		Logger::GetInstance().WriteLineFormatted(
+			LogLevel::Info,
+			"Loaded %zu shared custom budget department definitions.",
+			departmentDefinitions.GetCount());
+	}
+}
 
-		cRZBaseString exemplarName;
+bool CustomBudgetDepartmentManager::OpenIndex(const std::filesystem::path& path, uint64_t pluginFingerprint)
+{
+	buildingTypeInfoCache.clear();
+	indexWriter.Clear();
+	indexPath = path;
+	indexPluginFingerprint = pluginFingerprint;
 
-		if (GetExemplarName(pPropertyHolder, exemplarName))
-		{
-			logger.WriteLineFormatted(
-				LogLevel::Error,
-				"Failed to get the %s property for exemplar name: %s",
-				propertyName,
-				exemplarName.ToChar());
-		}
-		else
-		{
-			logger.WriteLineFormatted(
-				LogLevel::Error,
-				"Failed to get the %s property.",
-				propertyName);
-		}
-	}
+	Logger& logger = Logger::GetInstance();
 
-	void LogBudgetPropertyWrongCount(
-		const cISCPropertyHolder* pPropertyHolder,
-		const char* propertyName,
-		size_t requiredCount)
+	const bool result = index.Open(path, pluginFingerprint);
+
+	if (result)
 	{
-		Logger& logger = Logger::GetInstance();
+		logger.WriteLineFormatted(
+			LogLevel::Info,
+			"Loaded %zu building types from the custom budget index.",
+			index.GetBuildingTypeCount());
+	}
+	else
+	{
+		logger.WriteLine(
+			LogLevel::Info,
+			"The custom budget index does not exist or does not match the installed plugins, it will be rebuilt at shutdown.");
+	}
 
-		cRZBaseString exemplarName;
+	return result;
+}
 
-		if (GetExemplarName(pPropertyHolder, exemplarName))
-		{
-			logger.WriteLineFormatted(
-				LogLevel::Error,
-				"The %s property must have %u items for exemplar name: %s",
-				propertyName,
-				requiredCount,
-				exemplarName.ToChar());
-		}
-		else
-		{
-			logger.WriteLineFormatted(
-				LogLevel::Error,
-				"The %s property must have %u items.",
-				propertyName,
-				requiredCount);
-		}
-	}
+bool CustomBudgetDepartmentManager::GetPlacementCostPreview(
+	uint32_t buildingType,
+	const cISCPropertyHolder* pExemplar,
+	PlacementCostPreview& preview)
+{
+	preview.expenseDelta = 0;
+	preview.incomeDelta = 0;
 
-	struct BudgetPropertyInfo
-	{
-		std::vector<uint32_t> departmentIds;
-		std::vector<uint32_t> lines;
-		std::vector<int64_t> costs;
-		std::unordered_map<uint32_t, uint32_t> budgetGroups;
-		std::unordered_map<uint32_t, StringResourceKey> departmentNameKeys;
-	};
+	bool result = false;
 
-	bool GetBudgetPropertyInfo(
-		const cISCPropertyHolder* pPropertyHolder,
-		const std::vector<uint32_t>& purposeIds,
-		BudgetPropertyInfo& info)
+	if (pBudgetSim)
 	{
-		if (!GetPropertyValue(pPropertyHolder, kBudgetItemDepartmentProperty, info.departmentIds))
-		{
-			LogBudgetPropertyNotFound(pPropertyHolder, "Budget Item: Department.");
-			return false;
-		}
+		BuildingTypeInfo* const pInfo = GetBuildingTypeInfo(buildingType, pExemplar);
 
-		if (!GetPropertyValue(pPropertyHolder, kBudgetItemLineProperty, info.lines))
+		if (pInfo && !pInfo->items.empty())
 		{
-			LogBudgetPropertyNotFound(pPropertyHolder, "Budget Item: Line");
-			return false;
-		}
+			if ((pExemplar || !pInfo->indexTransactions.empty()) && !pInfo->previewTransactionsCreated)
+			{
+				CreatePreviewTransactions(*pInfo, pExemplar);
+			}
 
-		if (!GetPropertyValue(pPropertyHolder, kBudgetItemCostProperty, info.costs))
-		{
-			LogBudgetPropertyNotFound(pPropertyHolder, "Budget Item: Cost");
-			return false;
-		}
+			const size_t itemCount = pInfo->items.size();
 
-		if (!GetPropertyValue(pPropertyHolder, kCustomBudgetDepartmentBudgetGroupProperty, info.budgetGroups))
-		{
-			LogBudgetPropertyNotFound(pPropertyHolder, "Budget: Custom Department Budget Group");
-			return false;
-		}
+			for (size_t i = 0; i < itemCount; i++)
+			{
+				const CustomBudgetDepartmentInfo& item = pInfo->items[i];
+				const LineItemTransaction* pPreviewTransaction = i < pInfo->previewTransactions.size()
+					? pInfo->previewTransactions[i].get()
+					: nullptr;
 
-		if (!GetBudgetDepartmentNameProperty(pPropertyHolder, kCustomBudgetDepartmentNameKeyProperty, info.departmentNameKeys))
-		{
-			LogBudgetPropertyNotFound(pPropertyHolder, "Budget: Custom Department Name Key");
-			return false;
-		}
+				const int64_t delta = CalculatePlacementCostDelta(item, pPreviewTransaction);
 
-		const size_t budgetDepartmentCount = info.departmentIds.size();
-		const size_t customBudgetDepartmentCount = info.budgetGroups.size();
+				if (item.type == CustomBudgetDepartmentItemType::Expense)
+				{
+					preview.expenseDelta += delta;
+				}
+				else
+				{
+					preview.incomeDelta += delta;
+				}
+			}
 
-		if (purposeIds.size() != budgetDepartmentCount)
-		{
-			LogBudgetPropertyWrongCount(
-				pPropertyHolder,
-				"Budget Item: Purpose",
-				budgetDepartmentCount);
-			return false;
+			result = true;
 		}
+	}
 
-		if (info.lines.size() != budgetDepartmentCount)
-		{
-			LogBudgetPropertyWrongCount(
-				pPropertyHolder,
-				"Budget Item: Line",
-				budgetDepartmentCount);
-			return false;
-		}
+	return result;
+}
 
-		if (info.costs.size() != budgetDepartmentCount)
-		{
-			LogBudgetPropertyWrongCount(
-				pPropertyHolder,
-				"Budget Item: Cost",
-				budgetDepartmentCount);
-			return false;
-		}
+bool CustomBudgetDepartmentManager::GetDepartmentTotals(uint32_t department, BudgetTotals& totals) const
+{
+	return budgetTotals.GetDepartmentTotals(department, totals);
+}
 
-		if (info.departmentNameKeys.size() != customBudgetDepartmentCount)
-		{
-			LogBudgetPropertyWrongCount(
-				pPropertyHolder,
-				"Budget: Custom Department Name Key",
-				customBudgetDepartmentCount);
-			return false;
-		}
+bool CustomBudgetDepartmentManager::GetBudgetGroupTotals(uint32_t budgetGroup, BudgetTotals& totals) const
+{
+	return budgetTotals.GetBudgetGroupTotals(budgetGroup, totals);
+}
 
-		return true;
-	}
+const CustomBudgetLineItemTable& CustomBudgetDepartmentManager::GetLineItemTable() const
+{
+	return lineItemTable;
+}
 
-	void LogRequiredDepartmentItemNotFound(
-		const cISCPropertyHolder* pPropertyHolder,
-		const char* itemName,
-		uint32_t departmentID)
+bool CustomBudgetDepartmentManager::AddLineItemListener(
+	cICustomBudgetLineItemListener* pListener,
+	uint32_t department,
+	uint32_t budgetGroup)
+{
+	return lineItemChangeNotifier.AddListener(pListener, department, budgetGroup);
+}
+
+bool CustomBudgetDepartmentManager::RemoveLineItemListener(cICustomBudgetLineItemListener* pListener)
+{
+	return lineItemChangeNotifier.RemoveListener(pListener);
+}
+
+bool CustomBudgetDepartmentManager::GetCurrentPopulation(CustomBudgetPopulation& population)
+{
+	bool result = false;
+
+	if (pBudgetSim)
 	{
-		Logger& logger = Logger::GetInstance();
+		population.city = populationProvider.GetCityResidentialPopulation();
+		population.cityLowWealth = populationProvider.GetCityPopulation(0x1010);
+		population.cityMediumWealth = populationProvider.GetCityPopulation(0x1020);
+		population.cityHighWealth = populationProvider.GetCityPopulation(0x1030);
+		population.region = populationProvider.GetRegionResidentialPopulation();
+		population.regionLowWealth = populationProvider.GetRegionPopulation(0x1010);
+		population.regionMediumWealth = populationProvider.GetRegionPopulation(0x1020);
+		population.regionHighWealth = populationProvider.GetRegionPopulation(0x1030);
+
+		result = true;
+	}
 
-		cRZBaseString exemplarName;
+	return result;
+}
+
+bool CustomBudgetDepartmentManager::CreateHistoryTrajectory(
+	uint32_t historyType,
+	uint32_t historyMonthCount,
+	uint32_t monthCount,
+	CustomBudgetPopulationTrajectory& trajectory)
+{
+	bool result = false;
 
-		if (GetExemplarName(pPropertyHolder, exemplarName))
+	if (historyMonthCount >= 1
+		&& historyMonthCount <= HistoryAlgorithm::MaxMonthCount
+		&& monthCount >= 1
+		&& monthCount <= BudgetProjection::MaxMonthCount
+		&& GetCurrentPopulation(trajectory.start))
+	{
+		HistoryStatistics statistics{};
+
+		if (historyProvider.GetStatistics(historyType, historyMonthCount, statistics))
 		{
-			logger.WriteLineFormatted(
-				LogLevel::Error,
-				"Could not find the %s value for department id 0x%08X. Item exemplar name: %s",
-				itemName,
-				departmentID,
-				exemplarName.ToChar());
+			const CustomBudgetPopulation& start = trajectory.start;
+			CustomBudgetPopulation& end = trajectory.end;
+
+			const double monthlyChange = static_cast<double>(statistics.trendChange) / static_cast<double>(historyMonthCount);
+			const double cityPopulation = std::max(
+				static_cast<double>(start.city) + (monthlyChange * static_cast<double>(monthCount)),
+				0.0);
+
+			// The population is limited to the range of the game's 32-bit population values,
+			// this also excludes NaN and infinity.
+			if (cityPopulation <= static_cast<double>(std::numeric_limits<int32_t>::max()))
+			{
+				end = start;
+				end.city = std::llround(cityPopulation);
+
+				// The wealth groups keep their share of the city population.
+				if (start.city > 0)
+				{
+					end.cityLowWealth = (start.cityLowWealth * end.city) / start.city;
+					end.cityMediumWealth = (start.cityMediumWealth * end.city) / start.city;
+					end.cityHighWealth = (start.cityHighWealth * end.city) / start.city;
+				}
+
+				result = true;
+			}
 		}
-		else
+	}
+
+	return result;
+}
+
+size_t CustomBudgetDepartmentManager::ProjectDepartmentTotals(
+	const CustomBudgetPopulationTrajectory& trajectory,
+	uint32_t monthCount,
+	CustomBudgetProjectedTotals* pBuffer,
+	size_t capacity)
+{
+	size_t result = 0;
+
+	if (pBudgetSim && budgetProjection.Begin(monthCount))
+	{
+		TraceScope traceScope("ProjectDepartmentTotals", "simulation");
+
+		for (const CustomBudgetLineItemState& state : lineItemTable.GetLineItems())
 		{
-			logger.WriteLineFormatted(
-				LogLevel::Error,
-				"Could not find the %s value for department id 0x%08X.",
-				itemName,
-				departmentID);
+			const LineItemTransaction* pTransaction = nullptr;
+
+			const auto& departmentLineItems = customBudgetDepartments.find(state.department);
+
+			if (departmentLineItems != customBudgetDepartments.end())
+			{
+				pTransaction = GetLineItemTransactionPtr(departmentLineItems->second, state.lineNumber);
+			}
+
+			// The monthly update does not change the fixed cost line items.
+			if (pTransaction && !pTransaction->IsFixedCost())
+			{
+				budgetProjection.AddLineItem(state.department, *pTransaction, state.buildingCount, state.expenses, state.income);
+			}
+			else
+			{
+				budgetProjection.AddFixedLineItem(state.department, state.expenses, state.income);
+			}
 		}
+
+		budgetProjection.Project(trajectory, historyProvider);
+		result = budgetProjection.Copy(pBuffer, capacity);
 	}
+
+	return result;
 }
 
-CustomBudgetDepartmentManager::CustomBudgetDepartmentManager()
-	: refCount(0),
-	  pBudgetSim(nullptr)
+BudgetSandbox CustomBudgetDepartmentManager::CreateSandbox() const
 {
+	return BudgetSandbox(lineItemVersion);
 }
 
-bool CustomBudgetDepartmentManager::Init()
+bool CustomBudgetDepartmentManager::ChangeSandboxBuildings(
+	BudgetSandbox& sandbox,
+	uint32_t buildingType,
+	const cISCPropertyHolder* pExemplar,
+	int64_t buildingCountDelta)
 {
-	cIGZMessageServer2Ptr pMsgServ;
+	bool result = false;
 
-	if (pMsgServ)
+	if (pBudgetSim && sandbox.GetVersion() == lineItemVersion)
 	{
-		for (uint32_t messageID : MessageIds)
+		BuildingTypeInfo* const pInfo = GetBuildingTypeInfo(buildingType, pExemplar);
+
+		if (pInfo && !pInfo->items.empty())
 		{
-			pMsgServ->AddNotification(this, messageID);
+			if ((pExemplar || !pInfo->indexTransactions.empty()) && !pInfo->previewTransactionsCreated)
+			{
+				CreatePreviewTransactions(*pInfo, pExemplar);
+			}
+
+			const size_t itemCount = pInfo->items.size();
+
+			for (size_t i = 0; i < itemCount; i++)
+			{
+				const CustomBudgetDepartmentInfo& item = pInfo->items[i];
+
+				BudgetSandbox::LineItem* pLineItem = sandbox.FindLineItem(item.department, item.lineNumber);
+
+				if (!pLineItem)
+				{
+					pLineItem = &AddSandboxLineItem(sandbox, item);
+				}
+
+				// The line items that do not have a transaction use the transaction that placing or removing
+				// a building creates from the exemplar.
+				if (!pLineItem->pTransaction && i < pInfo->previewTransactions.size())
+				{
+					pLineItem->pTransaction = pInfo->previewTransactions[i].get();
+				}
+
+				if (!pLineItem->pTransaction)
+				{
+					// The buildings are ignored when their transaction cannot be created, as when they are placed or removed.
+					continue;
+				}
+
+				const int64_t newBuildingCount = std::max<int64_t>(pLineItem->buildingCount + buildingCountDelta, 0);
+
+				int64_t total = 0;
+
+				if (newBuildingCount > 0)
+				{
+					total = pLineItem->pTransaction->CalculateLineItemTotal(newBuildingCount, previewSharedValues);
+				}
+
+				pLineItem->buildingCount = newBuildingCount;
+
+				if (newBuildingCount == 0)
+				{
+					// The line item is removed from the city with its last building.
+					sandbox.SetLineItemTotals(item.department, *pLineItem, 0, 0);
+				}
+				else if (pLineItem->isIncome)
+				{
+					sandbox.SetLineItemTotals(item.department, *pLineItem, pLineItem->expenses, total);
+				}
+				else
+				{
+					sandbox.SetLineItemTotals(item.department, *pLineItem, total, pLineItem->income);
+				}
+			}
+
+			result = true;
 		}
 	}
 
-	spPopulationProvider = &populationProvider;
-
-	return true;
+	return result;
 }
 
-bool CustomBudgetDepartmentManager::Shutdown()
+bool CustomBudgetDepartmentManager::GetSandboxDepartmentTotals(
+	const BudgetSandbox& sandbox,
+	uint32_t department,
+	BudgetTotals& totals) const
 {
-	cIGZMessageServer2Ptr pMsgServ;
+	bool result = false;
 
-	if (pMsgServ)
+	if (pBudgetSim && sandbox.GetVersion() == lineItemVersion)
 	{
-		for (uint32_t messageID : MessageIds)
-		{
-			pMsgServ->RemoveNotification(this, messageID);
-		}
+		// The departments that the sandbox has not changed use the city totals.
+		result = sandbox.GetDepartmentTotals(department, totals) || budgetTotals.GetDepartmentTotals(department, totals);
 	}
 
-	return true;
+	return result;
+}
+
+bool CustomBudgetDepartmentManager::GetRegionDepartmentTotals(uint32_t department, BudgetTotals& totals) const
+{
+	return regionalBudgetSummary.GetRegionDepartmentTotals(department, totals);
 }
 
 bool CustomBudgetDepartmentManager::QueryInterface(uint32_t riid, void** ppVoid)
@@ -629,8 +899,32 @@ uint32_t CustomBudgetDepartmentManager::Release()
 bool CustomBudgetDepartmentManager::DoMessage(cIGZMessage2* pMsg)
 {
 	cIGZMessage2Standard* pStandardMsg = static_cast<cIGZMessage2Standard*>(pMsg);
+	const uint32_t messageType = pStandardMsg->GetType();
+
+	{
+		TraceScope traceScope(GetMessageName(messageType), "message");
+
+		HandleMessage(messageType, pStandardMsg);
+	}
+
+	if (MessageStreamRecorder::GetInstance().IsEnabled())
+	{
+		RecordMessage(messageType, pStandardMsg);
+	}
+
+	if (messageType == kSC4MessagePostCityShutdown)
+	{
+		// The trace is written after the message's trace scope has ended, so the city
+		// shutdown is included in the city's trace.
+		WriteTraceFile();
+	}
+
+	return true;
+}
 
-	switch (pStandardMsg->GetType())
+void CustomBudgetDepartmentManager::HandleMessage(uint32_t messageType, cIGZMessage2Standard* pStandardMsg)
+{
+	switch (messageType)
 	{
 	case kSC4MessagePostCityInit:
 		PostCityInit(static_cast<cISC4City*>(pStandardMsg->GetVoid1()));
@@ -654,8 +948,98 @@ bool CustomBudgetDepartmentManager::DoMessage(cIGZMessage2* pMsg)
 		SimNewMonth();
 		break;
 	}
+}
 
-	return true;
+void CustomBudgetDepartmentManager::RecordMessage(uint32_t messageType, cIGZMessage2Standard* pStandardMsg)
+{
+	MessageStreamRecorder& recorder = MessageStreamRecorder::GetInstance();
+
+	switch (messageType)
+	{
+	case kSC4MessagePostCityInit:
+		// The line items that the game restored from the save game are recorded
+		// because the game does not send InsertOccupant messages for them.
+		recorder.RecordPostCityInit(populationProvider, GetRecordedLineItems());
+		break;
+	case kSC4MessagePostCityShutdown:
+		recorder.RecordPostCityShutdown();
+		break;
+	case kSC4MessageInsertOccupant:
+	case kSC4MessageRemoveOccupant:
+	{
+		cISC4Occupant* const pOccupant = static_cast<cISC4Occupant*>(pStandardMsg->GetVoid1());
+
+		// Only the buildings that have custom budget department line items are recorded.
+		if (pOccupant->GetType() == kOccupantType_Building)
+		{
+			if (CustomBudgetExemplarReader::HasCustomBudgetDepartmentItems(pOccupant->AsPropertyHolder()))
+			{
+				if (messageType == kSC4MessageInsertOccupant)
+				{
+					recorder.RecordInsertOccupant(pOccupant);
+				}
+				else
+				{
+					recorder.RecordRemoveOccupant(pOccupant);
+				}
+			}
+		}
+		break;
+	}
+	case kSC4MessageLoad:
+		recorder.RecordLoad(
+			static_cast<cIGZPersistDBSegment*>(pStandardMsg->GetVoid1()),
+			cGZPersistResourceKey(
+				CustomBudgetDepartmentManagerTypeId,
+				CustomBudgetDepartmentManagerGroupId,
+				CustomBudgetDepartmentManagerInstanceId));
+		break;
+	case kSC4MessageSave:
+		recorder.RecordSave();
+		break;
+	case kSC4MessageSimNewMonth:
+		// The line item values are recorded so that the replay can check the results of each month.
+		recorder.RecordSimNewMonth(
+			populationProvider,
+			residentialCatchmentProvider.GetPopulationGrid(),
+			GetRecordedLineItems());
+		break;
+	}
+}
+
+std::vector<MessageStreamLineItem> CustomBudgetDepartmentManager::GetRecordedLineItems() const
+{
+	std::vector<MessageStreamLineItem> lineItems;
+
+	if (pBudgetSim)
+	{
+		for (const auto& department : customBudgetDepartments)
+		{
+			cISC4DepartmentBudget* pDepartment = pBudgetSim->GetDepartmentBudget(department.first);
+
+			if (pDepartment)
+			{
+				for (const auto& lineItem : department.second)
+				{
+					const cISC4LineItem* pLineItem = pDepartment->GetLineItem(lineItem.first);
+
+					if (pLineItem)
+					{
+						lineItems.push_back(MessageStreamLineItem{
+							department.first,
+							pDepartment->GetBudgetGroup(),
+							lineItem.first,
+							pLineItem->GetType() == cISC4LineItem::Type::Income,
+							pLineItem->GetFullExpenses(),
+							pLineItem->GetIncome(),
+							pLineItem->GetSecondaryInfoField() });
+					}
+				}
+			}
+		}
+	}
+
+	return lineItems;
 }
 
 void CustomBudgetDepartmentManager::PostCityInit(cISC4City* pCity)
@@ -666,6 +1050,15 @@ void CustomBudgetDepartmentManager::PostCityInit(cISC4City* pCity)
 	{
 		pBudgetSim = pCity->GetBudgetSimulator();
 		populationProvider.Init();
+		historyProvider.Init();
+		residentialCatchmentProvider.Init();
+		conditionPredicates.Init();
+		// The conditions of the line items that were loaded from the save game
+		// were registered before the game simulators were available.
+		conditionPredicates.Update();
+		MigrateLegacyLineItems(pCity);
+		OpenRegionalBudgetSummary();
+		RebuildBudgetTotals();
 	}
 }
 
@@ -673,7 +1066,212 @@ void CustomBudgetDepartmentManager::PostCityShutdown()
 {
 	pBudgetSim = nullptr;
 	populationProvider.Shutdown();
+	historyProvider.Shutdown();
+	residentialCatchmentProvider.Shutdown();
+	// Must be called while the line item transactions still reference the algorithm instances.
+	TransactionAlgorithmFactory::RetainRecentInstances(MaxRetainedAlgorithmInstances);
 	customBudgetDepartments.clear();
+	legacyLineItemsMigrated = false;
+	budgetTotals.Clear();
+	lineItemTable.Clear();
+	lineItemChangeNotifier.Clear();
+	TrimBuildingTypeInfoCache();
+	previewSharedValues.Clear();
+	budgetProjection.Clear();
+	regionalBudgetSummary.Close();
+	lineItemVersion++;
+	conditionPredicates.Shutdown();
+	conditionPredicates.Clear();
+}
+
+void CustomBudgetDepartmentManager::WriteTraceFile()
+{
+	TraceEventRecorder& traceEventRecorder = TraceEventRecorder::GetInstance();
+
+	if (traceEventRecorder.IsEnabled())
+	{
+		if (!traceEventRecorder.WriteTraceFile())
+		{
+			Logger::GetInstance().WriteLine(LogLevel::Error, "Failed to write the trace event file.");
+		}
+	}
+}
+
+void CustomBudgetDepartmentManager::MigrateLegacyLineItems(cISC4City* pCity)
+{
+	if (legacyLineItemsMigrated || !pBudgetSim)
+	{
+		return;
+	}
+
+	cISC4OccupantManager* const pOccupantManager = pCity->GetOccupantManager();
+
+	if (!pOccupantManager)
+	{
+		return;
+	}
+
+	TraceScope traceScope("MigrateLegacyLineItems", "persistence");
+
+	// The buildings that were placed before the line item transactions were introduced are in the
+	// city's line items, but not in the save game data. The transactions of those line items are
+	// created from the building exemplars, so removing a building always uses its transaction.
+
+	std::vector<cISC4Occupant*> occupants;
+
+	// The bounding box parameters are assumed to be the X and Z ranges of the city in meters.
+	// The line item building counts are checked below, so the city is not marked as migrated
+	// if the occupant manager interprets them differently.
+	const float xRange[2] = { 0.0f, pCity->SizeX() };
+	const float zRange[2] = { 0.0f, pCity->SizeZ() };
+
+	BuildingOccupantFilter filter;
+
+	if (!pOccupantManager->IterateOccupantsByBBox(&AddBuildingOccupant, &occupants, xRange, zRange, &filter))
+	{
+		Logger::GetInstance().WriteLine(
+			LogLevel::Error,
+			"Failed to enumerate the city's buildings, the custom budget line items were not updated.");
+		return;
+	}
+
+	struct LegacyBuilding
+	{
+		uint64_t key;
+		int32_t age;
+	};
+
+	struct MigratedLineItem
+	{
+		cISC4DepartmentBudget* pDepartment;
+		cISC4LineItem* pLineItem;
+		const cISCPropertyHolder* pPropertyHolder;
+		const CustomBudgetDepartmentInfo* pItem;
+		std::span<const uint8_t> indexTransaction;
+		std::vector<LegacyBuilding> buildings;
+		LineItemTransaction* pTransaction;
+	};
+
+	// The line items that had a transaction before the migration are not changed.
+	std::unordered_map<uint64_t, MigratedLineItem> migratedLineItems;
+
+	for (cISC4Occupant* pOccupant : occupants)
+	{
+		cRZAutoRefCount<cISC4BuildingOccupant> buildingOccupant;
+
+		if (!pOccupant->QueryInterface(GZIID_cISC4BuildingOccupant, buildingOccupant.AsPPVoid()))
+		{
+			continue;
+		}
+
+		cISCPropertyHolder* const pPropertyHolder = pOccupant->AsPropertyHolder();
+		const BuildingTypeInfo* const pInfo = GetBuildingTypeInfo(buildingOccupant->GetBuildingType(), pPropertyHolder);
+
+		if (!pInfo || pInfo->items.empty())
+		{
+			continue;
+		}
+
+		const LegacyBuilding building{ GetBuildingInstanceKey(pOccupant), buildingOccupant->GetBuildingAge() };
+
+		for (size_t i = 0; i < pInfo->items.size(); i++)
+		{
+			const CustomBudgetDepartmentInfo& item = pInfo->items[i];
+			const uint64_t lineItemKey = (static_cast<uint64_t>(item.department) << 32) | item.lineNumber;
+
+			auto migratedItem = migratedLineItems.find(lineItemKey);
+
+			if (migratedItem == migratedLineItems.end())
+			{
+				if (GetLineItemTransaction(item))
+				{
+					continue;
+				}
+
+				cISC4DepartmentBudget* const pDepartment = pBudgetSim->GetDepartmentBudget(item.department);
+				cISC4LineItem* const pLineItem = pDepartment ? pDepartment->GetLineItem(item.lineNumber) : nullptr;
+
+				if (!pLineItem)
+				{
+					continue;
+				}
+
+				migratedItem = migratedLineItems.emplace(
+					lineItemKey,
+					MigratedLineItem{ pDepartment, pLineItem, pPropertyHolder, &item, pInfo->GetIndexTransaction(i), {}, nullptr }).first;
+			}
+
+			migratedItem->second.buildings.push_back(building);
+		}
+	}
+
+	// Each building was counted in its line item's secondary info field when it was placed.
+	// A different count means that the enumeration missed some of the city's buildings, the
+	// transactions are not created so that the city is checked again when it is next loaded.
+	for (const auto& [lineItemKey, item] : migratedLineItems)
+	{
+		const int64_t buildingCount = item.pLineItem->GetSecondaryInfoField();
+
+		if (buildingCount != static_cast<int64_t>(item.buildings.size()))
+		{
+			Logger::GetInstance().WriteLineFormatted(
+				LogLevel::Error,
+				"Found %zu buildings for custom budget department 0x%08X line item 0x%08X, the line item has %" PRId64
+				". The custom budget line items were not updated.",
+				item.buildings.size(),
+				item.pItem->department,
+				item.pItem->lineNumber,
+				buildingCount);
+			return;
+		}
+	}
+
+	size_t migratedLineItemCount = 0;
+
+	for (auto& [lineItemKey, item] : migratedLineItems)
+	{
+		item.pTransaction = GetOrCreateLineItemTransaction(item.pPropertyHolder, *item.pItem, item.indexTransaction);
+
+		if (item.pTransaction)
+		{
+			for (const LegacyBuilding& building : item.buildings)
+			{
+				item.pTransaction->InsertBuilding(building.key, building.age);
+			}
+
+			migratedLineItemCount++;
+		}
+	}
+
+	if (migratedLineItemCount > 0)
+	{
+		// The new transactions registered their conditions after the predicates were updated.
+		conditionPredicates.Update();
+
+		for (const auto& [lineItemKey, item] : migratedLineItems)
+		{
+			if (item.pTransaction)
+			{
+				const int64_t total = item.pTransaction->CalculateLineItemTotal(item.pLineItem->GetSecondaryInfoField());
+
+				if (item.pTransaction->IsIncome())
+				{
+					SetLineItemIncome(item.pDepartment, item.pLineItem, total);
+				}
+				else
+				{
+					SetLineItemExpenses(item.pDepartment, item.pLineItem, total);
+				}
+			}
+		}
+
+		Logger::GetInstance().WriteLineFormatted(
+			LogLevel::Info,
+			"Created the transactions of %zu custom budget line items from the city's buildings.",
+			migratedLineItemCount);
+	}
+
+	legacyLineItemsMigrated = true;
 }
 
 void CustomBudgetDepartmentManager::InsertOccupant(cIGZMessage2Standard* pStandardMsg)
@@ -684,17 +1282,26 @@ void CustomBudgetDepartmentManager::InsertOccupant(cIGZMessage2Standard* pStanda
 	{
 		cISCPropertyHolder* const pPropertyHolder = pOccupant->AsPropertyHolder();
 
-		const std::vector<CustomBudgetDepartmentInfo> items = LoadCustomBudgetDepartmentInfo(pPropertyHolder);
+		cRZAutoRefCount<cISC4BuildingOccupant> buildingOccupant;
 
-		if (!items.empty())
+		if (pOccupant->QueryInterface(GZIID_cISC4BuildingOccupant, buildingOccupant.AsPPVoid()))
 		{
-			cRZAutoRefCount<cISC4BuildingOccupant> buildingOccupant;
+			const BuildingTypeInfo* const pInfo = GetBuildingTypeInfo(buildingOccupant->GetBuildingType(), pPropertyHolder);
 
-			if (pOccupant->QueryInterface(GZIID_cISC4BuildingOccupant, buildingOccupant.AsPPVoid()))
+			if (pInfo && !pInfo->items.empty())
 			{
-				for (const CustomBudgetDepartmentInfo& item : items)
+				const std::vector<CustomBudgetDepartmentInfo>& items = pInfo->items;
+
+				const uint64_t buildingKey = GetBuildingInstanceKey(pOccupant);
+
+				for (size_t i = 0; i < items.size(); i++)
 				{
-					LineItemTransaction* pTransaction = GetOrCreateLineItemTransaction(pPropertyHolder, item);
+					const CustomBudgetDepartmentInfo& item = items[i];
+
+					LineItemTransaction* pTransaction = GetOrCreateLineItemTransaction(
+						pPropertyHolder,
+						item,
+						pInfo->GetIndexTransaction(i));
 
 					if (pTransaction)
 					{
@@ -716,15 +1323,17 @@ void CustomBudgetDepartmentManager::InsertOccupant(cIGZMessage2Standard* pStanda
 								buildingCount++;
 								pLineItem->SetSecondaryInfoField(buildingCount);
 
+								pTransaction->InsertBuilding(buildingKey, buildingOccupant->GetBuildingAge());
+
 								if (item.type == CustomBudgetDepartmentItemType::Expense)
 								{
 									// Add the cost of the new building tho the current expenses.
-									pLineItem->SetFullExpenses(pTransaction->CalculateLineItemTotal(buildingCount));
+									SetLineItemExpenses(pDepartment, pLineItem, pTransaction->CalculateLineItemTotal(buildingCount));
 								}
 								else
 								{
 									// Add the cost of the new building tho the current income.
-									pLineItem->SetIncome(pTransaction->CalculateLineItemTotal(buildingCount));
+									SetLineItemIncome(pDepartment, pLineItem, pTransaction->CalculateLineItemTotal(buildingCount));
 								}
 
 								if (buildingCount > 1)
@@ -759,73 +1368,72 @@ void CustomBudgetDepartmentManager::RemoveOccupant(cIGZMessage2Standard* pStanda
 	{
 		cISCPropertyHolder* const pPropertyHolder = pOccupant->AsPropertyHolder();
 
-		const std::vector<CustomBudgetDepartmentInfo> items = LoadCustomBudgetDepartmentInfo(pPropertyHolder);
+		cRZAutoRefCount<cISC4BuildingOccupant> buildingOccupant;
 
-		if (!items.empty())
+		if (pOccupant->QueryInterface(GZIID_cISC4BuildingOccupant, buildingOccupant.AsPPVoid()))
 		{
-			for (const CustomBudgetDepartmentInfo& item : items)
+			const BuildingTypeInfo* const pInfo = GetBuildingTypeInfo(buildingOccupant->GetBuildingType(), pPropertyHolder);
+
+			if (pInfo && !pInfo->items.empty())
 			{
-				cISC4DepartmentBudget* const pDepartment = pBudgetSim->GetDepartmentBudget(item.department);
+				const std::vector<CustomBudgetDepartmentInfo>& items = pInfo->items;
 
-				if (pDepartment)
+				const uint64_t buildingKey = GetBuildingInstanceKey(pOccupant);
+
+				for (size_t i = 0; i < items.size(); i++)
 				{
-					cISC4LineItem* const pLineItem = pDepartment->GetLineItem(item.lineNumber);
+					const CustomBudgetDepartmentInfo& item = items[i];
 
-					if (pLineItem)
-					{
-						// We use the secondary info field to track the number of buildings
-						// of each type in the city.
+					cISC4DepartmentBudget* const pDepartment = pBudgetSim->GetDepartmentBudget(item.department);
 
-						int64_t buildingCount = pLineItem->GetSecondaryInfoField();
+					if (pDepartment)
+					{
+						cISC4LineItem* const pLineItem = pDepartment->GetLineItem(item.lineNumber);
 
-						LineItemTransaction* pTransaction = GetLineItemTransaction(item);
+						// The transactions of the buildings that were placed before the transactions were introduced
+						// are created when the city is loaded, the transaction is only created here if the city's
+						// buildings could not be enumerated.
+						LineItemTransaction* const pTransaction = pLineItem
+							? GetOrCreateLineItemTransaction(pPropertyHolder, item, pInfo->GetIndexTransaction(i))
+							: nullptr;
 
-						if (item.type == CustomBudgetDepartmentItemType::Expense)
-						{
-							// Subtract the cost of the building from the current expenses.
-							if (pTransaction)
-							{
-								pLineItem->SetFullExpenses(pTransaction->CalculateLineItemTotal(buildingCount - 1));
-							}
-							else
-							{
-								// Handle buildings that were in the city before the transaction system was introduced.
-								pLineItem->AddToFullExpenses(-item.cost);
-							}
-						}
-						else
+						if (pTransaction)
 						{
-							// Subtract the cost of the building from the current income.
-							if (pTransaction)
+							// We use the secondary info field to track the number of buildings
+							// of each type in the city.
+
+							int64_t buildingCount = pLineItem->GetSecondaryInfoField();
+
+							pTransaction->RemoveBuilding(buildingKey);
+
+							if (item.type == CustomBudgetDepartmentItemType::Expense)
 							{
-								pLineItem->SetIncome(pTransaction->CalculateLineItemTotal(buildingCount - 1));
+								// Subtract the cost of the building from the current expenses.
+								SetLineItemExpenses(pDepartment, pLineItem, pTransaction->CalculateLineItemTotal(buildingCount - 1));
 							}
 							else
 							{
-								// Handle buildings that were in the city before the transaction system was introduced.
-								pLineItem->AddToIncome(-item.cost);
+								// Subtract the cost of the building from the current income.
+								SetLineItemIncome(pDepartment, pLineItem, pTransaction->CalculateLineItemTotal(buildingCount - 1));
 							}
-						}
-
-						if (buildingCount > 1)
-						{
-							buildingCount--;
-							pLineItem->SetSecondaryInfoField(buildingCount);
 
-							// If there are two or more buildings of the same type we tell the game to display the building count
-							// in the UI.
-							// It will be displayed using the following format: <Building name> (<Building count>) <Total expense>
-							if (buildingCount == 1)
+							if (buildingCount > 1)
 							{
-								pLineItem->SetDisplayFlag(cISC4LineItem::DisplayFlag::ShowSecondaryInfoField, false);
-							}
-						}
-						else
-						{
-							pDepartment->RemoveLineItem(item.lineNumber);
+								buildingCount--;
+								pLineItem->SetSecondaryInfoField(buildingCount);
+								RecordLineItem(pDepartment, pLineItem);
 
-							if (pTransaction)
+								// If there are two or more buildings of the same type we tell the game to display the building count
+								// in the UI.
+								// It will be displayed using the following format: <Building name> (<Building count>) <Total expense>
+								if (buildingCount == 1)
+								{
+									pLineItem->SetDisplayFlag(cISC4LineItem::DisplayFlag::ShowSecondaryInfoField, false);
+								}
+							}
+							else
 							{
+								RemoveLineItem(pDepartment, pLineItem);
 								RemoveLineItemTransaction(item);
 							}
 						}
@@ -838,10 +1446,22 @@ void CustomBudgetDepartmentManager::RemoveOccupant(cIGZMessage2Standard* pStanda
 
 void CustomBudgetDepartmentManager::SimNewMonth()
 {
+	// The line items that use the same algorithm parameters share one algorithm
+	// instance, each instance is evaluated once per month.
+	monthlySharedValues.Clear();
+	previewSharedValues.Clear();
+	budgetProjection.InvalidateHistory();
+	// The population grid summed-area table is rebuilt when it is first used in the new month.
+	residentialCatchmentProvider.Invalidate();
+	// The ordinance and tax rate predicates used by the line item conditions are evaluated once per month.
+	conditionPredicates.Update();
+
 	for (auto& department : customBudgetDepartments)
 	{
 		if (!department.second.empty())
 		{
+			TraceScope traceScope("UpdateDepartmentLineItems", "simulation");
+
 			cISC4DepartmentBudget* pDepartment = pBudgetSim->GetDepartmentBudget(department.first);
 
 			if (pDepartment)
@@ -850,24 +1470,26 @@ void CustomBudgetDepartmentManager::SimNewMonth()
 				{
 					auto& transaction = lineItem.second;
 
-					// Fixed cost line items don't need to be updated as the cost is set
-					// in the building's exemplar and never changes.
+					// Fixed cost line items without conditions don't need to be updated as
+					// the cost is set in the building's exemplar and never changes.
 					if (transaction && !transaction->IsFixedCost())
 					{
 						cISC4LineItem* pLineItem = pDepartment->GetLineItem(lineItem.first);
 
 						if (pLineItem)
 						{
+							transaction->AdvanceBuildingAges();
+
 							int64_t buildingCount = pLineItem->GetSecondaryInfoField();
-							const int64_t newTotal = transaction->CalculateLineItemTotal(buildingCount);
+							const int64_t newTotal = transaction->CalculateLineItemTotal(buildingCount, monthlySharedValues);
 
 							if (transaction->IsIncome())
 							{
-								pLineItem->SetIncome(newTotal);
+								SetLineItemIncome(pDepartment, pLineItem, newTotal);
 							}
 							else
 							{
-								pLineItem->SetFullExpenses(newTotal);
+								SetLineItemExpenses(pDepartment, pLineItem, newTotal);
 							}
 						}
 					}
@@ -875,6 +1497,9 @@ void CustomBudgetDepartmentManager::SimNewMonth()
 			}
 		}
 	}
+
+	// The listeners receive the changes since the previous month in one batch.
+	lineItemChangeNotifier.Flush();
 }
 
 void CustomBudgetDepartmentManager::Load(cIGZPersistDBSegment* pSegment)
@@ -890,99 +1515,236 @@ void CustomBudgetDepartmentManager::Load(cIGZPersistDBSegment* pSegment)
 				CustomBudgetDepartmentManagerGroupId,
 				CustomBudgetDepartmentManagerInstanceId);
 
+			cGZPersistResourceKey migrationKey(
+				CustomBudgetDepartmentManagerTypeId,
+				CustomBudgetDepartmentManagerGroupId,
+				CustomBudgetMigrationInstanceId);
+
+			cRZAutoRefCount<cISC4DBSegmentIStream> pMigrationStream;
+
+			if (pSC4DBSegment->OpenIStream(migrationKey, pMigrationStream.AsPPObj()))
+			{
+				ReadMigrationRecord(*pMigrationStream);
+			}
+
 			cRZAutoRefCount<cISC4DBSegmentIStream> pStream;
 
-			if (pSC4DBSegment->OpenIStream(key, pStream.AsPPObj()))
+			if (pSC4DBSegment->OpenIStream(key, pStream.AsPPObj()))
+			{
+				ReadFromDBSegment(*pStream);
+			}
+		}
+	}
+}
+
+void CustomBudgetDepartmentManager::Save(cIGZPersistDBSegment* pSegment) const
+{
+	if (!pSegment)
+	{
+		return;
+	}
+
+	cRZAutoRefCount<cISC4DBSegment> pSC4DBSegment;
+
+	if (!pSegment->QueryInterface(GZIID_cISC4DBSegment, pSC4DBSegment.AsPPVoid()))
+	{
+		return;
+	}
+
+	if (legacyLineItemsMigrated)
+	{
+		// The record is written even if the city does not have any line items,
+		// so the city's buildings are not enumerated again when it is loaded.
+		cGZPersistResourceKey migrationKey(
+			CustomBudgetDepartmentManagerTypeId,
+			CustomBudgetDepartmentManagerGroupId,
+			CustomBudgetMigrationInstanceId);
+
+		cRZAutoRefCount<cISC4DBSegmentOStream> pMigrationStream;
+
+		if (pSC4DBSegment->OpenOStream(migrationKey, pMigrationStream.AsPPObj(), true))
+		{
+			WriteMigrationRecord(*pMigrationStream);
+		}
+	}
+
+	if (!customBudgetDepartments.empty())
+	{
+		cGZPersistResourceKey key(
+			CustomBudgetDepartmentManagerTypeId,
+			CustomBudgetDepartmentManagerGroupId,
+			CustomBudgetDepartmentManagerInstanceId);
+
+		cRZAutoRefCount<cISC4DBSegmentOStream> pStream;
+
+		if (pSC4DBSegment->OpenOStream(key, pStream.AsPPObj(), true))
+		{
+			WriteToDBSegment(*pStream);
+		}
+
+		cGZPersistResourceKey summaryKey(
+			CustomBudgetDepartmentManagerTypeId,
+			CustomBudgetDepartmentManagerGroupId,
+			CustomBudgetCitySummaryInstanceId);
+
+		cRZAutoRefCount<cISC4DBSegmentOStream> pSummaryStream;
+
+		if (pSC4DBSegment->OpenOStream(summaryKey, pSummaryStream.AsPPObj(), true))
+		{
+			WriteCitySummary(*pSummaryStream);
+		}
+	}
+}
+
+void CustomBudgetDepartmentManager::ReadFromDBSegment(cISC4DBSegmentIStream& stream)
+{
+	TraceScope traceScope("ReadFromDBSegment", "persistence");
+
+	uint32_t version = 0;
+
+	if (stream.GetUint32(version))
+	{
+		if (version == 1)
+		{
+			previewSharedValues.Clear();
+			customBudgetDepartments.clear();
+
+			if (!ReadLineItemTransactions(stream, customBudgetDepartments))
 			{
-				ReadFromDBSegment(*pStream);
+				// The partially read data is discarded, the transactions are created
+				// from the city's buildings when the city is loaded.
+				customBudgetDepartments.clear();
+				legacyLineItemsMigrated = false;
+				Logger::GetInstance().WriteLine(LogLevel::Error, "The custom budget department save game data is invalid.");
 			}
+
+			RebuildBudgetTotals();
 		}
 	}
 }
 
-void CustomBudgetDepartmentManager::Save(cIGZPersistDBSegment* pSegment) const
+void CustomBudgetDepartmentManager::WriteToDBSegment(cISC4DBSegmentOStream& stream) const
 {
-	if (pSegment && !customBudgetDepartments.empty())
+	TraceScope traceScope("WriteToDBSegment", "persistence");
+
+	if (stream.SetUint32(1))
 	{
-		cRZAutoRefCount<cISC4DBSegment> pSC4DBSegment;
+		stream.SetUint32(customBudgetDepartments.size());
 
-		if (pSegment->QueryInterface(GZIID_cISC4DBSegment, pSC4DBSegment.AsPPVoid()))
+		for (const auto& departments : customBudgetDepartments)
 		{
-			cGZPersistResourceKey key(
-				CustomBudgetDepartmentManagerTypeId,
-				CustomBudgetDepartmentManagerGroupId,
-				CustomBudgetDepartmentManagerInstanceId);
+			stream.SetUint32(departments.first); // department id
+
+			const auto& lineItems = departments.second;
 
-			cRZAutoRefCount<cISC4DBSegmentOStream> pStream;
+			stream.SetUint32(lineItems.size()); // line item count
 
-			if (pSC4DBSegment->OpenOStream(key, pStream.AsPPObj(), true))
+			for (const auto& lineItem : lineItems)
 			{
-				WriteToDBSegment(*pStream);
+				stream.SetUint32(lineItem.first); // line item id
+				lineItem.second->Write(stream);   // line item transaction
 			}
 		}
 	}
 }
 
-void CustomBudgetDepartmentManager::ReadFromDBSegment(cISC4DBSegmentIStream& stream)
+void CustomBudgetDepartmentManager::ReadMigrationRecord(cISC4DBSegmentIStream& stream)
 {
 	uint32_t version = 0;
 
-	if (stream.GetUint32(version))
-	{
-		if (version == 1)
-		{
-			uint32_t departmentCount = 0;
-			stream.GetUint32(departmentCount);
+	legacyLineItemsMigrated = stream.GetUint32(version) && version == MigrationRecordVersion;
+}
 
-			customBudgetDepartments.clear();
-			customBudgetDepartments.reserve(departmentCount);
+void CustomBudgetDepartmentManager::WriteMigrationRecord(cISC4DBSegmentOStream& stream) const
+{
+	stream.SetUint32(MigrationRecordVersion);
+}
 
-			for (uint32_t i = 0; i < departmentCount; i++)
-			{
-				uint32_t departmentId = 0;
-				stream.GetUint32(departmentId);
+void CustomBudgetDepartmentManager::WriteCitySummary(cISC4DBSegmentOStream& stream) const
+{
+	CustomBudgetCitySummary summary;
 
-				uint32_t lineItemCount = 0;
-				stream.GetUint32(lineItemCount);
+	cISC4AppPtr pSC4App;
 
-				std::unordered_map<uint32_t, std::unique_ptr<LineItemTransaction>> lineItems;
-				lineItems.reserve(lineItemCount);
+	if (pSC4App)
+	{
+		cISC4City* pCity = pSC4App->GetCity();
+		cISC4RegionalCity* pRegionalCity = pSC4App->GetRegionalCity();
 
-				for (uint32_t i = 0; i < lineItemCount; i++)
-				{
-					uint32_t lineItemId = 0;
-					stream.GetUint32(lineItemId);
+		if (pRegionalCity)
+		{
+			pRegionalCity->GetPosition(summary.tileX, summary.tileZ);
+		}
 
-					std::unique_ptr<LineItemTransaction> transaction = std::make_unique<LineItemTransaction>();
-					transaction->Read(stream);
+		if (pCity)
+		{
+			cISC4ResidentialSimulator* pResidentialSimulator = pCity->GetResidentialSimulator();
 
-					lineItems.emplace(lineItemId, std::move(transaction));
-				}
+			if (pResidentialSimulator)
+			{
+				summary.residentialPopulation = pResidentialSimulator->GetPopulation();
+			}
+		}
+	}
+
+	if (pBudgetSim)
+	{
+		summary.departments.reserve(customBudgetDepartments.size());
+
+		for (const auto& department : customBudgetDepartments)
+		{
+			cISC4DepartmentBudget* const pDepartment = pBudgetSim->GetDepartmentBudget(department.first);
+			BudgetTotals totals{};
 
-				customBudgetDepartments.emplace(departmentId, std::move(lineItems));
+			if (pDepartment && budgetTotals.GetDepartmentTotals(department.first, totals))
+			{
+				summary.departments.push_back(
+					CustomBudgetCityDepartmentTotals{ department.first, pDepartment->GetBudgetGroup(), totals.expenses, totals.income });
 			}
 		}
+
+		std::sort(
+			summary.departments.begin(),
+			summary.departments.end(),
+			[](const CustomBudgetCityDepartmentTotals& left, const CustomBudgetCityDepartmentTotals& right)
+			{
+				return left.department < right.department;
+			});
 	}
+
+	summary.Write(stream);
 }
 
-void CustomBudgetDepartmentManager::WriteToDBSegment(cISC4DBSegmentOStream& stream) const
+void CustomBudgetDepartmentManager::OpenRegionalBudgetSummary()
 {
-	if (stream.SetUint32(1))
-	{
-		stream.SetUint32(customBudgetDepartments.size());
+	regionalBudgetSummary.Close();
 
-		for (const auto& departments : customBudgetDepartments)
-		{
-			stream.SetUint32(departments.first); // department id
+	cISC4AppPtr pSC4App;
 
-			const auto& lineItems = departments.second;
+	if (pSC4App)
+	{
+		cISC4RegionalCity* pRegionalCity = pSC4App->GetRegionalCity();
 
-			stream.SetUint32(lineItems.size()); // line item count
+		if (pRegionalCity)
+		{
+			cRZBaseString saveFilePath;
+			int32_t x = 0;
+			int32_t z = 0;
 
-			for (const auto& lineItem : lineItems)
+			if (pRegionalCity->GetCitySaveFilePath(saveFilePath)
+				&& saveFilePath.Strlen() > 0
+				&& pRegionalCity->GetPosition(x, z))
 			{
-				stream.SetUint32(lineItem.first); // line item id
-				lineItem.second->Write(stream);   // line item transaction
+				// The summary is stored in the region folder, next to the city save games.
+				const std::filesystem::path path = std::filesystem::path(saveFilePath.ToChar()).parent_path() / RegionalBudgetSummaryFileName;
+
+				if (regionalBudgetSummary.Open(path, x, z))
+				{
+					Logger::GetInstance().WriteLineFormatted(
+						LogLevel::Info,
+						"Loaded the custom budget totals of %zu cities from the region summary.",
+						regionalBudgetSummary.GetCityCount());
+				}
 			}
 		}
 	}
@@ -1000,7 +1762,7 @@ cISC4DepartmentBudget* CustomBudgetDepartmentManager::GetOrCreateBudgetDepartmen
 
 		if (!pDepartmentBudget)
 		{
-			if (IsValidBudgetGroup(info.budgetGroup))
+			if (CustomBudgetExemplarReader::IsValidBudgetGroup(info.budgetGroup))
 			{
 				pDepartmentBudget = pBudgetSim->CreateDepartmentBudget(info.department, info.budgetGroup);
 
@@ -1070,7 +1832,8 @@ cISC4LineItem* CustomBudgetDepartmentManager::GetOrCreateLineItem(
 
 LineItemTransaction* CustomBudgetDepartmentManager::GetOrCreateLineItemTransaction(
 	const cISCPropertyHolder* pPropertyHolder,
-	const CustomBudgetDepartmentInfo& info)
+	const CustomBudgetDepartmentInfo& info,
+	std::span<const uint8_t> indexTransaction)
 {
 	LineItemTransaction* result = nullptr;
 
@@ -1084,6 +1847,7 @@ LineItemTransaction* CustomBudgetDepartmentManager::GetOrCreateLineItemTransacti
 		{
 			if (CreateLineItemTransaction(
 				pPropertyHolder,
+				indexTransaction,
 				info.lineNumber,
 				info.cost,
 				info.type == CustomBudgetDepartmentItemType::Income,
@@ -1099,6 +1863,7 @@ LineItemTransaction* CustomBudgetDepartmentManager::GetOrCreateLineItemTransacti
 
 		if (CreateLineItemTransaction(
 			pPropertyHolder,
+			indexTransaction,
 			info.lineNumber,
 			info.cost,
 			info.type == CustomBudgetDepartmentItemType::Income,
@@ -1137,6 +1902,9 @@ void CustomBudgetDepartmentManager::RemoveLineItemTransaction(const CustomBudget
 
 		if (lineItems.erase(info.lineNumber) == 1)
 		{
+			previewSharedValues.Clear();
+			lineItemVersion++;
+
 			if (lineItems.size() == 0)
 			{
 				customBudgetDepartments.erase(departmentLineItems);
@@ -1145,76 +1913,378 @@ void CustomBudgetDepartmentManager::RemoveLineItemTransaction(const CustomBudget
 	}
 }
 
-std::vector<CustomBudgetDepartmentManager::CustomBudgetDepartmentInfo> CustomBudgetDepartmentManager::LoadCustomBudgetDepartmentInfo(
+void CustomBudgetDepartmentManager::AddBudgetTotalsDepartment(cISC4DepartmentBudget* pDepartment)
+{
+	const uint32_t department = pDepartment->GetDepartmentID();
+
+	if (!budgetTotals.ContainsDepartment(department))
+	{
+		// The department is walked once when it is first used, the line items of the departments
+		// that were created before the totals were tracked are included in the initial totals.
+		BudgetTotals initialTotals{};
+
+		eastl::vector<cISC4LineItem*> lineItems;
+
+		if (pDepartment->GetAllLineItems(lineItems))
+		{
+			for (cISC4LineItem* pLineItem : lineItems)
+			{
+				initialTotals.expenses += pLineItem->GetFullExpenses();
+				initialTotals.income += pLineItem->GetIncome();
+
+				RecordLineItem(pDepartment, pLineItem);
+			}
+		}
+
+		budgetTotals.AddDepartment(department, pDepartment->GetBudgetGroup(), initialTotals);
+	}
+}
+
+void CustomBudgetDepartmentManager::RebuildBudgetTotals()
+{
+	// The line item transactions were replaced.
+	lineItemVersion++;
+	budgetTotals.Clear();
+	lineItemTable.Clear();
+	// The line items are reported as added in the next notification.
+	lineItemChangeNotifier.Clear();
+
+	if (pBudgetSim)
+	{
+		for (const auto& department : customBudgetDepartments)
+		{
+			cISC4DepartmentBudget* const pDepartment = pBudgetSim->GetDepartmentBudget(department.first);
+
+			if (pDepartment)
+			{
+				AddBudgetTotalsDepartment(pDepartment);
+			}
+		}
+	}
+}
+
+void CustomBudgetDepartmentManager::SetLineItemExpenses(
+	cISC4DepartmentBudget* pDepartment,
+	cISC4LineItem* pLineItem,
+	int64_t value)
+{
+	AddBudgetTotalsDepartment(pDepartment);
+
+	const int64_t delta = value - pLineItem->GetFullExpenses();
+
+	pLineItem->SetFullExpenses(value);
+	budgetTotals.AddDelta(pDepartment->GetDepartmentID(), delta, 0);
+	RecordLineItem(pDepartment, pLineItem);
+}
+
+void CustomBudgetDepartmentManager::SetLineItemIncome(
+	cISC4DepartmentBudget* pDepartment,
+	cISC4LineItem* pLineItem,
+	int64_t value)
+{
+	AddBudgetTotalsDepartment(pDepartment);
+
+	const int64_t delta = value - pLineItem->GetIncome();
+
+	pLineItem->SetIncome(value);
+	budgetTotals.AddDelta(pDepartment->GetDepartmentID(), 0, delta);
+	RecordLineItem(pDepartment, pLineItem);
+}
+
+void CustomBudgetDepartmentManager::RemoveLineItem(cISC4DepartmentBudget* pDepartment, cISC4LineItem* pLineItem)
+{
+	lineItemVersion++;
+
+	AddBudgetTotalsDepartment(pDepartment);
+
+	budgetTotals.AddDelta(
+		pDepartment->GetDepartmentID(),
+		-pLineItem->GetFullExpenses(),
+		-pLineItem->GetIncome());
+	if (lineItemChangeNotifier.HasListeners())
+	{
+		lineItemChangeNotifier.RecordChange(
+			lineItemTable.Find(pDepartment->GetDepartmentID(), pLineItem->GetID()),
+			nullptr);
+	}
+
+	lineItemTable.Remove(pDepartment->GetDepartmentID(), pLineItem->GetID());
+	pDepartment->RemoveLineItem(pLineItem->GetID());
+}
+
+void CustomBudgetDepartmentManager::RecordLineItem(cISC4DepartmentBudget* pDepartment, cISC4LineItem* pLineItem)
+{
+	lineItemVersion++;
+
+	CustomBudgetLineItemState state{};
+	state.department = pDepartment->GetDepartmentID();
+	state.lineNumber = pLineItem->GetID();
+	state.budgetGroup = pDepartment->GetBudgetGroup();
+	state.algorithmType = static_cast<uint32_t>(TransactionAlgorithmType::Fixed);
+	state.buildingCount = pLineItem->GetSecondaryInfoField();
+	state.expenses = pLineItem->GetFullExpenses();
+	state.income = pLineItem->GetIncome();
+
+	const auto& departmentLineItems = customBudgetDepartments.find(state.department);
+
+	if (departmentLineItems != customBudgetDepartments.end())
+	{
+		const LineItemTransaction* pTransaction = GetLineItemTransactionPtr(departmentLineItems->second, state.lineNumber);
+
+		if (pTransaction)
+		{
+			state.algorithmType = static_cast<uint32_t>(pTransaction->GetAlgorithmType());
+		}
+	}
+
+	if (lineItemChangeNotifier.HasListeners())
+	{
+		const CustomBudgetLineItemState* pOldState = lineItemTable.Find(state.department, state.lineNumber);
+
+		if (pOldState)
+		{
+			const CustomBudgetLineItemState oldState = *pOldState;
+
+			lineItemTable.Set(state);
+			lineItemChangeNotifier.RecordChange(&oldState, &state);
+		}
+		else
+		{
+			lineItemTable.Set(state);
+			lineItemChangeNotifier.RecordChange(nullptr, &state);
+		}
+	}
+	else
+	{
+		lineItemTable.Set(state);
+	}
+}
+
+CustomBudgetDepartmentManager::BuildingTypeInfo* CustomBudgetDepartmentManager::GetBuildingTypeInfo(
+	uint32_t buildingType,
 	const cISCPropertyHolder* pPropertyHolder)
 {
-	std::vector<CustomBudgetDepartmentInfo> items;
+	BuildingTypeInfo* result = nullptr;
 
-	std::vector<uint32_t> purposeIds;
+	auto item = buildingTypeInfoCache.find(buildingType);
 
-	if (GetPropertyValue(pPropertyHolder, kBudgetItemPurpose, purposeIds))
+	if (item != buildingTypeInfoCache.end())
 	{
-		if (ContainsCustomBudgetDepartmentPurposeId(purposeIds))
+		result = &item->second;
+		result->lastUsed = ++buildingTypeInfoUseCounter;
+	}
+	else
+	{
+		BuildingTypeInfo info;
+		info.lastUsed = ++buildingTypeInfoUseCounter;
+
+		if (index.Find(buildingType, info.items, info.indexTransactions))
 		{
-			BudgetPropertyInfo info;
+			result = &buildingTypeInfoCache.emplace(buildingType, std::move(info)).first->second;
+		}
+		else if (pPropertyHolder)
+		{
+			// The building types that don't use a custom budget department are also
+			// cached, so their exemplars are only parsed once.
+			TraceScope traceScope("LoadCustomBudgetDepartmentInfo", "exemplar");
+
+			LoggerExemplarErrorReporter errorReporter;
+
+			info.items = CustomBudgetExemplarReader::ReadLineItems(pPropertyHolder, &departmentDefinitions, errorReporter);
 
-			if (GetBudgetPropertyInfo(pPropertyHolder, purposeIds, info))
+			if (!indexPath.empty())
 			{
-				const size_t budgetDepartmentCount = info.departmentIds.size();
+				AddToIndexWriter(buildingType, info, pPropertyHolder);
+			}
 
-				for (size_t i = 0; i < budgetDepartmentCount; i++)
-				{
-					CustomBudgetDepartmentItemType type = CustomBudgetDepartmentItemType::Invalid;
+			result = &buildingTypeInfoCache.emplace(buildingType, std::move(info)).first->second;
+		}
+	}
 
-					switch (purposeIds[i])
-					{
-					case kCustomBudgetDepartmentExpensePurposeId:
-						type = CustomBudgetDepartmentItemType::Expense;
-						break;
-					case kCustomBudgetDepartmentIncomePurposeId:
-						type = CustomBudgetDepartmentItemType::Income;
-						break;
-					}
+	return result;
+}
 
-					if (type != CustomBudgetDepartmentItemType::Invalid)
-					{
-						const uint32_t departmentId = info.departmentIds[i];
-						const auto& budgetGroupItem = info.budgetGroups.find(departmentId);
+void CustomBudgetDepartmentManager::AddToIndexWriter(
+	uint32_t buildingType,
+	const BuildingTypeInfo& info,
+	const cISCPropertyHolder* pPropertyHolder)
+{
+	std::vector<std::vector<uint8_t>> transactions;
+	transactions.reserve(info.items.size());
 
-						if (budgetGroupItem != info.budgetGroups.end())
-						{
-							const auto& departmentNameItem = info.departmentNameKeys.find(departmentId);
+	for (const CustomBudgetDepartmentInfo& item : info.items)
+	{
+		transactions.push_back(SerializeLineItemTransaction(pPropertyHolder, item));
+	}
 
-							if (departmentNameItem != info.departmentNameKeys.end())
-							{
-								items.push_back(CustomBudgetDepartmentInfo(
-									type,
-									departmentId,
-									info.lines[i],
-									budgetGroupItem->second,
-									info.costs[i],
-									departmentNameItem->second));
-							}
-							else
-							{
-								LogRequiredDepartmentItemNotFound(
-									pPropertyHolder,
-									"name key",
-									departmentId);
-							}
-						}
-						else
-						{
-							LogRequiredDepartmentItemNotFound(
-								pPropertyHolder,
-								"budget group id",
-								departmentId);
-						}
-					}
-				}
+	indexWriter.Add(buildingType, info.items, std::move(transactions));
+}
+
+void CustomBudgetDepartmentManager::WriteIndex()
+{
+	if (!indexWriter.IsEmpty())
+	{
+		// The building types of a valid index are kept, the file is replaced so it must not be mapped.
+		indexWriter.AddMissing(index);
+		index.Close();
+
+		if (!indexWriter.Write(indexPath, indexPluginFingerprint))
+		{
+			Logger::GetInstance().WriteLine(LogLevel::Error, "Failed to write the custom budget index.");
+		}
+
+		indexWriter.Clear();
+	}
+
+	index.Close();
+}
+
+void CustomBudgetDepartmentManager::TrimBuildingTypeInfoCache()
+{
+	// The preview transactions registered their conditions in the city's predicate table,
+	// they are created again when the building type is used in the next city.
+	for (auto& [buildingType, info] : buildingTypeInfoCache)
+	{
+		info.previewTransactions.clear();
+		info.previewTransactions.shrink_to_fit();
+		info.previewTransactionsCreated = false;
+	}
+
+	// The size is an estimate of the memory used by the building types, the hash table
+	// nodes are assumed to have two pointers of overhead.
+	auto getEntrySize = [](const BuildingTypeInfo& info)
+	{
+		return sizeof(std::pair<const uint32_t, BuildingTypeInfo>)
+			+ (2 * sizeof(void*))
+			+ (info.items.capacity() * sizeof(CustomBudgetDepartmentInfo))
+			+ (info.indexTransactions.capacity() * sizeof(std::span<const uint8_t>));
+	};
+
+	std::vector<std::pair<uint64_t, uint32_t>> entries;
+	entries.reserve(buildingTypeInfoCache.size());
+
+	size_t totalSize = 0;
+
+	for (const auto& [buildingType, info] : buildingTypeInfoCache)
+	{
+		entries.emplace_back(info.lastUsed, buildingType);
+		totalSize += getEntrySize(info);
+	}
+
+	if (totalSize > MaxRetainedBuildingTypeInfoBytes)
+	{
+		// Remove the least recently used building types until the cache fits in the limit.
+		std::sort(entries.begin(), entries.end());
+
+		for (const auto& [lastUsed, buildingType] : entries)
+		{
+			if (totalSize <= MaxRetainedBuildingTypeInfoBytes)
+			{
+				break;
 			}
+
+			const auto item = buildingTypeInfoCache.find(buildingType);
+
+			totalSize -= getEntrySize(item->second);
+			buildingTypeInfoCache.erase(item);
+		}
+	}
+}
+
+void CustomBudgetDepartmentManager::CreatePreviewTransactions(
+	BuildingTypeInfo& info,
+	const cISCPropertyHolder* pPropertyHolder)
+{
+	// The transactions are created once per building type, the line items that fail
+	// to create a transaction use the fixed cost from the exemplar.
+	info.previewTransactionsCreated = true;
+	info.previewTransactions.clear();
+	info.previewTransactions.reserve(info.items.size());
+
+	for (size_t i = 0; i < info.items.size(); i++)
+	{
+		const CustomBudgetDepartmentInfo& item = info.items[i];
+
+		std::unordered_map<uint32_t, std::unique_ptr<LineItemTransaction>> lineItems;
+
+		if (CreateLineItemTransaction(
+			pPropertyHolder,
+			info.GetIndexTransaction(i),
+			item.lineNumber,
+			item.cost,
+			item.type == CustomBudgetDepartmentItemType::Income,
+			lineItems))
+		{
+			info.previewTransactions.push_back(std::move(lineItems.begin()->second));
+		}
+		else
+		{
+			info.previewTransactions.push_back(nullptr);
+		}
+	}
+}
+
+int64_t CustomBudgetDepartmentManager::CalculatePlacementCostDelta(
+	const CustomBudgetDepartmentInfo& item,
+	const LineItemTransaction* pPreviewTransaction)
+{
+	int64_t buildingCount = 0;
+
+	cISC4DepartmentBudget* const pDepartment = pBudgetSim->GetDepartmentBudget(item.department);
+
+	if (pDepartment)
+	{
+		cISC4LineItem* const pLineItem = pDepartment->GetLineItem(item.lineNumber);
+
+		if (pLineItem)
+		{
+			buildingCount = pLineItem->GetSecondaryInfoField();
 		}
 	}
 
-	return items;
+	// The line items that are already in the city use their existing transaction,
+	// the first building of a line item uses the preview transaction.
+	const LineItemTransaction* pTransaction = GetLineItemTransaction(item);
+
+	if (!pTransaction)
+	{
+		pTransaction = pPreviewTransaction;
+	}
+
+	int64_t delta = 0;
+
+	if (pTransaction)
+	{
+		delta = pTransaction->CalculateMarginalTotal(buildingCount, previewSharedValues);
+	}
+	else
+	{
+		delta = item.cost;
+	}
+
+	return delta;
+}
+
+BudgetSandbox::LineItem& CustomBudgetDepartmentManager::AddSandboxLineItem(
+	BudgetSandbox& sandbox,
+	const CustomBudgetDepartmentInfo& item)
+{
+	BudgetSandbox::LineItem lineItem{};
+	lineItem.pTransaction = GetLineItemTransaction(item);
+	lineItem.isIncome = item.type == CustomBudgetDepartmentItemType::Income;
+
+	const CustomBudgetLineItemState* const pState = lineItemTable.Find(item.department, item.lineNumber);
+
+	if (pState)
+	{
+		lineItem.buildingCount = pState->buildingCount;
+		lineItem.expenses = pState->expenses;
+		lineItem.income = pState->income;
+	}
+
+	// The department totals are copied when the sandbox first changes one of its line items.
+	BudgetTotals departmentTotals{};
+	budgetTotals.GetDepartmentTotals(item.department, departmentTotals);
+
+	return sandbox.AddLineItem(item.department, item.lineNumber, lineItem, departmentTotals);
 }
\ No newline at end of file
@@ -13,9 +13,24 @@
 
 #pragma once
 #include "cIGZMessageTarget2.h"
+#include "BudgetProjection.h"
+#include "BudgetSandbox.h"
+#include "ConditionPredicateTable.h"
+#include "CustomBudgetExemplarReader.h"
+#include "CustomBudgetIndex.h"
+#include "CustomBudgetLineItemTable.h"
+#include "CustomBudgetTotals.h"
+#include "DepartmentDefinitionTable.h"
+#include "HistoryProvider.h"
+#include "LineItemChangeNotifier.h"
 #include "LineItemTransaction.h"
+#include "MessageStreamRecorder.h"
 #include "PopulationProvider.h"
+#include "RegionalBudgetSummary.h"
+#include "ResidentialCatchmentProvider.h"
 #include "StringResourceKey.h"
+#include <filesystem>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
@@ -38,47 +53,186 @@ public:
 	bool Init();
 	bool Shutdown();
 
-private:
-	enum class CustomBudgetDepartmentItemType : uint32_t
+	/**
+	 * @brief Loads the shared department definition exemplars from the game's resource manager.
+	 *
+	 * The definitions are loaded once after the game has loaded the plugins, they are not
+	 * modified while the game is running.
+	 */
+	void LoadDepartmentDefinitions();
+
+	/**
+	 * @brief Uses a precompiled index for the building type lookups instead of parsing the exemplars.
+	 *
+	 * The building types that are not in the index are parsed from their exemplars, Shutdown adds them
+	 * to the index file so that the next session does not have to parse them.
+	 * @param path The index file path.
+	 * @param pluginFingerprint The fingerprint of the current plugin set, see CustomBudgetIndex::ComputePluginFingerprint.
+	 * @return True if the index file matches the plugin set; otherwise, false and the index file is
+	 * replaced at shutdown.
+	 */
+	bool OpenIndex(const std::filesystem::path& path, uint64_t pluginFingerprint);
+
+	struct PlacementCostPreview
 	{
-		Invalid,
-		Expense,
-		Income
+		int64_t expenseDelta;
+		int64_t incomeDelta;
 	};
 
-	struct CustomBudgetDepartmentInfo
+	/**
+	 * @brief Gets the change in the monthly expenses and income if one more building of the specified type is placed.
+	 *
+	 * The parsed exemplar info is cached by building type, so the exemplar is only parsed the first time
+	 * that the building type is inserted or previewed. The game state is not modified and the algorithm
+	 * shared values are cached until the next monthly update, this allows the method to be called on every
+	 * frame while the player is hovering the building.
+	 * @param buildingType The building type, this is the instance id of the building exemplar.
+	 * @param pExemplar The building exemplar, used if the building type is not cached. Can be null.
+	 * @param preview Receives the monthly expense and income deltas.
+	 * @return True if the building has custom budget department line items; otherwise, false.
+	 */
+	bool GetPlacementCostPreview(uint32_t buildingType, const cISCPropertyHolder* pExemplar, PlacementCostPreview& preview);
+
+	/**
+	 * @brief Gets the expense and income totals of a custom budget department.
+	 * The totals are updated when the plugin changes a line item, so this does not walk the line items.
+	 * @param department The department id.
+	 * @param totals Receives the full expenses and the income of the department's line items.
+	 * @return True if the department is a custom budget department in the current city; otherwise, false.
+	 */
+	bool GetDepartmentTotals(uint32_t department, BudgetTotals& totals) const;
+
+	/**
+	 * @brief Gets the expense and income totals of the custom budget departments in a budget group.
+	 * @param budgetGroup The budget group id.
+	 * @param totals Receives the full expenses and the income of the group's custom departments.
+	 * @return True if the budget group has at least one custom budget department; otherwise, false.
+	 */
+	bool GetBudgetGroupTotals(uint32_t budgetGroup, BudgetTotals& totals) const;
+
+	/**
+	 * @brief Gets the state of the custom budget department line items in the current city.
+	 */
+	const CustomBudgetLineItemTable& GetLineItemTable() const;
+
+	/**
+	 * @brief Registers a listener that receives the line item changes once per simulation month.
+	 * @param pListener The listener.
+	 * @param department The department to receive changes for, or 0 for all departments.
+	 * @param budgetGroup The budget group to receive changes for, or 0 for all budget groups.
+	 * @return True if the listener was added; otherwise, false.
+	 */
+	bool AddLineItemListener(cICustomBudgetLineItemListener* pListener, uint32_t department, uint32_t budgetGroup);
+	bool RemoveLineItemListener(cICustomBudgetLineItemListener* pListener);
+
+	/**
+	 * @brief Gets the current city and region populations.
+	 * @return True if a city is loaded; otherwise, false.
+	 */
+	bool GetCurrentPopulation(CustomBudgetPopulation& population);
+
+	/**
+	 * @brief Creates a population trajectory that continues the trend of a city population history type.
+	 * @param historyType The id of the history type that records the city's residential population.
+	 * @param historyMonthCount The number of months before the current date that the trend uses.
+	 * @param monthCount The number of months to project.
+	 * @param trajectory Receives the trajectory.
+	 * @return True on success; otherwise, false.
+	 */
+	bool CreateHistoryTrajectory(
+		uint32_t historyType,
+		uint32_t historyMonthCount,
+		uint32_t monthCount,
+		CustomBudgetPopulationTrajectory& trajectory);
+
+	/**
+	 * @brief Projects the custom budget department totals for the following months.
+	 *
+	 * The projection uses the line item transactions and building counts of the current city, the
+	 * game state is not modified. See cICustomBudgetDepartmentQuery::ProjectDepartmentTotals for details.
+	 * @param trajectory The population trajectory.
+	 * @param monthCount The number of months to project, 1 to BudgetProjection::MaxMonthCount.
+	 * @param pBuffer The buffer that receives the department totals for each month, ordered by month.
+	 * @param capacity The number of values that the buffer can hold.
+	 * @return The number of values that were copied.
+	 */
+	size_t ProjectDepartmentTotals(
+		const CustomBudgetPopulationTrajectory& trajectory,
+		uint32_t monthCount,
+		CustomBudgetProjectedTotals* pBuffer,
+		size_t capacity);
+
+	/**
+	 * @brief Creates a what-if sandbox for the current city.
+	 *
+	 * Creating a sandbox does not copy the city state, the sandbox only stores the departments and line items
+	 * that it changes. The sandbox is valid until the city's line items change, e.g. when a building is placed
+	 * or at the start of the next month.
+	 */
+	BudgetSandbox CreateSandbox() const;
+
+	/**
+	 * @brief Adds or removes buildings of the specified type in a what-if sandbox.
+	 *
+	 * The line item totals are calculated in the same way as when the buildings are placed or removed, the
+	 * BuildingAge and ResidentialCatchment costs of the added or removed buildings themselves are not included
+	 * because they depend on the individual buildings. The city is not modified.
+	 * @param sandbox The sandbox.
+	 * @param buildingType The building type, this is the instance id of the building exemplar.
+	 * @param pExemplar The building exemplar, used if the building type is not cached. Can be null.
+	 * @param buildingCountDelta The number of buildings to add, or a negative number to remove buildings.
+	 * @return True if the building has custom budget department line items and the sandbox is valid; otherwise, false.
+	 */
+	bool ChangeSandboxBuildings(
+		BudgetSandbox& sandbox,
+		uint32_t buildingType,
+		const cISCPropertyHolder* pExemplar,
+		int64_t buildingCountDelta);
+
+	/**
+	 * @brief Gets the expense and income totals of a custom budget department in a what-if sandbox.
+	 * @param sandbox The sandbox.
+	 * @param department The department id.
+	 * @param totals Receives the full expenses and the income of the department's line items.
+	 * @return True if the department has line items in the sandbox or the city and the sandbox is valid; otherwise, false.
+	 */
+	bool GetSandboxDepartmentTotals(const BudgetSandbox& sandbox, uint32_t department, BudgetTotals& totals) const;
+
+	/**
+	 * @brief Gets the expense and income totals of a custom budget department in the other cities of the region.
+	 * @param department The department id.
+	 * @param totals Receives the totals from the region summary, excluding the current city.
+	 * @return True if the region summary was loaded and another city has the department; otherwise, false.
+	 */
+	bool GetRegionDepartmentTotals(uint32_t department, BudgetTotals& totals) const;
+
+private:
+	struct BuildingTypeInfo
 	{
-		CustomBudgetDepartmentItemType type;
-		uint32_t department;
-		uint32_t lineNumber;
-		uint32_t budgetGroup;
-		int64_t cost;
-		StringResourceKey departmentNameKey;
-
-		CustomBudgetDepartmentInfo()
-			: type(CustomBudgetDepartmentItemType::Expense),
-			  department(0),
-			  lineNumber(0),
-			  budgetGroup(0),
-			  cost(0),
-			  departmentNameKey()
+		std::vector<CustomBudgetDepartmentInfo> items;
+		// The transactions that the placement preview uses for the line items that are
+		// not in the city yet, in the same order as the items.
+		std::vector<std::unique_ptr<LineItemTransaction>> previewTransactions;
+		// The serialized transactions of the line items that were read from the custom
+		// budget index, in the same order as the items. Empty if the exemplar was parsed.
+		std::vector<std::span<const uint8_t>> indexTransactions;
+		bool previewTransactionsCreated;
+		// The value of the use counter when the building type was last used, the least
+		// recently used building types are removed when a city is unloaded.
+		uint64_t lastUsed;
+
+		BuildingTypeInfo()
+			: items(),
+			  previewTransactions(),
+			  indexTransactions(),
+			  previewTransactionsCreated(false),
+			  lastUsed(0)
 		{
 		}
 
-		CustomBudgetDepartmentInfo(
-			CustomBudgetDepartmentItemType type,
-			uint32_t department,
-			uint32_t line,
-			uint32_t budgetGroup,
-			int64_t cost,
-			StringResourceKey departmentNameKey)
-			: type(type),
-			  department(department),
-			  lineNumber(line),
-			  budgetGroup(budgetGroup),
-			  cost(cost),
-			  departmentNameKey(departmentNameKey)
+		std::span<const uint8_t> GetIndexTransaction(size_t index) const
 		{
+			return index < indexTransactions.size() ? indexTransactions[index] : std::span<const uint8_t>();
 		}
 	};
 
@@ -86,9 +240,14 @@ private:
 	uint32_t AddRef() override;
 	uint32_t Release() override;
 	bool DoMessage(cIGZMessage2* pMsg) override;
+	void HandleMessage(uint32_t messageType, cIGZMessage2Standard* pStandardMsg);
+	void RecordMessage(uint32_t messageType, cIGZMessage2Standard* pStandardMsg);
+	std::vector<MessageStreamLineItem> GetRecordedLineItems() const;
 
 	void PostCityInit(cISC4City* pCity);
 	void PostCityShutdown();
+	void WriteTraceFile();
+	void MigrateLegacyLineItems(cISC4City* pCity);
 	void InsertOccupant(cIGZMessage2Standard* pStandardMsg);
 	void RemoveOccupant(cIGZMessage2Standard* pStandardMsg);
 	void SimNewMonth();
@@ -97,6 +256,10 @@ private:
 
 	void ReadFromDBSegment(cISC4DBSegmentIStream& stream);
 	void WriteToDBSegment(cISC4DBSegmentOStream& stream) const;
+	void WriteCitySummary(cISC4DBSegmentOStream& stream) const;
+	void ReadMigrationRecord(cISC4DBSegmentIStream& stream);
+	void WriteMigrationRecord(cISC4DBSegmentOStream& stream) const;
+	void OpenRegionalBudgetSummary();
 
 	cISC4DepartmentBudget* GetOrCreateBudgetDepartment(const CustomBudgetDepartmentInfo& info);
 	cISC4LineItem* GetOrCreateLineItem(
@@ -105,16 +268,58 @@ private:
 		const CustomBudgetDepartmentInfo& info);
 	LineItemTransaction* GetOrCreateLineItemTransaction(
 		const cISCPropertyHolder* pPropertyHolder,
-		const CustomBudgetDepartmentInfo& info);
+		const CustomBudgetDepartmentInfo& info,
+		std::span<const uint8_t> indexTransaction);
 
 	LineItemTransaction* GetLineItemTransaction(const CustomBudgetDepartmentInfo& info);
 	void RemoveLineItemTransaction(const CustomBudgetDepartmentInfo& info);
 
-	std::vector<CustomBudgetDepartmentInfo> LoadCustomBudgetDepartmentInfo(const cISCPropertyHolder* pPropertyHolder);
+	void AddBudgetTotalsDepartment(cISC4DepartmentBudget* pDepartment);
+	void RebuildBudgetTotals();
+	void SetLineItemExpenses(cISC4DepartmentBudget* pDepartment, cISC4LineItem* pLineItem, int64_t value);
+	void SetLineItemIncome(cISC4DepartmentBudget* pDepartment, cISC4LineItem* pLineItem, int64_t value);
+	void RemoveLineItem(cISC4DepartmentBudget* pDepartment, cISC4LineItem* pLineItem);
+	void RecordLineItem(cISC4DepartmentBudget* pDepartment, cISC4LineItem* pLineItem);
+
+	BuildingTypeInfo* GetBuildingTypeInfo(uint32_t buildingType, const cISCPropertyHolder* pPropertyHolder);
+	void AddToIndexWriter(uint32_t buildingType, const BuildingTypeInfo& info, const cISCPropertyHolder* pPropertyHolder);
+	void WriteIndex();
+	void TrimBuildingTypeInfoCache();
+	void CreatePreviewTransactions(BuildingTypeInfo& info, const cISCPropertyHolder* pPropertyHolder);
+	int64_t CalculatePlacementCostDelta(const CustomBudgetDepartmentInfo& item, const LineItemTransaction* pPreviewTransaction);
+	BudgetSandbox::LineItem& AddSandboxLineItem(BudgetSandbox& sandbox, const CustomBudgetDepartmentInfo& item);
 
 	uint32_t refCount;
 	cISC4BudgetSimulator* pBudgetSim;
 	std::unordered_map<uint32_t, std::unordered_map<uint32_t, std::unique_ptr<LineItemTransaction>>> customBudgetDepartments;
 	PopulationProvider populationProvider;
+	HistoryProvider historyProvider;
+	ConditionPredicateTable conditionPredicates;
+	ResidentialCatchmentProvider residentialCatchmentProvider;
+	CustomBudgetTotals budgetTotals;
+	// Set when the buildings that were in the city before the line item transactions were
+	// introduced have been added to the transactions, the flag is stored in the save game.
+	bool legacyLineItemsMigrated;
+	CustomBudgetLineItemTable lineItemTable;
+	LineItemChangeNotifier lineItemChangeNotifier;
+	AlgorithmSharedValueCache monthlySharedValues;
+	// The parsed building types are kept when a city is unloaded, so the next city
+	// in the session does not parse the same exemplars again.
+	std::unordered_map<uint32_t, BuildingTypeInfo> buildingTypeInfoCache;
+	uint64_t buildingTypeInfoUseCounter;
+	// The algorithm shared values used by the placement preview and the sandboxes. The cache is cleared
+	// when a line item is removed because it is keyed by the algorithm instance address.
+	AlgorithmSharedValueCache previewSharedValues;
+	// Incremented when the line items change, the sandboxes created from an older version are not valid.
+	uint64_t lineItemVersion;
+	BudgetProjection budgetProjection;
+	CustomBudgetIndex index;
+	// Collects the building types that were parsed from their exemplars, empty if the index is not used.
+	CustomBudgetIndexWriter indexWriter;
+	std::filesystem::path indexPath;
+	uint64_t indexPluginFingerprint;
+	DepartmentDefinitionTable departmentDefinitions;
+	// The custom budget totals of the other cities in the region, not loaded if the summary has not been generated.
+	RegionalBudgetSummary regionalBudgetSummary;
 };
 
@@ -0,0 +1,168 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "CustomBudgetDepartmentQuery.h"
+#include "CustomBudgetDepartmentManager.h"
+
+CustomBudgetDepartmentQuery::CustomBudgetDepartmentQuery(CustomBudgetDepartmentManager& manager)
+	: manager(manager),
+	  refCount(0)
+{
+}
+
+bool CustomBudgetDepartmentQuery::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cICustomBudgetDepartmentQuery)
+	{
+		*ppvObj = static_cast<cICustomBudgetDepartmentQuery*>(this);
+		AddRef();
+
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t CustomBudgetDepartmentQuery::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t CustomBudgetDepartmentQuery::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool CustomBudgetDepartmentQuery::GetDepartmentTotals(uint32_t department, int64_t& expenses, int64_t& income) const
+{
+	bool result = false;
+
+	BudgetTotals totals{};
+
+	if (manager.GetDepartmentTotals(department, totals))
+	{
+		expenses = totals.expenses;
+		income = totals.income;
+		result = true;
+	}
+
+	return result;
+}
+
+bool CustomBudgetDepartmentQuery::GetBudgetGroupTotals(uint32_t budgetGroup, int64_t& expenses, int64_t& income) const
+{
+	bool result = false;
+
+	BudgetTotals totals{};
+
+	if (manager.GetBudgetGroupTotals(budgetGroup, totals))
+	{
+		expenses = totals.expenses;
+		income = totals.income;
+		result = true;
+	}
+
+	return result;
+}
+
+bool CustomBudgetDepartmentQuery::GetLineItemState(
+	uint32_t department,
+	uint32_t lineNumber,
+	CustomBudgetLineItemState& state) const
+{
+	bool result = false;
+
+	const CustomBudgetLineItemState* pState = manager.GetLineItemTable().Find(department, lineNumber);
+
+	if (pState)
+	{
+		state = *pState;
+		result = true;
+	}
+
+	return result;
+}
+
+uint32_t CustomBudgetDepartmentQuery::GetLineItemCount() const
+{
+	return static_cast<uint32_t>(manager.GetLineItemTable().GetCount());
+}
+
+uint32_t CustomBudgetDepartmentQuery::CopyLineItems(CustomBudgetLineItemState* pBuffer, uint32_t capacity) const
+{
+	return static_cast<uint32_t>(manager.GetLineItemTable().Copy(pBuffer, capacity));
+}
+
+bool CustomBudgetDepartmentQuery::AddLineItemListener(
+	cICustomBudgetLineItemListener* pListener,
+	uint32_t department,
+	uint32_t budgetGroup)
+{
+	return manager.AddLineItemListener(pListener, department, budgetGroup);
+}
+
+bool CustomBudgetDepartmentQuery::RemoveLineItemListener(cICustomBudgetLineItemListener* pListener)
+{
+	return manager.RemoveLineItemListener(pListener);
+}
+
+bool CustomBudgetDepartmentQuery::GetCurrentPopulation(CustomBudgetPopulation& population)
+{
+	return manager.GetCurrentPopulation(population);
+}
+
+bool CustomBudgetDepartmentQuery::CreateHistoryTrajectory(
+	uint32_t historyType,
+	uint32_t historyMonthCount,
+	uint32_t monthCount,
+	CustomBudgetPopulationTrajectory& trajectory)
+{
+	return manager.CreateHistoryTrajectory(historyType, historyMonthCount, monthCount, trajectory);
+}
+
+uint32_t CustomBudgetDepartmentQuery::ProjectDepartmentTotals(
+	const CustomBudgetPopulationTrajectory& trajectory,
+	uint32_t monthCount,
+	CustomBudgetProjectedTotals* pBuffer,
+	uint32_t capacity)
+{
+	return static_cast<uint32_t>(manager.ProjectDepartmentTotals(trajectory, monthCount, pBuffer, capacity));
+}
+
+bool CustomBudgetDepartmentQuery::GetRegionDepartmentTotals(uint32_t department, int64_t& expenses, int64_t& income) const
+{
+	bool result = false;
+
+	BudgetTotals totals{};
+
+	if (manager.GetRegionDepartmentTotals(department, totals))
+	{
+		expenses = totals.expenses;
+		income = totals.income;
+		result = true;
+	}
+
+	return result;
+}
@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cICustomBudgetDepartmentQuery.h"
+
+class CustomBudgetDepartmentManager;
+
+/**
+ * @brief Implements cICustomBudgetDepartmentQuery using the CustomBudgetDepartmentManager state.
+ *
+ * The object has the same lifetime as the plugin, the reference count is only tracked
+ * for the COM contract.
+ */
+class CustomBudgetDepartmentQuery final : public cICustomBudgetDepartmentQuery
+{
+public:
+	CustomBudgetDepartmentQuery(CustomBudgetDepartmentManager& manager);
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	bool GetDepartmentTotals(uint32_t department, int64_t& expenses, int64_t& income) const override;
+	bool GetBudgetGroupTotals(uint32_t budgetGroup, int64_t& expenses, int64_t& income) const override;
+	bool GetLineItemState(uint32_t department, uint32_t lineNumber, CustomBudgetLineItemState& state) const override;
+	uint32_t GetLineItemCount() const override;
+	uint32_t CopyLineItems(CustomBudgetLineItemState* pBuffer, uint32_t capacity) const override;
+	bool AddLineItemListener(cICustomBudgetLineItemListener* pListener, uint32_t department, uint32_t budgetGroup) override;
+	bool RemoveLineItemListener(cICustomBudgetLineItemListener* pListener) override;
+	bool GetCurrentPopulation(CustomBudgetPopulation& population) override;
+	bool CreateHistoryTrajectory(
+		uint32_t historyType,
+		uint32_t historyMonthCount,
+		uint32_t monthCount,
+		CustomBudgetPopulationTrajectory& trajectory) override;
+	uint32_t ProjectDepartmentTotals(
+		const CustomBudgetPopulationTrajectory& trajectory,
+		uint32_t monthCount,
+		CustomBudgetProjectedTotals* pBuffer,
+		uint32_t capacity) override;
+	bool GetRegionDepartmentTotals(uint32_t department, int64_t& expenses, int64_t& income) const override;
+
+private:
+	CustomBudgetDepartmentManager& manager;
+	uint32_t refCount;
+};
@@ -13,15 +13,20 @@
 
 #include "version.h"
 #include "CustomBudgetDepartmentManager.h"
+#include "CustomBudgetDepartmentQuery.h"
 #include "DebugUtil.h"
 #include "Logger.h"
+#include "MessageStreamRecorder.h"
+#include "TraceEventRecorder.h"
 #include "cIGZApp.h"
+#include "cIGZCmdLine.h"
 #include "cIGZCOM.h"
 #include "cIGZFrameWork.h"
 #include "cRZBaseString.h"
 #include "cRZCOMDllDirector.h"
 
 #include <array>
+#include <vector>
 
 #include <Windows.h>
 #include "wil/resource.h"
@@ -34,6 +39,16 @@ static constexpr uint32_t kCustomBudgetDepartmentsDirectorID = 0x810A913B;
 using namespace std::string_view_literals;
 
 static constexpr std::string_view PluginLogFileName = "SC4CustomBudgetDepartments.log"sv;
+static constexpr std::string_view PluginTraceFileName = "SC4CustomBudgetDepartments.trace.json"sv;
+static constexpr std::string_view PluginMessageLogFileName = "SC4CustomBudgetDepartments.messages.bin"sv;
+static constexpr std::string_view PluginIndexFileName = "SC4CustomBudgetDepartments.index.bin"sv;
+
+// The game command line switch that enables the trace event recording, e.g. -CustomBudgetDepartmentsTrace
+static constexpr std::string_view TraceCommandLineSwitch = "CustomBudgetDepartmentsTrace"sv;
+static constexpr size_t TraceEventCapacity = 65536;
+
+// The game command line switch that enables the message stream recording, e.g. -CustomBudgetDepartmentsRecord
+static constexpr std::string_view RecordCommandLineSwitch = "CustomBudgetDepartmentsRecord"sv;
 
 namespace
 {
@@ -45,12 +60,43 @@ namespace
 
 		return temp.parent_path();
 	}
+
+	std::filesystem::path GetGamePluginsFolderPath()
+	{
+		// The game executable is in the Apps sub-folder of the installation folder.
+		wil::unique_cotaskmem_string modulePath = wil::GetModuleFileNameW(nullptr);
+
+		std::filesystem::path temp(modulePath.get());
+
+		return temp.parent_path().parent_path() / "Plugins";
+	}
+
+	bool IsCommandLineSwitchPresent(cIGZFrameWork* const pFramework, const std::string_view& name)
+	{
+		bool result = false;
+
+		if (pFramework)
+		{
+			cIGZCmdLine* const pCmdLine = pFramework->CommandLine();
+
+			if (pCmdLine)
+			{
+				cRZBaseString switchName(name.data(), name.size());
+
+				result = pCmdLine->IsSwitchPresent(switchName);
+			}
+		}
+
+		return result;
+	}
 }
 
 class CustomBudgetDepartmentsDllDirector final : public cRZCOMDllDirector
 {
 public:
 	CustomBudgetDepartmentsDllDirector()
+		: customBudgetDepartmentManager(),
+		  customBudgetDepartmentQuery(customBudgetDepartmentManager)
 	{
 		std::filesystem::path dllFolderPath = GetDllFolderPath();
 
@@ -60,6 +106,9 @@ public:
 		Logger& logger = Logger::GetInstance();
 		logger.Init(logFilePath, LogLevel::Error, false);
 		logger.WriteLogFileHeader("SC4CustomBudgetDepartment v" PLUGIN_VERSION_STR);
+
+		// Allows other DLL plugins to get the query interface through cIGZCOM::GetClassObject.
+		AddCls(GZCLSID_cICustomBudgetDepartmentQuery, GetCustomBudgetDepartmentQuery);
 	}
 
 	uint32_t GetDirectorID() const
@@ -67,6 +116,16 @@ public:
 		return kCustomBudgetDepartmentsDirectorID;
 	}
 
+	bool QueryInterface(uint32_t riid, void** ppvObj) override
+	{
+		if (riid == GZIID_cICustomBudgetDepartmentQuery)
+		{
+			return customBudgetDepartmentQuery.QueryInterface(riid, ppvObj);
+		}
+
+		return cRZCOMDllDirector::QueryInterface(riid, ppvObj);
+	}
+
 private:
 	bool OnStart(cIGZCOM* pCOM)
 	{
@@ -86,7 +145,45 @@ private:
 
 	bool PostAppInit()
 	{
+		cIGZFrameWork* const pFramework = RZGetFrameWork();
+
+		if (IsCommandLineSwitchPresent(pFramework, TraceCommandLineSwitch))
+		{
+			std::filesystem::path traceFilePath = GetDllFolderPath();
+			traceFilePath /= PluginTraceFileName;
+
+			TraceEventRecorder::GetInstance().Init(traceFilePath, TraceEventCapacity);
+		}
+
+		if (IsCommandLineSwitchPresent(pFramework, RecordCommandLineSwitch))
+		{
+			std::filesystem::path messageLogFilePath = GetDllFolderPath();
+			messageLogFilePath /= PluginMessageLogFileName;
+
+			MessageStreamRecorder::GetInstance().Init(messageLogFilePath);
+		}
+
 		customBudgetDepartmentManager.Init();
+		customBudgetDepartmentManager.LoadDepartmentDefinitions();
+
+		// The DLL plugins are loaded from the root of a Plugins folder, so the DLL folder
+		// is the user Plugins folder or the Plugins folder in the game installation.
+		std::vector<std::filesystem::path> pluginFolders;
+		pluginFolders.push_back(GetDllFolderPath());
+
+		std::filesystem::path gamePluginsFolderPath = GetGamePluginsFolderPath();
+
+		if (gamePluginsFolderPath != pluginFolders[0])
+		{
+			pluginFolders.push_back(std::move(gamePluginsFolderPath));
+		}
+
+		std::filesystem::path indexFilePath = GetDllFolderPath();
+		indexFilePath /= PluginIndexFileName;
+
+		customBudgetDepartmentManager.OpenIndex(
+			indexFilePath,
+			CustomBudgetIndex::ComputePluginFingerprint(pluginFolders));
 
 		return true;
 	}
@@ -98,10 +195,20 @@ private:
 		return true;
 	}
 
+	static bool GetCustomBudgetDepartmentQuery(uint32_t riid, void** ppvObj);
+
 	CustomBudgetDepartmentManager customBudgetDepartmentManager;
+	CustomBudgetDepartmentQuery customBudgetDepartmentQuery;
 };
 
 cRZCOMDllDirector* RZGetCOMDllDirector() {
 	static CustomBudgetDepartmentsDllDirector sDirector;
 	return &sDirector;
+}
+
+bool CustomBudgetDepartmentsDllDirector::GetCustomBudgetDepartmentQuery(uint32_t riid, void** ppvObj)
+{
+	CustomBudgetDepartmentsDllDirector* const pDirector = static_cast<CustomBudgetDepartmentsDllDirector*>(RZGetCOMDllDirector());
+
+	return pDirector->customBudgetDepartmentQuery.QueryInterface(riid, ppvObj);
 }
\ No newline at end of file
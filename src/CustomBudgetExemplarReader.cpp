@@ -0,0 +1,716 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "CustomBudgetExemplarReader.h"
+#include "cIGZVariant.h"
+#include "cISCProperty.h"
+#include "cISCPropertyHolder.h"
+#include "cRZBaseString.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+static constexpr uint32_t kBudgetGroupBusinessDeals = 0xA5A72D1;
+static constexpr uint32_t kBudgetGroupCityBeautification = 0x6A357B96;
+static constexpr uint32_t kBudgetGroupGovernmentBuildings = 0xEA597195;
+static constexpr uint32_t kBudgetGroupHealthAndEducation = 0x6A357B7F;
+static constexpr uint32_t kBudgetGroupPublicSafety = 0x4A357B40;
+static constexpr uint32_t kBudgetGroupTransportation = 0xAA369059;
+static constexpr uint32_t kBudgetGroupUtilities = 0x4A357EAF;
+
+static constexpr uint32_t kBudgetItemDepartmentProperty = 0xEA54D283;
+static constexpr uint32_t kBudgetItemLineProperty = 0xEA54D284;
+static constexpr uint32_t kBudgetItemPurpose = 0xEA54D285;
+static constexpr uint32_t kBudgetItemCostProperty = 0xEA54D286;
+
+static constexpr uint32_t kCustomBudgetDepartmentBudgetGroupProperty = 0x90222B81;
+static constexpr uint32_t kCustomBudgetDepartmentNameKeyProperty = 0x4252085F;
+static constexpr uint32_t kCustomBudgetLineItemAlgorithm = 0x9EE1240F;
+// See TransactionAlgorithmFactory.cpp for the custom budget line item algorithm
+// tuning property ids, each custom budget line item algorithm that takes tuning
+// parameters has expense and income tuning properties defined for that purpose.
+
+static constexpr uint32_t kCustomBudgetDepartmentExpensePurposeId = 0x87BD3990;
+static constexpr uint32_t kCustomBudgetDepartmentIncomePurposeId = 0x46261226;
+
+namespace
+{
+	void ReportErrorFormatted(ICustomBudgetExemplarErrorReporter& errorReporter, const char* const format, ...)
+	{
+		va_list args;
+		va_start(args, format);
+
+		va_list argsCopy;
+		va_copy(argsCopy, args);
+
+		const int formattedStringLength = std::vsnprintf(nullptr, 0, format, argsCopy);
+
+		va_end(argsCopy);
+
+		if (formattedStringLength > 0)
+		{
+			const size_t formattedStringLengthWithNull = static_cast<size_t>(formattedStringLength) + 1;
+
+			std::unique_ptr<char[]> buffer = std::make_unique_for_overwrite<char[]>(formattedStringLengthWithNull);
+
+			std::vsnprintf(buffer.get(), formattedStringLengthWithNull, format, args);
+
+			errorReporter.ReportError(buffer.get());
+		}
+
+		va_end(args);
+	}
+
+	bool GetPropertyValue(const cISCPropertyHolder* pPropertyHolder, uint32_t id, std::vector<uint32_t>& values)
+	{
+		if (pPropertyHolder)
+		{
+			const cISCProperty* property = pPropertyHolder->GetProperty(id);
+
+			if (property)
+			{
+				const cIGZVariant* pVariant = property->GetPropertyValue();
+
+				if (pVariant)
+				{
+					if (pVariant->GetType() == cIGZVariant::Type::Uint32Array)
+					{
+						const uint32_t count = pVariant->GetCount();
+						values.reserve(count);
+
+						const uint32_t* pData = pVariant->RefUint32();
+
+						for (uint32_t i = 0; i < count; i++)
+						{
+							values.push_back(pData[i]);
+						}
+
+						return true;
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	bool GetPropertyValue(const cISCPropertyHolder* pPropertyHolder, uint32_t id, std::vector<int64_t>& values)
+	{
+		if (pPropertyHolder)
+		{
+			const cISCProperty* property = pPropertyHolder->GetProperty(id);
+
+			if (property)
+			{
+				const cIGZVariant* pVariant = property->GetPropertyValue();
+
+				if (pVariant)
+				{
+					if (pVariant->GetType() == cIGZVariant::Type::Sint64Array)
+					{
+						const uint32_t count = pVariant->GetCount();
+						values.reserve(count);
+
+						const int64_t* pData = pVariant->RefSint64();
+
+						for (uint32_t i = 0; i < count; i++)
+						{
+							values.push_back(pData[i]);
+						}
+
+						return true;
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	bool GetPropertyValue(
+		const cISCPropertyHolder* pPropertyHolder,
+		uint32_t id,
+		std::unordered_map<uint32_t, uint32_t>& values)
+	{
+		if (pPropertyHolder)
+		{
+			const cISCProperty* property = pPropertyHolder->GetProperty(id);
+
+			if (property)
+			{
+				const cIGZVariant* pVariant = property->GetPropertyValue();
+
+				if (pVariant)
+				{
+					if (pVariant->GetType() == cIGZVariant::Type::Uint32Array)
+					{
+						const uint32_t count = pVariant->GetCount();
+
+						// The values are an array of 2 items each.
+						if (count >= 2 && (count % 2) == 0)
+						{
+							const uint32_t* pData = pVariant->RefUint32();
+							values.reserve(count / 2);
+
+							for (uint32_t i = 0; i < count; i += 2)
+							{
+								values.try_emplace(pData[i], pData[i + 1]);
+							}
+
+							return true;
+						}
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	bool GetBudgetDepartmentNameProperty(
+		const cISCPropertyHolder* pPropertyHolder,
+		uint32_t id,
+		std::unordered_map<uint32_t, StringResourceKey>& values)
+	{
+		if (pPropertyHolder)
+		{
+			const cISCProperty* property = pPropertyHolder->GetProperty(id);
+
+			if (property)
+			{
+				const cIGZVariant* pVariant = property->GetPropertyValue();
+
+				if (pVariant)
+				{
+					if (pVariant->GetType() == cIGZVariant::Type::Uint32Array)
+					{
+						const uint32_t count = pVariant->GetCount();
+
+						// The values are an array of 3 items each.
+						// The format is: <department id> <department name key group id> <department name key instance id>
+						if (count >= 3 && (count % 3) == 0)
+						{
+							const uint32_t* pData = pVariant->RefUint32();
+							values.reserve(count / 3);
+
+							for (uint32_t i = 0; i < count; i += 3)
+							{
+								values.try_emplace(pData[i], StringResourceKey(pData[i + 1], pData[i + 2]));
+							}
+
+							return true;
+						}
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	bool ContainsCustomBudgetDepartmentPurposeId(const std::vector<uint32_t>& purposeIds)
+	{
+		for (const uint32_t& item : purposeIds)
+		{
+			if (item == kCustomBudgetDepartmentExpensePurposeId
+				|| item == kCustomBudgetDepartmentIncomePurposeId)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool GetExemplarName(const cISCPropertyHolder* pPropertyHolder, cRZBaseString& value)
+	{
+		bool result = false;
+
+		if (pPropertyHolder)
+		{
+			constexpr uint32_t kExemplarNameProperty = 0x20;
+
+			const cISCProperty* pExemplarNameProperty = pPropertyHolder->GetProperty(kExemplarNameProperty);
+
+			if (pExemplarNameProperty)
+			{
+				const cIGZVariant* pVariant = pExemplarNameProperty->GetPropertyValue();
+
+				if (pVariant)
+				{
+					if (pVariant->GetValString(value))
+					{
+						result = value.Strlen() > 0;
+					}
+				}
+			}
+		}
+
+		return result;
+	}
+
+	void ReportBudgetPropertyNotFound(
+		const cISCPropertyHolder* pPropertyHolder,
+		ICustomBudgetExemplarErrorReporter& errorReporter,
+		const char* propertyName)
+	{
+		cRZBaseString exemplarName;
+
+		if (GetExemplarName(pPropertyHolder, exemplarName))
+		{
+			ReportErrorFormatted(
+				errorReporter,
+				"Failed to get the %s property for exemplar name: %s",
+				propertyName,
+				exemplarName.ToChar());
+		}
+		else
+		{
+			ReportErrorFormatted(
+				errorReporter,
+				"Failed to get the %s property.",
+				propertyName);
+		}
+	}
+
+	void ReportBudgetPropertyWrongCount(
+		const cISCPropertyHolder* pPropertyHolder,
+		ICustomBudgetExemplarErrorReporter& errorReporter,
+		const char* propertyName,
+		size_t requiredCount)
+	{
+		cRZBaseString exemplarName;
+
+		if (GetExemplarName(pPropertyHolder, exemplarName))
+		{
+			ReportErrorFormatted(
+				errorReporter,
+				"The %s property must have %u items for exemplar name: %s",
+				propertyName,
+				requiredCount,
+				exemplarName.ToChar());
+		}
+		else
+		{
+			ReportErrorFormatted(
+				errorReporter,
+				"The %s property must have %u items.",
+				propertyName,
+				requiredCount);
+		}
+	}
+
+	struct BudgetPropertyInfo
+	{
+		std::vector<uint32_t> departmentIds;
+		std::vector<uint32_t> lines;
+		std::vector<int64_t> costs;
+		std::unordered_map<uint32_t, uint32_t> budgetGroups;
+		std::unordered_map<uint32_t, StringResourceKey> departmentNameKeys;
+	};
+
+	bool HasProperty(const cISCPropertyHolder* pPropertyHolder, uint32_t id)
+	{
+		return pPropertyHolder && pPropertyHolder->GetProperty(id) != nullptr;
+	}
+
+	bool GetCustomDepartmentProperties(
+		const cISCPropertyHolder* pPropertyHolder,
+		bool hasDefinitions,
+		BudgetPropertyInfo& info,
+		ICustomBudgetExemplarErrorReporter& errorReporter)
+	{
+		// The properties are optional when the departments can be defined in the shared
+		// department definitions, but they must be valid if they are present.
+
+		if (!GetPropertyValue(pPropertyHolder, kCustomBudgetDepartmentBudgetGroupProperty, info.budgetGroups)
+			&& (!hasDefinitions || HasProperty(pPropertyHolder, kCustomBudgetDepartmentBudgetGroupProperty)))
+		{
+			ReportBudgetPropertyNotFound(pPropertyHolder, errorReporter, "Budget: Custom Department Budget Group");
+			return false;
+		}
+
+		if (!GetBudgetDepartmentNameProperty(pPropertyHolder, kCustomBudgetDepartmentNameKeyProperty, info.departmentNameKeys)
+			&& (!hasDefinitions || HasProperty(pPropertyHolder, kCustomBudgetDepartmentNameKeyProperty)))
+		{
+			ReportBudgetPropertyNotFound(pPropertyHolder, errorReporter, "Budget: Custom Department Name Key");
+			return false;
+		}
+
+		const size_t customBudgetDepartmentCount = info.budgetGroups.size();
+
+		if (!info.departmentNameKeys.empty() && info.departmentNameKeys.size() != customBudgetDepartmentCount)
+		{
+			ReportBudgetPropertyWrongCount(
+				pPropertyHolder,
+				errorReporter,
+				"Budget: Custom Department Name Key",
+				customBudgetDepartmentCount);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool GetBudgetPropertyInfo(
+		const cISCPropertyHolder* pPropertyHolder,
+		const std::vector<uint32_t>& purposeIds,
+		bool hasDefinitions,
+		BudgetPropertyInfo& info,
+		ICustomBudgetExemplarErrorReporter& errorReporter)
+	{
+		if (!GetPropertyValue(pPropertyHolder, kBudgetItemDepartmentProperty, info.departmentIds))
+		{
+			ReportBudgetPropertyNotFound(pPropertyHolder, errorReporter, "Budget Item: Department.");
+			return false;
+		}
+
+		if (!GetPropertyValue(pPropertyHolder, kBudgetItemLineProperty, info.lines))
+		{
+			ReportBudgetPropertyNotFound(pPropertyHolder, errorReporter, "Budget Item: Line");
+			return false;
+		}
+
+		if (!GetPropertyValue(pPropertyHolder, kBudgetItemCostProperty, info.costs))
+		{
+			ReportBudgetPropertyNotFound(pPropertyHolder, errorReporter, "Budget Item: Cost");
+			return false;
+		}
+
+		if (!GetCustomDepartmentProperties(pPropertyHolder, hasDefinitions, info, errorReporter))
+		{
+			return false;
+		}
+
+		const size_t budgetDepartmentCount = info.departmentIds.size();
+
+		if (purposeIds.size() != budgetDepartmentCount)
+		{
+			ReportBudgetPropertyWrongCount(
+				pPropertyHolder,
+				errorReporter,
+				"Budget Item: Purpose",
+				budgetDepartmentCount);
+			return false;
+		}
+
+		if (info.lines.size() != budgetDepartmentCount)
+		{
+			ReportBudgetPropertyWrongCount(
+				pPropertyHolder,
+				errorReporter,
+				"Budget Item: Line",
+				budgetDepartmentCount);
+			return false;
+		}
+
+		if (info.costs.size() != budgetDepartmentCount)
+		{
+			ReportBudgetPropertyWrongCount(
+				pPropertyHolder,
+				errorReporter,
+				"Budget Item: Cost",
+				budgetDepartmentCount);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool FindBudgetGroup(
+		const BudgetPropertyInfo& info,
+		const DepartmentDefinition* pDefinition,
+		uint32_t departmentId,
+		uint32_t& budgetGroup)
+	{
+		const auto& item = info.budgetGroups.find(departmentId);
+
+		if (item != info.budgetGroups.end())
+		{
+			budgetGroup = item->second;
+			return true;
+		}
+		else if (pDefinition)
+		{
+			budgetGroup = pDefinition->budgetGroup;
+			return true;
+		}
+
+		return false;
+	}
+
+	bool FindDepartmentNameKey(
+		const BudgetPropertyInfo& info,
+		const DepartmentDefinition* pDefinition,
+		uint32_t departmentId,
+		StringResourceKey& nameKey)
+	{
+		const auto& item = info.departmentNameKeys.find(departmentId);
+
+		if (item != info.departmentNameKeys.end())
+		{
+			nameKey = item->second;
+			return true;
+		}
+		else if (pDefinition)
+		{
+			nameKey = pDefinition->nameKey;
+			return true;
+		}
+
+		return false;
+	}
+
+	void ReportRequiredDepartmentItemNotFound(
+		const cISCPropertyHolder* pPropertyHolder,
+		ICustomBudgetExemplarErrorReporter& errorReporter,
+		const char* itemName,
+		uint32_t departmentID)
+	{
+		cRZBaseString exemplarName;
+
+		if (GetExemplarName(pPropertyHolder, exemplarName))
+		{
+			ReportErrorFormatted(
+				errorReporter,
+				"Could not find the %s value for department id 0x%08X. Item exemplar name: %s",
+				itemName,
+				departmentID,
+				exemplarName.ToChar());
+		}
+		else
+		{
+			ReportErrorFormatted(
+				errorReporter,
+				"Could not find the %s value for department id 0x%08X.",
+				itemName,
+				departmentID);
+		}
+	}
+
+	void ReportInvalidDefinitionBudgetGroup(
+		const cISCPropertyHolder* pPropertyHolder,
+		ICustomBudgetExemplarErrorReporter& errorReporter,
+		uint32_t budgetGroup,
+		uint32_t departmentID)
+	{
+		cRZBaseString exemplarName;
+
+		if (GetExemplarName(pPropertyHolder, exemplarName))
+		{
+			ReportErrorFormatted(
+				errorReporter,
+				"Invalid budget group 0x%08X for department id 0x%08X. Definition exemplar name: %s",
+				budgetGroup,
+				departmentID,
+				exemplarName.ToChar());
+		}
+		else
+		{
+			ReportErrorFormatted(
+				errorReporter,
+				"Invalid budget group 0x%08X for department id 0x%08X.",
+				budgetGroup,
+				departmentID);
+		}
+	}
+}
+
+bool CustomBudgetExemplarReader::HasCustomBudgetDepartmentItems(const cISCPropertyHolder* pPropertyHolder)
+{
+	std::vector<uint32_t> purposeIds;
+
+	return GetPropertyValue(pPropertyHolder, kBudgetItemPurpose, purposeIds)
+		&& ContainsCustomBudgetDepartmentPurposeId(purposeIds);
+}
+
+std::vector<CustomBudgetDepartmentInfo> CustomBudgetExemplarReader::ReadLineItems(
+	const cISCPropertyHolder* pPropertyHolder,
+	const DepartmentDefinitionTable* pDefinitions,
+	ICustomBudgetExemplarErrorReporter& errorReporter)
+{
+	std::vector<CustomBudgetDepartmentInfo> items;
+
+	std::vector<uint32_t> purposeIds;
+
+	if (GetPropertyValue(pPropertyHolder, kBudgetItemPurpose, purposeIds))
+	{
+		if (ContainsCustomBudgetDepartmentPurposeId(purposeIds))
+		{
+			BudgetPropertyInfo info;
+			const bool hasDefinitions = pDefinitions && !pDefinitions->IsEmpty();
+
+			if (GetBudgetPropertyInfo(pPropertyHolder, purposeIds, hasDefinitions, info, errorReporter))
+			{
+				const size_t budgetDepartmentCount = info.departmentIds.size();
+
+				for (size_t i = 0; i < budgetDepartmentCount; i++)
+				{
+					CustomBudgetDepartmentItemType type = CustomBudgetDepartmentItemType::Invalid;
+
+					switch (purposeIds[i])
+					{
+					case kCustomBudgetDepartmentExpensePurposeId:
+						type = CustomBudgetDepartmentItemType::Expense;
+						break;
+					case kCustomBudgetDepartmentIncomePurposeId:
+						type = CustomBudgetDepartmentItemType::Income;
+						break;
+					}
+
+					if (type != CustomBudgetDepartmentItemType::Invalid)
+					{
+						const uint32_t departmentId = info.departmentIds[i];
+						const DepartmentDefinition* const pDefinition = hasDefinitions ? pDefinitions->Find(departmentId) : nullptr;
+
+						uint32_t budgetGroup = 0;
+						StringResourceKey departmentNameKey;
+
+						if (FindBudgetGroup(info, pDefinition, departmentId, budgetGroup))
+						{
+							if (FindDepartmentNameKey(info, pDefinition, departmentId, departmentNameKey))
+							{
+								items.push_back(CustomBudgetDepartmentInfo(
+									type,
+									departmentId,
+									info.lines[i],
+									budgetGroup,
+									info.costs[i],
+									departmentNameKey));
+							}
+							else
+							{
+								ReportRequiredDepartmentItemNotFound(
+									pPropertyHolder,
+									errorReporter,
+									"name key",
+									departmentId);
+							}
+						}
+						else
+						{
+							ReportRequiredDepartmentItemNotFound(
+								pPropertyHolder,
+								errorReporter,
+								"budget group id",
+								departmentId);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return items;
+}
+
+std::vector<DepartmentDefinition> CustomBudgetExemplarReader::ReadDepartmentDefinitions(
+	const cISCPropertyHolder* pPropertyHolder,
+	ICustomBudgetExemplarErrorReporter& errorReporter)
+{
+	std::vector<DepartmentDefinition> definitions;
+
+	BudgetPropertyInfo info;
+
+	if (GetCustomDepartmentProperties(pPropertyHolder, false, info, errorReporter))
+	{
+		definitions.reserve(info.budgetGroups.size());
+
+		for (const auto& [departmentId, budgetGroup] : info.budgetGroups)
+		{
+			StringResourceKey departmentNameKey;
+
+			if (!FindDepartmentNameKey(info, nullptr, departmentId, departmentNameKey))
+			{
+				ReportRequiredDepartmentItemNotFound(pPropertyHolder, errorReporter, "name key", departmentId);
+			}
+			else if (!IsValidBudgetGroup(budgetGroup))
+			{
+				ReportInvalidDefinitionBudgetGroup(pPropertyHolder, errorReporter, budgetGroup, departmentId);
+			}
+			else
+			{
+				definitions.push_back(DepartmentDefinition{ departmentId, budgetGroup, departmentNameKey });
+			}
+		}
+
+		std::sort(
+			definitions.begin(),
+			definitions.end(),
+			[](const DepartmentDefinition& left, const DepartmentDefinition& right)
+			{
+				return left.department < right.department;
+			});
+	}
+
+	return definitions;
+}
+
+bool CustomBudgetExemplarReader::GetDepartmentDefinition(
+	const cISCPropertyHolder* pPropertyHolder,
+	uint32_t department,
+	const DepartmentDefinitionTable* pDefinitions,
+	DepartmentDefinition& definition)
+{
+	BudgetPropertyInfo info;
+	GetPropertyValue(pPropertyHolder, kCustomBudgetDepartmentBudgetGroupProperty, info.budgetGroups);
+	GetBudgetDepartmentNameProperty(pPropertyHolder, kCustomBudgetDepartmentNameKeyProperty, info.departmentNameKeys);
+
+	const DepartmentDefinition* const pDefinition = pDefinitions ? pDefinitions->Find(department) : nullptr;
+
+	definition.department = department;
+
+	return FindBudgetGroup(info, pDefinition, department, definition.budgetGroup)
+		&& FindDepartmentNameKey(info, pDefinition, department, definition.nameKey);
+}
+
+TransactionAlgorithmType CustomBudgetExemplarReader::GetLineItemAlgorithmType(
+	const cISCPropertyHolder* pPropertyHolder,
+	uint32_t lineNumber)
+{
+	TransactionAlgorithmType type = TransactionAlgorithmType::Fixed;
+
+	std::unordered_map<uint32_t, uint32_t> lineItemTransactionAlgorithms;
+
+	if (GetPropertyValue(pPropertyHolder, kCustomBudgetLineItemAlgorithm, lineItemTransactionAlgorithms))
+	{
+		const auto& item = lineItemTransactionAlgorithms.find(lineNumber);
+
+		if (item != lineItemTransactionAlgorithms.end())
+		{
+			type = static_cast<TransactionAlgorithmType>(item->second);
+		}
+	}
+
+	return type;
+}
+
+bool CustomBudgetExemplarReader::IsValidBudgetGroup(uint32_t budgetGroup)
+{
+	switch (budgetGroup)
+	{
+	case kBudgetGroupBusinessDeals:
+	case kBudgetGroupCityBeautification:
+	case kBudgetGroupGovernmentBuildings:
+	case kBudgetGroupHealthAndEducation:
+	case kBudgetGroupPublicSafety:
+	case kBudgetGroupTransportation:
+	case kBudgetGroupUtilities:
+		return true;
+	default:
+		return false;
+	}
+}
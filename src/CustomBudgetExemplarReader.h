@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "DepartmentDefinitionTable.h"
+#include "StringResourceKey.h"
+#include "TransactionAlgorithmType.h"
+#include <cstdint>
+#include <vector>
+
+class cISCPropertyHolder;
+
+/**
+ * @brief Receives the errors that are found while reading the custom budget properties of an exemplar.
+ *
+ * The plugin writes the errors to its log file, the exemplar linter reports them with the file and TGI.
+ */
+class ICustomBudgetExemplarErrorReporter
+{
+public:
+	virtual void ReportError(const char* message) = 0;
+};
+
+enum class CustomBudgetDepartmentItemType : uint32_t
+{
+	Invalid,
+	Expense,
+	Income
+};
+
+struct CustomBudgetDepartmentInfo
+{
+	CustomBudgetDepartmentItemType type;
+	uint32_t department;
+	uint32_t lineNumber;
+	uint32_t budgetGroup;
+	int64_t cost;
+	StringResourceKey departmentNameKey;
+
+	CustomBudgetDepartmentInfo()
+		: type(CustomBudgetDepartmentItemType::Expense),
+		  department(0),
+		  lineNumber(0),
+		  budgetGroup(0),
+		  cost(0),
+		  departmentNameKey()
+	{
+	}
+
+	CustomBudgetDepartmentInfo(
+		CustomBudgetDepartmentItemType type,
+		uint32_t department,
+		uint32_t line,
+		uint32_t budgetGroup,
+		int64_t cost,
+		StringResourceKey departmentNameKey)
+		: type(type),
+		  department(department),
+		  lineNumber(line),
+		  budgetGroup(budgetGroup),
+		  cost(cost),
+		  departmentNameKey(departmentNameKey)
+	{
+	}
+};
+
+/**
+ * @brief Reads and validates the custom budget department properties of a building exemplar.
+ *
+ * The functions do not use any global state, so they can be called from multiple threads.
+ */
+namespace CustomBudgetExemplarReader
+{
+	// The group id of the shared department definition exemplars.
+	static constexpr uint32_t DepartmentDefinitionExemplarGroup = 0xFE005708;
+
+	/**
+	 * @brief Checks if the exemplar's Budget Item: Purpose property has a custom budget department purpose.
+	 */
+	bool HasCustomBudgetDepartmentItems(const cISCPropertyHolder* pPropertyHolder);
+
+	/**
+	 * @brief Reads the custom budget department line items of an exemplar.
+	 * @param pPropertyHolder The exemplar.
+	 * @param pDefinitions The shared department definitions, used for the departments that the exemplar
+	 * does not define itself. Can be null.
+	 * @param errorReporter Receives the errors for the properties that are missing or have the wrong item count.
+	 * @return The line items, or an empty list if the exemplar does not have any valid custom budget department line items.
+	 */
+	std::vector<CustomBudgetDepartmentInfo> ReadLineItems(
+		const cISCPropertyHolder* pPropertyHolder,
+		const DepartmentDefinitionTable* pDefinitions,
+		ICustomBudgetExemplarErrorReporter& errorReporter);
+
+	/**
+	 * @brief Reads the departments of a shared department definition exemplar.
+	 *
+	 * The exemplar uses the Budget: Custom Department Budget Group and Name Key properties
+	 * of a building exemplar, without any Budget Item properties.
+	 * @param pPropertyHolder The definition exemplar.
+	 * @param errorReporter Receives the errors for the properties that are missing or not valid.
+	 * @return The valid departments, sorted by department id.
+	 */
+	std::vector<DepartmentDefinition> ReadDepartmentDefinitions(
+		const cISCPropertyHolder* pPropertyHolder,
+		ICustomBudgetExemplarErrorReporter& errorReporter);
+
+	/**
+	 * @brief Gets the budget group and name key of a department, in the same way as ReadLineItems.
+	 * @return True if the exemplar or the shared definitions define the department; otherwise, false.
+	 */
+	bool GetDepartmentDefinition(
+		const cISCPropertyHolder* pPropertyHolder,
+		uint32_t department,
+		const DepartmentDefinitionTable* pDefinitions,
+		DepartmentDefinition& definition);
+
+	/**
+	 * @brief Gets the transaction algorithm type of a line item.
+	 *
+	 * The line items that are not in the Custom Budget Line Item Algorithm property use the Fixed algorithm.
+	 * The value is not checked, TransactionAlgorithmFactory rejects the unknown algorithm types.
+	 */
+	TransactionAlgorithmType GetLineItemAlgorithmType(const cISCPropertyHolder* pPropertyHolder, uint32_t lineNumber);
+
+	bool IsValidBudgetGroup(uint32_t budgetGroup);
+}
@@ -0,0 +1,509 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "CustomBudgetIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+namespace
+{
+	// The index is stored in the native byte order, which is little-endian
+	// on the platforms that the game runs on.
+	// The record sizes are multiples of 8, so the records in the mapped file are aligned.
+
+	constexpr uint32_t IndexSignature = 0x49444243; // CBDI
+
+	// An index that is larger than this is treated as corrupt.
+	constexpr uint64_t MaxIndexSize = 256 * 1024 * 1024;
+
+	struct IndexHeader
+	{
+		uint32_t signature;
+		uint32_t version;
+		uint64_t pluginFingerprint;
+		uint32_t buildingTypeCount;
+		uint32_t lineItemCount;
+		uint32_t transactionDataSize;
+		uint32_t reserved;
+	};
+
+	struct BuildingTypeRecord
+	{
+		uint32_t buildingType;
+		uint32_t firstLineItem;
+		uint32_t lineItemCount;
+		uint32_t reserved;
+	};
+
+	struct LineItemRecord
+	{
+		uint32_t itemType;
+		uint32_t department;
+		uint32_t lineNumber;
+		uint32_t budgetGroup;
+		uint32_t departmentNameGroupID;
+		uint32_t departmentNameInstanceID;
+		int64_t cost;
+		uint32_t transactionOffset;
+		uint32_t transactionSize;
+		// The checksum of the record fields above and the transaction data,
+		// a line item that does not match falls back to parsing the exemplar.
+		uint32_t checksum;
+		uint32_t reserved;
+	};
+
+	static_assert(sizeof(IndexHeader) == 32);
+	static_assert(sizeof(BuildingTypeRecord) == 16);
+	static_assert(sizeof(LineItemRecord) == 48);
+
+	constexpr uint64_t FnvOffsetBasis = 0xcbf29ce484222325;
+	constexpr uint64_t FnvPrime = 0x100000001b3;
+
+	uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+	{
+		const uint8_t* const bytes = static_cast<const uint8_t*>(data);
+
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= FnvPrime;
+		}
+
+		return hash;
+	}
+
+	uint32_t ComputeLineItemChecksum(const LineItemRecord& record, const uint8_t* pTransactionData)
+	{
+		uint64_t hash = FnvOffsetBasis;
+		hash = HashBytes(hash, &record, offsetof(LineItemRecord, checksum));
+		hash = HashBytes(hash, pTransactionData, record.transactionSize);
+
+		return static_cast<uint32_t>(hash ^ (hash >> 32));
+	}
+
+	bool IsPluginFile(const std::filesystem::path& path)
+	{
+		// The DBPF file extensions that the game loads, and the DLL plugins.
+		static constexpr std::string_view PluginExtensions[] =
+		{
+			".dat",
+			".dll",
+			".sc4desc",
+			".sc4lot",
+			".sc4model",
+		};
+
+		std::string extension = path.extension().string();
+		std::transform(
+			extension.begin(),
+			extension.end(),
+			extension.begin(),
+			[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+		return std::find(std::begin(PluginExtensions), std::end(PluginExtensions), extension) != std::end(PluginExtensions);
+	}
+
+	struct PluginFile
+	{
+		std::string relativePath;
+		uint64_t size;
+		int64_t lastWriteTime;
+	};
+
+	void AddPluginFiles(const std::filesystem::path& folder, std::vector<PluginFile>& files)
+	{
+		std::error_code errorCode;
+
+		const auto options = std::filesystem::directory_options::follow_directory_symlink
+			| std::filesystem::directory_options::skip_permission_denied;
+
+		std::filesystem::recursive_directory_iterator iterator(folder, options, errorCode);
+
+		for (; !errorCode && iterator != std::filesystem::recursive_directory_iterator(); iterator.increment(errorCode))
+		{
+			const std::filesystem::directory_entry& entry = *iterator;
+
+			if (entry.is_regular_file(errorCode) && IsPluginFile(entry.path()))
+			{
+				PluginFile file{};
+				file.relativePath = entry.path().lexically_relative(folder).generic_string();
+				file.size = entry.file_size(errorCode);
+				file.lastWriteTime = static_cast<int64_t>(entry.last_write_time(errorCode).time_since_epoch().count());
+
+				files.push_back(std::move(file));
+			}
+		}
+	}
+
+	template<typename T> void WriteRecord(std::ofstream& stream, const T& record)
+	{
+		stream.write(reinterpret_cast<const char*>(&record), sizeof(record));
+	}
+}
+
+CustomBudgetIndex::CustomBudgetIndex()
+	: file(),
+	  buildingTypeCount(0),
+	  lineItemCount(0),
+	  pBuildingTypes(nullptr),
+	  pLineItems(nullptr),
+	  pTransactionData(nullptr),
+	  transactionDataSize(0)
+{
+}
+
+CustomBudgetIndex::~CustomBudgetIndex()
+{
+	Close();
+}
+
+bool CustomBudgetIndex::Open(const std::filesystem::path& path, uint64_t pluginFingerprint)
+{
+	Close();
+
+	if (file.Open(path, sizeof(IndexHeader), MaxIndexSize))
+	{
+		const uint8_t* const pData = file.GetData();
+		const IndexHeader* const pHeader = reinterpret_cast<const IndexHeader*>(pData);
+
+		// Only the header and the record array sizes are checked here, the records
+		// are checked when Find reads them.
+		const uint64_t expectedSize = sizeof(IndexHeader)
+			+ (static_cast<uint64_t>(pHeader->buildingTypeCount) * sizeof(BuildingTypeRecord))
+			+ (static_cast<uint64_t>(pHeader->lineItemCount) * sizeof(LineItemRecord))
+			+ pHeader->transactionDataSize;
+
+		if (pHeader->signature == IndexSignature
+			&& pHeader->version == CurrentVersion
+			&& pHeader->pluginFingerprint == pluginFingerprint
+			&& expectedSize == file.GetSize())
+		{
+			buildingTypeCount = pHeader->buildingTypeCount;
+			lineItemCount = pHeader->lineItemCount;
+			pBuildingTypes = pData + sizeof(IndexHeader);
+			pLineItems = pBuildingTypes + (buildingTypeCount * sizeof(BuildingTypeRecord));
+			pTransactionData = pLineItems + (lineItemCount * sizeof(LineItemRecord));
+			transactionDataSize = pHeader->transactionDataSize;
+		}
+		else
+		{
+			Close();
+		}
+	}
+
+	return IsOpen();
+}
+
+void CustomBudgetIndex::Close()
+{
+	file.Close();
+	buildingTypeCount = 0;
+	lineItemCount = 0;
+	pBuildingTypes = nullptr;
+	pLineItems = nullptr;
+	pTransactionData = nullptr;
+	transactionDataSize = 0;
+}
+
+bool CustomBudgetIndex::IsOpen() const
+{
+	return file.IsOpen();
+}
+
+size_t CustomBudgetIndex::GetBuildingTypeCount() const
+{
+	return buildingTypeCount;
+}
+
+uint32_t CustomBudgetIndex::GetBuildingType(size_t index) const
+{
+	uint32_t result = 0;
+
+	if (index < buildingTypeCount)
+	{
+		result = reinterpret_cast<const BuildingTypeRecord*>(pBuildingTypes)[index].buildingType;
+	}
+
+	return result;
+}
+
+bool CustomBudgetIndex::Find(
+	uint32_t buildingType,
+	std::vector<CustomBudgetDepartmentInfo>& items,
+	std::vector<std::span<const uint8_t>>& transactions) const
+{
+	bool result = false;
+
+	items.clear();
+	transactions.clear();
+
+	if (file.IsOpen())
+	{
+		const BuildingTypeRecord* const first = reinterpret_cast<const BuildingTypeRecord*>(pBuildingTypes);
+		const BuildingTypeRecord* const last = first + buildingTypeCount;
+
+		const BuildingTypeRecord* const record = std::lower_bound(
+			first,
+			last,
+			buildingType,
+			[](const BuildingTypeRecord& item, uint32_t value) { return item.buildingType < value; });
+
+		if (record != last
+			&& record->buildingType == buildingType
+			&& record->firstLineItem <= lineItemCount
+			&& record->lineItemCount <= lineItemCount - record->firstLineItem)
+		{
+			const LineItemRecord* const lineItems = reinterpret_cast<const LineItemRecord*>(pLineItems) + record->firstLineItem;
+
+			result = true;
+			items.reserve(record->lineItemCount);
+			transactions.reserve(record->lineItemCount);
+
+			for (uint32_t i = 0; i < record->lineItemCount; i++)
+			{
+				const LineItemRecord& lineItem = lineItems[i];
+
+				const CustomBudgetDepartmentItemType itemType = static_cast<CustomBudgetDepartmentItemType>(lineItem.itemType);
+
+				if ((itemType != CustomBudgetDepartmentItemType::Expense && itemType != CustomBudgetDepartmentItemType::Income)
+					|| lineItem.transactionOffset > transactionDataSize
+					|| lineItem.transactionSize > transactionDataSize - lineItem.transactionOffset
+					|| lineItem.checksum != ComputeLineItemChecksum(lineItem, pTransactionData + lineItem.transactionOffset))
+				{
+					// The building type falls back to parsing the exemplar.
+					result = false;
+					break;
+				}
+
+				items.emplace_back(
+					itemType,
+					lineItem.department,
+					lineItem.lineNumber,
+					lineItem.budgetGroup,
+					lineItem.cost,
+					StringResourceKey(lineItem.departmentNameGroupID, lineItem.departmentNameInstanceID));
+				transactions.emplace_back(pTransactionData + lineItem.transactionOffset, lineItem.transactionSize);
+			}
+
+			if (!result)
+			{
+				items.clear();
+				transactions.clear();
+			}
+		}
+	}
+
+	return result;
+}
+
+uint64_t CustomBudgetIndex::ComputePluginFingerprint(const std::vector<std::filesystem::path>& pluginFolders)
+{
+	std::vector<PluginFile> files;
+
+	for (const std::filesystem::path& folder : pluginFolders)
+	{
+		AddPluginFiles(folder, files);
+	}
+
+	// The files are sorted so that the fingerprint does not depend on the directory enumeration order.
+	std::sort(
+		files.begin(),
+		files.end(),
+		[](const PluginFile& left, const PluginFile& right)
+		{
+			return std::tie(left.relativePath, left.size, left.lastWriteTime)
+				< std::tie(right.relativePath, right.size, right.lastWriteTime);
+		});
+
+	uint64_t hash = FnvOffsetBasis;
+
+	for (const PluginFile& file : files)
+	{
+		hash = HashBytes(hash, file.relativePath.data(), file.relativePath.size() + 1);
+		hash = HashBytes(hash, &file.size, sizeof(file.size));
+		hash = HashBytes(hash, &file.lastWriteTime, sizeof(file.lastWriteTime));
+	}
+
+	return hash;
+}
+
+CustomBudgetIndexWriter::CustomBudgetIndexWriter()
+	: buildingTypes()
+{
+}
+
+void CustomBudgetIndexWriter::Add(
+	uint32_t buildingType,
+	const std::vector<CustomBudgetDepartmentInfo>& items,
+	std::vector<std::vector<uint8_t>> transactions)
+{
+	BuildingType value;
+	value.items = items;
+	value.transactions = std::move(transactions);
+	value.transactions.resize(value.items.size());
+
+	buildingTypes.try_emplace(buildingType, std::move(value));
+}
+
+void CustomBudgetIndexWriter::AddMissing(const CustomBudgetIndex& index)
+{
+	std::vector<CustomBudgetDepartmentInfo> items;
+	std::vector<std::span<const uint8_t>> transactions;
+
+	for (size_t i = 0; i < index.GetBuildingTypeCount(); i++)
+	{
+		const uint32_t buildingType = index.GetBuildingType(i);
+
+		if (!buildingTypes.contains(buildingType) && index.Find(buildingType, items, transactions))
+		{
+			std::vector<std::vector<uint8_t>> transactionData;
+			transactionData.reserve(transactions.size());
+
+			for (const std::span<const uint8_t>& transaction : transactions)
+			{
+				transactionData.emplace_back(transaction.begin(), transaction.end());
+			}
+
+			Add(buildingType, items, std::move(transactionData));
+		}
+	}
+}
+
+bool CustomBudgetIndexWriter::IsEmpty() const
+{
+	return buildingTypes.empty();
+}
+
+void CustomBudgetIndexWriter::Clear()
+{
+	buildingTypes.clear();
+}
+
+bool CustomBudgetIndexWriter::Write(const std::filesystem::path& path, uint64_t pluginFingerprint) const
+{
+	IndexHeader header{};
+	header.signature = IndexSignature;
+	header.version = CustomBudgetIndex::CurrentVersion;
+	header.pluginFingerprint = pluginFingerprint;
+
+	uint64_t lineItemCount = 0;
+	uint64_t transactionDataSize = 0;
+
+	for (const auto& [buildingType, value] : buildingTypes)
+	{
+		lineItemCount += value.items.size();
+
+		for (const std::vector<uint8_t>& transaction : value.transactions)
+		{
+			// The transaction data is padded so that the file size stays a multiple of 8.
+			transactionDataSize += (transaction.size() + 7) & ~static_cast<uint64_t>(7);
+		}
+	}
+
+	if (transactionDataSize > MaxIndexSize)
+	{
+		return false;
+	}
+
+	header.buildingTypeCount = static_cast<uint32_t>(buildingTypes.size());
+	header.lineItemCount = static_cast<uint32_t>(lineItemCount);
+	header.transactionDataSize = static_cast<uint32_t>(transactionDataSize);
+
+	std::filesystem::path temporaryPath = path;
+	temporaryPath += ".tmp";
+
+	{
+		std::ofstream stream(temporaryPath, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+		if (!stream)
+		{
+			return false;
+		}
+
+		WriteRecord(stream, header);
+
+		uint32_t firstLineItem = 0;
+
+		for (const auto& [buildingType, value] : buildingTypes)
+		{
+			BuildingTypeRecord record{};
+			record.buildingType = buildingType;
+			record.firstLineItem = firstLineItem;
+			record.lineItemCount = static_cast<uint32_t>(value.items.size());
+
+			WriteRecord(stream, record);
+
+			firstLineItem += record.lineItemCount;
+		}
+
+		uint32_t transactionOffset = 0;
+
+		for (const auto& [buildingType, value] : buildingTypes)
+		{
+			for (size_t i = 0; i < value.items.size(); i++)
+			{
+				const CustomBudgetDepartmentInfo& item = value.items[i];
+				const std::vector<uint8_t>& transaction = value.transactions[i];
+
+				LineItemRecord record{};
+				record.itemType = static_cast<uint32_t>(item.type);
+				record.department = item.department;
+				record.lineNumber = item.lineNumber;
+				record.budgetGroup = item.budgetGroup;
+				record.departmentNameGroupID = item.departmentNameKey.groupID;
+				record.departmentNameInstanceID = item.departmentNameKey.instanceID;
+				record.cost = item.cost;
+				record.transactionOffset = transactionOffset;
+				record.transactionSize = static_cast<uint32_t>(transaction.size());
+				record.checksum = ComputeLineItemChecksum(record, transaction.data());
+
+				WriteRecord(stream, record);
+
+				transactionOffset += (record.transactionSize + 7) & ~7U;
+			}
+		}
+
+		static constexpr char Padding[8]{};
+
+		for (const auto& [buildingType, value] : buildingTypes)
+		{
+			for (const std::vector<uint8_t>& transaction : value.transactions)
+			{
+				stream.write(reinterpret_cast<const char*>(transaction.data()), static_cast<std::streamsize>(transaction.size()));
+				stream.write(Padding, static_cast<std::streamsize>(((transaction.size() + 7) & ~static_cast<size_t>(7)) - transaction.size()));
+			}
+		}
+
+		if (!stream)
+		{
+			stream.close();
+
+			std::error_code errorCode;
+			std::filesystem::remove(temporaryPath, errorCode);
+
+			return false;
+		}
+	}
+
+	std::error_code errorCode;
+	std::filesystem::rename(temporaryPath, path, errorCode);
+
+	return !errorCode;
+}
@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "CustomBudgetExemplarReader.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <span>
+#include <vector>
+
+/**
+ * @brief A memory-mapped index of the custom budget department line items of each building type.
+ *
+ * The index holds the validated line items of the building types whose exemplars were read
+ * in a previous game session, including the building types that do not have any custom budget
+ * department line items, and the serialized LineItemTransaction of each line item.
+ * The records are used directly from the mapped file, Find does not parse any exemplar properties.
+ *
+ * The index is only used when its version and plugin fingerprint match, the building types that
+ * are not in the index fall back to parsing the exemplar.
+ */
+class CustomBudgetIndex
+{
+public:
+	static constexpr uint32_t CurrentVersion = 1;
+
+	CustomBudgetIndex();
+	~CustomBudgetIndex();
+
+	CustomBudgetIndex(const CustomBudgetIndex&) = delete;
+	CustomBudgetIndex& operator=(const CustomBudgetIndex&) = delete;
+
+	/**
+	 * @brief Maps an index file.
+	 * @param path The index file path.
+	 * @param pluginFingerprint The fingerprint of the current plugin set.
+	 * @return True if the index was mapped; otherwise, false if the file does not exist,
+	 * is not valid or was written for a different plugin version or plugin set.
+	 */
+	bool Open(const std::filesystem::path& path, uint64_t pluginFingerprint);
+	void Close();
+	bool IsOpen() const;
+
+	size_t GetBuildingTypeCount() const;
+	uint32_t GetBuildingType(size_t index) const;
+
+	/**
+	 * @brief Gets the line items of a building type.
+	 * @param buildingType The building type.
+	 * @param items Receives the line items.
+	 * @param transactions Receives the serialized transaction of each line item, in the same order as the items.
+	 * The span is empty if the transaction could not be created when the index was written.
+	 * @return True if the building type is in the index; otherwise, false.
+	 */
+	bool Find(
+		uint32_t buildingType,
+		std::vector<CustomBudgetDepartmentInfo>& items,
+		std::vector<std::span<const uint8_t>>& transactions) const;
+
+	/**
+	 * @brief Computes the fingerprint of the DBPF and DLL files in the plugin folders.
+	 *
+	 * The fingerprint combines the relative path, size and last write time of each file,
+	 * any added, removed or modified plugin invalidates the index.
+	 * @param pluginFolders The plugin folders, the folders are searched recursively.
+	 */
+	static uint64_t ComputePluginFingerprint(const std::vector<std::filesystem::path>& pluginFolders);
+
+private:
+	MappedFile file;
+	size_t buildingTypeCount;
+	size_t lineItemCount;
+	const uint8_t* pBuildingTypes;
+	const uint8_t* pLineItems;
+	const uint8_t* pTransactionData;
+	size_t transactionDataSize;
+};
+
+/**
+ * @brief Collects the line items of the building types and writes a CustomBudgetIndex file.
+ */
+class CustomBudgetIndexWriter
+{
+public:
+	CustomBudgetIndexWriter();
+
+	/**
+	 * @brief Adds a building type, the building types that are already in the writer are not replaced.
+	 * @param buildingType The building type.
+	 * @param items The line items.
+	 * @param transactions The serialized transaction of each line item, in the same order as the items.
+	 */
+	void Add(
+		uint32_t buildingType,
+		const std::vector<CustomBudgetDepartmentInfo>& items,
+		std::vector<std::vector<uint8_t>> transactions);
+
+	/**
+	 * @brief Adds the building types of an index that are not already in the writer.
+	 */
+	void AddMissing(const CustomBudgetIndex& index);
+
+	bool IsEmpty() const;
+	void Clear();
+
+	/**
+	 * @brief Writes the index file.
+	 *
+	 * The file is written to a temporary file that replaces the index, the index must not be mapped.
+	 * @param path The index file path.
+	 * @param pluginFingerprint The fingerprint of the current plugin set.
+	 * @return True on success; otherwise, false.
+	 */
+	bool Write(const std::filesystem::path& path, uint64_t pluginFingerprint) const;
+
+private:
+	struct BuildingType
+	{
+		std::vector<CustomBudgetDepartmentInfo> items;
+		std::vector<std::vector<uint8_t>> transactions;
+	};
+
+	std::map<uint32_t, BuildingType> buildingTypes;
+};
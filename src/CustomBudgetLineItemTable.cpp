@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "CustomBudgetLineItemTable.h"
+#include <algorithm>
+
+CustomBudgetLineItemTable::CustomBudgetLineItemTable()
+	: lineItems(),
+	  indexes()
+{
+}
+
+void CustomBudgetLineItemTable::Set(const CustomBudgetLineItemState& state)
+{
+	const auto pair = indexes.try_emplace(CreateKey(state.department, state.lineNumber), lineItems.size());
+
+	if (pair.second)
+	{
+		lineItems.push_back(state);
+	}
+	else
+	{
+		lineItems[pair.first->second] = state;
+	}
+}
+
+void CustomBudgetLineItemTable::Remove(uint32_t department, uint32_t lineNumber)
+{
+	const auto item = indexes.find(CreateKey(department, lineNumber));
+
+	if (item != indexes.end())
+	{
+		const size_t index = item->second;
+		const size_t lastIndex = lineItems.size() - 1;
+
+		indexes.erase(item);
+
+		if (index != lastIndex)
+		{
+			const CustomBudgetLineItemState& last = lineItems[lastIndex];
+
+			lineItems[index] = last;
+			indexes[CreateKey(last.department, last.lineNumber)] = index;
+		}
+
+		lineItems.pop_back();
+	}
+}
+
+const CustomBudgetLineItemState* CustomBudgetLineItemTable::Find(uint32_t department, uint32_t lineNumber) const
+{
+	const CustomBudgetLineItemState* result = nullptr;
+
+	const auto item = indexes.find(CreateKey(department, lineNumber));
+
+	if (item != indexes.end())
+	{
+		result = &lineItems[item->second];
+	}
+
+	return result;
+}
+
+size_t CustomBudgetLineItemTable::GetCount() const
+{
+	return lineItems.size();
+}
+
+const std::vector<CustomBudgetLineItemState>& CustomBudgetLineItemTable::GetLineItems() const
+{
+	return lineItems;
+}
+
+size_t CustomBudgetLineItemTable::Copy(CustomBudgetLineItemState* pBuffer, size_t capacity) const
+{
+	size_t count = 0;
+
+	if (pBuffer)
+	{
+		count = std::min(capacity, lineItems.size());
+
+		std::copy_n(lineItems.data(), count, pBuffer);
+	}
+
+	return count;
+}
+
+void CustomBudgetLineItemTable::Clear()
+{
+	lineItems.clear();
+	indexes.clear();
+}
+
+uint64_t CustomBudgetLineItemTable::CreateKey(uint32_t department, uint32_t lineNumber)
+{
+	return (static_cast<uint64_t>(department) << 32) | static_cast<uint64_t>(lineNumber);
+}
@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cICustomBudgetDepartmentQuery.h"
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief The state of the custom budget department line items.
+ *
+ * The line items are stored in a flat array so that all of them can be copied at once,
+ * removing a line item moves the last line item into its slot.
+ */
+class CustomBudgetLineItemTable
+{
+public:
+	CustomBudgetLineItemTable();
+
+	/**
+	 * @brief Adds or updates a line item.
+	 */
+	void Set(const CustomBudgetLineItemState& state);
+	void Remove(uint32_t department, uint32_t lineNumber);
+
+	const CustomBudgetLineItemState* Find(uint32_t department, uint32_t lineNumber) const;
+
+	size_t GetCount() const;
+	const std::vector<CustomBudgetLineItemState>& GetLineItems() const;
+
+	/**
+	 * @brief Copies the line items into the buffer.
+	 * @param pBuffer The buffer that receives the line items.
+	 * @param capacity The number of line items that the buffer can hold.
+	 * @return The number of line items that were copied.
+	 */
+	size_t Copy(CustomBudgetLineItemState* pBuffer, size_t capacity) const;
+
+	void Clear();
+
+private:
+	static uint64_t CreateKey(uint32_t department, uint32_t lineNumber);
+
+	std::vector<CustomBudgetLineItemState> lineItems;
+	std::unordered_map<uint64_t, size_t> indexes;
+};
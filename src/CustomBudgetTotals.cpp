@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "CustomBudgetTotals.h"
+
+CustomBudgetTotals::CustomBudgetTotals()
+	: departments(),
+	  budgetGroups()
+{
+}
+
+bool CustomBudgetTotals::AddDepartment(uint32_t department, uint32_t budgetGroup, const BudgetTotals& initialTotals)
+{
+	bool result = false;
+
+	if (departments.find(department) == departments.end())
+	{
+		BudgetTotals& groupTotals = budgetGroups.try_emplace(budgetGroup, BudgetTotals{}).first->second;
+		groupTotals.expenses += initialTotals.expenses;
+		groupTotals.income += initialTotals.income;
+
+		departments.emplace(department, DepartmentTotals{ initialTotals, &groupTotals });
+		result = true;
+	}
+
+	return result;
+}
+
+bool CustomBudgetTotals::ContainsDepartment(uint32_t department) const
+{
+	return departments.find(department) != departments.end();
+}
+
+void CustomBudgetTotals::AddDelta(uint32_t department, int64_t expensesDelta, int64_t incomeDelta)
+{
+	const auto item = departments.find(department);
+
+	if (item != departments.end())
+	{
+		DepartmentTotals& departmentTotals = item->second;
+
+		departmentTotals.totals.expenses += expensesDelta;
+		departmentTotals.totals.income += incomeDelta;
+		departmentTotals.pBudgetGroupTotals->expenses += expensesDelta;
+		departmentTotals.pBudgetGroupTotals->income += incomeDelta;
+	}
+}
+
+bool CustomBudgetTotals::GetDepartmentTotals(uint32_t department, BudgetTotals& totals) const
+{
+	bool result = false;
+
+	const auto item = departments.find(department);
+
+	if (item != departments.end())
+	{
+		totals = item->second.totals;
+		result = true;
+	}
+
+	return result;
+}
+
+bool CustomBudgetTotals::GetBudgetGroupTotals(uint32_t budgetGroup, BudgetTotals& totals) const
+{
+	bool result = false;
+
+	const auto item = budgetGroups.find(budgetGroup);
+
+	if (item != budgetGroups.end())
+	{
+		totals = item->second;
+		result = true;
+	}
+
+	return result;
+}
+
+void CustomBudgetTotals::Clear()
+{
+	departments.clear();
+	budgetGroups.clear();
+}
@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+
+struct BudgetTotals
+{
+	int64_t expenses;
+	int64_t income;
+};
+
+/**
+ * @brief The running expense and income totals of the custom budget departments.
+ *
+ * The totals are updated with the change in the line item values whenever the plugin sets
+ * a line item total, so the department and budget group totals can be queried without
+ * walking the line items. The budget group totals only include the custom departments.
+ */
+class CustomBudgetTotals
+{
+public:
+	CustomBudgetTotals();
+
+	/**
+	 * @brief Adds a department and the current totals of its line items.
+	 * @param department The department id.
+	 * @param budgetGroup The budget group that the department belongs to.
+	 * @param initialTotals The current totals of the department's line items.
+	 * @return True if the department was added; otherwise, false if it was already present.
+	 */
+	bool AddDepartment(uint32_t department, uint32_t budgetGroup, const BudgetTotals& initialTotals);
+	bool ContainsDepartment(uint32_t department) const;
+
+	/**
+	 * @brief Adds the change in a line item's expenses and income to its department and budget group.
+	 * @param department The department id.
+	 * @param expensesDelta The change in the line item expenses.
+	 * @param incomeDelta The change in the line item income.
+	 */
+	void AddDelta(uint32_t department, int64_t expensesDelta, int64_t incomeDelta);
+
+	bool GetDepartmentTotals(uint32_t department, BudgetTotals& totals) const;
+	bool GetBudgetGroupTotals(uint32_t budgetGroup, BudgetTotals& totals) const;
+
+	void Clear();
+
+private:
+	struct DepartmentTotals
+	{
+		BudgetTotals totals;
+		// The budget group totals are stored in an unordered_map, so the pointer stays
+		// valid when other groups are added.
+		BudgetTotals* pBudgetGroupTotals;
+	};
+
+	std::unordered_map<uint32_t, DepartmentTotals> departments;
+	std::unordered_map<uint32_t, BudgetTotals> budgetGroups;
+};
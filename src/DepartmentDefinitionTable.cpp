@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "DepartmentDefinitionTable.h"
+#include <algorithm>
+#include <utility>
+
+DepartmentDefinitionTable::DepartmentDefinitionTable()
+	: definitions()
+{
+}
+
+DepartmentDefinitionTable::DepartmentDefinitionTable(std::vector<DepartmentDefinition> definitions)
+	: definitions(std::move(definitions))
+{
+	auto departmentLess = [](const DepartmentDefinition& left, const DepartmentDefinition& right)
+	{
+		return left.department < right.department;
+	};
+
+	auto departmentEqual = [](const DepartmentDefinition& left, const DepartmentDefinition& right)
+	{
+		return left.department == right.department;
+	};
+
+	// The stable sort keeps the first definition of a department in front of the duplicates.
+	std::stable_sort(this->definitions.begin(), this->definitions.end(), departmentLess);
+	this->definitions.erase(
+		std::unique(this->definitions.begin(), this->definitions.end(), departmentEqual),
+		this->definitions.end());
+	this->definitions.shrink_to_fit();
+}
+
+const DepartmentDefinition* DepartmentDefinitionTable::Find(uint32_t department) const
+{
+	const auto item = std::lower_bound(
+		definitions.begin(),
+		definitions.end(),
+		department,
+		[](const DepartmentDefinition& definition, uint32_t value) { return definition.department < value; });
+
+	return item != definitions.end() && item->department == department ? &*item : nullptr;
+}
+
+bool DepartmentDefinitionTable::IsEmpty() const
+{
+	return definitions.empty();
+}
+
+size_t DepartmentDefinitionTable::GetCount() const
+{
+	return definitions.size();
+}
@@ -0,0 +1,53 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "StringResourceKey.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct DepartmentDefinition
+{
+	uint32_t department;
+	uint32_t budgetGroup;
+	StringResourceKey nameKey;
+};
+
+/**
+ * @brief The custom budget departments that are defined in the shared department definition exemplars.
+ *
+ * A building exemplar that uses a defined department only needs the Budget Item properties,
+ * its own Budget: Custom Department properties take precedence over the definition.
+ * The table is not modified after it is created, so it can be read from multiple threads.
+ */
+class DepartmentDefinitionTable
+{
+public:
+	DepartmentDefinitionTable();
+
+	/**
+	 * @brief Creates the table.
+	 * @param definitions The definitions, a department that is defined more than once uses the first definition.
+	 */
+	explicit DepartmentDefinitionTable(std::vector<DepartmentDefinition> definitions);
+
+	const DepartmentDefinition* Find(uint32_t department) const;
+
+	bool IsEmpty() const;
+	size_t GetCount() const;
+
+private:
+	// Sorted by department id.
+	std::vector<DepartmentDefinition> definitions;
+};
@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HistoryProvider.h"
+#include "cIGZDate.h"
+#include "cISC4App.h"
+#include "cISC4City.h"
+#include "cISC4HistoryWarehouse.h"
+#include "cISC4Simulator.h"
+#include "cRZAutoRefCount.h"
+#include "GZServPtrs.h"
+#include <algorithm>
+
+HistoryProvider::HistoryProvider()
+	: pHistoryWarehouse(nullptr),
+	  pSimulator(nullptr),
+	  cachedMonth(-1),
+	  cachedStatistics()
+{
+}
+
+bool HistoryProvider::Init()
+{
+	bool result = false;
+
+	cISC4AppPtr pSC4App;
+
+	if (pSC4App)
+	{
+		cISC4City* pCity = pSC4App->GetCity();
+
+		if (pCity)
+		{
+			pHistoryWarehouse = pCity->GetHistoryWarehouse();
+			pSimulator = pCity->GetSimulator();
+
+			result = pHistoryWarehouse && pSimulator;
+		}
+	}
+
+	return result;
+}
+
+bool HistoryProvider::Shutdown()
+{
+	pHistoryWarehouse = nullptr;
+	pSimulator = nullptr;
+	cachedMonth = -1;
+	cachedStatistics.clear();
+
+	return true;
+}
+
+bool HistoryProvider::GetStatistics(uint32_t historyType, uint32_t monthCount, HistoryStatistics& statistics)
+{
+	if (!pHistoryWarehouse || !pSimulator)
+	{
+		return false;
+	}
+
+	long year = 0;
+	long month = 0;
+	long day = 0;
+	long dayOfYear = 0;
+	long weekDay = 0;
+
+	pSimulator->GetSimDate(year, month, day, dayOfYear, weekDay);
+
+	const int64_t currentMonth = (static_cast<int64_t>(year) * 12) + month;
+
+	// The cached statistics are discarded when the simulation month changes.
+	if (currentMonth != cachedMonth)
+	{
+		cachedMonth = currentMonth;
+		cachedStatistics.clear();
+	}
+
+	const uint64_t key = (static_cast<uint64_t>(historyType) << 32) | monthCount;
+
+	auto item = cachedStatistics.find(key);
+
+	if (item == cachedStatistics.end())
+	{
+		CachedStatistics value{};
+		value.valid = QueryStatistics(historyType, monthCount, value.statistics);
+
+		item = cachedStatistics.emplace(key, value).first;
+	}
+
+	statistics = item->second.statistics;
+	return item->second.valid;
+}
+
+bool HistoryProvider::QueryStatistics(uint32_t historyType, uint32_t monthCount, HistoryStatistics& statistics)
+{
+	cIGZDate* pEndDate = pSimulator->GetSimDate();
+
+	if (!pEndDate)
+	{
+		return false;
+	}
+
+	cRZAutoRefCount<cIGZDate> pStartDate;
+
+	if (!pEndDate->Clone(pStartDate.AsPPObj()))
+	{
+		return false;
+	}
+
+	// The start date is the same day of the month, monthCount months before the current date.
+	// The day is limited to 28 so that it is valid for every month.
+	const int64_t endMonthIndex = (static_cast<int64_t>(pEndDate->Year()) * 12) + (pEndDate->Month() - 1);
+	const int64_t startMonthIndex = std::max<int64_t>(endMonthIndex - monthCount, 0);
+
+	if (!pStartDate->Set(
+		static_cast<uint32_t>(startMonthIndex % 12) + 1,
+		std::min(pEndDate->DayOfMonth(), 28U),
+		static_cast<uint32_t>(startMonthIndex / 12)))
+	{
+		return false;
+	}
+
+	float slope = 0.0f;
+	float intercept = 0.0f;
+
+	if (!pHistoryWarehouse->GetMinMaxAverage(
+			historyType,
+			*pStartDate,
+			*pEndDate,
+			statistics.minimum,
+			statistics.maximum,
+			statistics.average)
+		|| !pHistoryWarehouse->GetTrend(historyType, *pStartDate, *pEndDate, slope, intercept))
+	{
+		return false;
+	}
+
+	// The trend line is a function of the day number.
+	const uint32_t dayCount = pEndDate->DayNumber() - pStartDate->DayNumber();
+	statistics.trendChange = slope * static_cast<float>(dayCount);
+
+	return true;
+}
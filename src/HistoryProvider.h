@@ -0,0 +1,50 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "IHistoryProvider.h"
+#include <unordered_map>
+
+class cISC4HistoryWarehouse;
+class cISC4Simulator;
+
+/**
+ * @brief Provides the city history statistics to the transaction algorithms.
+ *
+ * The history warehouse queries span a date range and are expensive, so the statistics for each
+ * history type and month count are queried once per simulation month and shared by all of the callers.
+ */
+class HistoryProvider : public IHistoryProvider
+{
+public:
+	HistoryProvider();
+
+	bool Init();
+	bool Shutdown();
+
+	bool GetStatistics(uint32_t historyType, uint32_t monthCount, HistoryStatistics& statistics) override;
+
+private:
+	struct CachedStatistics
+	{
+		HistoryStatistics statistics;
+		bool valid;
+	};
+
+	bool QueryStatistics(uint32_t historyType, uint32_t monthCount, HistoryStatistics& statistics);
+
+	cISC4HistoryWarehouse* pHistoryWarehouse;
+	cISC4Simulator* pSimulator;
+	int64_t cachedMonth;
+	std::unordered_map<uint64_t, CachedStatistics> cachedStatistics;
+};
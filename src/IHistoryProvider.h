@@ -0,0 +1,37 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstdint>
+
+struct HistoryStatistics
+{
+	float minimum;
+	float maximum;
+	float average;
+	// The change in the trend line value over the date range.
+	float trendChange;
+};
+
+class IHistoryProvider
+{
+public:
+	/**
+	 * @brief Gets the statistics for a city history type over the specified number of months.
+	 * @param historyType The history type id.
+	 * @param monthCount The number of months before the current simulation date.
+	 * @param statistics Receives the statistics.
+	 * @return True on success; otherwise, false.
+	 */
+	virtual bool GetStatistics(uint32_t historyType, uint32_t monthCount, HistoryStatistics& statistics) = 0;
+};
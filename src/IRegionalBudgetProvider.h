@@ -0,0 +1,29 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstdint>
+
+class IRegionalBudgetProvider
+{
+public:
+	/**
+	 * @brief Gets the custom budget department expenses of the other cities in the region.
+	 */
+	virtual int64_t GetRegionCustomBudgetExpenses() = 0;
+
+	/**
+	 * @brief Gets the custom budget department income of the other cities in the region.
+	 */
+	virtual int64_t GetRegionCustomBudgetIncome() = 0;
+};
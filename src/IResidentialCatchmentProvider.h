@@ -0,0 +1,28 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstdint>
+
+class IResidentialCatchmentProvider
+{
+public:
+	/**
+	 * @brief Gets the residential population within a square area centered on the specified position.
+	 * @param x The x position in meters.
+	 * @param z The z position in meters.
+	 * @param radius The distance in meters from the center to each edge of the area.
+	 * @return The residential population within the area.
+	 */
+	virtual int64_t GetResidentialPopulation(float x, float z, float radius) = 0;
+};
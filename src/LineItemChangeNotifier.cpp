@@ -0,0 +1,238 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "LineItemChangeNotifier.h"
+#include <algorithm>
+
+namespace
+{
+	uint64_t CreateKey(uint32_t department, uint32_t lineNumber)
+	{
+		return (static_cast<uint64_t>(department) << 32) | static_cast<uint64_t>(lineNumber);
+	}
+
+	bool IsUnchanged(const CustomBudgetLineItemChange& change)
+	{
+		return change.flags == CustomBudgetLineItemChangeFlag_None
+			&& change.oldBuildingCount == change.newBuildingCount
+			&& change.oldExpenses == change.newExpenses
+			&& change.oldIncome == change.newIncome;
+	}
+}
+
+LineItemChangeNotifier::LineItemChangeNotifier()
+	: listeners(),
+	  changes(),
+	  changeIndexes(),
+	  filteredChanges(),
+	  notifying(false)
+{
+}
+
+bool LineItemChangeNotifier::AddListener(
+	cICustomBudgetLineItemListener* pListener,
+	uint32_t department,
+	uint32_t budgetGroup)
+{
+	bool result = false;
+
+	if (pListener)
+	{
+		const auto item = std::find_if(
+			listeners.begin(),
+			listeners.end(),
+			[pListener](const Listener& listener) { return listener.pListener == pListener; });
+
+		if (item == listeners.end())
+		{
+			pListener->AddRef();
+			listeners.push_back(Listener{ pListener, department, budgetGroup });
+			result = true;
+		}
+	}
+
+	return result;
+}
+
+bool LineItemChangeNotifier::RemoveListener(cICustomBudgetLineItemListener* pListener)
+{
+	bool result = false;
+
+	for (Listener& listener : listeners)
+	{
+		if (pListener && listener.pListener == pListener)
+		{
+			// The listeners can remove themselves while they are being notified, so the
+			// entry is released and the list is compacted after the notification.
+			listener.pListener->Release();
+			listener.pListener = nullptr;
+			result = true;
+			break;
+		}
+	}
+
+	if (!notifying)
+	{
+		RemoveReleasedListeners();
+
+		if (listeners.empty())
+		{
+			Clear();
+		}
+	}
+
+	return result;
+}
+
+void LineItemChangeNotifier::RemoveAllListeners()
+{
+	for (Listener& listener : listeners)
+	{
+		if (listener.pListener)
+		{
+			listener.pListener->Release();
+			listener.pListener = nullptr;
+		}
+	}
+
+	if (!notifying)
+	{
+		listeners.clear();
+		Clear();
+	}
+}
+
+bool LineItemChangeNotifier::HasListeners() const
+{
+	return !listeners.empty();
+}
+
+void LineItemChangeNotifier::RecordChange(const CustomBudgetLineItemState* pOldState, const CustomBudgetLineItemState* pNewState)
+{
+	const CustomBudgetLineItemState* pState = pNewState ? pNewState : pOldState;
+
+	if (!pState || listeners.empty())
+	{
+		return;
+	}
+
+	const auto pair = changeIndexes.try_emplace(CreateKey(pState->department, pState->lineNumber), changes.size());
+
+	if (pair.second)
+	{
+		CustomBudgetLineItemChange change{};
+		change.department = pState->department;
+		change.lineNumber = pState->lineNumber;
+		change.budgetGroup = pState->budgetGroup;
+		change.flags = CustomBudgetLineItemChangeFlag_None;
+
+		if (pOldState)
+		{
+			change.oldBuildingCount = pOldState->buildingCount;
+			change.oldExpenses = pOldState->expenses;
+			change.oldIncome = pOldState->income;
+		}
+		else
+		{
+			change.flags |= CustomBudgetLineItemChangeFlag_Added;
+		}
+
+		changes.push_back(change);
+	}
+
+	// The old values are kept from the first change in the batch.
+	CustomBudgetLineItemChange& change = changes[pair.first->second];
+
+	if (pNewState)
+	{
+		change.flags &= ~CustomBudgetLineItemChangeFlag_Removed;
+		change.newBuildingCount = pNewState->buildingCount;
+		change.newExpenses = pNewState->expenses;
+		change.newIncome = pNewState->income;
+	}
+	else
+	{
+		change.flags |= CustomBudgetLineItemChangeFlag_Removed;
+		change.newBuildingCount = 0;
+		change.newExpenses = 0;
+		change.newIncome = 0;
+	}
+}
+
+void LineItemChangeNotifier::Flush()
+{
+	if (changes.empty() || notifying)
+	{
+		return;
+	}
+
+	notifying = true;
+
+	// The listeners that are added during the notification receive the next batch.
+	const size_t listenerCount = listeners.size();
+
+	for (size_t i = 0; i < listenerCount; i++)
+	{
+		const Listener& listener = listeners[i];
+
+		if (!listener.pListener)
+		{
+			continue;
+		}
+
+		filteredChanges.clear();
+
+		for (const CustomBudgetLineItemChange& change : changes)
+		{
+			// The line items that were added and removed within the batch are skipped.
+			const bool addedAndRemoved = (change.flags & CustomBudgetLineItemChangeFlag_Added) != 0
+				&& (change.flags & CustomBudgetLineItemChangeFlag_Removed) != 0;
+
+			if (!addedAndRemoved
+				&& !IsUnchanged(change)
+				&& (listener.department == 0 || listener.department == change.department)
+				&& (listener.budgetGroup == 0 || listener.budgetGroup == change.budgetGroup))
+			{
+				filteredChanges.push_back(change);
+			}
+		}
+
+		if (!filteredChanges.empty())
+		{
+			listener.pListener->LineItemsChanged(filteredChanges.data(), static_cast<uint32_t>(filteredChanges.size()));
+		}
+	}
+
+	notifying = false;
+
+	RemoveReleasedListeners();
+	Clear();
+}
+
+void LineItemChangeNotifier::Clear()
+{
+	// The buffers keep their capacity for the next batch.
+	changes.clear();
+	changeIndexes.clear();
+	filteredChanges.clear();
+}
+
+void LineItemChangeNotifier::RemoveReleasedListeners()
+{
+	listeners.erase(
+		std::remove_if(
+			listeners.begin(),
+			listeners.end(),
+			[](const Listener& listener) { return listener.pListener == nullptr; }),
+		listeners.end());
+}
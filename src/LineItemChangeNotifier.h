@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cICustomBudgetDepartmentQuery.h"
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Collects the line item changes and sends them to the registered listeners in one batch.
+ *
+ * The changes are coalesced per line item until the next flush, and the buffers are
+ * reused between the batches. The changes are only collected while there is a listener.
+ */
+class LineItemChangeNotifier
+{
+public:
+	LineItemChangeNotifier();
+
+	bool AddListener(cICustomBudgetLineItemListener* pListener, uint32_t department, uint32_t budgetGroup);
+	bool RemoveListener(cICustomBudgetLineItemListener* pListener);
+	void RemoveAllListeners();
+
+	bool HasListeners() const;
+
+	/**
+	 * @brief Records a line item change.
+	 * @param pOldState The line item state before the change, or null if the line item was added.
+	 * @param pNewState The line item state after the change, or null if the line item was removed.
+	 */
+	void RecordChange(const CustomBudgetLineItemState* pOldState, const CustomBudgetLineItemState* pNewState);
+
+	/**
+	 * @brief Sends the pending changes to the listeners.
+	 */
+	void Flush();
+
+	/**
+	 * @brief Discards the pending changes.
+	 */
+	void Clear();
+
+private:
+	struct Listener
+	{
+		// Null if the listener was removed during a notification.
+		cICustomBudgetLineItemListener* pListener;
+		uint32_t department;
+		uint32_t budgetGroup;
+	};
+
+	void RemoveReleasedListeners();
+
+	std::vector<Listener> listeners;
+	std::vector<CustomBudgetLineItemChange> changes;
+	std::unordered_map<uint64_t, size_t> changeIndexes;
+	std::vector<CustomBudgetLineItemChange> filteredChanges;
+	bool notifying;
+};
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "LineItemConditions.h"
+#include "cIGZIStream.h"
+#include "cIGZOStream.h"
+#include <utility>
+
+LineItemConditions::LineItemConditions()
+	: conditions()
+{
+}
+
+void LineItemConditions::Add(const ConditionPredicate& predicate, AlgorithmFactor multiplier)
+{
+	conditions.push_back(Condition{ predicate, multiplier, 0, 0 });
+}
+
+bool LineItemConditions::IsEmpty() const
+{
+	return conditions.empty();
+}
+
+size_t LineItemConditions::GetCount() const
+{
+	return conditions.size();
+}
+
+void LineItemConditions::Compile(ConditionPredicateTable& table)
+{
+	for (Condition& condition : conditions)
+	{
+		const uint32_t bitIndex = table.Register(condition.predicate);
+
+		if (bitIndex != ConditionPredicateTable::InvalidBitIndex)
+		{
+			condition.wordIndex = bitIndex / 64;
+			condition.mask = uint64_t(1) << (bitIndex % 64);
+		}
+		else
+		{
+			condition.wordIndex = 0;
+			condition.mask = 0;
+		}
+	}
+}
+
+int64_t LineItemConditions::Apply(int64_t total, const ConditionPredicateTable& table) const
+{
+	int64_t newTotal = total;
+
+	for (const Condition& condition : conditions)
+	{
+		if (condition.mask != 0 && table.IsSet(condition.wordIndex, condition.mask))
+		{
+			newTotal = condition.multiplier.Multiply(newTotal);
+		}
+	}
+
+	return newTotal;
+}
+
+bool LineItemConditions::Read(cIGZIStream& stream)
+{
+	uint32_t count = 0;
+
+	if (!stream.GetUint32(count) || count > MaxConditionCount)
+	{
+		return false;
+	}
+
+	std::vector<Condition> newConditions;
+	newConditions.reserve(count);
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint32_t type = 0;
+		Condition condition{};
+
+		if (!stream.GetUint32(type)
+			|| type >= static_cast<uint32_t>(ConditionPredicateType::Count)
+			|| !stream.GetUint32(condition.predicate.id)
+			|| !stream.GetUint32(condition.predicate.threshold)
+			|| condition.predicate.threshold > ConditionPredicateTable::MaxTaxRateThreshold
+			|| !condition.multiplier.Read(stream, false))
+		{
+			return false;
+		}
+
+		condition.predicate.type = static_cast<ConditionPredicateType>(type);
+		newConditions.push_back(condition);
+	}
+
+	conditions = std::move(newConditions);
+	return true;
+}
+
+bool LineItemConditions::Write(cIGZOStream& stream) const
+{
+	if (!stream.SetUint32(static_cast<uint32_t>(conditions.size())))
+	{
+		return false;
+	}
+
+	for (const Condition& condition : conditions)
+	{
+		if (!stream.SetUint32(static_cast<uint32_t>(condition.predicate.type))
+			|| !stream.SetUint32(condition.predicate.id)
+			|| !stream.SetUint32(condition.predicate.threshold)
+			|| !condition.multiplier.Write(stream))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
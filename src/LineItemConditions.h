@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "AlgorithmFactor.h"
+#include "ConditionPredicateTable.h"
+#include <vector>
+
+class cIGZIStream;
+class cIGZOStream;
+
+/**
+ * @brief The conditions that multiply a line item's total when their predicate is true.
+ *
+ * A multiplier of zero disables the line item while the predicate is true. The predicates are
+ * compiled to a word index and bit mask in the ConditionPredicateTable, so evaluating a condition
+ * is a single mask test.
+ */
+class LineItemConditions
+{
+public:
+	static constexpr uint32_t MaxConditionCount = 16;
+
+	LineItemConditions();
+
+	void Add(const ConditionPredicate& predicate, AlgorithmFactor multiplier);
+	bool IsEmpty() const;
+	size_t GetCount() const;
+
+	/**
+	 * @brief Registers the predicates with the table and compiles the mask tests.
+	 */
+	void Compile(ConditionPredicateTable& table);
+
+	/**
+	 * @brief Applies the multipliers of the conditions whose predicate is true.
+	 * @param total The line item total.
+	 * @param table The table that the conditions were compiled with.
+	 * @return The new line item total.
+	 */
+	int64_t Apply(int64_t total, const ConditionPredicateTable& table) const;
+
+	bool Read(cIGZIStream& stream);
+	bool Write(cIGZOStream& stream) const;
+
+private:
+	struct Condition
+	{
+		ConditionPredicate predicate;
+		AlgorithmFactor multiplier;
+		uint32_t wordIndex;
+		// Zero if the condition has not been compiled.
+		uint64_t mask;
+	};
+
+	std::vector<Condition> conditions;
+};
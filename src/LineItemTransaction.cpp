@@ -12,8 +12,17 @@
 ////////////////////////////////////////////////////////////////////////
 
 #include "LineItemTransaction.h"
+#include "BuildingAgeAlgorithm.h"
+#include "ResidentialCatchmentAlgorithm.h"
+#include "TransactionAlgorithmStaticPointers.h"
 #include "cIGZIStream.h"
 #include "cIGZOStream.h"
+#include <algorithm>
+#include <utility>
+
+// Version 2 stores the algorithm factors as rational numbers, version 1 stored them as Float32 values.
+// Version 3 adds the line item conditions.
+static constexpr uint32_t CurrentVersion = 3;
 
 namespace
 {
@@ -41,6 +50,8 @@ namespace
 
 LineItemTransaction::LineItemTransaction()
 	: algorithm(),
+	  buildingInstances(),
+	  conditions(),
 	  perBuildingFixedCashFlow(0),
 	  isIncome(false)
 {
@@ -52,15 +63,36 @@ LineItemTransaction::LineItemTransaction(
 	int64_t perBuildingFixedCashFlow,
 	uint32_t lineNumber,
 	bool isIncome)
+	: LineItemTransaction(pPropertyHolder, type, perBuildingFixedCashFlow, lineNumber, isIncome, true)
+{
+}
+
+LineItemTransaction::LineItemTransaction(
+	const cISCPropertyHolder* pPropertyHolder,
+	TransactionAlgorithmType type,
+	int64_t perBuildingFixedCashFlow,
+	uint32_t lineNumber,
+	bool isIncome,
+	bool compileConditions)
 	: algorithm(TransactionAlgorithmFactory::Create(pPropertyHolder, type, lineNumber)),
+	  buildingInstances(),
+	  conditions(TransactionAlgorithmFactory::CreateConditions(pPropertyHolder, lineNumber)),
 	  perBuildingFixedCashFlow(perBuildingFixedCashFlow),
 	  isIncome(isIncome)
 {
+	CreateBuildingInstances();
+
+	if (compileConditions && conditions && spConditionPredicateTable)
+	{
+		conditions->Compile(*spConditionPredicateTable);
+	}
 }
 
 LineItemTransaction::LineItemTransaction(LineItemTransaction&& other) noexcept
 {
 	algorithm = std::move(other.algorithm);
+	buildingInstances = std::move(other.buildingInstances);
+	conditions = std::move(other.conditions);
 	perBuildingFixedCashFlow = std::exchange(other.perBuildingFixedCashFlow, 0);
 	isIncome = std::exchange(other.isIncome, false);
 }
@@ -68,13 +100,15 @@ LineItemTransaction::LineItemTransaction(LineItemTransaction&& other) noexcept
 LineItemTransaction& LineItemTransaction::operator=(LineItemTransaction&& other) noexcept
 {
 	algorithm = std::move(other.algorithm);
+	buildingInstances = std::move(other.buildingInstances);
+	conditions = std::move(other.conditions);
 	perBuildingFixedCashFlow = std::exchange(other.perBuildingFixedCashFlow, 0);
 	isIncome = std::exchange(other.isIncome, false);
 
 	return *this;
 }
 
-int64_t LineItemTransaction::CalculateLineItemTotal(int64_t buildingCount)
+int64_t LineItemTransaction::CalculateLineItemTotal(int64_t buildingCount) const
 {
 	int64_t total = 0;
 
@@ -84,17 +118,131 @@ int64_t LineItemTransaction::CalculateLineItemTotal(int64_t buildingCount)
 
 		if (algorithm)
 		{
-			total = algorithm->Calculate(total);
+			total = algorithm->Calculate(total, buildingCount, algorithm->CalculateSharedValue());
+			total = AddBuildingInstanceCost(total);
 		}
+
+		total = ApplyConditions(total);
 	}
 
 	return total;
 }
 
+int64_t LineItemTransaction::CalculateLineItemTotal(int64_t buildingCount, AlgorithmSharedValueCache& sharedValues) const
+{
+	int64_t total = 0;
+
+	if (buildingCount > 0)
+	{
+		total = perBuildingFixedCashFlow * buildingCount;
+
+		if (algorithm)
+		{
+			total = algorithm->Calculate(total, buildingCount, sharedValues.GetOrCalculate(*algorithm));
+			total = AddBuildingInstanceCost(total);
+		}
+
+		total = ApplyConditions(total);
+	}
+
+	return total;
+}
+
+int64_t LineItemTransaction::CalculateMarginalTotal(int64_t buildingCount, AlgorithmSharedValueCache& sharedValues) const
+{
+	const int64_t currentCount = buildingCount > 0 ? buildingCount : 0;
+
+	int64_t sharedValue = 0;
+	int64_t buildingInstanceCost = 0;
+
+	if (algorithm)
+	{
+		sharedValue = sharedValues.GetOrCalculate(*algorithm);
+
+		// The new building is not in the building instances, so the instance cost is the same
+		// for both totals and it only changes the difference when a condition scales the totals.
+		if (conditions)
+		{
+			buildingInstanceCost = AddBuildingInstanceCost(0);
+		}
+	}
+
+	return CalculateTotal(currentCount + 1, sharedValue, buildingInstanceCost)
+		 - CalculateTotal(currentCount, sharedValue, buildingInstanceCost);
+}
+
+void LineItemTransaction::CalculateProjectedBuildingInstanceCosts(uint32_t monthCount, int64_t* costs) const
+{
+	if (buildingInstances)
+	{
+		if (algorithm->GetAlgorithmType() == TransactionAlgorithmType::BuildingAge)
+		{
+			const BuildingAgeAlgorithm& buildingAgeAlgorithm = static_cast<const BuildingAgeAlgorithm&>(*algorithm);
+
+			buildingInstances->GetProjectedAgeTotals(monthCount, costs);
+
+			for (uint32_t i = 0; i < monthCount; i++)
+			{
+				costs[i] = buildingAgeAlgorithm.CalculateAgeCost(costs[i]);
+			}
+		}
+		else
+		{
+			const ResidentialCatchmentAlgorithm& catchmentAlgorithm = static_cast<const ResidentialCatchmentAlgorithm&>(*algorithm);
+
+			std::fill_n(costs, monthCount, catchmentAlgorithm.CalculateCatchmentCost(*buildingInstances));
+		}
+	}
+	else
+	{
+		std::fill_n(costs, monthCount, 0);
+	}
+}
+
+int64_t LineItemTransaction::CalculateProjectedTotal(
+	int64_t buildingCount,
+	int64_t buildingInstanceCost,
+	AlgorithmSharedValueCache& sharedValues) const
+{
+	const int64_t sharedValue = algorithm ? sharedValues.GetOrCalculate(*algorithm) : 0;
+
+	return CalculateTotal(buildingCount, sharedValue, buildingInstanceCost);
+}
+
+void LineItemTransaction::InsertBuilding(uint64_t key, int32_t age)
+{
+	if (buildingInstances)
+	{
+		buildingInstances->Insert(key, age);
+	}
+}
+
+void LineItemTransaction::RemoveBuilding(uint64_t key)
+{
+	if (buildingInstances)
+	{
+		buildingInstances->Remove(key);
+	}
+}
+
+void LineItemTransaction::AdvanceBuildingAges()
+{
+	if (buildingInstances)
+	{
+		buildingInstances->AdvanceMonth();
+	}
+}
+
 bool LineItemTransaction::IsFixedCost() const
 {
-	// Fixed expense/income is represented by a null ITransactionAlgorithm.
-	return !algorithm;
+	// Fixed expense/income is represented by a null ITransactionAlgorithm,
+	// the conditions can change the total of a fixed expense/income line item.
+	return !algorithm && !conditions;
+}
+
+TransactionAlgorithmType LineItemTransaction::GetAlgorithmType() const
+{
+	return algorithm ? algorithm->GetAlgorithmType() : TransactionAlgorithmType::Fixed;
 }
 
 bool LineItemTransaction::IsIncome() const
@@ -105,7 +253,7 @@ bool LineItemTransaction::IsIncome() const
 bool LineItemTransaction::Read(cIGZIStream& stream)
 {
 	uint32_t version = 0;
-	if (!stream.GetUint32(version) || version != 1)
+	if (!stream.GetUint32(version) || version < 1 || version > CurrentVersion)
 	{
 		return false;
 	}
@@ -131,23 +279,59 @@ bool LineItemTransaction::Read(cIGZIStream& stream)
 	// Any variable expense/income algorithm will have an actual ITransactionAlgorithm instance
 	// that calculates the line item costs using to the specified algorithm.
 
-	algorithm = TransactionAlgorithmFactory::Create(algorithmType);
+	std::unique_ptr<ITransactionAlgorithm> newAlgorithm = TransactionAlgorithmFactory::Create(algorithmType);
 
-	if (algorithm)
+	if (newAlgorithm)
+	{
+		if (!newAlgorithm->Read(stream, version))
+		{
+			return false;
+		}
+	}
+
+	// The line items that use the same algorithm parameters share one instance.
+	algorithm = TransactionAlgorithmFactory::Intern(std::move(newAlgorithm));
+
+	CreateBuildingInstances();
+
+	// The building instances follow the algorithm data.
+	if (buildingInstances)
 	{
-		if (!algorithm->Read(stream))
+		if (!buildingInstances->Read(stream))
 		{
 			return false;
 		}
 	}
 
+	conditions.reset();
+
+	if (version >= 3)
+	{
+		std::unique_ptr<LineItemConditions> newConditions = std::make_unique<LineItemConditions>();
+
+		if (!newConditions->Read(stream))
+		{
+			return false;
+		}
+
+		if (!newConditions->IsEmpty())
+		{
+			conditions = std::move(newConditions);
+
+			if (spConditionPredicateTable)
+			{
+				conditions->Compile(*spConditionPredicateTable);
+			}
+		}
+	}
+
 	return true;
 }
 
 
 bool LineItemTransaction::Write(cIGZOStream& stream) const
 {
-	if (!stream.SetUint32(1)) // version
+	if (!stream.SetUint32(CurrentVersion))
 	{
 		return false;
 	}
@@ -177,6 +361,14 @@ bool LineItemTransaction::Write(cIGZOStream& stream) const
 		{
 			return false;
 		}
+
+		if (buildingInstances)
+		{
+			if (!buildingInstances->Write(stream))
+			{
+				return false;
+			}
+		}
 	}
 	else
 	{
@@ -186,5 +378,111 @@ bool LineItemTransaction::Write(cIGZOStream& stream) const
 		}
 	}
 
+	// The conditions follow the algorithm data, an empty list is written if the line item does not have any.
+	if (conditions)
+	{
+		if (!conditions->Write(stream))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		if (!LineItemConditions().Write(stream))
+		{
+			return false;
+		}
+	}
+
 	return true;
 }
+
+bool LineItemTransaction::WriteFromExemplar(
+	const cISCPropertyHolder* pPropertyHolder,
+	TransactionAlgorithmType type,
+	int64_t perBuildingFixedCashFlow,
+	uint32_t lineNumber,
+	bool isIncome,
+	cIGZOStream& stream)
+{
+	// The conditions are compiled when the transaction is read for a line item in the city.
+	const LineItemTransaction transaction(pPropertyHolder, type, perBuildingFixedCashFlow, lineNumber, isIncome, false);
+
+	return transaction.Write(stream);
+}
+
+void LineItemTransaction::CreateBuildingInstances()
+{
+	buildingInstances.reset();
+
+	if (algorithm)
+	{
+		const TransactionAlgorithmType type = algorithm->GetAlgorithmType();
+
+		if (type == TransactionAlgorithmType::BuildingAge)
+		{
+			const BuildingAgeAlgorithm& buildingAgeAlgorithm = static_cast<const BuildingAgeAlgorithm&>(*algorithm);
+
+			buildingInstances = std::make_unique<BuildingInstanceArray>(buildingAgeAlgorithm.GetMaxAge());
+		}
+		else if (type == TransactionAlgorithmType::ResidentialCatchment)
+		{
+			// Only the building positions are used, the ages stay at zero.
+			buildingInstances = std::make_unique<BuildingInstanceArray>(0);
+		}
+	}
+}
+
+int64_t LineItemTransaction::AddBuildingInstanceCost(int64_t total) const
+{
+	int64_t newTotal = total;
+
+	if (buildingInstances)
+	{
+		if (algorithm->GetAlgorithmType() == TransactionAlgorithmType::BuildingAge)
+		{
+			const BuildingAgeAlgorithm& buildingAgeAlgorithm = static_cast<const BuildingAgeAlgorithm&>(*algorithm);
+
+			newTotal += buildingAgeAlgorithm.CalculateAgeCost(buildingInstances->GetAgeTotal());
+		}
+		else
+		{
+			const ResidentialCatchmentAlgorithm& catchmentAlgorithm = static_cast<const ResidentialCatchmentAlgorithm&>(*algorithm);
+
+			newTotal += catchmentAlgorithm.CalculateCatchmentCost(*buildingInstances);
+		}
+	}
+
+	return newTotal;
+}
+
+int64_t LineItemTransaction::ApplyConditions(int64_t total) const
+{
+	int64_t newTotal = total;
+
+	if (conditions && spConditionPredicateTable)
+	{
+		newTotal = conditions->Apply(total, *spConditionPredicateTable);
+	}
+
+	return newTotal;
+}
+
+int64_t LineItemTransaction::CalculateTotal(int64_t buildingCount, int64_t sharedValue, int64_t buildingInstanceCost) const
+{
+	int64_t total = 0;
+
+	if (buildingCount > 0)
+	{
+		total = perBuildingFixedCashFlow * buildingCount;
+
+		if (algorithm)
+		{
+			total = algorithm->Calculate(total, buildingCount, sharedValue) + buildingInstanceCost;
+		}
+
+		total = ApplyConditions(total);
+	}
+
+	return total;
+}
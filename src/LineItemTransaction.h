@@ -13,6 +13,8 @@
 
 #pragma once
 #include "cIGZSerializable.h"
+#include "AlgorithmSharedValueCache.h"
+#include "BuildingInstanceArray.h"
 #include "ITransactionAlgorithm.h"
 #include "TransactionAlgorithmFactory.h"
 #include <memory>
@@ -34,16 +36,99 @@ public:
 	LineItemTransaction& operator=(const LineItemTransaction&) = delete;
 	LineItemTransaction& operator=(LineItemTransaction&&) noexcept;
 
-	int64_t CalculateLineItemTotal(int64_t buildingCount);
+	int64_t CalculateLineItemTotal(int64_t buildingCount) const;
+
+	/**
+	 * @brief Calculates the line item total using the cached algorithm shared value.
+	 * @param buildingCount The number of buildings that use the line item.
+	 * @param sharedValues The shared values for the current monthly update.
+	 * @return The line item total.
+	 */
+	int64_t CalculateLineItemTotal(int64_t buildingCount, AlgorithmSharedValueCache& sharedValues) const;
+
+	/**
+	 * @brief Calculates the change in the line item total when one more building is added.
+	 * This is equivalent to CalculateLineItemTotal(buildingCount + 1) - CalculateLineItemTotal(buildingCount),
+	 * but the algorithm shared value and the building instance cost are only calculated once.
+	 * @param buildingCount The number of buildings that currently use the line item.
+	 * @param sharedValues The cached algorithm shared values.
+	 * @return The change in the line item total.
+	 */
+	int64_t CalculateMarginalTotal(int64_t buildingCount, AlgorithmSharedValueCache& sharedValues) const;
+
+	/**
+	 * @brief Calculates the building instance cost for each of the following months.
+	 * The building ages are advanced by one month for each value, the ResidentialCatchment cost
+	 * uses the current population grid for every month.
+	 * @param monthCount The number of months.
+	 * @param costs Receives the building instance cost of months 1 to monthCount.
+	 */
+	void CalculateProjectedBuildingInstanceCosts(uint32_t monthCount, int64_t* costs) const;
+
+	/**
+	 * @brief Calculates the line item total for a projected month.
+	 * @param buildingCount The number of buildings that use the line item.
+	 * @param buildingInstanceCost The month's value from CalculateProjectedBuildingInstanceCosts.
+	 * @param sharedValues The shared values for the projected month.
+	 * @return The line item total.
+	 */
+	int64_t CalculateProjectedTotal(
+		int64_t buildingCount,
+		int64_t buildingInstanceCost,
+		AlgorithmSharedValueCache& sharedValues) const;
+
+	/**
+	 * @brief Adds a building to the line item's building instances.
+	 * Only the line items that use the BuildingAge or ResidentialCatchment algorithms track the individual buildings.
+	 * @param key The key that identifies the building.
+	 * @param age The building age in months.
+	 */
+	void InsertBuilding(uint64_t key, int32_t age);
+	void RemoveBuilding(uint64_t key);
+
+	/**
+	 * @brief Increments the age of the line item's buildings by one month.
+	 */
+	void AdvanceBuildingAges();
 
 	bool IsFixedCost() const;
+	TransactionAlgorithmType GetAlgorithmType() const;
 	bool IsIncome() const;
 
 	bool Read(cIGZIStream& stream);
 	bool Write(cIGZOStream& stream) const;
 
+	/**
+	 * @brief Writes the transaction that a line item creates from its exemplar.
+	 * The line item conditions are not compiled, so the condition predicate table is not changed.
+	 * @throws CreateTransactionAlgorithmException if the exemplar's algorithm parameters are not valid.
+	 */
+	static bool WriteFromExemplar(
+		const cISCPropertyHolder* pPropertyHolder,
+		TransactionAlgorithmType type,
+		int64_t perBuildingFixedCashFlow,
+		uint32_t lineNumber,
+		bool isIncome,
+		cIGZOStream& stream);
+
 private:
-	std::unique_ptr<ITransactionAlgorithm> algorithm;
+	LineItemTransaction(
+		const cISCPropertyHolder* pPropertyHolder,
+		TransactionAlgorithmType type,
+		int64_t perBuildingFixedCashFlow,
+		uint32_t lineNumber,
+		bool isIncome,
+		bool compileConditions);
+
+	void CreateBuildingInstances();
+	int64_t AddBuildingInstanceCost(int64_t total) const;
+	int64_t ApplyConditions(int64_t total) const;
+	int64_t CalculateTotal(int64_t buildingCount, int64_t sharedValue, int64_t buildingInstanceCost) const;
+
+	std::shared_ptr<const ITransactionAlgorithm> algorithm;
+	std::unique_ptr<BuildingInstanceArray> buildingInstances;
+	// Null if the line item does not have any conditions.
+	std::unique_ptr<LineItemConditions> conditions;
 	int64_t perBuildingFixedCashFlow;
 	bool isIncome;
 };
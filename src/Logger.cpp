@@ -12,7 +12,16 @@
 ////////////////////////////////////////////////////////////////////////
 
 #include "Logger.h"
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#ifdef _WIN32
 #include <Windows.h>
+#else
+#include <ctime>
+#endif // _WIN32
 
 namespace
 {
@@ -20,6 +29,7 @@ namespace
 	{
 		char buffer[1024]{};
 
+#ifdef _WIN32
 		GetTimeFormatA(
 			LOCALE_USER_DEFAULT,
 			0,
@@ -27,6 +37,17 @@ namespace
 			nullptr,
 			buffer,
 			_countof(buffer));
+#else
+		// Use the locale's time representation, this matches the default
+		// format of GetTimeFormatA.
+		const std::time_t now = std::time(nullptr);
+		std::tm localTime{};
+
+		if (localtime_r(&now, &localTime))
+		{
+			std::strftime(buffer, sizeof(buffer), "%X", &localTime);
+		}
+#endif // _WIN32
 
 		std::string time(buffer);
 
@@ -39,7 +60,7 @@ namespace
 		return time;
 	}
 
-#ifdef _DEBUG
+#if defined(_DEBUG) && defined(_WIN32)
 	void PrintLineToDebugOutput(const char* timeStamp, const char* line)
 	{
 		if (timeStamp)
@@ -165,7 +186,7 @@ void Logger::WriteLineCore(const char* const message)
 		{
 			std::string timeStamp = GetTimeStamp();
 
-#ifdef _DEBUG
+#if defined(_DEBUG) && defined(_WIN32)
 			PrintLineToDebugOutput(timeStamp.c_str(), message);
 #endif // _DEBUG
 
@@ -173,7 +194,7 @@ void Logger::WriteLineCore(const char* const message)
 		}
 		else
 		{
-#ifdef _DEBUG
+#if defined(_DEBUG) && defined(_WIN32)
 			PrintLineToDebugOutput(nullptr, message);
 #endif // _DEBUG
 
@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+MappedFile::MappedFile()
+	: pData(nullptr),
+	  size(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const std::filesystem::path& path, uint64_t minimumSize, uint64_t maximumSize)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileW(
+		path.c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		nullptr);
+
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		LARGE_INTEGER fileSize{};
+
+		if (GetFileSizeEx(file, &fileSize)
+			&& static_cast<uint64_t>(fileSize.QuadPart) >= minimumSize
+			&& static_cast<uint64_t>(fileSize.QuadPart) <= maximumSize
+			&& fileSize.QuadPart > 0)
+		{
+			HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+			if (mapping)
+			{
+				// The view keeps the file mapping open after the handles are closed.
+				pData = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+				if (pData)
+				{
+					size = static_cast<size_t>(fileSize.QuadPart);
+				}
+
+				CloseHandle(mapping);
+			}
+		}
+
+		CloseHandle(file);
+	}
+#else
+	const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+	if (fd >= 0)
+	{
+		struct stat fileStatus{};
+
+		if (fstat(fd, &fileStatus) == 0
+			&& static_cast<uint64_t>(fileStatus.st_size) >= minimumSize
+			&& static_cast<uint64_t>(fileStatus.st_size) <= maximumSize
+			&& fileStatus.st_size > 0)
+		{
+			void* const pView = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+			if (pView != MAP_FAILED)
+			{
+				pData = static_cast<const uint8_t*>(pView);
+				size = static_cast<size_t>(fileStatus.st_size);
+			}
+		}
+
+		// The mapping stays valid after the file descriptor is closed.
+		close(fd);
+	}
+#endif // _WIN32
+
+	return IsOpen();
+}
+
+void MappedFile::Close()
+{
+	if (pData)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(pData);
+#else
+		munmap(const_cast<uint8_t*>(pData), size);
+#endif // _WIN32
+
+		pData = nullptr;
+		size = 0;
+	}
+}
+
+bool MappedFile::IsOpen() const
+{
+	return pData != nullptr;
+}
+
+const uint8_t* MappedFile::GetData() const
+{
+	return pData;
+}
+
+size_t MappedFile::GetSize() const
+{
+	return size;
+}
@@ -0,0 +1,50 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+/**
+ * @brief A read-only memory-mapped file.
+ *
+ * The plugin's data files are mapped instead of read, so only the pages that are used are loaded from the disk.
+ */
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/**
+	 * @brief Maps a file.
+	 * @param path The file path.
+	 * @param minimumSize The minimum file size.
+	 * @param maximumSize The maximum file size, larger files are treated as corrupt.
+	 * @return True on success; otherwise, false if the file does not exist or its size is out of range.
+	 */
+	bool Open(const std::filesystem::path& path, uint64_t minimumSize, uint64_t maximumSize);
+	void Close();
+	bool IsOpen() const;
+
+	const uint8_t* GetData() const;
+	size_t GetSize() const;
+
+private:
+	const uint8_t* pData;
+	size_t size;
+};
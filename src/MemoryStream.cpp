@@ -0,0 +1,310 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "MemoryStream.h"
+#include <cstring>
+
+MemoryIStream::MemoryIStream(const uint8_t* data, size_t size)
+	: data(data),
+	  size(size),
+	  position(0),
+	  error(0)
+{
+}
+
+bool MemoryIStream::IsAtEnd() const
+{
+	return position == size;
+}
+
+bool MemoryIStream::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t MemoryIStream::AddRef()
+{
+	return 1;
+}
+
+uint32_t MemoryIStream::Release()
+{
+	return 1;
+}
+
+bool MemoryIStream::Skip(uint32_t dwBytes)
+{
+	bool result = false;
+
+	if (error == 0 && dwBytes <= size - position)
+	{
+		position += dwBytes;
+		result = true;
+	}
+	else
+	{
+		error = 1;
+	}
+
+	return result;
+}
+
+bool MemoryIStream::GetSint8(int8_t& cValueOut)
+{
+	return Read(&cValueOut, sizeof(cValueOut));
+}
+
+bool MemoryIStream::GetUint8(uint8_t& ucValueOut)
+{
+	return Read(&ucValueOut, sizeof(ucValueOut));
+}
+
+bool MemoryIStream::GetSint16(int16_t& sValueOut)
+{
+	return Read(&sValueOut, sizeof(sValueOut));
+}
+
+bool MemoryIStream::GetUint16(uint16_t& usValueOut)
+{
+	return Read(&usValueOut, sizeof(usValueOut));
+}
+
+bool MemoryIStream::GetSint32(int32_t& lValueOut)
+{
+	return Read(&lValueOut, sizeof(lValueOut));
+}
+
+bool MemoryIStream::GetUint32(uint32_t& ulValueOut)
+{
+	return Read(&ulValueOut, sizeof(ulValueOut));
+}
+
+bool MemoryIStream::GetSint64(int64_t& llValueOut)
+{
+	return Read(&llValueOut, sizeof(llValueOut));
+}
+
+bool MemoryIStream::GetUint64(uint64_t& ullValueOut)
+{
+	return Read(&ullValueOut, sizeof(ullValueOut));
+}
+
+bool MemoryIStream::GetFloat32(float& fValueOut)
+{
+	return Read(&fValueOut, sizeof(fValueOut));
+}
+
+bool MemoryIStream::GetFloat64(double& dValueOut)
+{
+	return Read(&dValueOut, sizeof(dValueOut));
+}
+
+bool MemoryIStream::GetRZCharStr(char* pszDataOut, uint32_t dwMaxBytes)
+{
+	return false;
+}
+
+bool MemoryIStream::GetGZStr(cIGZString& szDataOut)
+{
+	return false;
+}
+
+bool MemoryIStream::GetGZSerializable(cIGZSerializable& sDataOut)
+{
+	return false;
+}
+
+bool MemoryIStream::GetVoid(void* pDataOut, uint32_t dwSize)
+{
+	return Read(pDataOut, dwSize);
+}
+
+int32_t MemoryIStream::GetError()
+{
+	return error;
+}
+
+int32_t MemoryIStream::SetUserData(cIGZVariant* pData)
+{
+	return 0;
+}
+
+int32_t MemoryIStream::GetUserData()
+{
+	return 0;
+}
+
+bool MemoryIStream::Read(void* destination, size_t count)
+{
+	bool result = false;
+
+	// The values are stored in the native byte order, which is little-endian
+	// on the platforms that the game runs on.
+	if (error == 0 && destination && count <= size - position)
+	{
+		std::memcpy(destination, data + position, count);
+		position += count;
+		result = true;
+	}
+	else
+	{
+		error = 1;
+	}
+
+	return result;
+}
+
+MemoryOStream::MemoryOStream()
+	: data()
+{
+}
+
+const std::vector<uint8_t>& MemoryOStream::GetData() const
+{
+	return data;
+}
+
+bool MemoryOStream::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t MemoryOStream::AddRef()
+{
+	return 1;
+}
+
+uint32_t MemoryOStream::Release()
+{
+	return 1;
+}
+
+void MemoryOStream::Flush()
+{
+}
+
+bool MemoryOStream::SetSint8(int8_t cValue)
+{
+	return Write(&cValue, sizeof(cValue));
+}
+
+bool MemoryOStream::SetUint8(uint8_t ucValue)
+{
+	return Write(&ucValue, sizeof(ucValue));
+}
+
+bool MemoryOStream::SetSint16(int16_t sValue)
+{
+	return Write(&sValue, sizeof(sValue));
+}
+
+bool MemoryOStream::SetUint16(uint16_t usValue)
+{
+	return Write(&usValue, sizeof(usValue));
+}
+
+bool MemoryOStream::SetSint32(int32_t lValue)
+{
+	return Write(&lValue, sizeof(lValue));
+}
+
+bool MemoryOStream::SetUint32(uint32_t ulValue)
+{
+	return Write(&ulValue, sizeof(ulValue));
+}
+
+bool MemoryOStream::SetSint64(int64_t llValue)
+{
+	return Write(&llValue, sizeof(llValue));
+}
+
+bool MemoryOStream::SetUint64(uint64_t ullValue)
+{
+	return Write(&ullValue, sizeof(ullValue));
+}
+
+bool MemoryOStream::SetFloat32(float fValue)
+{
+	return Write(&fValue, sizeof(fValue));
+}
+
+bool MemoryOStream::SetFloat64(double dValue)
+{
+	return Write(&dValue, sizeof(dValue));
+}
+
+bool MemoryOStream::SetRZCharStr(char const* pszData)
+{
+	return false;
+}
+
+bool MemoryOStream::SetGZStr(cIGZString const& szData)
+{
+	return false;
+}
+
+bool MemoryOStream::SetGZSerializable(cIGZSerializable const& sData)
+{
+	return false;
+}
+
+bool MemoryOStream::SetVoid(void const* pData, uint32_t dwSize)
+{
+	return Write(pData, dwSize);
+}
+
+int32_t MemoryOStream::GetError()
+{
+	return 0;
+}
+
+int32_t MemoryOStream::SetUserData(cIGZVariant* pData)
+{
+	return 0;
+}
+
+int32_t MemoryOStream::GetUserData()
+{
+	return 0;
+}
+
+bool MemoryOStream::Write(const void* source, size_t count)
+{
+	bool result = false;
+
+	if (source)
+	{
+		const uint8_t* const bytes = static_cast<const uint8_t*>(source);
+
+		data.insert(data.end(), bytes, bytes + count);
+		result = true;
+	}
+
+	return result;
+}
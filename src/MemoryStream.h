@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cIGZIStream.h"
+#include "cIGZOStream.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Reads the serialized plugin data from a memory buffer.
+ *
+ * The stream does not copy the data, the buffer must outlive the stream.
+ * The stream is not reference counted, it is intended to be used as a local variable.
+ */
+class MemoryIStream final : public cIGZIStream
+{
+public:
+	MemoryIStream(const uint8_t* data, size_t size);
+
+	bool IsAtEnd() const;
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	bool Skip(uint32_t dwBytes) override;
+	bool GetSint8(int8_t& cValueOut) override;
+	bool GetUint8(uint8_t& ucValueOut) override;
+	bool GetSint16(int16_t& sValueOut) override;
+	bool GetUint16(uint16_t& usValueOut) override;
+	bool GetSint32(int32_t& lValueOut) override;
+	bool GetUint32(uint32_t& ulValueOut) override;
+	bool GetSint64(int64_t& llValueOut) override;
+	bool GetUint64(uint64_t& ullValueOut) override;
+	bool GetFloat32(float& fValueOut) override;
+	bool GetFloat64(double& dValueOut) override;
+	bool GetRZCharStr(char* pszDataOut, uint32_t dwMaxBytes) override;
+	bool GetGZStr(cIGZString& szDataOut) override;
+	bool GetGZSerializable(cIGZSerializable& sDataOut) override;
+	bool GetVoid(void* pDataOut, uint32_t dwSize) override;
+	int32_t GetError() override;
+	int32_t SetUserData(cIGZVariant* pData) override;
+	int32_t GetUserData() override;
+
+private:
+	bool Read(void* destination, size_t count);
+
+	const uint8_t* data;
+	size_t size;
+	size_t position;
+	int32_t error;
+};
+
+/**
+ * @brief Writes the serialized plugin data to a memory buffer.
+ *
+ * The stream is not reference counted, it is intended to be used as a local variable.
+ */
+class MemoryOStream final : public cIGZOStream
+{
+public:
+	MemoryOStream();
+
+	const std::vector<uint8_t>& GetData() const;
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	void Flush() override;
+	bool SetSint8(int8_t cValue) override;
+	bool SetUint8(uint8_t ucValue) override;
+	bool SetSint16(int16_t sValue) override;
+	bool SetUint16(uint16_t usValue) override;
+	bool SetSint32(int32_t lValue) override;
+	bool SetUint32(uint32_t ulValue) override;
+	bool SetSint64(int64_t llValue) override;
+	bool SetUint64(uint64_t ullValue) override;
+	bool SetFloat32(float fValue) override;
+	bool SetFloat64(double dValue) override;
+	bool SetRZCharStr(char const* pszData) override;
+	bool SetGZStr(cIGZString const& szData) override;
+	bool SetGZSerializable(cIGZSerializable const& sData) override;
+	bool SetVoid(void const* pData, uint32_t dwSize) override;
+	int32_t GetError() override;
+	int32_t SetUserData(cIGZVariant* pData) override;
+	int32_t GetUserData() override;
+
+private:
+	bool Write(const void* source, size_t count);
+
+	std::vector<uint8_t> data;
+};
@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstdint>
+
+// The message stream log starts with a header that contains the signature and format version,
+// followed by the records. Each record starts with a MessageStreamRecordType value.
+// All values are stored in little-endian byte order.
+
+static constexpr uint32_t MessageStreamSignature = 0x4D444243; // CBDM
+static constexpr uint32_t MessageStreamVersion = 3;
+
+enum class MessageStreamRecordType : uint8_t
+{
+	// The regional residential population as 4 Sint64 values: total, low wealth,
+	// medium wealth and high wealth.
+	// Followed by a Uint32 line item count and the custom line items that the game restored
+	// from the save game. Each line item is stored as the Uint32 department id, the Uint32
+	// budget group id, the Uint32 line item id, a Uint8 value that is 1 for income items, and the
+	// Sint64 expense, income and building count values.
+	PostCityInit = 1,
+	// No data.
+	PostCityShutdown = 2,
+	// A Uint32 exemplar index followed by a Uint32 property count and the properties.
+	// Each property is stored as a Uint32 property id, a MessageStreamPropertyType value,
+	// a Uint32 value count and the values.
+	Exemplar = 3,
+	// A Uint32 occupant id, the Uint32 index of the occupant's exemplar, the Uint64 building
+	// instance key that encodes the occupant's X and Z position, and the Sint32 building age.
+	InsertOccupant = 4,
+	// A Uint32 occupant id.
+	RemoveOccupant = 5,
+	// The city residential population as 4 Sint32 values: total, low wealth, medium wealth and high wealth.
+	// Followed by the residential population grid as the Sint32 tract shift, the Uint32 tract counts
+	// in the X and Z directions and the Uint16 tract values in row-major order. The tract counts are
+	// zero if the city has no population grid.
+	// Followed by a Uint32 line item count and the line item values after the month was processed.
+	// Each line item value is stored as the Uint32 department id, the Uint32 line item id and the
+	// Sint64 expense and income values.
+	SimNewMonth = 6,
+	// A Uint8 value that indicates if the save game contained the plugin's record, followed by
+	// the Uint32 record size and the record data.
+	Load = 7,
+	// No data.
+	Save = 8,
+};
+
+enum class MessageStreamPropertyType : uint8_t
+{
+	Uint32Array = 0,
+	Sint64Array = 1,
+	String = 2,
+};
@@ -0,0 +1,462 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "MessageStreamRecorder.h"
+#include "MessageStreamFormat.h"
+#include "BuildingInstanceArray.h"
+#include "CustomBudgetExemplarReader.h"
+#include "IPopulationProvider.h"
+#include "cGZPersistResourceKey.h"
+#include "cIGZPersistDBSegment.h"
+#include "cIGZVariant.h"
+#include "cISC4BuildingOccupant.h"
+#include "cISC4Occupant.h"
+#include "cISC4SimGrid.h"
+#include "cISCProperty.h"
+#include "cISCPropertyHolder.h"
+#include "cRZAutoRefCount.h"
+#include "cS3DVector3.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+// The exemplar properties that the plugin reads when a building is added or removed.
+static constexpr std::array<uint32_t, 16> RecordedPropertyIds =
+{
+	0xEA54D283, // Budget Item: Department
+	0xEA54D284, // Budget Item: Line
+	0xEA54D285, // Budget Item: Purpose
+	0xEA54D286, // Budget Item: Cost
+	0x90222B81, // Budget: Custom Department Budget Group
+	0x4252085F, // Budget: Custom Department Name Key
+	0x9EE1240F, // Budget: Custom Line Item Cost Algorithm
+	0x9EE12410, // Budget Custom Line Item Variable Expense/Income: Res. Total Pop.
+	0x9EE12411, // Budget Custom Line Item Variable Expense/Income: Res. Wealth Groups Pop.
+	0x9EE12412, // Budget Custom Line Item Variable Expense/Income: Tourism
+	0x9EE12413, // Budget Custom Line Item Variable Expense/Income: Formula
+	0x9EE12414, // Budget Custom Line Item Variable Expense/Income: Tiered
+	0x9EE12415, // Budget Custom Line Item Variable Expense/Income: History
+	0x9EE12416, // Budget Custom Line Item Variable Expense/Income: Building Age
+	0x9EE12417, // Budget Custom Line Item Variable Expense/Income: Res. Catchment
+	0x9EE12418, // Budget Custom Line Item Condition
+};
+
+static constexpr uint32_t kBudgetItemDepartmentProperty = 0xEA54D283;
+static constexpr uint32_t kCustomBudgetDepartmentBudgetGroupProperty = 0x90222B81;
+static constexpr uint32_t kCustomBudgetDepartmentNameKeyProperty = 0x4252085F;
+
+static constexpr size_t FlushThreshold = 64 * 1024;
+
+namespace
+{
+	template<typename T> void AppendValue(std::string& destination, T value)
+	{
+		destination.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	bool AppendProperty(std::string& destination, const cISCPropertyHolder* pPropertyHolder, uint32_t id)
+	{
+		const cISCProperty* pProperty = pPropertyHolder->GetProperty(id);
+
+		if (pProperty)
+		{
+			const cIGZVariant* pVariant = pProperty->GetPropertyValue();
+
+			if (pVariant)
+			{
+				const uint32_t count = pVariant->GetCount();
+
+				switch (pVariant->GetType())
+				{
+				case cIGZVariant::Type::Uint32Array:
+					AppendValue(destination, id);
+					AppendValue(destination, MessageStreamPropertyType::Uint32Array);
+					AppendValue(destination, count);
+					destination.append(reinterpret_cast<const char*>(pVariant->RefUint32()), count * sizeof(uint32_t));
+					return true;
+				case cIGZVariant::Type::Sint64Array:
+					AppendValue(destination, id);
+					AppendValue(destination, MessageStreamPropertyType::Sint64Array);
+					AppendValue(destination, count);
+					destination.append(reinterpret_cast<const char*>(pVariant->RefSint64()), count * sizeof(int64_t));
+					return true;
+				case cIGZVariant::Type::CharArray:
+					AppendValue(destination, id);
+					AppendValue(destination, MessageStreamPropertyType::String);
+					AppendValue(destination, count);
+					destination.append(pVariant->RefChar(), count);
+					return true;
+				default:
+					break;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	bool AppendResolvedDepartmentProperty(
+		std::string& destination,
+		const cISCPropertyHolder* pPropertyHolder,
+		uint32_t id,
+		const DepartmentDefinitionTable& definitions)
+	{
+		const cISCProperty* pProperty = pPropertyHolder->GetProperty(kBudgetItemDepartmentProperty);
+
+		if (!pProperty)
+		{
+			return false;
+		}
+
+		const cIGZVariant* pVariant = pProperty->GetPropertyValue();
+
+		if (!pVariant || pVariant->GetType() != cIGZVariant::Type::Uint32Array)
+		{
+			return false;
+		}
+
+		const uint32_t* const pDepartments = pVariant->RefUint32();
+		const uint32_t departmentCount = pVariant->GetCount();
+
+		std::vector<uint32_t> values;
+
+		for (uint32_t i = 0; i < departmentCount; i++)
+		{
+			const uint32_t department = pDepartments[i];
+
+			if (std::find(pDepartments, pDepartments + i, department) != pDepartments + i)
+			{
+				continue;
+			}
+
+			DepartmentDefinition definition{};
+
+			if (CustomBudgetExemplarReader::GetDepartmentDefinition(pPropertyHolder, department, &definitions, definition))
+			{
+				values.push_back(department);
+
+				if (id == kCustomBudgetDepartmentBudgetGroupProperty)
+				{
+					values.push_back(definition.budgetGroup);
+				}
+				else
+				{
+					values.push_back(definition.nameKey.groupID);
+					values.push_back(definition.nameKey.instanceID);
+				}
+			}
+		}
+
+		if (values.empty())
+		{
+			return false;
+		}
+
+		AppendValue(destination, id);
+		AppendValue(destination, MessageStreamPropertyType::Uint32Array);
+		AppendValue(destination, static_cast<uint32_t>(values.size()));
+		destination.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(uint32_t));
+
+		return true;
+	}
+}
+
+MessageStreamRecorder& MessageStreamRecorder::GetInstance()
+{
+	static MessageStreamRecorder recorder;
+
+	return recorder;
+}
+
+MessageStreamRecorder::MessageStreamRecorder()
+	: initialized(false),
+	  nextOccupantId(0),
+	  stream(),
+	  buffer(),
+	  occupantIds(),
+	  exemplarIndices(),
+	  pDepartmentDefinitions(nullptr)
+{
+}
+
+void MessageStreamRecorder::Init(std::filesystem::path logFilePath)
+{
+	if (!initialized)
+	{
+		stream.open(logFilePath, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+		if (stream)
+		{
+			initialized = true;
+
+			WriteValue(MessageStreamSignature);
+			WriteValue(MessageStreamVersion);
+			Flush();
+		}
+	}
+}
+
+bool MessageStreamRecorder::IsEnabled() const
+{
+	return initialized;
+}
+
+void MessageStreamRecorder::SetDepartmentDefinitions(const DepartmentDefinitionTable* pDefinitions)
+{
+	pDepartmentDefinitions = pDefinitions;
+}
+
+void MessageStreamRecorder::RecordPostCityInit(
+	IPopulationProvider& populationProvider,
+	const std::vector<MessageStreamLineItem>& lineItems)
+{
+	if (initialized)
+	{
+		WriteValue(MessageStreamRecordType::PostCityInit);
+		WriteValue(populationProvider.GetRegionResidentialPopulation());
+		WriteValue(populationProvider.GetRegionPopulation(0x1010));
+		WriteValue(populationProvider.GetRegionPopulation(0x1020));
+		WriteValue(populationProvider.GetRegionPopulation(0x1030));
+		WriteValue(static_cast<uint32_t>(lineItems.size()));
+
+		for (const MessageStreamLineItem& lineItem : lineItems)
+		{
+			WriteValue(lineItem.department);
+			WriteValue(lineItem.budgetGroup);
+			WriteValue(lineItem.lineNumber);
+			WriteValue(static_cast<uint8_t>(lineItem.isIncome ? 1 : 0));
+			WriteValue(lineItem.expenses);
+			WriteValue(lineItem.income);
+			WriteValue(lineItem.buildingCount);
+		}
+	}
+}
+
+void MessageStreamRecorder::RecordPostCityShutdown()
+{
+	if (initialized)
+	{
+		WriteValue(MessageStreamRecordType::PostCityShutdown);
+		Flush();
+
+		// The occupant and exemplar ids are only valid for a single city.
+		occupantIds.clear();
+		exemplarIndices.clear();
+		nextOccupantId = 0;
+	}
+}
+
+void MessageStreamRecorder::RecordInsertOccupant(cISC4Occupant* pOccupant)
+{
+	if (initialized)
+	{
+		const uint32_t exemplarIndex = GetOrAddExemplar(pOccupant->AsPropertyHolder());
+		const uint32_t occupantId = nextOccupantId++;
+
+		occupantIds.insert_or_assign(pOccupant, occupantId);
+
+		// The BuildingAge and ResidentialCatchment algorithms depend on the building's position and age.
+		cS3DVector3 position;
+		pOccupant->GetPosition(&position);
+
+		int32_t buildingAge = 0;
+		cRZAutoRefCount<cISC4BuildingOccupant> buildingOccupant;
+
+		if (pOccupant->QueryInterface(GZIID_cISC4BuildingOccupant, buildingOccupant.AsPPVoid()))
+		{
+			buildingAge = buildingOccupant->GetBuildingAge();
+		}
+
+		WriteValue(MessageStreamRecordType::InsertOccupant);
+		WriteValue(occupantId);
+		WriteValue(exemplarIndex);
+		WriteValue(BuildingInstanceArray::CreateKey(position.fX, position.fZ));
+		WriteValue(buildingAge);
+	}
+}
+
+void MessageStreamRecorder::RecordRemoveOccupant(cISC4Occupant* pOccupant)
+{
+	if (initialized)
+	{
+		const auto& item = occupantIds.find(pOccupant);
+
+		if (item != occupantIds.end())
+		{
+			WriteValue(MessageStreamRecordType::RemoveOccupant);
+			WriteValue(item->second);
+
+			// The game can reuse the occupant pointer for a new building.
+			occupantIds.erase(item);
+		}
+	}
+}
+
+void MessageStreamRecorder::RecordSimNewMonth(
+	IPopulationProvider& populationProvider,
+	cISC4SimGrid<uint16_t>* pPopulationGrid,
+	const std::vector<MessageStreamLineItem>& lineItems)
+{
+	if (initialized)
+	{
+		WriteValue(MessageStreamRecordType::SimNewMonth);
+		WriteValue(populationProvider.GetCityResidentialPopulation());
+		WriteValue(populationProvider.GetCityPopulation(0x1010));
+		WriteValue(populationProvider.GetCityPopulation(0x1020));
+		WriteValue(populationProvider.GetCityPopulation(0x1030));
+		WritePopulationGrid(pPopulationGrid);
+		WriteValue(static_cast<uint32_t>(lineItems.size()));
+
+		for (const MessageStreamLineItem& lineItem : lineItems)
+		{
+			WriteValue(lineItem.department);
+			WriteValue(lineItem.lineNumber);
+			WriteValue(lineItem.expenses);
+			WriteValue(lineItem.income);
+		}
+	}
+}
+
+void MessageStreamRecorder::RecordLoad(cIGZPersistDBSegment* pSegment, const cGZPersistResourceKey& key)
+{
+	if (initialized)
+	{
+		std::vector<uint8_t> record;
+
+		const bool hasRecord = pSegment && pSegment->TestForRecord(key);
+
+		if (hasRecord)
+		{
+			uint32_t recordSize = pSegment->GetRecordSize(key);
+			record.resize(recordSize);
+
+			if (recordSize > 0)
+			{
+				recordSize = pSegment->ReadRecord(key, record.data(), recordSize);
+				record.resize(recordSize);
+			}
+		}
+
+		WriteValue(MessageStreamRecordType::Load);
+		WriteValue(static_cast<uint8_t>(hasRecord ? 1 : 0));
+		WriteValue(static_cast<uint32_t>(record.size()));
+		WriteBytes(record.data(), record.size());
+	}
+}
+
+void MessageStreamRecorder::RecordSave()
+{
+	if (initialized)
+	{
+		WriteValue(MessageStreamRecordType::Save);
+		Flush();
+	}
+}
+
+uint32_t MessageStreamRecorder::GetOrAddExemplar(const cISCPropertyHolder* pPropertyHolder)
+{
+	std::string properties;
+	uint32_t propertyCount = 0;
+
+	if (pPropertyHolder)
+	{
+		const bool resolveDepartments = pDepartmentDefinitions && !pDepartmentDefinitions->IsEmpty();
+
+		for (uint32_t id : RecordedPropertyIds)
+		{
+			if (resolveDepartments
+				&& (id == kCustomBudgetDepartmentBudgetGroupProperty || id == kCustomBudgetDepartmentNameKeyProperty))
+			{
+				if (AppendResolvedDepartmentProperty(properties, pPropertyHolder, id, *pDepartmentDefinitions))
+				{
+					propertyCount++;
+				}
+			}
+			else if (AppendProperty(properties, pPropertyHolder, id))
+			{
+				propertyCount++;
+			}
+		}
+	}
+
+	const uint32_t nextExemplarIndex = static_cast<uint32_t>(exemplarIndices.size());
+
+	auto result = exemplarIndices.try_emplace(properties, nextExemplarIndex);
+
+	if (result.second)
+	{
+		WriteValue(MessageStreamRecordType::Exemplar);
+		WriteValue(nextExemplarIndex);
+		WriteValue(propertyCount);
+		WriteBytes(properties.data(), properties.size());
+	}
+
+	return result.first->second;
+}
+
+void MessageStreamRecorder::WritePopulationGrid(cISC4SimGrid<uint16_t>* pGrid)
+{
+	// The ResidentialCatchment algorithm reads the grid when the month is processed.
+	int32_t tractShift = 0;
+	uint32_t tractCountX = 0;
+	uint32_t tractCountZ = 0;
+
+	if (pGrid)
+	{
+		tractShift = pGrid->GetTractShift();
+		tractCountX = static_cast<uint32_t>(std::max(pGrid->GetTractCountX(), 0));
+		tractCountZ = static_cast<uint32_t>(std::max(pGrid->GetTractCountZ(), 0));
+	}
+
+	WriteValue(tractShift);
+	WriteValue(tractCountX);
+	WriteValue(tractCountZ);
+
+	for (uint32_t z = 0; z < tractCountZ; z++)
+	{
+		for (uint32_t x = 0; x < tractCountX; x++)
+		{
+			WriteValue(pGrid->GetTractValue(static_cast<int32_t>(x), static_cast<int32_t>(z)));
+		}
+	}
+}
+
+template<typename T> void MessageStreamRecorder::WriteValue(T value)
+{
+	WriteBytes(&value, sizeof(T));
+}
+
+void MessageStreamRecorder::WriteBytes(const void* data, size_t size)
+{
+	if (size > 0)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+		buffer.insert(buffer.end(), bytes, bytes + size);
+
+		if (buffer.size() >= FlushThreshold)
+		{
+			Flush();
+		}
+	}
+}
+
+void MessageStreamRecorder::Flush()
+{
+	if (!buffer.empty())
+	{
+		stream.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+		stream.flush();
+		buffer.clear();
+	}
+}
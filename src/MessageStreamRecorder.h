@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class cGZPersistResourceKey;
+class cIGZPersistDBSegment;
+class cISC4Occupant;
+class cISCPropertyHolder;
+class DepartmentDefinitionTable;
+class IPopulationProvider;
+template<typename T> class cISC4SimGrid;
+
+struct MessageStreamLineItem
+{
+	uint32_t department;
+	uint32_t budgetGroup;
+	uint32_t lineNumber;
+	bool isIncome;
+	int64_t expenses;
+	int64_t income;
+	int64_t buildingCount;
+};
+
+/**
+ * @brief Records the game messages that the plugin handles as a compact binary log.
+ *
+ * The log contains the inputs that are required to drive the plugin outside of the game,
+ * see MessageStreamFormat.h for the format. The recorder is disabled unless Init is called.
+ */
+class MessageStreamRecorder
+{
+public:
+
+	static MessageStreamRecorder& GetInstance();
+
+	void Init(std::filesystem::path logFilePath);
+
+	bool IsEnabled() const;
+
+	/**
+	 * @brief Sets the shared department definitions.
+	 *
+	 * The definitions are not recorded, the exemplars that use them are recorded with the
+	 * budget group and name key properties that the definitions provide.
+	 */
+	void SetDepartmentDefinitions(const DepartmentDefinitionTable* pDefinitions);
+
+	void RecordPostCityInit(
+		IPopulationProvider& populationProvider,
+		const std::vector<MessageStreamLineItem>& lineItems);
+	void RecordPostCityShutdown();
+	void RecordInsertOccupant(cISC4Occupant* pOccupant);
+	void RecordRemoveOccupant(cISC4Occupant* pOccupant);
+	void RecordSimNewMonth(
+		IPopulationProvider& populationProvider,
+		cISC4SimGrid<uint16_t>* pPopulationGrid,
+		const std::vector<MessageStreamLineItem>& lineItems);
+	void RecordLoad(cIGZPersistDBSegment* pSegment, const cGZPersistResourceKey& key);
+	void RecordSave();
+
+private:
+
+	MessageStreamRecorder();
+
+	uint32_t GetOrAddExemplar(const cISCPropertyHolder* pPropertyHolder);
+	void WritePopulationGrid(cISC4SimGrid<uint16_t>* pGrid);
+
+	template<typename T> void WriteValue(T value);
+	void WriteBytes(const void* data, size_t size);
+	void Flush();
+
+	bool initialized;
+	uint32_t nextOccupantId;
+	std::ofstream stream;
+	std::vector<uint8_t> buffer;
+	std::unordered_map<const cISC4Occupant*, uint32_t> occupantIds;
+	// The exemplars are identified by their serialized property data.
+	std::unordered_map<std::string, uint32_t> exemplarIndices;
+	const DepartmentDefinitionTable* pDepartmentDefinitions;
+};
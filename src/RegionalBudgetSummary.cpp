@@ -0,0 +1,503 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "RegionalBudgetSummary.h"
+#include "cIGZIStream.h"
+#include "cIGZOStream.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <tuple>
+#include <utility>
+
+namespace
+{
+	// The summary is stored in the native byte order, which is little-endian
+	// on the platforms that the game runs on.
+	// The record sizes are multiples of 8, so the records in the mapped file are aligned.
+
+	constexpr uint32_t SummarySignature = 0x53524243; // CBRS
+
+	// A summary that is larger than this is treated as corrupt.
+	constexpr uint64_t MaxSummarySize = 64 * 1024 * 1024;
+
+	constexpr uint32_t CitySummaryVersion = 1;
+
+	// Limits the allocation when reading a corrupt save game record.
+	constexpr uint32_t MaxCitySummaryDepartmentCount = 65536;
+
+	struct SummaryHeader
+	{
+		uint32_t signature;
+		uint32_t version;
+		uint32_t cityCount;
+		uint32_t departmentCount;
+		uint32_t cityDepartmentCount;
+		uint32_t reserved;
+		int64_t expenses;
+		int64_t income;
+	};
+
+	struct CityRecord
+	{
+		int32_t tileX;
+		int32_t tileZ;
+		uint32_t firstDepartment;
+		uint32_t departmentCount;
+		int64_t residentialPopulation;
+		int64_t expenses;
+		int64_t income;
+	};
+
+	struct DepartmentRecord
+	{
+		uint32_t department;
+		uint32_t budgetGroup;
+		uint32_t cityCount;
+		uint32_t reserved;
+		int64_t expenses;
+		int64_t income;
+	};
+
+	static_assert(sizeof(SummaryHeader) == 40);
+	static_assert(sizeof(CityRecord) == 40);
+	static_assert(sizeof(DepartmentRecord) == 32);
+
+	const DepartmentRecord* FindDepartment(const DepartmentRecord* first, const DepartmentRecord* last, uint32_t department)
+	{
+		const DepartmentRecord* const record = std::lower_bound(
+			first,
+			last,
+			department,
+			[](const DepartmentRecord& item, uint32_t value) { return item.department < value; });
+
+		return record != last && record->department == department ? record : nullptr;
+	}
+
+	template<typename T> void WriteRecord(std::ofstream& stream, const T& record)
+	{
+		stream.write(reinterpret_cast<const char*>(&record), sizeof(record));
+	}
+}
+
+CustomBudgetCitySummary::CustomBudgetCitySummary()
+	: tileX(0),
+	  tileZ(0),
+	  residentialPopulation(0),
+	  departments()
+{
+}
+
+bool CustomBudgetCitySummary::Read(cIGZIStream& stream)
+{
+	uint32_t version = 0;
+	uint32_t departmentCount = 0;
+
+	if (!stream.GetUint32(version)
+		|| version != CitySummaryVersion
+		|| !stream.GetSint32(tileX)
+		|| !stream.GetSint32(tileZ)
+		|| !stream.GetSint64(residentialPopulation)
+		|| !stream.GetUint32(departmentCount)
+		|| departmentCount > MaxCitySummaryDepartmentCount)
+	{
+		return false;
+	}
+
+	departments.resize(departmentCount);
+
+	for (CustomBudgetCityDepartmentTotals& item : departments)
+	{
+		if (!stream.GetUint32(item.department)
+			|| !stream.GetUint32(item.budgetGroup)
+			|| !stream.GetSint64(item.expenses)
+			|| !stream.GetSint64(item.income))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool CustomBudgetCitySummary::Write(cIGZOStream& stream) const
+{
+	if (!stream.SetUint32(CitySummaryVersion)
+		|| !stream.SetSint32(tileX)
+		|| !stream.SetSint32(tileZ)
+		|| !stream.SetSint64(residentialPopulation)
+		|| !stream.SetUint32(static_cast<uint32_t>(departments.size())))
+	{
+		return false;
+	}
+
+	for (const CustomBudgetCityDepartmentTotals& item : departments)
+	{
+		if (!stream.SetUint32(item.department)
+			|| !stream.SetUint32(item.budgetGroup)
+			|| !stream.SetSint64(item.expenses)
+			|| !stream.SetSint64(item.income))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+RegionalBudgetSummary::RegionalBudgetSummary()
+	: file(),
+	  retainedData(),
+	  retainedSize(0),
+	  retainedPath(),
+	  retainedWriteTime(),
+	  fileWriteTime(),
+	  filePath(),
+	  cityCount(0),
+	  departmentCount(0),
+	  cityDepartmentCount(0),
+	  pCities(nullptr),
+	  pDepartments(nullptr),
+	  pCityDepartments(nullptr),
+	  pCurrentCity(nullptr),
+	  regionExpenses(0),
+	  regionIncome(0)
+{
+}
+
+bool RegionalBudgetSummary::Open(const std::filesystem::path& path, int32_t cityTileX, int32_t cityTileZ)
+{
+	Close();
+
+	std::error_code ec;
+	const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(path, ec);
+
+	if (ec)
+	{
+		return false;
+	}
+
+	if (!retainedData.empty() && retainedPath == path && retainedWriteTime == writeTime)
+	{
+		const uint64_t fileSize = std::filesystem::file_size(path, ec);
+
+		if (!ec && fileSize == retainedSize)
+		{
+			return Attach(reinterpret_cast<const uint8_t*>(retainedData.data()), retainedSize, cityTileX, cityTileZ);
+		}
+	}
+
+	retainedData.clear();
+	retainedData.shrink_to_fit();
+	retainedSize = 0;
+	retainedPath.clear();
+
+	if (file.Open(path, sizeof(SummaryHeader), MaxSummarySize))
+	{
+		if (Attach(file.GetData(), file.GetSize(), cityTileX, cityTileZ))
+		{
+			filePath = path;
+			fileWriteTime = writeTime;
+		}
+		else
+		{
+			file.Close();
+		}
+	}
+
+	return IsOpen();
+}
+
+void RegionalBudgetSummary::Close()
+{
+	if (file.IsOpen())
+	{
+		if (IsOpen() && file.GetSize() <= MaxRetainedSize)
+		{
+			// The buffer is made of 8 byte values to keep the records aligned.
+			retainedData.resize((file.GetSize() + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+			std::memcpy(retainedData.data(), file.GetData(), file.GetSize());
+			retainedSize = file.GetSize();
+			retainedPath = filePath;
+			retainedWriteTime = fileWriteTime;
+		}
+
+		file.Close();
+		filePath.clear();
+	}
+
+	Detach();
+}
+
+void RegionalBudgetSummary::Clear()
+{
+	Close();
+	retainedData.clear();
+	retainedData.shrink_to_fit();
+	retainedSize = 0;
+	retainedPath.clear();
+}
+
+bool RegionalBudgetSummary::IsOpen() const
+{
+	return pCities != nullptr;
+}
+
+size_t RegionalBudgetSummary::GetCityCount() const
+{
+	return cityCount;
+}
+
+bool RegionalBudgetSummary::GetRegionDepartmentTotals(uint32_t department, BudgetTotals& totals) const
+{
+	bool result = false;
+
+	totals.expenses = 0;
+	totals.income = 0;
+
+	if (IsOpen())
+	{
+		const DepartmentRecord* const regionFirst = reinterpret_cast<const DepartmentRecord*>(pDepartments);
+		const DepartmentRecord* const region = FindDepartment(regionFirst, regionFirst + departmentCount, department);
+
+		if (region)
+		{
+			uint32_t otherCityCount = region->cityCount;
+			totals.expenses = region->expenses;
+			totals.income = region->income;
+
+			if (pCurrentCity)
+			{
+				const CityRecord* const city = reinterpret_cast<const CityRecord*>(pCurrentCity);
+				const DepartmentRecord* const cityFirst = reinterpret_cast<const DepartmentRecord*>(pCityDepartments) + city->firstDepartment;
+				const DepartmentRecord* const current = FindDepartment(cityFirst, cityFirst + city->departmentCount, department);
+
+				if (current)
+				{
+					otherCityCount--;
+					totals.expenses -= current->expenses;
+					totals.income -= current->income;
+				}
+			}
+
+			result = otherCityCount > 0;
+		}
+	}
+
+	return result;
+}
+
+int64_t RegionalBudgetSummary::GetRegionCustomBudgetExpenses()
+{
+	return regionExpenses;
+}
+
+int64_t RegionalBudgetSummary::GetRegionCustomBudgetIncome()
+{
+	return regionIncome;
+}
+
+bool RegionalBudgetSummary::Write(const std::filesystem::path& path, const std::vector<CustomBudgetCitySummary>& cities)
+{
+	// A city that was saved more than once uses its last summary.
+	std::map<std::pair<int32_t, int32_t>, const CustomBudgetCitySummary*> sortedCities;
+
+	for (const CustomBudgetCitySummary& city : cities)
+	{
+		sortedCities.insert_or_assign(std::make_pair(city.tileX, city.tileZ), &city);
+	}
+
+	SummaryHeader header{};
+	header.signature = SummarySignature;
+	header.version = CurrentVersion;
+	header.cityCount = static_cast<uint32_t>(sortedCities.size());
+
+	std::vector<CityRecord> cityRecords;
+	std::vector<DepartmentRecord> cityDepartmentRecords;
+	std::map<uint32_t, DepartmentRecord> regionDepartments;
+
+	cityRecords.reserve(sortedCities.size());
+
+	for (const auto& [position, pCity] : sortedCities)
+	{
+		std::map<uint32_t, DepartmentRecord> cityDepartments;
+
+		for (const CustomBudgetCityDepartmentTotals& item : pCity->departments)
+		{
+			DepartmentRecord& record = cityDepartments[item.department];
+			record.department = item.department;
+			record.budgetGroup = item.budgetGroup;
+			record.cityCount = 1;
+			record.expenses += item.expenses;
+			record.income += item.income;
+		}
+
+		CityRecord cityRecord{};
+		cityRecord.tileX = pCity->tileX;
+		cityRecord.tileZ = pCity->tileZ;
+		cityRecord.firstDepartment = static_cast<uint32_t>(cityDepartmentRecords.size());
+		cityRecord.departmentCount = static_cast<uint32_t>(cityDepartments.size());
+		cityRecord.residentialPopulation = pCity->residentialPopulation;
+
+		for (const auto& [department, record] : cityDepartments)
+		{
+			cityRecord.expenses += record.expenses;
+			cityRecord.income += record.income;
+
+			DepartmentRecord& regionRecord = regionDepartments[department];
+			regionRecord.department = department;
+			regionRecord.budgetGroup = record.budgetGroup;
+			regionRecord.cityCount++;
+			regionRecord.expenses += record.expenses;
+			regionRecord.income += record.income;
+
+			cityDepartmentRecords.push_back(record);
+		}
+
+		header.expenses += cityRecord.expenses;
+		header.income += cityRecord.income;
+
+		cityRecords.push_back(cityRecord);
+	}
+
+	header.departmentCount = static_cast<uint32_t>(regionDepartments.size());
+	header.cityDepartmentCount = static_cast<uint32_t>(cityDepartmentRecords.size());
+
+	std::filesystem::path temporaryPath = path;
+	temporaryPath += ".tmp";
+
+	{
+		std::ofstream stream(temporaryPath, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+		if (!stream)
+		{
+			return false;
+		}
+
+		WriteRecord(stream, header);
+
+		for (const CityRecord& record : cityRecords)
+		{
+			WriteRecord(stream, record);
+		}
+
+		for (const auto& [department, record] : regionDepartments)
+		{
+			WriteRecord(stream, record);
+		}
+
+		for (const DepartmentRecord& record : cityDepartmentRecords)
+		{
+			WriteRecord(stream, record);
+		}
+
+		if (!stream)
+		{
+			stream.close();
+
+			std::error_code errorCode;
+			std::filesystem::remove(temporaryPath, errorCode);
+
+			return false;
+		}
+	}
+
+	std::error_code errorCode;
+	std::filesystem::rename(temporaryPath, path, errorCode);
+
+	return !errorCode;
+}
+
+bool RegionalBudgetSummary::Attach(const uint8_t* pData, uint64_t size, int32_t cityTileX, int32_t cityTileZ)
+{
+	if (size < sizeof(SummaryHeader))
+	{
+		return false;
+	}
+
+	const SummaryHeader* const pHeader = reinterpret_cast<const SummaryHeader*>(pData);
+
+	const uint64_t expectedSize = sizeof(SummaryHeader)
+		+ (static_cast<uint64_t>(pHeader->cityCount) * sizeof(CityRecord))
+		+ ((static_cast<uint64_t>(pHeader->departmentCount) + pHeader->cityDepartmentCount) * sizeof(DepartmentRecord));
+
+	if (pHeader->signature != SummarySignature
+		|| pHeader->version != CurrentVersion
+		|| expectedSize != size)
+	{
+		return false;
+	}
+
+	const DepartmentRecord* const regionFirst = reinterpret_cast<const DepartmentRecord*>(
+		pData + sizeof(SummaryHeader) + (static_cast<uint64_t>(pHeader->cityCount) * sizeof(CityRecord)));
+
+	// Every region department is used by at least one city, GetRegionDepartmentTotals subtracts
+	// the current city from the count.
+	if (std::any_of(
+		regionFirst,
+		regionFirst + pHeader->departmentCount,
+		[](const DepartmentRecord& item) { return item.cityCount == 0; }))
+	{
+		return false;
+	}
+
+	cityCount = pHeader->cityCount;
+	departmentCount = pHeader->departmentCount;
+	cityDepartmentCount = pHeader->cityDepartmentCount;
+	pCities = pData + sizeof(SummaryHeader);
+	pDepartments = pCities + (cityCount * sizeof(CityRecord));
+	pCityDepartments = pDepartments + (departmentCount * sizeof(DepartmentRecord));
+	regionExpenses = pHeader->expenses;
+	regionIncome = pHeader->income;
+
+	const CityRecord* const first = reinterpret_cast<const CityRecord*>(pCities);
+	const CityRecord* const last = first + cityCount;
+
+	const CityRecord* const city = std::lower_bound(
+		first,
+		last,
+		std::make_pair(cityTileX, cityTileZ),
+		[](const CityRecord& item, const std::pair<int32_t, int32_t>& value)
+		{
+			return std::tie(item.tileX, item.tileZ) < std::tie(value.first, value.second);
+		});
+
+	// The current city's totals in the summary are from its last save, the live values
+	// are used instead.
+	if (city != last
+		&& city->tileX == cityTileX
+		&& city->tileZ == cityTileZ
+		&& city->firstDepartment <= cityDepartmentCount
+		&& city->departmentCount <= cityDepartmentCount - city->firstDepartment)
+	{
+		pCurrentCity = reinterpret_cast<const uint8_t*>(city);
+		regionExpenses -= city->expenses;
+		regionIncome -= city->income;
+	}
+
+	return true;
+}
+
+void RegionalBudgetSummary::Detach()
+{
+	cityCount = 0;
+	departmentCount = 0;
+	cityDepartmentCount = 0;
+	pCities = nullptr;
+	pDepartments = nullptr;
+	pCityDepartments = nullptr;
+	pCurrentCity = nullptr;
+	regionExpenses = 0;
+	regionIncome = 0;
+}
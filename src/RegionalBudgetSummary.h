@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "CustomBudgetTotals.h"
+#include "IRegionalBudgetProvider.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+class cIGZIStream;
+class cIGZOStream;
+
+struct CustomBudgetCityDepartmentTotals
+{
+	uint32_t department;
+	uint32_t budgetGroup;
+	int64_t expenses;
+	int64_t income;
+};
+
+/**
+ * @brief The custom budget department totals that the plugin writes to the city save game.
+ *
+ * The record is separate from the line item transactions, so the region scanner can read
+ * the totals of a city without loading it in the game.
+ */
+struct CustomBudgetCitySummary
+{
+	int32_t tileX;
+	int32_t tileZ;
+	int64_t residentialPopulation;
+	// Sorted by department id.
+	std::vector<CustomBudgetCityDepartmentTotals> departments;
+
+	CustomBudgetCitySummary();
+
+	bool Read(cIGZIStream& stream);
+	bool Write(cIGZOStream& stream) const;
+};
+
+/**
+ * @brief The custom budget department totals of the cities in a region.
+ *
+ * The summary file is written by the CustomBudgetDepartmentsRegionScan tool from the region's save games.
+ * The plugin maps the file when a city is loaded, the region totals are stored in the file and the current
+ * city's totals are subtracted from them, so the file is not parsed and its size does not affect the load time.
+ *
+ * A small summary is copied to memory when it is closed, so switching to another city in the same region
+ * does not map and validate the file again unless the file was modified. The copy also keeps the file
+ * from being locked while the player is in the region view.
+ */
+class RegionalBudgetSummary final : public IRegionalBudgetProvider
+{
+public:
+	static constexpr uint32_t CurrentVersion = 1;
+	// The largest summary that is kept in memory between cities.
+	static constexpr uint64_t MaxRetainedSize = 1024 * 1024;
+
+	RegionalBudgetSummary();
+
+	/**
+	 * @brief Maps a region summary file.
+	 * @param path The summary file path.
+	 * @param cityTileX The tile x position of the current city, its totals are not included in the region totals.
+	 * @param cityTileZ The tile z position of the current city.
+	 * @return True on success; otherwise, false if the file does not exist or is not valid.
+	 */
+	bool Open(const std::filesystem::path& path, int32_t cityTileX, int32_t cityTileZ);
+	/**
+	 * @brief Closes the summary, keeping a copy of its data for the next Open call if the file is small.
+	 */
+	void Close();
+	/**
+	 * @brief Closes the summary and discards the copy of its data.
+	 */
+	void Clear();
+	bool IsOpen() const;
+
+	/**
+	 * @brief Gets the number of cities in the summary, including the current city.
+	 */
+	size_t GetCityCount() const;
+
+	/**
+	 * @brief Gets the totals of a custom budget department in the other cities of the region.
+	 * @param department The department id.
+	 * @param totals Receives the expenses and income of the department in the other cities.
+	 * @return True if another city in the region has the department; otherwise, false.
+	 */
+	bool GetRegionDepartmentTotals(uint32_t department, BudgetTotals& totals) const;
+
+	int64_t GetRegionCustomBudgetExpenses() override;
+	int64_t GetRegionCustomBudgetIncome() override;
+
+	/**
+	 * @brief Writes a region summary file.
+	 * @param path The summary file path.
+	 * @param cities The city summaries, a city that appears more than once uses the last summary.
+	 * @return True on success; otherwise, false.
+	 */
+	static bool Write(const std::filesystem::path& path, const std::vector<CustomBudgetCitySummary>& cities);
+
+private:
+	bool Attach(const uint8_t* pData, uint64_t size, int32_t cityTileX, int32_t cityTileZ);
+	void Detach();
+
+	MappedFile file;
+	// The data of the last summary that was closed, and the file properties used to check if it changed.
+	std::vector<uint64_t> retainedData;
+	uint64_t retainedSize;
+	std::filesystem::path retainedPath;
+	std::filesystem::file_time_type retainedWriteTime;
+	// The write time of the mapped file.
+	std::filesystem::file_time_type fileWriteTime;
+	std::filesystem::path filePath;
+	size_t cityCount;
+	size_t departmentCount;
+	size_t cityDepartmentCount;
+	const uint8_t* pCities;
+	const uint8_t* pDepartments;
+	const uint8_t* pCityDepartments;
+	// The current city's record, or null if the current city is not in the summary.
+	const uint8_t* pCurrentCity;
+	int64_t regionExpenses;
+	int64_t regionIncome;
+};
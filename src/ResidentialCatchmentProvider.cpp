@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "ResidentialCatchmentProvider.h"
+#include "cISC4App.h"
+#include "cISC4City.h"
+#include "cISC4ResidentialSimulator.h"
+#include "cISC4SimGrid.h"
+#include "GZServPtrs.h"
+#include <algorithm>
+#include <cmath>
+
+ResidentialCatchmentProvider::ResidentialCatchmentProvider()
+	: pResidentialSimulator(nullptr),
+	  populationTable(),
+	  populationValues(),
+	  oneOverTractWidthX(0.0f),
+	  oneOverTractWidthZ(0.0f),
+	  tableValid(false)
+{
+}
+
+bool ResidentialCatchmentProvider::Init()
+{
+	bool result = false;
+
+	cISC4AppPtr pSC4App;
+
+	if (pSC4App)
+	{
+		cISC4City* pCity = pSC4App->GetCity();
+
+		if (pCity)
+		{
+			pResidentialSimulator = pCity->GetResidentialSimulator();
+
+			result = pResidentialSimulator != nullptr;
+		}
+	}
+
+	Invalidate();
+
+	return result;
+}
+
+bool ResidentialCatchmentProvider::Shutdown()
+{
+	pResidentialSimulator = nullptr;
+	populationTable.Clear();
+	populationValues.clear();
+	populationValues.shrink_to_fit();
+	Invalidate();
+
+	return true;
+}
+
+void ResidentialCatchmentProvider::Invalidate()
+{
+	tableValid = false;
+}
+
+int64_t ResidentialCatchmentProvider::GetResidentialPopulation(float x, float z, float radius)
+{
+	if (!tableValid && !UpdateTable())
+	{
+		return 0;
+	}
+
+	const int32_t tractCountX = populationTable.GetWidth();
+	const int32_t tractCountZ = populationTable.GetHeight();
+
+	return populationTable.GetSum(
+		PositionToTract(x - radius, oneOverTractWidthX, tractCountX),
+		PositionToTract(z - radius, oneOverTractWidthZ, tractCountZ),
+		PositionToTract(x + radius, oneOverTractWidthX, tractCountX),
+		PositionToTract(z + radius, oneOverTractWidthZ, tractCountZ));
+}
+
+cISC4SimGrid<uint16_t>* ResidentialCatchmentProvider::GetPopulationGrid() const
+{
+	// The other two grid parameters are not used by the plugin.
+	cISC4SimGrid<uint16_t>* pGrid = nullptr;
+
+	if (!pResidentialSimulator || !pResidentialSimulator->GetPopulationGrids(pGrid, nullptr, nullptr))
+	{
+		return nullptr;
+	}
+
+	return pGrid;
+}
+
+bool ResidentialCatchmentProvider::UpdateTable()
+{
+	populationTable.Clear();
+
+	cISC4SimGrid<uint16_t>* const pGrid = GetPopulationGrid();
+
+	if (!pGrid)
+	{
+		return false;
+	}
+
+	const int32_t tractCountX = std::max(pGrid->GetTractCountX(), 0);
+	const int32_t tractCountZ = std::max(pGrid->GetTractCountZ(), 0);
+
+	populationValues.resize(static_cast<size_t>(tractCountX) * static_cast<size_t>(tractCountZ));
+
+	for (int32_t z = 0; z < tractCountZ; z++)
+	{
+		uint16_t* const row = populationValues.data() + (static_cast<size_t>(z) * tractCountX);
+
+		for (int32_t x = 0; x < tractCountX; x++)
+		{
+			row[x] = pGrid->GetTractValue(x, z);
+		}
+	}
+
+	populationTable.Build(tractCountX, tractCountZ, populationValues.data());
+	oneOverTractWidthX = pGrid->GetOneOverTractWidthX();
+	oneOverTractWidthZ = pGrid->GetOneOverTractWidthZ();
+	tableValid = true;
+
+	return true;
+}
+
+int32_t ResidentialCatchmentProvider::PositionToTract(float position, float oneOverTractWidth, int32_t tractCount) const
+{
+	// The tract index is limited to one tract outside of the grid before it is converted
+	// to an integer, the summed-area table clips the rest of the query rectangle.
+	// The comparisons are written so that a NaN position is treated as being before the grid.
+	const float tract = std::floor(position * oneOverTractWidth);
+
+	if (!(tract > -1.0f))
+	{
+		return -1;
+	}
+	else if (tract >= static_cast<float>(tractCount))
+	{
+		return tractCount;
+	}
+
+	return static_cast<int32_t>(tract);
+}
@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "IResidentialCatchmentProvider.h"
+#include "SummedAreaTable.h"
+#include <vector>
+
+class cISC4ResidentialSimulator;
+template<typename T> class cISC4SimGrid;
+
+/**
+ * @brief Provides the residential population around a position to the transaction algorithms.
+ *
+ * The residential population grid is converted to a summed-area table the first time it is queried
+ * in each simulation month, after which the population of any rectangular area is found with four
+ * table reads instead of summing every grid tract in the area.
+ */
+class ResidentialCatchmentProvider : public IResidentialCatchmentProvider
+{
+public:
+	ResidentialCatchmentProvider();
+
+	bool Init();
+	bool Shutdown();
+
+	/**
+	 * @brief Discards the table so that it is rebuilt from the current population grid.
+	 */
+	void Invalidate();
+
+	int64_t GetResidentialPopulation(float x, float z, float radius) override;
+
+	/**
+	 * @brief Gets the residential population grid of the current city.
+	 * @return The grid, or nullptr if a city is not loaded.
+	 */
+	cISC4SimGrid<uint16_t>* GetPopulationGrid() const;
+
+private:
+	bool UpdateTable();
+	int32_t PositionToTract(float position, float oneOverTractWidth, int32_t tractCount) const;
+
+	cISC4ResidentialSimulator* pResidentialSimulator;
+	SummedAreaTable populationTable;
+	std::vector<uint16_t> populationValues;
+	float oneOverTractWidthX;
+	float oneOverTractWidthZ;
+	bool tableValid;
+};
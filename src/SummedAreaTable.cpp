@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "SummedAreaTable.h"
+#include <algorithm>
+
+SummedAreaTable::SummedAreaTable()
+	: sums(),
+	  width(0),
+	  height(0)
+{
+}
+
+void SummedAreaTable::Build(int32_t width, int32_t height, const uint16_t* values)
+{
+	this->width = std::max(width, 0);
+	this->height = std::max(height, 0);
+
+	const size_t stride = static_cast<size_t>(this->width) + 1;
+
+	sums.assign(stride * (static_cast<size_t>(this->height) + 1), 0);
+
+	for (int32_t row = 0; row < this->height; row++)
+	{
+		const uint16_t* const rowValues = values + (static_cast<size_t>(row) * this->width);
+		const int64_t* const previousRow = &sums[GetIndex(0, row)];
+		int64_t* const currentRow = &sums[GetIndex(0, row + 1)];
+
+		int64_t rowSum = 0;
+
+		for (int32_t column = 0; column < this->width; column++)
+		{
+			rowSum += rowValues[column];
+			currentRow[column + 1] = previousRow[column + 1] + rowSum;
+		}
+	}
+}
+
+void SummedAreaTable::Clear()
+{
+	sums.clear();
+	width = 0;
+	height = 0;
+}
+
+int32_t SummedAreaTable::GetWidth() const
+{
+	return width;
+}
+
+int32_t SummedAreaTable::GetHeight() const
+{
+	return height;
+}
+
+int64_t SummedAreaTable::GetSum(int32_t left, int32_t top, int32_t right, int32_t bottom) const
+{
+	const int32_t clippedLeft = std::max(left, 0);
+	const int32_t clippedTop = std::max(top, 0);
+	const int32_t clippedRight = std::min(right, width - 1);
+	const int32_t clippedBottom = std::min(bottom, height - 1);
+
+	if (clippedLeft > clippedRight || clippedTop > clippedBottom)
+	{
+		return 0;
+	}
+
+	return sums[GetIndex(clippedRight + 1, clippedBottom + 1)]
+		- sums[GetIndex(clippedLeft, clippedBottom + 1)]
+		- sums[GetIndex(clippedRight + 1, clippedTop)]
+		+ sums[GetIndex(clippedLeft, clippedTop)];
+}
+
+size_t SummedAreaTable::GetIndex(int32_t column, int32_t row) const
+{
+	return (static_cast<size_t>(row) * (static_cast<size_t>(width) + 1)) + static_cast<size_t>(column);
+}
@@ -0,0 +1,61 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief A summed-area table of a two-dimensional grid.
+ *
+ * Each entry holds the sum of the grid values above and to the left of it, so the
+ * sum of any rectangle of grid cells can be read from the four corner entries.
+ * The table has one extra row and column of zeros, which removes the edge checks
+ * from the rectangle queries.
+ */
+class SummedAreaTable
+{
+public:
+	SummedAreaTable();
+
+	/**
+	 * @brief Rebuilds the table from the grid values.
+	 * @param width The grid width.
+	 * @param height The grid height.
+	 * @param values The grid values in row-major order.
+	 */
+	void Build(int32_t width, int32_t height, const uint16_t* values);
+	void Clear();
+
+	int32_t GetWidth() const;
+	int32_t GetHeight() const;
+
+	/**
+	 * @brief Gets the sum of the grid values in the specified rectangle.
+	 * The rectangle is inclusive and is clipped to the grid bounds.
+	 * @param left The left column.
+	 * @param top The top row.
+	 * @param right The right column.
+	 * @param bottom The bottom row.
+	 * @return The sum of the grid values in the rectangle.
+	 */
+	int64_t GetSum(int32_t left, int32_t top, int32_t right, int32_t bottom) const;
+
+private:
+	size_t GetIndex(int32_t column, int32_t row) const;
+
+	std::vector<int64_t> sums;
+	int32_t width;
+	int32_t height;
+};
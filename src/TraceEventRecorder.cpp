@@ -0,0 +1,206 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "TraceEventRecorder.h"
+#include <cinttypes>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+
+namespace
+{
+	std::string GetSessionTimestamp()
+	{
+		char buffer[64]{};
+
+		const std::time_t now = std::time(nullptr);
+		std::tm localTime{};
+
+#ifdef _WIN32
+		const bool result = localtime_s(&localTime, &now) == 0;
+#else
+		const bool result = localtime_r(&now, &localTime) != nullptr;
+#endif // _WIN32
+
+		if (result)
+		{
+			std::strftime(buffer, sizeof(buffer), "%Y%m%d-%H%M%S", &localTime);
+		}
+
+		return std::string(buffer);
+	}
+
+	void WriteMicroseconds(std::ofstream& stream, int64_t nanoseconds)
+	{
+		// The trace_event format uses microseconds, the remaining
+		// nanoseconds are written as the fractional part.
+		char buffer[64]{};
+
+		std::snprintf(
+			buffer,
+			sizeof(buffer),
+			"%" PRId64 ".%03" PRId64,
+			nanoseconds / 1000,
+			nanoseconds % 1000);
+
+		stream << buffer;
+	}
+}
+
+TraceEventRecorder& TraceEventRecorder::GetInstance()
+{
+	static TraceEventRecorder recorder;
+
+	return recorder;
+}
+
+TraceEventRecorder::TraceEventRecorder()
+	: initialized(false),
+	  wrapped(false),
+	  nextEventIndex(0),
+	  events(),
+	  traceFilePath(),
+	  sessionTimestamp(),
+	  traceFileCount(0),
+	  startTime()
+{
+}
+
+void TraceEventRecorder::Init(std::filesystem::path traceFilePath, size_t capacity)
+{
+	if (!initialized && capacity > 0)
+	{
+		initialized = true;
+
+		this->traceFilePath = traceFilePath;
+		sessionTimestamp = GetSessionTimestamp();
+		events.resize(capacity);
+		startTime = std::chrono::steady_clock::now();
+	}
+}
+
+bool TraceEventRecorder::IsEnabled() const
+{
+	return initialized;
+}
+
+int64_t TraceEventRecorder::GetTimestamp() const
+{
+	const auto elapsed = std::chrono::steady_clock::now() - startTime;
+
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+void TraceEventRecorder::AddEvent(
+	const char* const name,
+	const char* const category,
+	int64_t startTimestamp,
+	int64_t endTimestamp)
+{
+	if (initialized)
+	{
+		TraceEvent& event = events[nextEventIndex];
+		event.name = name;
+		event.category = category;
+		event.startTimestamp = startTimestamp;
+		event.duration = endTimestamp - startTimestamp;
+
+		nextEventIndex++;
+
+		if (nextEventIndex == events.size())
+		{
+			nextEventIndex = 0;
+			wrapped = true;
+		}
+	}
+}
+
+bool TraceEventRecorder::WriteTraceFile()
+{
+	if (!initialized)
+	{
+		return false;
+	}
+
+	// The file name includes the session start time and a sequence number, so the trace
+	// of each city that is closed in the session is kept.
+	traceFileCount++;
+
+	char suffix[96]{};
+	std::snprintf(suffix, sizeof(suffix), ".%s-%03u", sessionTimestamp.c_str(), traceFileCount);
+
+	std::filesystem::path path = traceFilePath.parent_path() / traceFilePath.stem();
+	path += suffix;
+	path += traceFilePath.extension();
+
+	std::ofstream stream(path, std::ofstream::out | std::ofstream::trunc);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	stream << "{\"traceEvents\":[\n";
+	stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+		      "\"args\":{\"name\":\"SC4CustomBudgetDepartments\"}}";
+
+	// When the ring buffer has wrapped the oldest event is the one
+	// that will be overwritten next.
+	const size_t eventCount = wrapped ? events.size() : nextEventIndex;
+	const size_t firstEventIndex = wrapped ? nextEventIndex : 0;
+
+	for (size_t i = 0; i < eventCount; i++)
+	{
+		const TraceEvent& event = events[(firstEventIndex + i) % events.size()];
+
+		// Each event is written as a complete event, the begin and end timestamps
+		// are stored together so an event is never split by the ring buffer.
+		stream << ",\n{\"name\":\"" << event.name
+			   << "\",\"cat\":\"" << event.category
+			   << "\",\"ph\":\"X\",\"ts\":";
+		WriteMicroseconds(stream, event.startTimestamp);
+		stream << ",\"dur\":";
+		WriteMicroseconds(stream, event.duration);
+		stream << ",\"pid\":1,\"tid\":1}";
+	}
+
+	stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	nextEventIndex = 0;
+	wrapped = false;
+
+	return static_cast<bool>(stream);
+}
+
+TraceScope::TraceScope(const char* const name, const char* const category)
+	: name(name),
+	  category(category),
+	  startTimestamp(0)
+{
+	const TraceEventRecorder& recorder = TraceEventRecorder::GetInstance();
+
+	if (recorder.IsEnabled())
+	{
+		startTimestamp = recorder.GetTimestamp();
+	}
+}
+
+TraceScope::~TraceScope()
+{
+	TraceEventRecorder& recorder = TraceEventRecorder::GetInstance();
+
+	if (recorder.IsEnabled())
+	{
+		recorder.AddEvent(name, category, startTimestamp, recorder.GetTimestamp());
+	}
+}
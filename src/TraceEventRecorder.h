@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Records the plugin's activity as Chrome trace_event JSON.
+ *
+ * The recorder is disabled unless Init is called. The events are stored in a
+ * fixed size ring buffer that is allocated by Init, when the buffer is full the
+ * oldest events are overwritten.
+ */
+class TraceEventRecorder
+{
+public:
+
+	static TraceEventRecorder& GetInstance();
+
+	void Init(std::filesystem::path traceFilePath, size_t capacity);
+
+	bool IsEnabled() const;
+
+	/**
+	 * @brief Gets the number of nanoseconds that have elapsed since Init was called.
+	 */
+	int64_t GetTimestamp() const;
+
+	void AddEvent(const char* const name, const char* const category, int64_t startTimestamp, int64_t endTimestamp);
+
+	/**
+	 * @brief Writes the recorded events to a new trace file and clears the ring buffer.
+	 *
+	 * Each call writes a separate file, the session start time and a sequence number are
+	 * added to the trace file name that was passed to Init.
+	 *
+	 * @return True on success; otherwise, false.
+	 */
+	bool WriteTraceFile();
+
+private:
+
+	struct TraceEvent
+	{
+		const char* name;
+		const char* category;
+		int64_t startTimestamp;
+		int64_t duration;
+	};
+
+	TraceEventRecorder();
+
+	bool initialized;
+	bool wrapped;
+	size_t nextEventIndex;
+	std::vector<TraceEvent> events;
+	std::filesystem::path traceFilePath;
+	std::string sessionTimestamp;
+	uint32_t traceFileCount;
+	std::chrono::steady_clock::time_point startTime;
+};
+
+/**
+ * @brief Adds a trace event that spans the lifetime of the object.
+ *
+ * The name and category strings must be string literals, the recorder only stores the pointers.
+ */
+class TraceScope final
+{
+public:
+	TraceScope(const char* const name, const char* const category);
+	~TraceScope();
+
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+	const char* const name;
+	const char* const category;
+	int64_t startTimestamp;
+};
@@ -12,6 +12,14 @@
 ////////////////////////////////////////////////////////////////////////
 
 #pragma once
+#include "ConditionPredicateTable.h"
+#include "IHistoryProvider.h"
 #include "IPopulationProvider.h"
+#include "IRegionalBudgetProvider.h"
+#include "IResidentialCatchmentProvider.h"
 
+extern ConditionPredicateTable* spConditionPredicateTable;
+extern IHistoryProvider* spHistoryProvider;
 extern IPopulationProvider* spPopulationProvider;
+extern IRegionalBudgetProvider* spRegionalBudgetProvider;
+extern IResidentialCatchmentProvider* spResidentialCatchmentProvider;
@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "AllocationTracker.h"
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif // !_WIN32
+
+namespace
+{
+	// The size of each allocation is stored in front of the returned pointer,
+	// the header size keeps the pointer aligned for any fundamental type.
+	constexpr size_t AllocationHeaderSize = alignof(std::max_align_t) > sizeof(size_t)
+		? alignof(std::max_align_t)
+		: sizeof(size_t);
+
+	uint64_t allocationCount = 0;
+	uint64_t allocatedBytes = 0;
+	uint64_t currentBytes = 0;
+	uint64_t peakBytes = 0;
+
+	void* TrackedAllocate(size_t size) noexcept
+	{
+		void* block = std::malloc(size + AllocationHeaderSize);
+
+		if (!block)
+		{
+			return nullptr;
+		}
+
+		*static_cast<size_t*>(block) = size;
+
+		allocationCount++;
+		allocatedBytes += size;
+		currentBytes += size;
+
+		if (currentBytes > peakBytes)
+		{
+			peakBytes = currentBytes;
+		}
+
+		return static_cast<char*>(block) + AllocationHeaderSize;
+	}
+
+	void TrackedFree(void* ptr) noexcept
+	{
+		if (ptr)
+		{
+			void* block = static_cast<char*>(ptr) - AllocationHeaderSize;
+
+			currentBytes -= *static_cast<size_t*>(block);
+
+			std::free(block);
+		}
+	}
+
+	void* TrackedAllocateOrThrow(size_t size)
+	{
+		void* ptr = TrackedAllocate(size);
+
+		if (!ptr)
+		{
+			throw std::bad_alloc();
+		}
+
+		return ptr;
+	}
+}
+
+AllocationSnapshot AllocationTracker::GetSnapshot()
+{
+	return AllocationSnapshot{ allocationCount, allocatedBytes };
+}
+
+void AllocationTracker::ResetPeak()
+{
+	peakBytes = currentBytes;
+}
+
+uint64_t AllocationTracker::GetPeakBytes()
+{
+	return peakBytes;
+}
+
+uint64_t AllocationTracker::GetPeakResidentSetBytes()
+{
+	uint64_t value = 0;
+
+#ifndef _WIN32
+	rusage usage{};
+
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+	{
+		// Linux reports the value in kilobytes.
+		value = static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+	}
+#endif // !_WIN32
+
+	return value;
+}
+
+void* operator new(size_t size)
+{
+	return TrackedAllocateOrThrow(size);
+}
+
+void* operator new[](size_t size)
+{
+	return TrackedAllocateOrThrow(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return TrackedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return TrackedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	TrackedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	TrackedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	TrackedFree(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+	TrackedFree(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+	TrackedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+	TrackedFree(ptr);
+}
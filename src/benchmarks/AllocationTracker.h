@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstdint>
+
+struct AllocationSnapshot
+{
+	uint64_t allocationCount;
+	uint64_t allocatedBytes;
+};
+
+/**
+ * @brief Counts the heap allocations made through the global operator new.
+ *
+ * The benchmark executable replaces the global allocation functions, allocations
+ * that are made directly with malloc (e.g. by the EASTL allocator) are not counted.
+ */
+class AllocationTracker
+{
+public:
+	static AllocationSnapshot GetSnapshot();
+
+	/**
+	 * @brief Resets the peak heap size to the current heap size.
+	 */
+	static void ResetPeak();
+
+	/**
+	 * @brief Gets the largest number of bytes that were allocated at the same time
+	 * since the last ResetPeak call.
+	 */
+	static uint64_t GetPeakBytes();
+
+	/**
+	 * @brief Gets the peak resident set size of the process, or 0 if it is not available.
+	 */
+	static uint64_t GetPeakResidentSetBytes();
+};
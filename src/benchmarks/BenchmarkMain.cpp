@@ -0,0 +1,884 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "AllocationTracker.h"
+#include "CustomBudgetDepartmentManager.h"
+#include "CustomBudgetDepartmentQuery.h"
+#include "HeadlessGame.h"
+#include "HeadlessPropertyHolder.h"
+#include "MessageStreamRecorder.h"
+#include "SyntheticCity.h"
+#include "TransactionAlgorithmFactory.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+static constexpr uint32_t kResidentialTotalPopulationFactorProperty = 0x9EE12410;
+static constexpr uint32_t kResidentialWealthGroupPopulationFactorsProperty = 0x9EE12411;
+static constexpr uint32_t kTourismFactorsProperty = 0x9EE12412;
+static constexpr uint32_t kHistoryProperty = 0x9EE12415;
+static constexpr uint32_t kBuildingAgeProperty = 0x9EE12416;
+static constexpr uint32_t kResidentialCatchmentProperty = 0x9EE12417;
+
+namespace
+{
+	struct BenchmarkOptions
+	{
+		std::vector<uint32_t> buildingCounts;
+		std::vector<uint32_t> departmentCounts;
+		std::array<uint32_t, 9> algorithmWeights;
+		uint32_t buildingsPerType;
+		uint32_t iterations;
+		std::string outputPath;
+		std::string recordPath;
+		bool verifyOnly;
+
+		BenchmarkOptions()
+			: buildingCounts{ 1000, 10000, 100000, 1000000 },
+			  departmentCounts{ 10, 100, 1000 },
+			  algorithmWeights{ 1, 1, 1, 1, 0, 0, 0, 0, 0 },
+			  buildingsPerType(10),
+			  iterations(12),
+			  outputPath(),
+			  recordPath(),
+			  verifyOnly(false)
+		{
+		}
+	};
+
+	struct BenchmarkResult
+	{
+		const char* name;
+		uint32_t buildingCount;
+		uint32_t departmentCount;
+		uint64_t operations;
+		double nanosecondsPerOperation;
+		double allocationsPerOperation;
+		double bytesPerOperation;
+		uint64_t peakHeapBytes;
+	};
+
+	struct AlgorithmInstanceResult
+	{
+		uint32_t buildingCount;
+		uint32_t departmentCount;
+		TransactionAlgorithmInstanceStatistics statistics;
+	};
+
+	std::vector<uint32_t> ParseList(const char* value)
+	{
+		std::vector<uint32_t> list;
+
+		const char* current = value;
+
+		while (*current != '\0')
+		{
+			char* end = nullptr;
+			const unsigned long item = std::strtoul(current, &end, 10);
+
+			if (end == current)
+			{
+				break;
+			}
+
+			list.push_back(static_cast<uint32_t>(item));
+
+			current = *end == ',' ? end + 1 : end;
+		}
+
+		return list;
+	}
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: CustomBudgetDepartmentsBenchmark [options]\n"
+			"  --buildings <list>          Comma-separated building counts, default 1000,10000,100000,1000000.\n"
+			"  --departments <list>        Comma-separated department counts, default 10,100,1000.\n"
+			"  --mix <f,t,w,r[,e,s,h,a,c]> The relative weights of the Fixed, Total Pop., Wealth Group Pop.,\n"
+			"                              Tourism, Formula, Tiered, History, Building Age and Residential\n"
+			"                              Catchment algorithms, default 1,1,1,1,0,0,0,0,0.\n"
+			"  --buildings-per-type <n>    The number of buildings that share an exemplar, default 10.\n"
+			"  --iterations <n>            The number of times the monthly/save/load operations are repeated, default 12.\n"
+			"  --output <path>             Writes the results to the specified JSON file.\n"
+			"  --record <path>             Records the plugin's message stream for CustomBudgetDepartmentsReplay.\n"
+			"  --verify-only               Only run the line item property, projection and sandbox checks.\n");
+	}
+
+	bool ParseOptions(int argc, char** argv, BenchmarkOptions& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const char* const arg = argv[i];
+			const char* const value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+			if (std::strcmp(arg, "--help") == 0)
+			{
+				return false;
+			}
+			else if (std::strcmp(arg, "--verify-only") == 0)
+			{
+				options.verifyOnly = true;
+				continue;
+			}
+			else if (!value)
+			{
+				std::fprintf(stderr, "Missing the value for %s.\n", arg);
+				return false;
+			}
+			else if (std::strcmp(arg, "--buildings") == 0)
+			{
+				options.buildingCounts = ParseList(value);
+			}
+			else if (std::strcmp(arg, "--departments") == 0)
+			{
+				options.departmentCounts = ParseList(value);
+			}
+			else if (std::strcmp(arg, "--mix") == 0)
+			{
+				const std::vector<uint32_t> weights = ParseList(value);
+
+				// The Formula, Tiered, History, Building Age and Residential Catchment weights are optional.
+				if (weights.size() < options.algorithmWeights.size() - 5 || weights.size() > options.algorithmWeights.size())
+				{
+					std::fprintf(stderr, "The --mix option requires 4 to 9 values.\n");
+					return false;
+				}
+
+				options.algorithmWeights.fill(0);
+				std::copy(weights.begin(), weights.end(), options.algorithmWeights.begin());
+			}
+			else if (std::strcmp(arg, "--buildings-per-type") == 0)
+			{
+				options.buildingsPerType = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+			}
+			else if (std::strcmp(arg, "--iterations") == 0)
+			{
+				options.iterations = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+			}
+			else if (std::strcmp(arg, "--output") == 0)
+			{
+				options.outputPath = value;
+			}
+			else if (std::strcmp(arg, "--record") == 0)
+			{
+				options.recordPath = value;
+			}
+			else
+			{
+				std::fprintf(stderr, "Unknown option: %s\n", arg);
+				return false;
+			}
+
+			i++;
+		}
+
+		return !options.buildingCounts.empty()
+			&& !options.departmentCounts.empty()
+			&& options.iterations > 0;
+	}
+
+	BenchmarkResult Measure(
+		const char* name,
+		uint32_t buildingCount,
+		uint32_t departmentCount,
+		uint64_t operations,
+		const std::function<void()>& body)
+	{
+		AllocationTracker::ResetPeak();
+
+		const AllocationSnapshot before = AllocationTracker::GetSnapshot();
+		const auto start = std::chrono::steady_clock::now();
+
+		body();
+
+		const auto end = std::chrono::steady_clock::now();
+		const AllocationSnapshot after = AllocationTracker::GetSnapshot();
+
+		const double elapsed = static_cast<double>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+		const double count = static_cast<double>(operations > 0 ? operations : 1);
+
+		BenchmarkResult result{};
+		result.name = name;
+		result.buildingCount = buildingCount;
+		result.departmentCount = departmentCount;
+		result.operations = operations;
+		result.nanosecondsPerOperation = elapsed / count;
+		result.allocationsPerOperation = static_cast<double>(after.allocationCount - before.allocationCount) / count;
+		result.bytesPerOperation = static_cast<double>(after.allocatedBytes - before.allocatedBytes) / count;
+		result.peakHeapBytes = AllocationTracker::GetPeakBytes();
+
+		std::printf(
+			"%-20s %10" PRIu32 " %12" PRIu32 " %14.1f %12.2f %14.1f %16" PRIu64 "\n",
+			result.name,
+			result.buildingCount,
+			result.departmentCount,
+			result.nanosecondsPerOperation,
+			result.allocationsPerOperation,
+			result.bytesPerOperation,
+			result.peakHeapBytes);
+		std::fflush(stdout);
+
+		return result;
+	}
+
+	void InitializeGame(HeadlessGame& game, SyntheticCity& syntheticCity)
+	{
+		game.SetCityResidentialPopulation(20000, 15000, 5000);
+		syntheticCity.InitializePopulationGrid(game.GetPopulationGrid());
+
+		// A few neighbor cities for the tourism algorithm.
+		game.GetRegion().AddCity(4, 0, true)->SetResidentialPopulation(10000, 8000, 2000);
+		game.GetRegion().AddCity(0, 4, true)->SetResidentialPopulation(30000, 20000, 10000);
+		game.GetRegion().AddCity(4, 4, false);
+	}
+
+	void RunBenchmark(
+		const BenchmarkOptions& options,
+		uint32_t buildingCount,
+		uint32_t departmentCount,
+		std::vector<BenchmarkResult>& results,
+		std::vector<AlgorithmInstanceResult>& algorithmInstanceResults)
+	{
+		SyntheticCityOptions cityOptions{};
+		cityOptions.buildingCount = buildingCount;
+		cityOptions.departmentCount = departmentCount;
+		cityOptions.buildingsPerType = options.buildingsPerType;
+		cityOptions.algorithmWeights = options.algorithmWeights;
+
+		SyntheticCity syntheticCity(cityOptions);
+
+		HeadlessGame game;
+		InitializeGame(game, syntheticCity);
+
+		CustomBudgetDepartmentManager manager;
+		manager.Init();
+		game.PostCityInit();
+
+		const size_t count = syntheticCity.GetBuildingCount();
+
+		results.push_back(Measure("InsertOccupant", buildingCount, departmentCount, count, [&]()
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				game.InsertOccupant(syntheticCity.GetBuilding(i));
+			}
+		}));
+
+		// The placement preview is called for every frame while the player hovers a building.
+		int64_t previewTotal = 0;
+
+		results.push_back(Measure("PlacementPreview", buildingCount, departmentCount, count, [&]()
+		{
+			CustomBudgetDepartmentManager::PlacementCostPreview preview{};
+
+			for (size_t i = 0; i < count; i++)
+			{
+				HeadlessBuildingOccupant* const pBuilding = syntheticCity.GetBuilding(i);
+
+				if (manager.GetPlacementCostPreview(pBuilding->GetBuildingType(), pBuilding->AsPropertyHolder(), preview))
+				{
+					previewTotal += preview.expenseDelta - preview.incomeDelta;
+				}
+			}
+		}));
+
+		if (previewTotal == 0)
+		{
+			std::printf("The placement preview did not report any cost.\n");
+		}
+
+		// A planning tool adds one building of every type to a new sandbox and reads the department totals.
+		const size_t buildingTypeCount = syntheticCity.GetBuildingTypeCount();
+		std::vector<uint32_t> departments;
+
+		for (const CustomBudgetLineItemState& state : manager.GetLineItemTable().GetLineItems())
+		{
+			if (std::find(departments.begin(), departments.end(), state.department) == departments.end())
+			{
+				departments.push_back(state.department);
+			}
+		}
+
+		int64_t sandboxTotal = 0;
+
+		results.push_back(Measure("Sandbox", buildingCount, departmentCount, buildingTypeCount, [&]()
+		{
+			BudgetSandbox sandbox = manager.CreateSandbox();
+
+			for (size_t i = 0; i < buildingTypeCount; i++)
+			{
+				HeadlessBuildingOccupant* const pBuilding = syntheticCity.GetBuilding(i);
+
+				manager.ChangeSandboxBuildings(sandbox, pBuilding->GetBuildingType(), pBuilding->AsPropertyHolder(), 1);
+			}
+
+			for (uint32_t department : departments)
+			{
+				BudgetTotals totals{};
+
+				if (manager.GetSandboxDepartmentTotals(sandbox, department, totals))
+				{
+					sandboxTotal += totals.expenses - totals.income;
+				}
+			}
+		}));
+
+		if (sandboxTotal == 0)
+		{
+			std::printf("The sandbox did not report any department totals.\n");
+		}
+
+		// The line items that use the same algorithm parameters share one algorithm instance.
+		const TransactionAlgorithmInstanceStatistics statistics = TransactionAlgorithmFactory::GetInstanceStatistics();
+		algorithmInstanceResults.push_back(AlgorithmInstanceResult{ buildingCount, departmentCount, statistics });
+
+		std::printf(
+			"%-20s %10" PRIu32 " %12" PRIu32 " %14zu distinct / %zu total\n",
+			"AlgorithmInstances",
+			buildingCount,
+			departmentCount,
+			statistics.distinctInstances,
+			statistics.totalInstances);
+
+		results.push_back(Measure("SimNewMonth", buildingCount, departmentCount, options.iterations, [&]()
+		{
+			for (uint32_t i = 0; i < options.iterations; i++)
+			{
+				game.SimNewMonth();
+			}
+		}));
+
+		// Other DLL plugins read the line items through the query interface, the buffer is
+		// allocated once and the snapshot is copied for every frame.
+		CustomBudgetDepartmentQuery query(manager);
+		std::vector<CustomBudgetLineItemState> snapshot(query.GetLineItemCount());
+
+		results.push_back(Measure("QuerySnapshot", buildingCount, departmentCount, options.iterations, [&]()
+		{
+			for (uint32_t i = 0; i < options.iterations; i++)
+			{
+				query.CopyLineItems(snapshot.data(), static_cast<uint32_t>(snapshot.size()));
+			}
+		}));
+
+		// A forecast panel recalculates the projection when the player changes the population trajectory.
+		constexpr uint32_t projectionMonthCount = 120;
+
+		CustomBudgetPopulationTrajectory trajectory{};
+		query.GetCurrentPopulation(trajectory.start);
+		trajectory.end = trajectory.start;
+		trajectory.end.city *= 2;
+		trajectory.end.cityLowWealth *= 2;
+		trajectory.end.cityMediumWealth *= 2;
+		trajectory.end.cityHighWealth *= 2;
+
+		std::vector<CustomBudgetProjectedTotals> projection(snapshot.size() * projectionMonthCount);
+
+		results.push_back(Measure("Projection", buildingCount, departmentCount, options.iterations, [&]()
+		{
+			for (uint32_t i = 0; i < options.iterations; i++)
+			{
+				query.ProjectDepartmentTotals(
+					trajectory,
+					projectionMonthCount,
+					projection.data(),
+					static_cast<uint32_t>(projection.size()));
+			}
+		}));
+
+		HeadlessDBSegment segment;
+
+		results.push_back(Measure("WriteToDBSegment", buildingCount, departmentCount, options.iterations, [&]()
+		{
+			for (uint32_t i = 0; i < options.iterations; i++)
+			{
+				game.Save(segment);
+			}
+		}));
+
+		results.push_back(Measure("ReadFromDBSegment", buildingCount, departmentCount, options.iterations, [&]()
+		{
+			for (uint32_t i = 0; i < options.iterations; i++)
+			{
+				game.Load(segment);
+			}
+		}));
+
+		results.push_back(Measure("RemoveOccupant", buildingCount, departmentCount, count, [&]()
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				game.RemoveOccupant(syntheticCity.GetBuilding(i));
+			}
+		}));
+
+		game.PostCityShutdown();
+		manager.Shutdown();
+	}
+
+	int32_t InterpolatePopulation(int64_t start, int64_t end, uint32_t month, uint32_t monthCount)
+	{
+		return static_cast<int32_t>(start + (((end - start) * month) / monthCount));
+	}
+
+	// Projects the department totals of a synthetic city that uses every algorithm type and checks
+	// that the monthly updates with the trajectory's population produce the same totals.
+	bool VerifyProjection()
+	{
+		constexpr uint32_t monthCount = 6;
+
+		SyntheticCityOptions cityOptions{};
+		cityOptions.buildingCount = 1000;
+		cityOptions.departmentCount = 10;
+		cityOptions.buildingsPerType = 10;
+		cityOptions.algorithmWeights = { 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+
+		SyntheticCity syntheticCity(cityOptions);
+
+		HeadlessGame game;
+		InitializeGame(game, syntheticCity);
+
+		CustomBudgetDepartmentManager manager;
+		manager.Init();
+		game.PostCityInit();
+
+		for (size_t i = 0; i < syntheticCity.GetBuildingCount(); i++)
+		{
+			game.InsertOccupant(syntheticCity.GetBuilding(i));
+		}
+
+		// The projection starts from the totals of a monthly update.
+		game.SimNewMonth();
+
+		CustomBudgetDepartmentQuery query(manager);
+
+		CustomBudgetPopulationTrajectory trajectory{};
+		query.GetCurrentPopulation(trajectory.start);
+		trajectory.end = trajectory.start;
+		// The wealth group changes are multiples of the month count, so the city population is
+		// always the sum of the wealth groups.
+		trajectory.end.cityLowWealth += 6000;
+		trajectory.end.cityMediumWealth += 3000;
+		trajectory.end.cityHighWealth += 3000;
+		trajectory.end.city = trajectory.end.cityLowWealth + trajectory.end.cityMediumWealth + trajectory.end.cityHighWealth;
+
+		std::vector<CustomBudgetProjectedTotals> projection(static_cast<size_t>(query.GetLineItemCount()) * monthCount);
+
+		const uint32_t projectedCount = query.ProjectDepartmentTotals(
+			trajectory,
+			monthCount,
+			projection.data(),
+			static_cast<uint32_t>(projection.size()));
+
+		uint32_t mismatchCount = 0;
+
+		if (projectedCount == 0)
+		{
+			std::printf("The projection did not return any department totals.\n");
+			mismatchCount++;
+		}
+
+		for (uint32_t month = 1; month <= monthCount; month++)
+		{
+			game.SetCityResidentialPopulation(
+				InterpolatePopulation(trajectory.start.cityLowWealth, trajectory.end.cityLowWealth, month, monthCount),
+				InterpolatePopulation(trajectory.start.cityMediumWealth, trajectory.end.cityMediumWealth, month, monthCount),
+				InterpolatePopulation(trajectory.start.cityHighWealth, trajectory.end.cityHighWealth, month, monthCount));
+			game.SimNewMonth();
+
+			for (uint32_t i = 0; i < projectedCount; i++)
+			{
+				const CustomBudgetProjectedTotals& projected = projection[i];
+
+				if (projected.month == month)
+				{
+					int64_t expenses = 0;
+					int64_t income = 0;
+
+					if (!query.GetDepartmentTotals(projected.department, expenses, income)
+						|| expenses != projected.expenses
+						|| income != projected.income)
+					{
+						if (mismatchCount < 10)
+						{
+							std::printf(
+								"Month %" PRIu32 ", department 0x%08" PRIX32 ": projected %" PRId64 "/%" PRId64
+								", simulated %" PRId64 "/%" PRId64 ".\n",
+								month,
+								projected.department,
+								projected.expenses,
+								projected.income,
+								expenses,
+								income);
+						}
+
+						mismatchCount++;
+					}
+				}
+			}
+		}
+
+		game.PostCityShutdown();
+		manager.Shutdown();
+
+		std::printf(
+			"Projection: %" PRIu32 " months, %" PRIu32 " department totals, %" PRIu32 " mismatches.\n",
+			monthCount,
+			projectedCount,
+			mismatchCount);
+
+		return mismatchCount == 0;
+	}
+
+	// Changes the buildings of a sandbox, makes the same changes to the city and counts the departments
+	// whose city totals differ from the sandbox totals.
+	uint32_t CompareSandboxChange(
+		HeadlessGame& game,
+		CustomBudgetDepartmentManager& manager,
+		SyntheticCity& syntheticCity,
+		const std::vector<size_t>& buildingIndices,
+		const std::vector<uint32_t>& departments,
+		bool remove)
+	{
+		BudgetSandbox sandbox = manager.CreateSandbox();
+
+		for (size_t index : buildingIndices)
+		{
+			HeadlessBuildingOccupant* const pBuilding = syntheticCity.GetBuilding(index);
+
+			manager.ChangeSandboxBuildings(sandbox, pBuilding->GetBuildingType(), pBuilding->AsPropertyHolder(), remove ? -1 : 1);
+		}
+
+		// The sandbox is only valid until the city changes.
+		std::vector<BudgetTotals> sandboxTotals(departments.size());
+
+		for (size_t i = 0; i < departments.size(); i++)
+		{
+			manager.GetSandboxDepartmentTotals(sandbox, departments[i], sandboxTotals[i]);
+		}
+
+		for (size_t index : buildingIndices)
+		{
+			if (remove)
+			{
+				game.RemoveOccupant(syntheticCity.GetBuilding(index));
+			}
+			else
+			{
+				game.InsertOccupant(syntheticCity.GetBuilding(index));
+			}
+		}
+
+		CustomBudgetDepartmentQuery query(manager);
+
+		uint32_t mismatchCount = 0;
+
+		for (size_t i = 0; i < departments.size(); i++)
+		{
+			int64_t expenses = 0;
+			int64_t income = 0;
+
+			query.GetDepartmentTotals(departments[i], expenses, income);
+
+			if (expenses != sandboxTotals[i].expenses || income != sandboxTotals[i].income)
+			{
+				std::printf(
+					"%s department 0x%08" PRIX32 ": sandbox %" PRId64 "/%" PRId64 ", city %" PRId64 "/%" PRId64 ".\n",
+					remove ? "Remove," : "Insert,",
+					departments[i],
+					sandboxTotals[i].expenses,
+					sandboxTotals[i].income,
+					expenses,
+					income);
+				mismatchCount++;
+			}
+		}
+
+		return mismatchCount;
+	}
+
+	// Checks that removing and adding buildings in a sandbox produces the same department totals as
+	// removing and inserting the buildings in the city. The BuildingAge and ResidentialCatchment
+	// algorithms are not used because the sandbox does not include the costs of the individual buildings.
+	bool VerifySandbox()
+	{
+		SyntheticCityOptions cityOptions{};
+		cityOptions.buildingCount = 1000;
+		cityOptions.departmentCount = 10;
+		cityOptions.buildingsPerType = 10;
+		cityOptions.algorithmWeights = { 1, 1, 1, 1, 1, 1, 1, 0, 0 };
+
+		SyntheticCity syntheticCity(cityOptions);
+
+		HeadlessGame game;
+		InitializeGame(game, syntheticCity);
+
+		CustomBudgetDepartmentManager manager;
+		manager.Init();
+		game.PostCityInit();
+
+		for (size_t i = 0; i < syntheticCity.GetBuildingCount(); i++)
+		{
+			game.InsertOccupant(syntheticCity.GetBuilding(i));
+		}
+
+		std::vector<uint32_t> departments;
+
+		for (const CustomBudgetLineItemState& state : manager.GetLineItemTable().GetLineItems())
+		{
+			if (std::find(departments.begin(), departments.end(), state.department) == departments.end())
+			{
+				departments.push_back(state.department);
+			}
+		}
+
+		// Every fourth building type is removed from the city and the other types lose a third of their buildings,
+		// adding the buildings back creates the line items of the removed types again.
+		const size_t buildingTypeCount = syntheticCity.GetBuildingTypeCount();
+		std::vector<size_t> changedBuildings;
+
+		for (size_t i = 0; i < syntheticCity.GetBuildingCount(); i++)
+		{
+			if (((i % buildingTypeCount) % 4) == 0 || (i % 3) == 0)
+			{
+				changedBuildings.push_back(i);
+			}
+		}
+
+		const uint32_t mismatchCount = CompareSandboxChange(game, manager, syntheticCity, changedBuildings, departments, true)
+			+ CompareSandboxChange(game, manager, syntheticCity, changedBuildings, departments, false);
+
+		game.PostCityShutdown();
+		manager.Shutdown();
+
+		std::printf(
+			"Sandbox: %zu buildings removed and inserted, %zu departments, %" PRIu32 " mismatches.\n",
+			changedBuildings.size(),
+			departments.size(),
+			mismatchCount);
+
+		return mismatchCount == 0 && !departments.empty();
+	}
+
+	struct LineItemPropertyCase
+	{
+		const char* name;
+		TransactionAlgorithmType type;
+		uint32_t propertyId;
+		std::vector<int64_t> firstLineItem;
+		std::vector<int64_t> secondLineItem;
+	};
+
+	// Checks that the algorithm parameters of each line item are read from its own group when
+	// a parameter property lists several line items. The line items that have the same parameters
+	// share one algorithm instance, so the second line item of a property with two line items must
+	// use the same instance as a property that only has that line item.
+	bool VerifyMultipleLineItemProperties()
+	{
+		constexpr int64_t firstLineNumber = 0x60000001;
+		constexpr int64_t secondLineNumber = 0x60000002;
+
+		const std::vector<LineItemPropertyCase> cases =
+		{
+			{ "ResidentialTotalPopulation", TransactionAlgorithmType::ResidentialTotalPopulation, kResidentialTotalPopulationFactorProperty,
+				{ firstLineNumber, 1, 1000 }, { secondLineNumber, 3, 1000 } },
+			{ "ResidentialWealthGroupPopulation", TransactionAlgorithmType::ResidentialWealthGroupPopulation, kResidentialWealthGroupPopulationFactorsProperty,
+				{ firstLineNumber, 1, 1000, 2, 1000, 3, 1000 }, { secondLineNumber, 4, 1000, 5, 1000, 6, 1000 } },
+			{ "Tourism", TransactionAlgorithmType::Tourism, kTourismFactorsProperty,
+				{ firstLineNumber, 1, 10, 1000 }, { secondLineNumber, 2, 10, 500 } },
+			{ "History", TransactionAlgorithmType::History, kHistoryProperty,
+				{ firstLineNumber, 2, 12, 0, 1, 1000 }, { secondLineNumber, 3, 24, 1, 2, 1000 } },
+			{ "BuildingAge", TransactionAlgorithmType::BuildingAge, kBuildingAgeProperty,
+				{ firstLineNumber, 1, 12, 240 }, { secondLineNumber, 2, 12, 120 } },
+			{ "ResidentialCatchment", TransactionAlgorithmType::ResidentialCatchment, kResidentialCatchmentProperty,
+				{ firstLineNumber, 1, 100, 8 }, { secondLineNumber, 2, 100, 4 } },
+		};
+
+		uint32_t failureCount = 0;
+
+		for (const LineItemPropertyCase& item : cases)
+		{
+			std::vector<int64_t> bothLineItems = item.firstLineItem;
+			bothLineItems.insert(bothLineItems.end(), item.secondLineItem.begin(), item.secondLineItem.end());
+
+			HeadlessPropertyHolder firstOnly;
+			firstOnly.SetSint64ArrayProperty(item.propertyId, item.firstLineItem);
+			HeadlessPropertyHolder secondOnly;
+			secondOnly.SetSint64ArrayProperty(item.propertyId, item.secondLineItem);
+			HeadlessPropertyHolder both;
+			both.SetSint64ArrayProperty(item.propertyId, bothLineItems);
+
+			bool passed = false;
+
+			try
+			{
+				passed = TransactionAlgorithmFactory::Create(&both, item.type, firstLineNumber)
+					== TransactionAlgorithmFactory::Create(&firstOnly, item.type, firstLineNumber)
+					&& TransactionAlgorithmFactory::Create(&both, item.type, secondLineNumber)
+					== TransactionAlgorithmFactory::Create(&secondOnly, item.type, secondLineNumber);
+			}
+			catch (const CreateTransactionAlgorithmException& e)
+			{
+				std::printf("%s: %s\n", item.name, e.what());
+			}
+
+			if (!passed)
+			{
+				std::printf("%s: the line items of a property with two line items use the wrong parameters.\n", item.name);
+				failureCount++;
+			}
+		}
+
+		std::printf("Line item properties: %zu algorithms, %" PRIu32 " failed.\n", cases.size(), failureCount);
+
+		return failureCount == 0;
+	}
+
+	bool WriteJson(
+		const std::string& path,
+		const BenchmarkOptions& options,
+		const std::vector<BenchmarkResult>& results,
+		const std::vector<AlgorithmInstanceResult>& algorithmInstanceResults)
+	{
+		std::ofstream stream(path, std::ofstream::out | std::ofstream::trunc);
+
+		if (!stream)
+		{
+			return false;
+		}
+
+		stream << "{\n  \"config\": {\"algorithmMix\": {"
+			   << "\"fixed\": " << options.algorithmWeights[0]
+			   << ", \"residentialTotalPopulation\": " << options.algorithmWeights[1]
+			   << ", \"residentialWealthGroupPopulation\": " << options.algorithmWeights[2]
+			   << ", \"tourism\": " << options.algorithmWeights[3]
+			   << ", \"formula\": " << options.algorithmWeights[4]
+			   << ", \"tiered\": " << options.algorithmWeights[5]
+			   << ", \"history\": " << options.algorithmWeights[6]
+			   << ", \"buildingAge\": " << options.algorithmWeights[7]
+			   << ", \"residentialCatchment\": " << options.algorithmWeights[8]
+			   << "}, \"buildingsPerType\": " << options.buildingsPerType
+			   << ", \"iterations\": " << options.iterations
+			   << "},\n  \"results\": [";
+
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const BenchmarkResult& result = results[i];
+
+			stream << (i == 0 ? "\n" : ",\n")
+				   << "    {\"name\": \"" << result.name
+				   << "\", \"buildings\": " << result.buildingCount
+				   << ", \"departments\": " << result.departmentCount
+				   << ", \"operations\": " << result.operations
+				   << ", \"nsPerOp\": " << result.nanosecondsPerOperation
+				   << ", \"allocationsPerOp\": " << result.allocationsPerOperation
+				   << ", \"bytesPerOp\": " << result.bytesPerOperation
+				   << ", \"peakHeapBytes\": " << result.peakHeapBytes
+				   << "}";
+		}
+
+		stream << "\n  ],\n  \"algorithmInstances\": [";
+
+		for (size_t i = 0; i < algorithmInstanceResults.size(); i++)
+		{
+			const AlgorithmInstanceResult& result = algorithmInstanceResults[i];
+
+			stream << (i == 0 ? "\n" : ",\n")
+				   << "    {\"buildings\": " << result.buildingCount
+				   << ", \"departments\": " << result.departmentCount
+				   << ", \"distinct\": " << result.statistics.distinctInstances
+				   << ", \"total\": " << result.statistics.totalInstances
+				   << "}";
+		}
+
+		stream << "\n  ],\n  \"peakResidentSetBytes\": " << AllocationTracker::GetPeakResidentSetBytes() << "\n}\n";
+
+		return static_cast<bool>(stream);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	const bool lineItemPropertiesPassed = VerifyMultipleLineItemProperties();
+	const bool projectionPassed = VerifyProjection();
+	const bool sandboxPassed = VerifySandbox();
+	const bool checksPassed = lineItemPropertiesPassed && projectionPassed && sandboxPassed;
+
+	std::printf(
+		"Line item property check: %s, projection check: %s, sandbox check: %s.\n\n",
+		lineItemPropertiesPassed ? "passed" : "FAILED",
+		projectionPassed ? "passed" : "FAILED",
+		sandboxPassed ? "passed" : "FAILED");
+
+	if (options.verifyOnly)
+	{
+		return checksPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (!options.recordPath.empty())
+	{
+		MessageStreamRecorder::GetInstance().Init(options.recordPath);
+	}
+
+	std::printf(
+		"%-20s %10s %12s %14s %12s %14s %16s\n",
+		"Benchmark",
+		"Buildings",
+		"Departments",
+		"ns/op",
+		"allocs/op",
+		"bytes/op",
+		"peak heap bytes");
+
+	std::vector<BenchmarkResult> results;
+	std::vector<AlgorithmInstanceResult> algorithmInstanceResults;
+
+	for (uint32_t buildingCount : options.buildingCounts)
+	{
+		for (uint32_t departmentCount : options.departmentCounts)
+		{
+			RunBenchmark(options, buildingCount, departmentCount, results, algorithmInstanceResults);
+		}
+	}
+
+	std::printf("Peak resident set size: %" PRIu64 " bytes\n", AllocationTracker::GetPeakResidentSetBytes());
+
+	if (!options.outputPath.empty())
+	{
+		if (!WriteJson(options.outputPath, options, results, algorithmInstanceResults))
+		{
+			std::fprintf(stderr, "Unable to write %s.\n", options.outputPath.c_str());
+			return EXIT_FAILURE;
+		}
+	}
+
+	return checksPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
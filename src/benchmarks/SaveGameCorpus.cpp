@@ -0,0 +1,209 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "SaveGameCorpus.h"
+#include "HeadlessDBSegmentOStream.h"
+#include "TransactionAlgorithmType.h"
+#include <cstring>
+#include <random>
+
+static constexpr uint32_t RecordVersion = 1;
+static constexpr uint32_t LegacyLineItemTransactionVersion = 1;
+static constexpr uint32_t LineItemTransactionVersion = 2;
+
+static constexpr uint32_t kFirstDepartmentId = 0x70000000;
+static constexpr uint32_t kFirstLineItemId = 0x60000000;
+
+namespace
+{
+	struct CitySize
+	{
+		const char* name;
+		uint32_t departmentCount;
+		uint32_t lineItemsPerDepartment;
+	};
+
+	constexpr CitySize CitySizes[] =
+	{
+		{ "Empty", 0, 0 },
+		{ "Small", 5, 4 },
+		{ "Medium", 50, 20 },
+		{ "Large", 500, 40 },
+		{ "Huge", 2000, 100 },
+	};
+
+	void WriteFactor(HeadlessDBSegmentOStream& stream, std::mt19937& random, uint32_t transactionVersion)
+	{
+		if (transactionVersion == LegacyLineItemTransactionVersion)
+		{
+			std::uniform_real_distribution<float> factorDistribution(0.0f, 1.0f);
+
+			stream.SetFloat32(factorDistribution(random));
+		}
+		else
+		{
+			// See AlgorithmFactor::Write.
+			std::uniform_int_distribution<int32_t> numeratorDistribution(0, 100);
+			std::uniform_int_distribution<int32_t> denominatorDistribution(1, 1000);
+
+			const uint8_t rationalStorageType = 0;
+
+			stream.SetVoid(&rationalStorageType, 1);
+			stream.SetSint32(numeratorDistribution(random));
+			stream.SetSint32(denominatorDistribution(random));
+		}
+	}
+
+	void WriteLineItemTransaction(HeadlessDBSegmentOStream& stream, std::mt19937& random, uint32_t transactionVersion)
+	{
+		std::uniform_int_distribution<int64_t> costDistribution(1, 10000);
+		std::uniform_int_distribution<uint32_t> algorithmDistribution(0, 3);
+
+		const TransactionAlgorithmType algorithm = static_cast<TransactionAlgorithmType>(algorithmDistribution(random));
+		const uint8_t isIncome = static_cast<uint8_t>(random() & 1);
+
+		// See LineItemTransaction::Write and the ITransactionAlgorithm::Write implementations.
+
+		stream.SetUint32(transactionVersion);
+		stream.SetSint64(costDistribution(random));
+		stream.SetVoid(&isIncome, 1);
+		stream.SetUint32(static_cast<uint32_t>(algorithm));
+
+		switch (algorithm)
+		{
+		case TransactionAlgorithmType::ResidentialTotalPopulation:
+			WriteFactor(stream, random, transactionVersion);
+			break;
+		case TransactionAlgorithmType::ResidentialWealthGroupPopulation:
+			WriteFactor(stream, random, transactionVersion);
+			WriteFactor(stream, random, transactionVersion);
+			WriteFactor(stream, random, transactionVersion);
+			break;
+		case TransactionAlgorithmType::Tourism:
+			WriteFactor(stream, random, transactionVersion);
+			stream.SetSint64(costDistribution(random));
+			break;
+		case TransactionAlgorithmType::Fixed:
+		default:
+			break;
+		}
+	}
+
+	SaveGameCorpusEntry CreateValidRecord(const CitySize& size, std::mt19937& random, uint32_t transactionVersion)
+	{
+		SaveGameCorpusEntry entry{};
+		entry.name = transactionVersion == LegacyLineItemTransactionVersion ? std::string("Legacy-") + size.name : size.name;
+		entry.lineItemCount = size.departmentCount * size.lineItemsPerDepartment;
+		entry.isValid = true;
+
+		HeadlessDBSegmentOStream stream(entry.record);
+
+		stream.SetUint32(RecordVersion);
+		stream.SetUint32(size.departmentCount);
+
+		for (uint32_t i = 0; i < size.departmentCount; i++)
+		{
+			stream.SetUint32(kFirstDepartmentId + i);
+			stream.SetUint32(size.lineItemsPerDepartment);
+
+			for (uint32_t j = 0; j < size.lineItemsPerDepartment; j++)
+			{
+				stream.SetUint32(kFirstLineItemId + (i * size.lineItemsPerDepartment) + j);
+				WriteLineItemTransaction(stream, random, transactionVersion);
+			}
+		}
+
+		return entry;
+	}
+
+	SaveGameCorpusEntry CreateInvalidRecord(const char* name, const SaveGameCorpusEntry& source, bool isValid)
+	{
+		SaveGameCorpusEntry entry{};
+		entry.name = name;
+		entry.record = source.record;
+		entry.lineItemCount = 0;
+		entry.isValid = isValid;
+
+		return entry;
+	}
+
+	void SetUint32(std::vector<uint8_t>& record, size_t offset, uint32_t value)
+	{
+		std::memcpy(record.data() + offset, &value, sizeof(value));
+	}
+}
+
+std::vector<SaveGameCorpusEntry> SaveGameCorpus::Generate()
+{
+	std::mt19937 random(0x5C4B0D6E);
+
+	std::vector<SaveGameCorpusEntry> corpus;
+
+	for (const CitySize& size : CitySizes)
+	{
+		corpus.push_back(CreateValidRecord(size, random, LineItemTransactionVersion));
+	}
+
+	// The records that were written by the plugin versions that stored the algorithm factors as Float32 values.
+	for (const CitySize& size : CitySizes)
+	{
+		if (size.departmentCount > 0)
+		{
+			corpus.push_back(CreateValidRecord(size, random, LegacyLineItemTransactionVersion));
+		}
+	}
+
+	// The invalid records are derived from the Small city record, the record starts with the
+	// record version, the department count, the first department id, the first department's
+	// line item count, the first line item id and the first line item transaction version.
+	const SaveGameCorpusEntry source = corpus[1];
+
+	SaveGameCorpusEntry zeroLength = CreateInvalidRecord("Corrupt-ZeroLength", source, false);
+	zeroLength.record.clear();
+	corpus.push_back(std::move(zeroLength));
+
+	SaveGameCorpusEntry versionOnly = CreateInvalidRecord("Truncated-VersionOnly", source, false);
+	versionOnly.record.resize(4);
+	corpus.push_back(std::move(versionOnly));
+
+	SaveGameCorpusEntry half = CreateInvalidRecord("Truncated-Half", source, false);
+	half.record.resize(half.record.size() / 2);
+	corpus.push_back(std::move(half));
+
+	SaveGameCorpusEntry lastByte = CreateInvalidRecord("Truncated-LastByte", source, false);
+	lastByte.record.pop_back();
+	corpus.push_back(std::move(lastByte));
+
+	SaveGameCorpusEntry unknownVersion = CreateInvalidRecord("Corrupt-UnknownRecordVersion", source, false);
+	SetUint32(unknownVersion.record, 0, 2);
+	corpus.push_back(std::move(unknownVersion));
+
+	SaveGameCorpusEntry hugeCount = CreateInvalidRecord("Corrupt-HugeDepartmentCount", source, false);
+	SetUint32(hugeCount.record, 4, UINT32_MAX);
+	corpus.push_back(std::move(hugeCount));
+
+	SaveGameCorpusEntry hugeLineItemCount = CreateInvalidRecord("Corrupt-HugeLineItemCount", source, false);
+	SetUint32(hugeLineItemCount.record, 12, UINT32_MAX);
+	corpus.push_back(std::move(hugeLineItemCount));
+
+	SaveGameCorpusEntry transactionVersion = CreateInvalidRecord("Corrupt-TransactionVersion", source, false);
+	SetUint32(transactionVersion.record, 20, 99);
+	corpus.push_back(std::move(transactionVersion));
+
+	// The algorithm type follows the transaction version, fixed cost and the isIncome flag.
+	SaveGameCorpusEntry algorithmType = CreateInvalidRecord("Corrupt-UnknownAlgorithmType", source, false);
+	SetUint32(algorithmType.record, 33, 99);
+	corpus.push_back(std::move(algorithmType));
+
+	return corpus;
+}
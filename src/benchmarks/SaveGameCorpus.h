@@ -0,0 +1,42 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct SaveGameCorpusEntry
+{
+	std::string name;
+	// The contents of the plugin's 0xFE005706 save game record.
+	std::vector<uint8_t> record;
+	uint32_t lineItemCount;
+	// True if the plugin should load the record, false if the plugin
+	// should discard the record because it is invalid or uses an unknown version.
+	bool isValid;
+};
+
+/**
+ * @brief Generates the plugin's save game records for the save/load benchmark.
+ *
+ * The corpus contains valid records for small to huge cities using the current and
+ * legacy line item formats, and truncated or corrupt records that are derived from
+ * one of the valid records.
+ * The records are generated from a fixed seed, so the corpus is the same for every run.
+ */
+class SaveGameCorpus
+{
+public:
+	static std::vector<SaveGameCorpusEntry> Generate();
+};
@@ -0,0 +1,678 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "AllocationTracker.h"
+#include "CustomBudgetDepartmentManager.h"
+#include "HeadlessGame.h"
+#include "SaveGameCorpus.h"
+#include "SyntheticCity.h"
+#include "cGZPersistResourceKey.h"
+#include "cISC4LineItem.h"
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+static constexpr uint32_t CustomBudgetDepartmentManagerTypeId = 0xFE005706;
+static constexpr uint32_t CustomBudgetDepartmentManagerGroupId = 0xFE005707;
+static constexpr uint32_t CustomBudgetDepartmentManagerInstanceId = 0;
+static constexpr uint32_t CustomBudgetMigrationInstanceId = 2;
+
+namespace
+{
+	// The serialized line item transactions of each department, sorted by id.
+	// The plugin writes the departments in hash table order, so the records are
+	// compared after they have been decoded.
+	typedef std::map<uint32_t, std::map<uint32_t, std::vector<uint8_t>>> DecodedRecord;
+
+	struct SaveLoadResult
+	{
+		std::string name;
+		const char* operation;
+		size_t recordBytes;
+		uint32_t lineItemCount;
+		double megabytesPerSecond;
+		double recordsPerSecond;
+		double lineItemsPerSecond;
+		double allocationsPerRecord;
+	};
+
+	class RecordDecoder
+	{
+	public:
+		RecordDecoder(const std::vector<uint8_t>& record)
+			: record(record),
+			  position(0)
+		{
+		}
+
+		bool Decode(DecodedRecord& decoded)
+		{
+			uint32_t version = 0;
+			uint32_t departmentCount = 0;
+
+			if (!ReadUint32(version) || version != 1 || !ReadUint32(departmentCount))
+			{
+				return false;
+			}
+
+			for (uint32_t i = 0; i < departmentCount; i++)
+			{
+				uint32_t departmentId = 0;
+				uint32_t lineItemCount = 0;
+
+				if (!ReadUint32(departmentId) || !ReadUint32(lineItemCount))
+				{
+					return false;
+				}
+
+				auto& lineItems = decoded[departmentId];
+
+				for (uint32_t j = 0; j < lineItemCount; j++)
+				{
+					uint32_t lineItemId = 0;
+
+					if (!ReadUint32(lineItemId))
+					{
+						return false;
+					}
+
+					if (!DecodeTransaction(lineItems[lineItemId]))
+					{
+						return false;
+					}
+				}
+			}
+
+			return position == record.size();
+		}
+
+	private:
+		// Converts the transaction to the current format, the legacy Float32
+		// factors are stored using the Float32 factor storage type.
+		bool DecodeTransaction(std::vector<uint8_t>& transaction)
+		{
+			uint32_t version = 0;
+			uint32_t algorithmType = 0;
+
+			if (!ReadUint32(version) || version < 1 || version > 3)
+			{
+				return false;
+			}
+
+			const uint32_t currentVersion = 3;
+			Append(transaction, &currentVersion, sizeof(currentVersion));
+
+			// The fixed cost and the isIncome flag.
+			if (!Copy(transaction, 8 + 1) || !ReadUint32(algorithmType))
+			{
+				return false;
+			}
+
+			Append(transaction, &algorithmType, sizeof(algorithmType));
+
+			bool result = false;
+
+			switch (algorithmType)
+			{
+			case 1: // ResidentialTotalPopulation
+				result = DecodeFactor(transaction, version);
+				break;
+			case 2: // ResidentialWealthGroupPopulation
+				result = DecodeFactor(transaction, version)
+					&& DecodeFactor(transaction, version)
+					&& DecodeFactor(transaction, version);
+				break;
+			case 3: // Tourism
+				result = DecodeFactor(transaction, version) && Copy(transaction, 8);
+				break;
+			case 0: // Fixed
+				result = true;
+				break;
+			default:
+				result = false;
+				break;
+			}
+
+			return result && DecodeConditions(transaction, version);
+		}
+
+		// Version 3 added the line item conditions, the older versions are
+		// converted to an empty condition list.
+		bool DecodeConditions(std::vector<uint8_t>& transaction, uint32_t version)
+		{
+			uint32_t conditionCount = 0;
+
+			if (version >= 3 && !ReadUint32(conditionCount))
+			{
+				return false;
+			}
+
+			Append(transaction, &conditionCount, sizeof(conditionCount));
+
+			for (uint32_t i = 0; i < conditionCount; i++)
+			{
+				// The predicate type, id and threshold.
+				if (!Copy(transaction, 12) || !DecodeFactor(transaction, version))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		bool DecodeFactor(std::vector<uint8_t>& transaction, uint32_t version)
+		{
+			const uint8_t rationalStorageType = 0;
+			const uint8_t float32StorageType = 1;
+
+			if (version == 1)
+			{
+				Append(transaction, &float32StorageType, 1);
+				return Copy(transaction, 4);
+			}
+
+			if (position >= record.size())
+			{
+				return false;
+			}
+
+			const uint8_t storageType = record[position];
+
+			return Copy(transaction, 1) && Copy(transaction, storageType == rationalStorageType ? 8 : 4);
+		}
+
+		static void Append(std::vector<uint8_t>& destination, const void* data, size_t size)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+			destination.insert(destination.end(), bytes, bytes + size);
+		}
+
+		bool Copy(std::vector<uint8_t>& destination, size_t count)
+		{
+			if (record.size() - position < count)
+			{
+				return false;
+			}
+
+			destination.insert(destination.end(), record.begin() + position, record.begin() + position + count);
+			position += count;
+
+			return true;
+		}
+
+		bool ReadUint32(uint32_t& value)
+		{
+			if (record.size() - position < sizeof(value))
+			{
+				return false;
+			}
+
+			std::memcpy(&value, record.data() + position, sizeof(value));
+			position += sizeof(value);
+
+			return true;
+		}
+
+		const std::vector<uint8_t>& record;
+		size_t position;
+	};
+
+	struct LineItemValues
+	{
+		int64_t expenses;
+		int64_t income;
+		int64_t buildingCount;
+
+		bool operator==(const LineItemValues& other) const = default;
+	};
+
+	// The line item values of the city, keyed by the line item id.
+	typedef std::map<uint32_t, LineItemValues> LineItemSnapshot;
+
+	class SaveLoadHarness
+	{
+	public:
+		SaveLoadHarness()
+			: game(),
+			  manager(),
+			  segment(),
+			  key(CustomBudgetDepartmentManagerTypeId, CustomBudgetDepartmentManagerGroupId, CustomBudgetDepartmentManagerInstanceId),
+			  migrationKey(CustomBudgetDepartmentManagerTypeId, CustomBudgetDepartmentManagerGroupId, CustomBudgetMigrationInstanceId)
+		{
+			manager.Init();
+			game.PostCityInit();
+		}
+
+		~SaveLoadHarness()
+		{
+			game.PostCityShutdown();
+			manager.Shutdown();
+		}
+
+		void ResetCity()
+		{
+			game.PostCityShutdown();
+			game.PostCityInit();
+		}
+
+		void SetRecord(const std::vector<uint8_t>& record)
+		{
+			segment.WriteRecord(key, const_cast<uint8_t*>(record.data()), static_cast<uint32_t>(record.size()));
+		}
+
+		bool GetRecord(std::vector<uint8_t>& record)
+		{
+			if (!segment.TestForRecord(key))
+			{
+				return false;
+			}
+
+			uint32_t size = segment.GetRecordSize(key);
+			record.resize(size);
+			segment.ReadRecord(key, record.data(), size);
+
+			return true;
+		}
+
+		void DeleteRecord()
+		{
+			segment.DeleteRecord(key);
+		}
+
+		bool HasMigrationRecord()
+		{
+			return segment.TestForRecord(migrationKey);
+		}
+
+		void DeleteMigrationRecord()
+		{
+			segment.DeleteRecord(migrationKey);
+		}
+
+		HeadlessGame& GetGame()
+		{
+			return game;
+		}
+
+		void Load()
+		{
+			game.Load(segment);
+		}
+
+		void Save()
+		{
+			game.Save(segment);
+		}
+
+	private:
+		HeadlessGame game;
+		CustomBudgetDepartmentManager manager;
+		HeadlessDBSegment segment;
+		cGZPersistResourceKey key;
+		cGZPersistResourceKey migrationKey;
+	};
+
+	bool VerifyRoundTrip(SaveLoadHarness& harness, const SaveGameCorpusEntry& entry)
+	{
+		harness.ResetCity();
+		harness.SetRecord(entry.record);
+		harness.Load();
+		harness.DeleteRecord();
+		harness.Save();
+
+		std::vector<uint8_t> savedRecord;
+		const bool hasSavedRecord = harness.GetRecord(savedRecord);
+
+		if (!entry.isValid || entry.lineItemCount == 0)
+		{
+			// The plugin does not write a record when it has no line items.
+			return !hasSavedRecord;
+		}
+
+		DecodedRecord expected;
+		DecodedRecord actual;
+
+		return hasSavedRecord
+			&& RecordDecoder(entry.record).Decode(expected)
+			&& RecordDecoder(savedRecord).Decode(actual)
+			&& expected == actual;
+	}
+
+	LineItemSnapshot GetLineItemSnapshot(HeadlessGame& game)
+	{
+		eastl::vector<cISC4LineItem*> lineItems;
+		game.GetBudgetSimulator().GetAllLineItems(lineItems);
+
+		LineItemSnapshot snapshot;
+
+		for (const cISC4LineItem* pLineItem : lineItems)
+		{
+			snapshot.emplace(
+				pLineItem->GetID(),
+				LineItemValues{ pLineItem->GetFullExpenses(), pLineItem->GetIncome(), pLineItem->GetSecondaryInfoField() });
+		}
+
+		return snapshot;
+	}
+
+	// Loads a city whose buildings were placed by a plugin version that did not store the line item
+	// transactions in the save game, and checks that the plugin creates the transactions from the
+	// city's buildings. If a building is missing from the occupant manager the building counts do not
+	// match the line items, and the plugin must leave the line items unchanged and not mark the city
+	// as migrated.
+	bool VerifyLegacyMigration(SaveLoadHarness& harness, SyntheticCity& city, bool omitBuilding)
+	{
+		HeadlessGame& game = harness.GetGame();
+
+		harness.ResetCity();
+		game.GetBudgetSimulator().Clear();
+
+		for (size_t i = 0; i < city.GetBuildingCount(); i++)
+		{
+			game.InsertOccupant(city.GetBuilding(i));
+		}
+
+		const LineItemSnapshot expected = GetLineItemSnapshot(game);
+
+		game.PostCityShutdown();
+
+		// The line items keep their building counts, the legacy plugin versions
+		// did not update the variable costs.
+		eastl::vector<cISC4LineItem*> lineItems;
+		game.GetBudgetSimulator().GetAllLineItems(lineItems);
+
+		for (cISC4LineItem* pLineItem : lineItems)
+		{
+			pLineItem->SetFullExpenses(0);
+			pLineItem->SetIncome(0);
+		}
+
+		LineItemSnapshot legacy = GetLineItemSnapshot(game);
+
+		// The game adds the saved buildings to the occupant manager without sending
+		// the InsertOccupant message.
+		for (size_t i = omitBuilding ? 1 : 0; i < city.GetBuildingCount(); i++)
+		{
+			game.GetOccupantManager().InsertOccupant(city.GetBuilding(i), 0);
+		}
+
+		harness.DeleteRecord();
+		harness.DeleteMigrationRecord();
+		harness.Load();
+		game.PostCityInit();
+
+		const LineItemSnapshot actual = GetLineItemSnapshot(game);
+
+		harness.DeleteMigrationRecord();
+		harness.Save();
+
+		const bool migrated = harness.HasMigrationRecord();
+
+		harness.ResetCity();
+		game.GetBudgetSimulator().Clear();
+
+		if (omitBuilding)
+		{
+			return !migrated && actual == legacy;
+		}
+
+		return migrated && !expected.empty() && actual == expected;
+	}
+
+	template<typename Callable> SaveLoadResult Measure(
+		const SaveGameCorpusEntry& entry,
+		const char* operation,
+		uint32_t iterations,
+		Callable&& callable)
+	{
+		const AllocationSnapshot before = AllocationTracker::GetSnapshot();
+		const auto start = std::chrono::steady_clock::now();
+
+		for (uint32_t i = 0; i < iterations; i++)
+		{
+			callable();
+		}
+
+		const auto end = std::chrono::steady_clock::now();
+		const AllocationSnapshot after = AllocationTracker::GetSnapshot();
+
+		const double seconds = std::chrono::duration<double>(end - start).count();
+		const double records = static_cast<double>(iterations);
+
+		SaveLoadResult result{};
+		result.name = entry.name;
+		result.operation = operation;
+		result.recordBytes = entry.record.size();
+		result.lineItemCount = entry.lineItemCount;
+		result.megabytesPerSecond = (static_cast<double>(entry.record.size()) * records) / (seconds * 1024.0 * 1024.0);
+		result.recordsPerSecond = records / seconds;
+		result.lineItemsPerSecond = (static_cast<double>(entry.lineItemCount) * records) / seconds;
+		result.allocationsPerRecord = static_cast<double>(after.allocationCount - before.allocationCount) / records;
+
+		std::printf(
+			"%-14s %-6s %12zu %10" PRIu32 " %12.2f %12.1f %14.0f %14.1f\n",
+			result.name.c_str(),
+			result.operation,
+			result.recordBytes,
+			result.lineItemCount,
+			result.megabytesPerSecond,
+			result.recordsPerSecond,
+			result.lineItemsPerSecond,
+			result.allocationsPerRecord);
+		std::fflush(stdout);
+
+		return result;
+	}
+
+	bool WriteCorpus(const std::filesystem::path& directory, const std::vector<SaveGameCorpusEntry>& corpus)
+	{
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+
+		for (const SaveGameCorpusEntry& entry : corpus)
+		{
+			std::ofstream stream(directory / (entry.name + ".bin"), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+			if (!stream)
+			{
+				return false;
+			}
+
+			stream.write(reinterpret_cast<const char*>(entry.record.data()), static_cast<std::streamsize>(entry.record.size()));
+
+			if (!stream)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool WriteJson(const std::string& path, uint32_t iterations, const std::vector<SaveLoadResult>& results)
+	{
+		std::ofstream stream(path, std::ofstream::out | std::ofstream::trunc);
+
+		if (!stream)
+		{
+			return false;
+		}
+
+		stream << "{\n  \"config\": {\"iterations\": " << iterations << "},\n  \"results\": [";
+
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const SaveLoadResult& result = results[i];
+
+			stream << (i == 0 ? "\n" : ",\n")
+				   << "    {\"name\": \"" << result.name
+				   << "\", \"operation\": \"" << result.operation
+				   << "\", \"recordBytes\": " << result.recordBytes
+				   << ", \"lineItems\": " << result.lineItemCount
+				   << ", \"megabytesPerSecond\": " << result.megabytesPerSecond
+				   << ", \"recordsPerSecond\": " << result.recordsPerSecond
+				   << ", \"lineItemsPerSecond\": " << result.lineItemsPerSecond
+				   << ", \"allocationsPerRecord\": " << result.allocationsPerRecord
+				   << "}";
+		}
+
+		stream << "\n  ]\n}\n";
+
+		return static_cast<bool>(stream);
+	}
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: CustomBudgetDepartmentsSaveLoadBenchmark [options]\n"
+			"  --iterations <n>        The number of times each record is loaded and saved, default 20.\n"
+			"  --verify-only           Only run the round-trip checks.\n"
+			"  --output <path>         Writes the results to the specified JSON file.\n"
+			"  --write-corpus <dir>    Writes the corpus records to the specified directory.\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t iterations = 20;
+	bool verifyOnly = false;
+	std::string outputPath;
+	std::string corpusPath;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const bool hasValue = i + 1 < argc;
+
+		if (std::strcmp(argv[i], "--iterations") == 0 && hasValue)
+		{
+			iterations = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (std::strcmp(argv[i], "--verify-only") == 0)
+		{
+			verifyOnly = true;
+		}
+		else if (std::strcmp(argv[i], "--output") == 0 && hasValue)
+		{
+			outputPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--write-corpus") == 0 && hasValue)
+		{
+			corpusPath = argv[++i];
+		}
+		else
+		{
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (iterations == 0)
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	const std::vector<SaveGameCorpusEntry> corpus = SaveGameCorpus::Generate();
+
+	if (!corpusPath.empty() && !WriteCorpus(corpusPath, corpus))
+	{
+		std::fprintf(stderr, "Unable to write the corpus to %s.\n", corpusPath.c_str());
+		return EXIT_FAILURE;
+	}
+
+	SaveLoadHarness harness;
+
+	uint32_t failureCount = 0;
+
+	for (const SaveGameCorpusEntry& entry : corpus)
+	{
+		const bool passed = VerifyRoundTrip(harness, entry);
+
+		std::printf("%-32s %-9s %s\n", entry.name.c_str(), entry.isValid ? "valid" : "invalid", passed ? "passed" : "FAILED");
+
+		if (!passed)
+		{
+			failureCount++;
+		}
+	}
+
+	std::printf("Round-trip: %zu records, %" PRIu32 " failed.\n", corpus.size(), failureCount);
+
+	{
+		SyntheticCityOptions options{};
+		options.buildingCount = 1000;
+		options.departmentCount = 10;
+		options.buildingsPerType = 10;
+		options.algorithmWeights = { 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+
+		SyntheticCity city(options);
+
+		const bool migrationPassed = VerifyLegacyMigration(harness, city, false);
+		const bool missingBuildingPassed = VerifyLegacyMigration(harness, city, true);
+
+		std::printf(
+			"Legacy migration: %s, with a missing building: %s.\n\n",
+			migrationPassed ? "passed" : "FAILED",
+			missingBuildingPassed ? "passed" : "FAILED");
+
+		if (!migrationPassed || !missingBuildingPassed)
+		{
+			failureCount++;
+		}
+	}
+
+	if (!verifyOnly)
+	{
+		std::printf(
+			"%-14s %-6s %12s %10s %12s %12s %14s %14s\n",
+			"Record",
+			"Op",
+			"Bytes",
+			"Line items",
+			"MB/s",
+			"Records/s",
+			"Line items/s",
+			"Allocs/record");
+
+		std::vector<SaveLoadResult> results;
+
+		for (const SaveGameCorpusEntry& entry : corpus)
+		{
+			if (entry.isValid && entry.lineItemCount > 0)
+			{
+				harness.ResetCity();
+				harness.SetRecord(entry.record);
+
+				results.push_back(Measure(entry, "Load", iterations, [&harness]() { harness.Load(); }));
+				results.push_back(Measure(entry, "Save", iterations, [&harness]() { harness.Save(); }));
+			}
+		}
+
+		if (!outputPath.empty() && !WriteJson(outputPath, iterations, results))
+		{
+			std::fprintf(stderr, "Unable to write %s.\n", outputPath.c_str());
+			return EXIT_FAILURE;
+		}
+	}
+
+	return failureCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,235 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "SyntheticCity.h"
+#include "AlgorithmInput.h"
+#include <algorithm>
+#include <cstdio>
+
+static constexpr uint32_t kBudgetItemDepartmentProperty = 0xEA54D283;
+static constexpr uint32_t kBudgetItemLineProperty = 0xEA54D284;
+static constexpr uint32_t kBudgetItemPurpose = 0xEA54D285;
+static constexpr uint32_t kBudgetItemCostProperty = 0xEA54D286;
+static constexpr uint32_t kCustomBudgetDepartmentBudgetGroupProperty = 0x90222B81;
+static constexpr uint32_t kCustomBudgetDepartmentNameKeyProperty = 0x4252085F;
+static constexpr uint32_t kCustomBudgetLineItemAlgorithm = 0x9EE1240F;
+static constexpr uint32_t kResidentialTotalPopulationFactorProperty = 0x9EE12410;
+static constexpr uint32_t kResidentialWealthGroupPopulationFactorsProperty = 0x9EE12411;
+static constexpr uint32_t kTourismFactorsProperty = 0x9EE12412;
+static constexpr uint32_t kFormulaProperty = 0x9EE12413;
+static constexpr uint32_t kTieredProperty = 0x9EE12414;
+static constexpr uint32_t kHistoryProperty = 0x9EE12415;
+static constexpr uint32_t kBuildingAgeProperty = 0x9EE12416;
+static constexpr uint32_t kResidentialCatchmentProperty = 0x9EE12417;
+static constexpr uint32_t kLineItemConditionProperty = 0x9EE12418;
+
+static constexpr uint32_t kCustomBudgetDepartmentExpensePurposeId = 0x87BD3990;
+static constexpr uint32_t kCustomBudgetDepartmentIncomePurposeId = 0x46261226;
+
+static constexpr std::array<uint32_t, 7> BudgetGroups =
+{
+	0xA5A72D1,
+	0x6A357B96,
+	0xEA597195,
+	0x6A357B7F,
+	0x4A357B40,
+	0xAA369059,
+	0x4A357EAF,
+};
+
+static constexpr uint32_t kFirstDepartmentId = 0x70000000;
+static constexpr uint32_t kFirstLineItemId = 0x60000000;
+static constexpr uint32_t kFirstBuildingTypeId = 0x50000000;
+static constexpr uint32_t kDepartmentNameGroupId = 0x26350A44;
+
+// A large city is 256 by 256 cells and each cell is 16 meters wide.
+static constexpr int32_t kCityCellCount = 256;
+static constexpr float kCellSizeInMeters = 16.0f;
+// The population grid tracts are 2 by 2 cells.
+static constexpr int32_t kPopulationGridTractShift = 1;
+
+namespace
+{
+	std::vector<TransactionAlgorithmType> CreateAlgorithmPattern(const std::array<uint32_t, 9>& weights)
+	{
+		std::vector<TransactionAlgorithmType> pattern;
+
+		for (size_t i = 0; i < weights.size(); i++)
+		{
+			pattern.insert(pattern.end(), weights[i], static_cast<TransactionAlgorithmType>(i));
+		}
+
+		if (pattern.empty())
+		{
+			pattern.push_back(TransactionAlgorithmType::Fixed);
+		}
+
+		return pattern;
+	}
+
+	std::unique_ptr<HeadlessPropertyHolder> CreateExemplar(
+		uint32_t departmentId,
+		uint32_t lineItemId,
+		bool isIncome,
+		TransactionAlgorithmType algorithm)
+	{
+		std::unique_ptr<HeadlessPropertyHolder> exemplar = std::make_unique<HeadlessPropertyHolder>();
+
+		const uint32_t budgetGroup = BudgetGroups[departmentId % BudgetGroups.size()];
+		const uint32_t purpose = isIncome ? kCustomBudgetDepartmentIncomePurposeId : kCustomBudgetDepartmentExpensePurposeId;
+		const int64_t lineItem = static_cast<int64_t>(lineItemId);
+
+		exemplar->SetUint32ArrayProperty(kBudgetItemDepartmentProperty, { departmentId });
+		exemplar->SetUint32ArrayProperty(kBudgetItemLineProperty, { lineItemId });
+		exemplar->SetUint32ArrayProperty(kBudgetItemPurpose, { purpose });
+		exemplar->SetSint64ArrayProperty(kBudgetItemCostProperty, { 100 });
+		exemplar->SetUint32ArrayProperty(kCustomBudgetDepartmentBudgetGroupProperty, { departmentId, budgetGroup });
+		exemplar->SetUint32ArrayProperty(kCustomBudgetDepartmentNameKeyProperty, { departmentId, kDepartmentNameGroupId, departmentId });
+		exemplar->SetUint32ArrayProperty(kCustomBudgetLineItemAlgorithm, { lineItemId, static_cast<uint32_t>(algorithm) });
+
+		if ((lineItemId % 4) == 0)
+		{
+			// A 10% discount while the tax rate of tax group 1 is below 9%. The benchmark and replay
+			// tools do not set the tax rates, so the condition is always true.
+			exemplar->SetSint64ArrayProperty(kLineItemConditionProperty, { lineItem, 3, 1, 90, 9, 10 });
+		}
+
+		switch (algorithm)
+		{
+		case TransactionAlgorithmType::ResidentialTotalPopulation:
+			exemplar->SetSint64ArrayProperty(kResidentialTotalPopulationFactorProperty, { lineItem, 2, 1000 });
+			break;
+		case TransactionAlgorithmType::ResidentialWealthGroupPopulation:
+			exemplar->SetSint64ArrayProperty(
+				kResidentialWealthGroupPopulationFactorsProperty,
+				{ lineItem, 1, 1000, 2, 1000, 3, 1000 });
+			break;
+		case TransactionAlgorithmType::Tourism:
+			exemplar->SetSint64ArrayProperty(kTourismFactorsProperty, { lineItem, 1, 10, 1000 });
+			break;
+		case TransactionAlgorithmType::Formula:
+		{
+			// The same expression is used for every building type, so all of the line items share one program.
+			char formula[256]{};
+			std::snprintf(
+				formula,
+				sizeof(formula),
+				"0x%08X = fixedCost + max(cityPopulation * 2 / 1000, regionPopulation / (1000 * 10))",
+				lineItemId);
+
+			exemplar->SetStringProperty(kFormulaProperty, formula);
+			break;
+		}
+		case TransactionAlgorithmType::Tiered:
+			// Every building type uses the same breakpoints, so all of the line items share one table.
+			exemplar->SetSint64ArrayProperty(
+				kTieredProperty,
+				{ lineItem, static_cast<int64_t>(AlgorithmInput::CityPopulation), 1, 4, 0, 0, 1000, 50, 10000, 200, 100000, 500 });
+			break;
+		case TransactionAlgorithmType::History:
+			// The headless host has no city history, the line items only use their fixed cost.
+			exemplar->SetSint64ArrayProperty(kHistoryProperty, { lineItem, 2, 12, 0, 1, 1000 });
+			break;
+		case TransactionAlgorithmType::BuildingAge:
+			exemplar->SetSint64ArrayProperty(kBuildingAgeProperty, { lineItem, 1, 12, 240 });
+			break;
+		case TransactionAlgorithmType::ResidentialCatchment:
+			exemplar->SetSint64ArrayProperty(kResidentialCatchmentProperty, { lineItem, 1, 100, 8 });
+			break;
+		case TransactionAlgorithmType::Fixed:
+		default:
+			break;
+		}
+
+		return exemplar;
+	}
+}
+
+SyntheticCity::SyntheticCity(const SyntheticCityOptions& options)
+	: exemplars(),
+	  buildings()
+{
+	const uint32_t departmentCount = std::max(options.departmentCount, 1U);
+	const uint32_t buildingsPerType = std::max(options.buildingsPerType, 1U);
+	const uint32_t buildingCount = options.buildingCount;
+
+	// Every department has at least one building type.
+	const uint32_t typeCount = std::max(
+		std::min(departmentCount, std::max(buildingCount, 1U)),
+		(buildingCount + buildingsPerType - 1) / buildingsPerType);
+
+	const std::vector<TransactionAlgorithmType> algorithmPattern = CreateAlgorithmPattern(options.algorithmWeights);
+
+	exemplars.reserve(typeCount);
+
+	for (uint32_t i = 0; i < typeCount; i++)
+	{
+		exemplars.push_back(CreateExemplar(
+			kFirstDepartmentId + (i % departmentCount),
+			kFirstLineItemId + i,
+			(i % 2) != 0,
+			algorithmPattern[i % algorithmPattern.size()]));
+	}
+
+	// The building types are interleaved so that the buildings of each type
+	// are added and removed throughout the benchmark.
+	for (uint32_t i = 0; i < buildingCount; i++)
+	{
+		const uint32_t type = i % typeCount;
+
+		HeadlessBuildingOccupant& building = buildings.emplace_back(kFirstBuildingTypeId + type, exemplars[type].get());
+
+		// The BuildingAge and ResidentialCatchment algorithms identify the buildings by their position.
+		// Each cell of the city has one building, the larger cities stack the extra buildings at
+		// small offsets within the cells.
+		const uint32_t cellIndex = i % (kCityCellCount * kCityCellCount);
+		const float offset = static_cast<float>(i / (kCityCellCount * kCityCellCount)) * 0.25f;
+		const cS3DVector3 position(
+			(static_cast<float>(cellIndex % kCityCellCount) * kCellSizeInMeters) + offset,
+			0.0f,
+			(static_cast<float>(cellIndex / kCityCellCount) * kCellSizeInMeters) + offset);
+		building.SetPosition(&position);
+		building.SetBuildingAge(static_cast<int32_t>(i % 120));
+	}
+}
+
+void SyntheticCity::InitializePopulationGrid(HeadlessPopulationGrid& grid) const
+{
+	grid.Resize(kCityCellCount, kPopulationGridTractShift);
+
+	const int32_t tractCount = grid.GetTractCountX();
+
+	// A repeating pattern of dense and sparse neighborhoods.
+	for (int32_t z = 0; z < tractCount; z++)
+	{
+		for (int32_t x = 0; x < tractCount; x++)
+		{
+			grid.SetTractValue(x, z, static_cast<uint16_t>(((x * 31) + (z * 17)) % 400));
+		}
+	}
+}
+
+size_t SyntheticCity::GetBuildingCount() const
+{
+	return buildings.size();
+}
+
+size_t SyntheticCity::GetBuildingTypeCount() const
+{
+	return exemplars.size();
+}
+
+HeadlessBuildingOccupant* SyntheticCity::GetBuilding(size_t index)
+{
+	return &buildings[index];
+}
@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "HeadlessBuildingOccupant.h"
+#include "HeadlessPopulationGrid.h"
+#include "HeadlessPropertyHolder.h"
+#include "TransactionAlgorithmType.h"
+#include <array>
+#include <deque>
+#include <memory>
+#include <vector>
+
+struct SyntheticCityOptions
+{
+	uint32_t buildingCount;
+	uint32_t departmentCount;
+	uint32_t buildingsPerType;
+	// The relative number of building types that use each algorithm,
+	// indexed by TransactionAlgorithmType.
+	std::array<uint32_t, 9> algorithmWeights;
+};
+
+/**
+ * @brief Generates the building exemplars and occupants for a benchmark city.
+ *
+ * Each building type has one custom budget line item, the building types are
+ * distributed evenly across the departments and the buildings are distributed
+ * evenly across the building types.
+ */
+class SyntheticCity
+{
+public:
+	SyntheticCity(const SyntheticCityOptions& options);
+
+	/**
+	 * @brief Fills the residential population grid of a large city.
+	 */
+	void InitializePopulationGrid(HeadlessPopulationGrid& grid) const;
+
+	size_t GetBuildingCount() const;
+	size_t GetBuildingTypeCount() const;
+
+	HeadlessBuildingOccupant* GetBuilding(size_t index);
+
+private:
+	std::vector<std::unique_ptr<HeadlessPropertyHolder>> exemplars;
+	std::deque<HeadlessBuildingOccupant> buildings;
+};
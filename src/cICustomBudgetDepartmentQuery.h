@@ -0,0 +1,209 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cIGZUnknown.h"
+#include <cstdint>
+
+// The interface and class ids that other DLL plugins use to access the custom budget department state.
+static constexpr uint32_t GZIID_cICustomBudgetDepartmentQuery = 0x5A1C7E93;
+static constexpr uint32_t GZCLSID_cICustomBudgetDepartmentQuery = 0xA6D3F28B;
+static constexpr uint32_t GZIID_cICustomBudgetLineItemListener = 0x3D84B1E6;
+
+struct CustomBudgetLineItemState
+{
+	uint32_t department;
+	uint32_t lineNumber;
+	uint32_t budgetGroup;
+	// The TransactionAlgorithmType value, the line items that were added before the
+	// transaction system was introduced use the Fixed algorithm.
+	uint32_t algorithmType;
+	int64_t buildingCount;
+	int64_t expenses;
+	int64_t income;
+};
+
+enum CustomBudgetLineItemChangeFlags : uint32_t
+{
+	CustomBudgetLineItemChangeFlag_None = 0,
+	// The line item was not in the city when the previous notification was sent.
+	CustomBudgetLineItemChangeFlag_Added = 1,
+	// The line item was removed from the city.
+	CustomBudgetLineItemChangeFlag_Removed = 2,
+};
+
+struct CustomBudgetLineItemChange
+{
+	uint32_t department;
+	uint32_t lineNumber;
+	uint32_t budgetGroup;
+	// A combination of the CustomBudgetLineItemChangeFlags values.
+	uint32_t flags;
+	int64_t oldBuildingCount;
+	int64_t newBuildingCount;
+	int64_t oldExpenses;
+	int64_t newExpenses;
+	int64_t oldIncome;
+	int64_t newIncome;
+};
+
+// The residential populations that the line item cost algorithms use,
+// the region populations do not include the current city.
+struct CustomBudgetPopulation
+{
+	int64_t city;
+	int64_t cityLowWealth;
+	int64_t cityMediumWealth;
+	int64_t cityHighWealth;
+	int64_t region;
+	int64_t regionLowWealth;
+	int64_t regionMediumWealth;
+	int64_t regionHighWealth;
+};
+
+// A linear population trajectory, month m of an n month projection uses the
+// population start + ((end - start) * m / n), so the last month uses the end population.
+struct CustomBudgetPopulationTrajectory
+{
+	CustomBudgetPopulation start;
+	CustomBudgetPopulation end;
+};
+
+struct CustomBudgetProjectedTotals
+{
+	uint32_t department;
+	// The number of months after the current month, starting at 1.
+	uint32_t month;
+	int64_t expenses;
+	int64_t income;
+};
+
+/**
+ * @brief Receives the line item changes from the custom budget departments plugin.
+ */
+class cICustomBudgetLineItemListener : public cIGZUnknown
+{
+public:
+	/**
+	 * @brief Called once per simulation month with the line items that changed since the previous notification.
+	 *
+	 * Each line item is listed once, the old values are the values when the previous notification was sent.
+	 * The buffer is owned by the plugin and it is only valid for the duration of the call.
+	 * @param pChanges The line item changes.
+	 * @param count The number of line item changes.
+	 */
+	virtual void LineItemsChanged(const CustomBudgetLineItemChange* pChanges, uint32_t count) = 0;
+};
+
+/**
+ * @brief Provides read-only access to the custom budget department state for other DLL plugins.
+ *
+ * The interface can be obtained by calling cIGZCOM::GetClassObject with GZCLSID_cICustomBudgetDepartmentQuery,
+ * or by calling QueryInterface on the plugin's COM director. The values are maintained by the plugin as the
+ * line items change, so the reads do not walk the game's budget objects. The expenses are the full expenses,
+ * before the department funding is applied. The interface must only be used on the game's main thread.
+ */
+class cICustomBudgetDepartmentQuery : public cIGZUnknown
+{
+public:
+	/**
+	 * @brief Gets the expense and income totals of a custom budget department.
+	 * @return True if the department is a custom budget department in the current city; otherwise, false.
+	 */
+	virtual bool GetDepartmentTotals(uint32_t department, int64_t& expenses, int64_t& income) const = 0;
+
+	/**
+	 * @brief Gets the expense and income totals of the custom budget departments in a budget group.
+	 * @return True if the budget group has at least one custom budget department; otherwise, false.
+	 */
+	virtual bool GetBudgetGroupTotals(uint32_t budgetGroup, int64_t& expenses, int64_t& income) const = 0;
+
+	/**
+	 * @brief Gets the state of a custom budget department line item.
+	 * @return True if the line item is in the current city; otherwise, false.
+	 */
+	virtual bool GetLineItemState(uint32_t department, uint32_t lineNumber, CustomBudgetLineItemState& state) const = 0;
+
+	virtual uint32_t GetLineItemCount() const = 0;
+
+	/**
+	 * @brief Copies the state of all of the custom budget department line items into the buffer.
+	 * @param pBuffer The buffer that receives the line items, use GetLineItemCount to determine its size.
+	 * @param capacity The number of line items that the buffer can hold.
+	 * @return The number of line items that were copied.
+	 */
+	virtual uint32_t CopyLineItems(CustomBudgetLineItemState* pBuffer, uint32_t capacity) const = 0;
+
+	/**
+	 * @brief Registers a listener for the line item changes.
+	 * @param pListener The listener, the plugin holds a reference until it is removed.
+	 * @param department The department to receive changes for, or 0 for all departments.
+	 * @param budgetGroup The budget group to receive changes for, or 0 for all budget groups.
+	 * @return True if the listener was added; otherwise, false if it is already registered.
+	 */
+	virtual bool AddLineItemListener(cICustomBudgetLineItemListener* pListener, uint32_t department, uint32_t budgetGroup) = 0;
+	virtual bool RemoveLineItemListener(cICustomBudgetLineItemListener* pListener) = 0;
+
+	/**
+	 * @brief Gets the current city and region populations, e.g. for the start of a population trajectory.
+	 * @return True if a city is loaded; otherwise, false.
+	 */
+	virtual bool GetCurrentPopulation(CustomBudgetPopulation& population) = 0;
+
+	/**
+	 * @brief Creates a population trajectory that continues the city's population trend.
+	 *
+	 * The city population changes by the same amount per month as the trend line of the history type,
+	 * the wealth groups keep their current share of the city population and the region population
+	 * does not change.
+	 * @param historyType The id of the history type that records the city's residential population.
+	 * @param historyMonthCount The number of months before the current date that the trend uses, 1 to 240.
+	 * @param monthCount The number of months to project, 1 to 120.
+	 * @param trajectory Receives the trajectory.
+	 * @return True on success; otherwise, false.
+	 */
+	virtual bool CreateHistoryTrajectory(
+		uint32_t historyType,
+		uint32_t historyMonthCount,
+		uint32_t monthCount,
+		CustomBudgetPopulationTrajectory& trajectory) = 0;
+
+	/**
+	 * @brief Projects the custom budget department totals for the following months.
+	 *
+	 * The line item totals are calculated in the same way as the monthly update, using the trajectory's
+	 * population for each month. The building ages increase by one month per month, the line item conditions,
+	 * the city history statistics and the ResidentialCatchment population grid keep their current values.
+	 * The game state is not modified, so the projection can be recalculated whenever the trajectory changes.
+	 * @param trajectory The population trajectory.
+	 * @param monthCount The number of months to project, 1 to 120.
+	 * @param pBuffer The buffer that receives the totals of each department for each month, ordered by month.
+	 * It needs monthCount values for each department, GetLineItemCount() * monthCount is always large enough.
+	 * @param capacity The number of values that the buffer can hold.
+	 * @return The number of values that were copied.
+	 */
+	virtual uint32_t ProjectDepartmentTotals(
+		const CustomBudgetPopulationTrajectory& trajectory,
+		uint32_t monthCount,
+		CustomBudgetProjectedTotals* pBuffer,
+		uint32_t capacity) = 0;
+
+	/**
+	 * @brief Gets the expense and income totals of a custom budget department in the other cities of the region.
+	 *
+	 * The totals are read from the region summary that the CustomBudgetDepartmentsRegionScan tool generates from
+	 * the region's save games, each city's totals are from its last save.
+	 * @return True if the region summary was loaded and another city has the department; otherwise, false.
+	 */
+	virtual bool GetRegionDepartmentTotals(uint32_t department, int64_t& expenses, int64_t& income) const = 0;
+};
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessAllocatorService.h"
+#include <cstdlib>
+
+HeadlessAllocatorService::HeadlessAllocatorService()
+	: refCount(0)
+{
+}
+
+bool HeadlessAllocatorService::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == kGZIID_cIGZAllocatorService)
+	{
+		*ppvObj = static_cast<cIGZAllocatorService*>(this);
+		AddRef();
+
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessAllocatorService::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessAllocatorService::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+void* HeadlessAllocatorService::Allocate(uint32_t dwSize)
+{
+	return std::malloc(dwSize);
+}
+
+bool HeadlessAllocatorService::Deallocate(void* pData)
+{
+	std::free(pData);
+
+	return true;
+}
+
+void* HeadlessAllocatorService::Reallocate(void* pData, uint32_t dwNewSize)
+{
+	return std::realloc(pData, dwNewSize);
+}
@@ -0,0 +1,39 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cIGZAllocatorService.h"
+
+static constexpr uint32_t kGZIID_cIGZAllocatorService = 0x3AE4BEAB;
+
+/**
+ * @brief A cIGZAllocatorService that uses the C runtime heap.
+ */
+class HeadlessAllocatorService final : public cIGZAllocatorService
+{
+public:
+	HeadlessAllocatorService();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cIGZAllocatorService
+
+	void* Allocate(uint32_t dwSize) override;
+	bool Deallocate(void* pData) override;
+	void* Reallocate(void* pData, uint32_t dwNewSize) override;
+
+private:
+	uint32_t refCount;
+};
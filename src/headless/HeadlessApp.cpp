@@ -0,0 +1,397 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessApp.h"
+
+HeadlessApp::HeadlessApp(cISC4City* pCity, cISC4Region* pRegion, cISC4RegionalCity* pRegionalCity)
+	: refCount(0),
+	  pCity(pCity),
+	  pRegion(pRegion),
+	  pRegionalCity(pRegionalCity)
+{
+}
+
+bool HeadlessApp::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cISC4App)
+	{
+		*ppvObj = static_cast<cISC4App*>(this);
+		AddRef();
+
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessApp::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessApp::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool HeadlessApp::OnIdle()
+{
+	return {};
+}
+
+bool HeadlessApp::RunMessageServerPump(uint32_t dwMinMessages, uint32_t dwMaxMessages, uint32_t dwMaxTime)
+{
+	return {};
+}
+
+bool HeadlessApp::RunMessageServer2Pump(uint32_t dwMinMessages, uint32_t dwMaxMessages, uint32_t dwMaxTime)
+{
+	return {};
+}
+
+bool HeadlessApp::RequestNewCity(intptr_t pCity)
+{
+	return {};
+}
+
+bool HeadlessApp::RequestLoadCity()
+{
+	return {};
+}
+
+bool HeadlessApp::RequestCloseCity(bool bShowConfirmPrompt)
+{
+	return {};
+}
+
+bool HeadlessApp::RequestSaveCity(bool bShowNotif, bool bFastSave)
+{
+	return {};
+}
+
+bool HeadlessApp::RequestQuit(bool bShowDialog, bool bSaveFirst)
+{
+	return {};
+}
+
+bool HeadlessApp::RequestQuitFromRegion(bool bShowDialog)
+{
+	return {};
+}
+
+bool HeadlessApp::RequestGoToRegionView(bool bShowDialog)
+{
+	return {};
+}
+
+bool HeadlessApp::LoadCity(cIGZString& szString, intptr_t pCityOut)
+{
+	return {};
+}
+
+bool HeadlessApp::CloseCity()
+{
+	return {};
+}
+
+bool HeadlessApp::SaveCity(bool bFastSave)
+{
+	return {};
+}
+
+bool HeadlessApp::SaveCity(cIGZString const& szName, bool bFastSave)
+{
+	return {};
+}
+
+bool HeadlessApp::SavePreferences()
+{
+	return {};
+}
+
+bool HeadlessApp::EnableFullGamePauseOnAppFocusLoss(bool bEnable)
+{
+	return {};
+}
+
+bool HeadlessApp::ApplyVideoPreferences(SC4VideoPreferences const& sPreferences)
+{
+	return {};
+}
+
+bool HeadlessApp::GetAutoVideoPreferences(SC4VideoPreferences& pPreferencesOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetDebugFunctionalityEnabled()
+{
+	return {};
+}
+
+cISC4App* HeadlessApp::SetDebugFunctionalityEnabled(bool bEnabled)
+{
+	return {};
+}
+
+bool HeadlessApp::GetPopupDialogsEnabled()
+{
+	return {};
+}
+
+cISC4App* HeadlessApp::SetPopupDialogsEnabled(bool bEnabled)
+{
+	return {};
+}
+
+int32_t HeadlessApp::GetAppState()
+{
+	return {};
+}
+
+cIGZWin* HeadlessApp::GetMainWindow()
+{
+	return {};
+}
+
+bool HeadlessApp::GetAppName(cIGZString& szNameOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetAppIniFileName(cIGZString& szPathOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetAppIniFilePath(cIGZString& szPathOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetAppPreferencesFileName(cIGZString& szPathOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetAppPreferencesFilePath(cIGZString& szPathOut)
+{
+	return {};
+}
+
+cISC4FeatureManager* HeadlessApp::GetFeatureManager()
+{
+	return {};
+}
+
+cIGZCheatCodeManager* HeadlessApp::GetCheatCodeManager()
+{
+	return {};
+}
+
+cISC4Nation* HeadlessApp::GetNation()
+{
+	return {};
+}
+
+cISC4Region* HeadlessApp::GetRegion()
+{
+	return pRegion;
+}
+
+cISC4RegionalCity* HeadlessApp::GetRegionalCity()
+{
+	return pRegionalCity;
+}
+
+cISC4City* HeadlessApp::GetCity()
+{
+	return pCity;
+}
+
+SC4Preferences* HeadlessApp::GetPreferences()
+{
+	return {};
+}
+
+intptr_t HeadlessApp::GetNewCitySpecification()
+{
+	return {};
+}
+
+intptr_t HeadlessApp::GetDebugConsole()
+{
+	return {};
+}
+
+intptr_t HeadlessApp::GetGimexFactory()
+{
+	return {};
+}
+
+intptr_t HeadlessApp::GetStringDetokenizer()
+{
+	return {};
+}
+
+intptr_t HeadlessApp::GetWinLocationSaver()
+{
+	return {};
+}
+
+cISC4RenderProperties* HeadlessApp::GetRenderProperties()
+{
+	return {};
+}
+
+intptr_t HeadlessApp::GetGlyphTextureManager()
+{
+	return {};
+}
+
+intptr_t HeadlessApp::GetLuaInterpreter()
+{
+	return {};
+}
+
+intptr_t HeadlessApp::GetTutorialRegistry()
+{
+	return {};
+}
+
+intptr_t HeadlessApp::GetExeceptionReportsDirectory() const
+{
+	return {};
+}
+
+intptr_t HeadlessApp::Unknown1()
+{
+	return {};
+}
+
+bool HeadlessApp::IsRunFirstTimeAfterInstall()
+{
+	return {};
+}
+
+bool HeadlessApp::GetAppDirectory(cIGZString& szPathOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetCDAppDirectory(cIGZString& szPathOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetDataDirectory(cIGZString& szPathOutt, int32_t index)
+{
+	return {};
+}
+
+bool HeadlessApp::GetCDDataDirectory(cIGZString& szPathOut, int32_t index)
+{
+	return {};
+}
+
+bool HeadlessApp::GetPluginDirectory(cIGZString& szPathOu)
+{
+	return {};
+}
+
+bool HeadlessApp::GetCDPluginDirectory(cIGZString& szPathOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetSkuSpecificDirectory(cIGZString& szPathOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetUserDataDirectory(cIGZString& szPathOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetUserPluginDirectory(cIGZString& szPathOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetRegionsDirectory(cIGZString& szPathOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetMySimDirectory(cIGZString& szPathOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetAlbumDirectory(cIGZString& szPathOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetHTTPCacheDirectory(cIGZString& szPathOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetTempDirectory(cIGZString& szPathOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetExceptionReportsDirectory(cIGZString& szPathOut)
+{
+	return {};
+}
+
+bool HeadlessApp::GetTestScriptDirectory(cIGZString& szPathOut)
+{
+	return {};
+}
+
+bool HeadlessApp::AddDynamicLibraryByName(cIGZString const& sName, cIGZString* pBasePath, bool bIgnoreINI)
+{
+	return {};
+}
+
+bool HeadlessApp::AddDynamicLibraryByPath(cIGZString const& sPath, bool bIgnoreINI)
+{
+	return {};
+}
+
+bool HeadlessApp::RegisterShutdownCallbackFunction(ShutdownCallback pfCallback, void* pUnknown)
+{
+	return {};
+}
+
+bool HeadlessApp::UnregisterShutdownCallbackFunction(ShutdownCallback pfCallback, void* pUnknown)
+{
+	return {};
+}
@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4App.h"
+
+/**
+ * @brief An in-memory cISC4App that provides the current city and region.
+ */
+class HeadlessApp final : public cISC4App
+{
+public:
+	HeadlessApp(cISC4City* pCity, cISC4Region* pRegion, cISC4RegionalCity* pRegionalCity);
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cISC4App
+
+	bool OnIdle() override;
+	bool RunMessageServerPump(uint32_t dwMinMessages, uint32_t dwMaxMessages, uint32_t dwMaxTime) override;
+	bool RunMessageServer2Pump(uint32_t dwMinMessages, uint32_t dwMaxMessages, uint32_t dwMaxTime) override;
+	bool RequestNewCity(intptr_t pCity) override;
+	bool RequestLoadCity() override;
+	bool RequestCloseCity(bool bShowConfirmPrompt) override;
+	bool RequestSaveCity(bool bShowNotif, bool bFastSave) override;
+	bool RequestQuit(bool bShowDialog, bool bSaveFirst) override;
+	bool RequestQuitFromRegion(bool bShowDialog) override;
+	bool RequestGoToRegionView(bool bShowDialog) override;
+	bool LoadCity(cIGZString& szString, intptr_t pCityOut) override;
+	bool CloseCity() override;
+	bool SaveCity(bool bFastSave) override;
+	bool SaveCity(cIGZString const& szName, bool bFastSave) override;
+	bool SavePreferences() override;
+	bool EnableFullGamePauseOnAppFocusLoss(bool bEnable) override;
+	bool ApplyVideoPreferences(SC4VideoPreferences const& sPreferences) override;
+	bool GetAutoVideoPreferences(SC4VideoPreferences& pPreferencesOut) override;
+	bool GetDebugFunctionalityEnabled() override;
+	cISC4App* SetDebugFunctionalityEnabled(bool bEnabled) override;
+	bool GetPopupDialogsEnabled() override;
+	cISC4App* SetPopupDialogsEnabled(bool bEnabled) override;
+	int32_t GetAppState() override;
+	cIGZWin* GetMainWindow() override;
+	bool GetAppName(cIGZString& szNameOut) override;
+	bool GetAppIniFileName(cIGZString& szPathOut) override;
+	bool GetAppIniFilePath(cIGZString& szPathOut) override;
+	bool GetAppPreferencesFileName(cIGZString& szPathOut) override;
+	bool GetAppPreferencesFilePath(cIGZString& szPathOut) override;
+	cISC4FeatureManager* GetFeatureManager() override;
+	cIGZCheatCodeManager* GetCheatCodeManager() override;
+	cISC4Nation* GetNation() override;
+	cISC4Region* GetRegion() override;
+	cISC4RegionalCity* GetRegionalCity() override;
+	cISC4City* GetCity() override;
+	SC4Preferences* GetPreferences() override;
+	intptr_t GetNewCitySpecification() override;
+	intptr_t GetDebugConsole() override;
+	intptr_t GetGimexFactory() override;
+	intptr_t GetStringDetokenizer() override;
+	intptr_t GetWinLocationSaver() override;
+	cISC4RenderProperties* GetRenderProperties() override;
+	intptr_t GetGlyphTextureManager() override;
+	intptr_t GetLuaInterpreter() override;
+	intptr_t GetTutorialRegistry() override;
+	intptr_t GetExeceptionReportsDirectory() const override;
+	intptr_t Unknown1() override;
+	bool IsRunFirstTimeAfterInstall() override;
+	bool GetAppDirectory(cIGZString& szPathOut) override;
+	bool GetCDAppDirectory(cIGZString& szPathOut) override;
+	bool GetDataDirectory(cIGZString& szPathOutt, int32_t index) override;
+	bool GetCDDataDirectory(cIGZString& szPathOut, int32_t index) override;
+	bool GetPluginDirectory(cIGZString& szPathOu) override;
+	bool GetCDPluginDirectory(cIGZString& szPathOut) override;
+	bool GetSkuSpecificDirectory(cIGZString& szPathOut) override;
+	bool GetUserDataDirectory(cIGZString& szPathOut) override;
+	bool GetUserPluginDirectory(cIGZString& szPathOut) override;
+	bool GetRegionsDirectory(cIGZString& szPathOut) override;
+	bool GetMySimDirectory(cIGZString& szPathOut) override;
+	bool GetAlbumDirectory(cIGZString& szPathOut) override;
+	bool GetHTTPCacheDirectory(cIGZString& szPathOut) override;
+	bool GetTempDirectory(cIGZString& szPathOut) override;
+	bool GetExceptionReportsDirectory(cIGZString& szPathOut) override;
+	bool GetTestScriptDirectory(cIGZString& szPathOut) override;
+	bool AddDynamicLibraryByName(cIGZString const& sName, cIGZString* pBasePath, bool bIgnoreINI) override;
+	bool AddDynamicLibraryByPath(cIGZString const& sPath, bool bIgnoreINI) override;
+	bool RegisterShutdownCallbackFunction(ShutdownCallback pfCallback, void* pUnknown) override;
+	bool UnregisterShutdownCallbackFunction(ShutdownCallback pfCallback, void* pUnknown) override;
+
+private:
+	uint32_t refCount;
+	cISC4City* pCity;
+	cISC4Region* pRegion;
+	cISC4RegionalCity* pRegionalCity;
+};
@@ -0,0 +1,376 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessBudgetSimulator.h"
+
+HeadlessBudgetSimulator::HeadlessBudgetSimulator()
+	: refCount(0),
+	  totalFunds(0),
+	  departments(),
+	  taxRates()
+{
+}
+
+bool HeadlessBudgetSimulator::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessBudgetSimulator::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessBudgetSimulator::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool HeadlessBudgetSimulator::Init()
+{
+	return true;
+}
+
+bool HeadlessBudgetSimulator::Shutdown()
+{
+	departments.clear();
+
+	return true;
+}
+
+bool HeadlessBudgetSimulator::SetTotalFunds(int64_t llFunds)
+{
+	totalFunds = llFunds;
+
+	return true;
+}
+
+int64_t HeadlessBudgetSimulator::GetTotalFunds()
+{
+	return totalFunds;
+}
+
+bool HeadlessBudgetSimulator::DepositFunds(int64_t llFunds)
+{
+	totalFunds += llFunds;
+
+	return true;
+}
+
+bool HeadlessBudgetSimulator::WithdrawFunds(int64_t llFunds)
+{
+	totalFunds -= llFunds;
+
+	return true;
+}
+
+int64_t HeadlessBudgetSimulator::GetMinAllowableFunds()
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetYTDIncome()
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetEstIncome()
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetYTDExpenses()
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetEstExpenses()
+{
+	return {};
+}
+
+uint32_t HeadlessBudgetSimulator::GetTotalMonthlyExpense()
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetTotalYearlyExpense()
+{
+	return {};
+}
+
+int32_t HeadlessBudgetSimulator::GetTotalMonthlyIncome()
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetTotalYearlyIncome()
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetTaxIncome()
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetTaxIncome(int32_t nTaxType)
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::SetTotalMonthlyExpense(int64_t llExpense)
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::SetTotalYearlyExpense(int64_t llExpense)
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::SetTotalMonthlyIncome(int64_t llIncome)
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::SetTotalYearlyIncome(int64_t llIncome)
+{
+	return {};
+}
+
+bool HeadlessBudgetSimulator::ShowBudgetWindow()
+{
+	return {};
+}
+
+cISC4DepartmentBudget* HeadlessBudgetSimulator::CreateDepartmentBudget(uint32_t dwDepartmentID, uint32_t dwBudgetGroup)
+{
+	auto pair = departments.try_emplace(dwDepartmentID, nullptr);
+
+	if (pair.second)
+	{
+		pair.first->second = std::make_unique<HeadlessDepartmentBudget>(dwDepartmentID, dwBudgetGroup);
+	}
+
+	return pair.first->second.get();
+}
+
+bool HeadlessBudgetSimulator::RemoveDepartmentBudget(uint32_t dwDepartmentID)
+{
+	return departments.erase(dwDepartmentID) == 1;
+}
+
+cISC4DepartmentBudget* HeadlessBudgetSimulator::GetDepartmentBudget(uint32_t dwDepartmentID)
+{
+	cISC4DepartmentBudget* pDepartment = nullptr;
+
+	const auto& item = departments.find(dwDepartmentID);
+
+	if (item != departments.end())
+	{
+		pDepartment = item->second.get();
+	}
+
+	return pDepartment;
+}
+
+cISC4DepartmentBudget* HeadlessBudgetSimulator::GetDepartmentBudget(cIGZString const& szDepartmentName)
+{
+	return {};
+}
+
+bool HeadlessBudgetSimulator::GetAllGroups(eastl::vector<BudgetGroupInfo>& sGroups)
+{
+	return {};
+}
+
+bool HeadlessBudgetSimulator::SetGroupName(uint32_t dwGroupID, cIGZString& szName)
+{
+	return {};
+}
+
+bool HeadlessBudgetSimulator::GetDepartmentBudgetsInGroup(uint32_t dwGroupID, eastl::vector<cISC4DepartmentBudget*>& sGroups)
+{
+	for (const auto& item : departments)
+	{
+		if (item.second->GetBudgetGroup() == dwGroupID)
+		{
+			sGroups.push_back(item.second.get());
+		}
+	}
+
+	return true;
+}
+
+void HeadlessBudgetSimulator::NeededFundingChanged(cISC4DepartmentBudget* pDepartmentBudget)
+{
+}
+
+void HeadlessBudgetSimulator::FundingPercentageChanged(cISC4DepartmentBudget* pDepartmentBudget)
+{
+}
+
+int64_t HeadlessBudgetSimulator::GetFunding(uint32_t dwUnknownID)
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetFunding(cISC4DepartmentBudget* pDepartmentBudget)
+{
+	return {};
+}
+
+float HeadlessBudgetSimulator::GetTaxRate(uint32_t dwTaxGroup)
+{
+	const auto& item = taxRates.find(dwTaxGroup);
+
+	return item != taxRates.end() ? item->second : 0.0f;
+}
+
+bool HeadlessBudgetSimulator::SetTaxRate(uint32_t dwTaxGroup, float fRate)
+{
+	taxRates[dwTaxGroup] = fRate;
+	return true;
+}
+
+int64_t HeadlessBudgetSimulator::GetWeightedAssessedTaxValue(uint32_t dwTaxGroup)
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetBondIncrement()
+{
+	return {};
+}
+
+bool HeadlessBudgetSimulator::IssueBond(uint32_t dwBondAmount)
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetTotalBorrowed()
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetCurrentBorrowingLimit()
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetCurrentBondLimit()
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetCurrentMaxOutstandingBondsLimit()
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetTotalMonthlyBondPayments()
+{
+	return {};
+}
+
+bool HeadlessBudgetSimulator::GetAllLoans(eastl::vector<LoanInfo>& sLoans)
+{
+	return {};
+}
+
+int32_t HeadlessBudgetSimulator::GetLoanTimeInMonths()
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetMonthlyPaymentForLoan(int64_t llLoanAmount)
+{
+	return {};
+}
+
+int64_t HeadlessBudgetSimulator::GetFullCostOfLoan(int64_t llLoanAmount)
+{
+	return {};
+}
+
+bool HeadlessBudgetSimulator::GetBudgetItemInfo(cISCPropertyHolder* pProperty, eastl::vector<BudgetItem>& sBudgetInfo)
+{
+	return {};
+}
+
+bool HeadlessBudgetSimulator::GetBudgetItemForPurpose(cISCPropertyHolder* pProperty, uint32_t dwPurpose, BudgetItem& sBudgetItem)
+{
+	return {};
+}
+
+bool HeadlessBudgetSimulator::ChangeBudgetItemLine(cISCPropertyHolder* pProperty, uint32_t dwPurpose, uint32_t dwLine)
+{
+	return {};
+}
+
+bool HeadlessBudgetSimulator::ChangeBudgetItemCost(cISCPropertyHolder* pProperty, uint32_t dwPurpose, int64_t llCost)
+{
+	return {};
+}
+
+bool HeadlessBudgetSimulator::ChangeBudgetItemLocalFunding(cISCPropertyHolder* pProperty, uint32_t dwPurpose, SC4Percentage const& sFunding)
+{
+	return {};
+}
+
+bool HeadlessBudgetSimulator::AddBudgetItemToBudget(cISCPropertyHolder* pProperty, uint32_t dwPurpose)
+{
+	return {};
+}
+
+bool HeadlessBudgetSimulator::RemoveBudgetItemFromBudget(cISCPropertyHolder* pProperty, uint32_t dwPurpose)
+{
+	return {};
+}
+
+cISC4LineItem* HeadlessBudgetSimulator::GetLineItemFromBudgetItem(BudgetItem& pBudgetItem)
+{
+	return {};
+}
+
+bool HeadlessBudgetSimulator::CopyBudgetItemProperties(cISCPropertyHolder* pOriginal, cISCPropertyHolder* pCopy)
+{
+	return {};
+}
+
+void HeadlessBudgetSimulator::Clear()
+{
+	departments.clear();
+}
+
+void HeadlessBudgetSimulator::GetAllLineItems(eastl::vector<cISC4LineItem*>& destination)
+{
+	for (const auto& item : departments)
+	{
+		item.second->GetAllLineItems(destination);
+	}
+}
@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4BudgetSimulator.h"
+#include "HeadlessDepartmentBudget.h"
+#include <memory>
+#include <unordered_map>
+
+/**
+ * @brief An in-memory budget simulator that owns the city's budget departments.
+ */
+class HeadlessBudgetSimulator final : public cISC4BudgetSimulator
+{
+public:
+	HeadlessBudgetSimulator();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cISC4BudgetSimulator
+
+	bool Init() override;
+	bool Shutdown() override;
+	bool SetTotalFunds(int64_t llFunds) override;
+	int64_t GetTotalFunds() override;
+	bool DepositFunds(int64_t llFunds) override;
+	bool WithdrawFunds(int64_t llFunds) override;
+	int64_t GetMinAllowableFunds() override;
+	int64_t GetYTDIncome() override;
+	int64_t GetEstIncome() override;
+	int64_t GetYTDExpenses() override;
+	int64_t GetEstExpenses() override;
+	uint32_t GetTotalMonthlyExpense() override;
+	int64_t GetTotalYearlyExpense() override;
+	int32_t GetTotalMonthlyIncome() override;
+	int64_t GetTotalYearlyIncome() override;
+	int64_t GetTaxIncome() override;
+	int64_t GetTaxIncome(int32_t nTaxType) override;
+	int64_t SetTotalMonthlyExpense(int64_t llExpense) override;
+	int64_t SetTotalYearlyExpense(int64_t llExpense) override;
+	int64_t SetTotalMonthlyIncome(int64_t llIncome) override;
+	int64_t SetTotalYearlyIncome(int64_t llIncome) override;
+	bool ShowBudgetWindow() override;
+	cISC4DepartmentBudget* CreateDepartmentBudget(uint32_t dwDepartmentID, uint32_t dwBudgetGroup) override;
+	bool RemoveDepartmentBudget(uint32_t dwDepartmentID) override;
+	cISC4DepartmentBudget* GetDepartmentBudget(uint32_t dwDepartmentID) override;
+	cISC4DepartmentBudget* GetDepartmentBudget(cIGZString const& szDepartmentName) override;
+	bool GetAllGroups(eastl::vector<BudgetGroupInfo>& sGroups) override;
+	bool SetGroupName(uint32_t dwGroupID, cIGZString& szName) override;
+	bool GetDepartmentBudgetsInGroup(uint32_t dwGroupID, eastl::vector<cISC4DepartmentBudget*>& sGroups) override;
+	void NeededFundingChanged(cISC4DepartmentBudget* pDepartmentBudget) override;
+	void FundingPercentageChanged(cISC4DepartmentBudget* pDepartmentBudget) override;
+	int64_t GetFunding(uint32_t dwUnknownID) override;
+	int64_t GetFunding(cISC4DepartmentBudget* pDepartmentBudget) override;
+	float GetTaxRate(uint32_t dwTaxGroup) override;
+	bool SetTaxRate(uint32_t dwTaxGroup, float fRate) override;
+	int64_t GetWeightedAssessedTaxValue(uint32_t dwTaxGroup) override;
+	int64_t GetBondIncrement() override;
+	bool IssueBond(uint32_t dwBondAmount) override;
+	int64_t GetTotalBorrowed() override;
+	int64_t GetCurrentBorrowingLimit() override;
+	int64_t GetCurrentBondLimit() override;
+	int64_t GetCurrentMaxOutstandingBondsLimit() override;
+	int64_t GetTotalMonthlyBondPayments() override;
+	bool GetAllLoans(eastl::vector<LoanInfo>& sLoans) override;
+	int32_t GetLoanTimeInMonths() override;
+	int64_t GetMonthlyPaymentForLoan(int64_t llLoanAmount) override;
+	int64_t GetFullCostOfLoan(int64_t llLoanAmount) override;
+	bool GetBudgetItemInfo(cISCPropertyHolder* pProperty, eastl::vector<BudgetItem>& sBudgetInfo) override;
+	bool GetBudgetItemForPurpose(cISCPropertyHolder* pProperty, uint32_t dwPurpose, BudgetItem& sBudgetItem) override;
+	bool ChangeBudgetItemLine(cISCPropertyHolder* pProperty, uint32_t dwPurpose, uint32_t dwLine) override;
+	bool ChangeBudgetItemCost(cISCPropertyHolder* pProperty, uint32_t dwPurpose, int64_t llCost) override;
+	bool ChangeBudgetItemLocalFunding(cISCPropertyHolder* pProperty, uint32_t dwPurpose, SC4Percentage const& sFunding) override;
+	bool AddBudgetItemToBudget(cISCPropertyHolder* pProperty, uint32_t dwPurpose) override;
+	bool RemoveBudgetItemFromBudget(cISCPropertyHolder* pProperty, uint32_t dwPurpose) override;
+	cISC4LineItem* GetLineItemFromBudgetItem(BudgetItem& pBudgetItem) override;
+	bool CopyBudgetItemProperties(cISCPropertyHolder* pOriginal, cISCPropertyHolder* pCopy) override;
+
+	/**
+	 * @brief Removes all of the budget departments, e.g. when a different city is loaded.
+	 */
+	void Clear();
+
+	/**
+	 * @brief Gets the line items of every budget department.
+	 */
+	void GetAllLineItems(eastl::vector<cISC4LineItem*>& destination);
+
+private:
+	uint32_t refCount;
+	int64_t totalFunds;
+	std::unordered_map<uint32_t, std::unique_ptr<HeadlessDepartmentBudget>> departments;
+	std::unordered_map<uint32_t, float> taxRates;
+};
@@ -0,0 +1,319 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessBuildingOccupant.h"
+
+HeadlessBuildingOccupant::HeadlessBuildingOccupant(uint32_t buildingType, cISCPropertyHolder* pPropertyHolder)
+	: refCount(0),
+	  buildingType(buildingType),
+	  buildingAge(0),
+	  pPropertyHolder(pPropertyHolder),
+	  position(),
+	  buildingProfile()
+{
+}
+
+bool HeadlessBuildingOccupant::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cISC4BuildingOccupant)
+	{
+		*ppvObj = static_cast<cISC4BuildingOccupant*>(this);
+		AddRef();
+
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(static_cast<cISC4Occupant*>(this));
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessBuildingOccupant::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessBuildingOccupant::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool HeadlessBuildingOccupant::Init()
+{
+	return true;
+}
+
+bool HeadlessBuildingOccupant::Shutdown()
+{
+	return true;
+}
+
+bool HeadlessBuildingOccupant::IsInitialized()
+{
+	return true;
+}
+
+cISCPropertyHolder* HeadlessBuildingOccupant::AsPropertyHolder()
+{
+	return pPropertyHolder;
+}
+
+int32_t HeadlessBuildingOccupant::GetType()
+{
+	constexpr uint32_t kOccupantType_Building = 0x278128A0;
+
+	return static_cast<int32_t>(kOccupantType_Building);
+}
+
+bool HeadlessBuildingOccupant::GetPosition(cS3DVector3* pVector)
+{
+	bool result = false;
+
+	if (pVector)
+	{
+		*pVector = position;
+		result = true;
+	}
+
+	return result;
+}
+
+bool HeadlessBuildingOccupant::SetPosition(cS3DVector3 const* pVector)
+{
+	bool result = false;
+
+	if (pVector)
+	{
+		position = *pVector;
+		result = true;
+	}
+
+	return result;
+}
+
+cS3DVector3* HeadlessBuildingOccupant::GetBoundingBox(cS3DVector3* pTopLeftVec, cS3DVector3* pBottomRightVec)
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::GetBoundingCityCells(SC4Rect<long>& sRect)
+{
+	return {};
+}
+
+uint32_t HeadlessBuildingOccupant::SetRemovalFlags(uint32_t dwFlags)
+{
+	return {};
+}
+
+uint32_t HeadlessBuildingOccupant::UnsetRemovalFlags(uint32_t dwFlags)
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::CanRemove(uint32_t dwFlags)
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::PostOccupantMessage(uint32_t dwMessageID, uint32_t dwData)
+{
+	return {};
+}
+
+uint32_t HeadlessBuildingOccupant::GetHighlight()
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::SetHighlight(uint32_t dwHighlight, bool bSendMessageNow)
+{
+	return {};
+}
+
+uint8_t HeadlessBuildingOccupant::SetVisibility(bool bVisible, bool bSendMessage)
+{
+	return {};
+}
+
+cISC43DPlaceableObject* HeadlessBuildingOccupant::GetPlaceableObject()
+{
+	return {};
+}
+
+cISC43DPlaceableObject* HeadlessBuildingOccupant::GetOrCreatePlaceableObject()
+{
+	return {};
+}
+
+cISC43DPlaceableObject* HeadlessBuildingOccupant::SetPlaceableObject(cISC43DPlaceableObject* pObject)
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::IsOccupantGroup(uint32_t dwGroup)
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::AddOccupantGroup(uint32_t dwGroup)
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::GetOccupantGroups(std::set<uint32_t>& sGroups)
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::GetOccupantManagerBBox(uint8_t* cBoxArray)
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::SetOccupantManagerBBox(uint8_t* cBoxArray)
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::GetLotTag(uint32_t& dwLotTag)
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::SetLotTag(uint32_t dwLotTag)
+{
+	return {};
+}
+
+uint32_t HeadlessBuildingOccupant::SetFlag(uint32_t dwFlags)
+{
+	return {};
+}
+
+cISC4Occupant* HeadlessBuildingOccupant::SetAllFlags(uint32_t dwFlags)
+{
+	return {};
+}
+
+uint32_t HeadlessBuildingOccupant::ClearFlag(uint32_t dwFlags)
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::IsFlagSet(uint32_t dwFlags)
+{
+	return {};
+}
+
+uint32_t HeadlessBuildingOccupant::GetFlags()
+{
+	return {};
+}
+
+cISC4Occupant* HeadlessBuildingOccupant::AsOccupant()
+{
+	return this;
+}
+
+uint32_t HeadlessBuildingOccupant::GetBuildingType()
+{
+	return buildingType;
+}
+
+cISC4BuildingOccupant* HeadlessBuildingOccupant::SetBuildingType(uint32_t buildingType)
+{
+	this->buildingType = buildingType;
+
+	return this;
+}
+
+int32_t HeadlessBuildingOccupant::GetBuildingAge()
+{
+	return buildingAge;
+}
+
+void HeadlessBuildingOccupant::SetBuildingAge(int32_t age)
+{
+	buildingAge = age;
+}
+
+bool HeadlessBuildingOccupant::SetBoundingBox(float const* fTopLeft, float const* fBottomRight)
+{
+	return {};
+}
+
+SC4Percentage* HeadlessBuildingOccupant::GetCompletionPercent()
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::SetCompletionPercent(SC4Percentage const&)
+{
+	return {};
+}
+
+cISC4BuildingOccupant::BuildingProfile& HeadlessBuildingOccupant::GetBuildingProfile()
+{
+	return buildingProfile;
+}
+
+cIGZString* HeadlessBuildingOccupant::GetBuildingName()
+{
+	return {};
+}
+
+cIGZString* HeadlessBuildingOccupant::GetExemplarName()
+{
+	return {};
+}
+
+int32_t HeadlessBuildingOccupant::GetOrientation()
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::SetOrientation(int32_t)
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::IsLit()
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::SetLit(bool)
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::SetName(cIGZString&)
+{
+	return {};
+}
+
+bool HeadlessBuildingOccupant::GetName(cIGZString&)
+{
+	return {};
+}
@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4Occupant.h"
+#include "cISC4BuildingOccupant.h"
+#include "cS3DVector3.h"
+
+/**
+ * @brief An in-memory building occupant.
+ *
+ * The building uses the properties of the specified property holder, which is
+ * usually shared by all of the buildings of the same type.
+ */
+class HeadlessBuildingOccupant final : public cISC4Occupant, public cISC4BuildingOccupant
+{
+public:
+	HeadlessBuildingOccupant(uint32_t buildingType, cISCPropertyHolder* pPropertyHolder);
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cISC4Occupant
+
+	bool Init() override;
+	bool Shutdown() override;
+	bool IsInitialized() override;
+	cISCPropertyHolder* AsPropertyHolder() override;
+	int32_t GetType() override;
+	bool GetPosition(cS3DVector3* pVector) override;
+	bool SetPosition(cS3DVector3 const* pVector) override;
+	cS3DVector3* GetBoundingBox(cS3DVector3* pTopLeftVec, cS3DVector3* pBottomRightVec) override;
+	bool GetBoundingCityCells(SC4Rect<long>& sRect) override;
+	uint32_t SetRemovalFlags(uint32_t dwFlags) override;
+	uint32_t UnsetRemovalFlags(uint32_t dwFlags) override;
+	bool CanRemove(uint32_t dwFlags) override;
+	bool PostOccupantMessage(uint32_t dwMessageID, uint32_t dwData) override;
+	uint32_t GetHighlight() override;
+	bool SetHighlight(uint32_t dwHighlight, bool bSendMessageNow) override;
+	uint8_t SetVisibility(bool bVisible, bool bSendMessage) override;
+	cISC43DPlaceableObject* GetPlaceableObject() override;
+	cISC43DPlaceableObject* GetOrCreatePlaceableObject() override;
+	cISC43DPlaceableObject* SetPlaceableObject(cISC43DPlaceableObject* pObject) override;
+	bool IsOccupantGroup(uint32_t dwGroup) override;
+	bool AddOccupantGroup(uint32_t dwGroup) override;
+	bool GetOccupantGroups(std::set<uint32_t>& sGroups) override;
+	bool GetOccupantManagerBBox(uint8_t* cBoxArray) override;
+	bool SetOccupantManagerBBox(uint8_t* cBoxArray) override;
+	bool GetLotTag(uint32_t& dwLotTag) override;
+	bool SetLotTag(uint32_t dwLotTag) override;
+	uint32_t SetFlag(uint32_t dwFlags) override;
+	cISC4Occupant* SetAllFlags(uint32_t dwFlags) override;
+	uint32_t ClearFlag(uint32_t dwFlags) override;
+	bool IsFlagSet(uint32_t dwFlags) override;
+	uint32_t GetFlags() override;
+	// cISC4BuildingOccupant
+
+	cISC4Occupant* AsOccupant() override;
+	uint32_t GetBuildingType() override;
+	cISC4BuildingOccupant* SetBuildingType(uint32_t buildingType) override;
+	int32_t GetBuildingAge() override;
+	void SetBuildingAge(int32_t age) override;
+	bool SetBoundingBox(float const* fTopLeft, float const* fBottomRight) override;
+	SC4Percentage* GetCompletionPercent() override;
+	bool SetCompletionPercent(SC4Percentage const&) override;
+	BuildingProfile& GetBuildingProfile() override;
+	cIGZString* GetBuildingName() override;
+	cIGZString* GetExemplarName() override;
+	int32_t GetOrientation() override;
+	bool SetOrientation(int32_t) override;
+	bool IsLit() override;
+	bool SetLit(bool) override;
+	bool SetName(cIGZString&) override;
+	bool GetName(cIGZString&) override;
+
+private:
+	uint32_t refCount;
+	uint32_t buildingType;
+	int32_t buildingAge;
+	cISCPropertyHolder* pPropertyHolder;
+	cS3DVector3 position;
+	BuildingProfile buildingProfile;
+};
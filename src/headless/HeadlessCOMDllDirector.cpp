@@ -0,0 +1,31 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessCOMDllDirector.h"
+
+static constexpr uint32_t kHeadlessDirectorID = 0x810A913B;
+
+uint32_t HeadlessCOMDllDirector::GetDirectorID() const
+{
+	return kHeadlessDirectorID;
+}
+
+void HeadlessCOMDllDirector::SetFrameWork(cIGZFrameWork* pFrameWork)
+{
+	mpFrameWork = pFrameWork;
+}
+
+cRZCOMDllDirector* RZGetCOMDllDirector() {
+	static HeadlessCOMDllDirector sDirector;
+	return &sDirector;
+}
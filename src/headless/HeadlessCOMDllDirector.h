@@ -0,0 +1,28 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cRZCOMDllDirector.h"
+
+/**
+ * @brief The COM director that the gzcom-dll framework helpers use in the headless build.
+ *
+ * RZGetFrameWork returns the framework that was set by the HeadlessGame.
+ */
+class HeadlessCOMDllDirector final : public cRZCOMDllDirector
+{
+public:
+	uint32_t GetDirectorID() const override;
+
+	void SetFrameWork(cIGZFrameWork* pFrameWork);
+};
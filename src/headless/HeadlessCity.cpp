@@ -0,0 +1,596 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessCity.h"
+
+// The size of a large city, 256 cells that are 16 meters wide.
+static constexpr float DefaultCitySizeInMeters = 4096.0f;
+
+HeadlessCity::HeadlessCity(
+	cISC4BudgetSimulator* pBudgetSimulator,
+	cISC4DemandSimulator* pDemandSimulator,
+	cISC4OccupantManager* pOccupantManager,
+	cISC4ResidentialSimulator* pResidentialSimulator)
+	: refCount(0),
+	  pBudgetSimulator(pBudgetSimulator),
+	  pDemandSimulator(pDemandSimulator),
+	  pOccupantManager(pOccupantManager),
+	  pResidentialSimulator(pResidentialSimulator),
+	  sizeX(DefaultCitySizeInMeters),
+	  sizeZ(DefaultCitySizeInMeters)
+{
+}
+
+bool HeadlessCity::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessCity::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessCity::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool HeadlessCity::Init()
+{
+	return {};
+}
+
+bool HeadlessCity::Shutdown()
+{
+	return {};
+}
+
+uint32_t HeadlessCity::GetCitySerialNumber()
+{
+	return {};
+}
+
+cISC4City* HeadlessCity::SetCitySerialNumber(uint32_t dwSerial)
+{
+	return {};
+}
+
+uint32_t HeadlessCity::GetNewOccupantSerialNumber()
+{
+	return {};
+}
+
+bool HeadlessCity::GetOriginalLanguageAndCountry(uint32_t& dwLanguage, uint32_t& dwCountry)
+{
+	return {};
+}
+
+bool HeadlessCity::GetLastLanguageAndCountry(uint32_t& dwLanguage, uint32_t& dwCountry)
+{
+	return {};
+}
+
+bool HeadlessCity::GetCitySaveFilePath(cIGZString& szPath)
+{
+	return {};
+}
+
+bool HeadlessCity::SetCitySaveFilePath(cIGZString const& szPath)
+{
+	return {};
+}
+
+bool HeadlessCity::GetCityName(cIGZString& szPath)
+{
+	return {};
+}
+
+bool HeadlessCity::SetCityName(cIGZString const& szPath)
+{
+	return {};
+}
+
+bool HeadlessCity::GetCityNameChanged()
+{
+	return {};
+}
+
+cISC4City* HeadlessCity::SetCityNameChanged(bool bToggle)
+{
+	return {};
+}
+
+bool HeadlessCity::GetMayorName(cIGZString& szName)
+{
+	return {};
+}
+
+bool HeadlessCity::SetMayorName(cIGZString const& szName)
+{
+	return {};
+}
+
+bool HeadlessCity::GetCityDescription(cIGZString& szDescription)
+{
+	return {};
+}
+
+bool HeadlessCity::SetCityDescription(cIGZString const& szDescription)
+{
+	return {};
+}
+
+uint32_t HeadlessCity::GetBirthDate()
+{
+	return {};
+}
+
+cISC4City* HeadlessCity::SetBirthDate(uint32_t dwDate)
+{
+	return {};
+}
+
+bool HeadlessCity::GetEstablished()
+{
+	return true;
+}
+
+bool HeadlessCity::SetEstablished(bool bEstablished)
+{
+	return {};
+}
+
+int32_t HeadlessCity::GetDifficultyLevel()
+{
+	return {};
+}
+
+cISC4City* HeadlessCity::SetDifficultyLevel(int32_t dwLevel)
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetWorldPosition(float& fX, float& fZ)
+{
+	return {};
+}
+
+cISC4City* HeadlessCity::SetWorldPosition(float fX, float fZ)
+{
+	return {};
+}
+
+float HeadlessCity::GetWorldBaseElevation()
+{
+	return {};
+}
+
+cISC4City* HeadlessCity::SetWorldBaseElevation(float fElevation)
+{
+	return {};
+}
+
+int32_t HeadlessCity::GetWorldHemisphere()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetDemolitionUtility()
+{
+	return {};
+}
+
+cISC4HistoryWarehouse* HeadlessCity::GetHistoryWarehouse()
+{
+	return {};
+}
+
+cISC4LotManager* HeadlessCity::GetLotManager()
+{
+	return {};
+}
+
+cISC4OccupantManager* HeadlessCity::GetOccupantManager()
+{
+	return pOccupantManager;
+}
+
+intptr_t HeadlessCity::GetPropManager()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetZoneManager()
+{
+	return {};
+}
+
+cISC4LotConfigurationManager* HeadlessCity::GetLotConfigurationManager()
+{
+	return {};
+}
+
+cISC4NetworkManager* HeadlessCity::GetNetworkManager()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetDispatchManager()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetTrafficNetwork()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetPropDeveloper()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetNetworkLotManager()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetVehicleManager()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetPedestrianManager()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetAircraftManager()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetWatercraftManager()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetAutomataControllerManager()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetAutomataScriptSystem()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetCitySituationManager()
+{
+	return {};
+}
+
+cISC4Simulator* HeadlessCity::GetSimulator()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetAuraSimulator()
+{
+	return {};
+}
+
+cISC4BudgetSimulator* HeadlessCity::GetBudgetSimulator()
+{
+	return pBudgetSimulator;
+}
+
+cISC4BuildingDevelopmentSimulator* HeadlessCity::GetBuildingDevelopmentSimulator()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetCommercialSimulator()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetCrimeSimulator()
+{
+	return {};
+}
+
+cISC4DemandSimulator* HeadlessCity::GetDemandSimulator()
+{
+	return pDemandSimulator;
+}
+
+intptr_t HeadlessCity::GetFireProtectionSimulator()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetFlammabilitySimulator()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetFloraSimulator()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetIndustrialSimulator()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetLandValueSimulator()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetNeighborsSimulator()
+{
+	return {};
+}
+
+cISC4OrdinanceSimulator* HeadlessCity::GetOrdinanceSimulator()
+{
+	return {};
+}
+
+cISC4PlumbingSimulator* HeadlessCity::GetPlumbingSimulator()
+{
+	return {};
+}
+
+cISC4PoliceSimulator* HeadlessCity::GetPoliceSimulator()
+{
+	return {};
+}
+
+cISC4PollutionSimulator* HeadlessCity::GetPollutionSimulator()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetPowerSimulator()
+{
+	return {};
+}
+
+cISC4ResidentialSimulator* HeadlessCity::GetResidentialSimulator()
+{
+	return pResidentialSimulator;
+}
+
+intptr_t HeadlessCity::GetTrafficSimulator()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetWeatherSimulator()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetMySimAgentSimulator()
+{
+	return {};
+}
+
+cISC4DisasterLayer* HeadlessCity::GetDisasterLayer()
+{
+	return {};
+}
+
+cISC4CivicBuildingSimulator* HeadlessCity::GetCivicBuildingSimulator()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetParkManager()
+{
+	return {};
+}
+
+cISC4LotManager* HeadlessCity::GetZoneDeveloper()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetSeaportDeveloper()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetAirportDeveloper()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetLandfillDeveloper()
+{
+	return {};
+}
+
+cISC4LotDeveloper* HeadlessCity::GetLotDeveloper()
+{
+	return {};
+}
+
+cISC4TractDeveloper* HeadlessCity::GetTractDeveloper()
+{
+	return {};
+}
+
+cISC4AdvisorSystem* HeadlessCity::GetAdvisorSystem()
+{
+	return {};
+}
+
+cISC4TutorialSystem* HeadlessCity::GetTutorialSystem()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetSurfaceWater()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetTerrain()
+{
+	return {};
+}
+
+intptr_t HeadlessCity::GetEffectsManager()
+{
+	return {};
+}
+
+cISC424HourClock* HeadlessCity::Get24HourClock()
+{
+	return {};
+}
+
+uint32_t HeadlessCity::GetCitySizeType()
+{
+	return {};
+}
+
+bool HeadlessCity::SetSize(float fX, float fZ)
+{
+	sizeX = fX;
+	sizeZ = fZ;
+	return true;
+}
+
+float HeadlessCity::SizeX()
+{
+	return sizeX;
+}
+
+float HeadlessCity::SizeZ()
+{
+	return sizeZ;
+}
+
+float HeadlessCity::CellWidthX()
+{
+	return {};
+}
+
+float HeadlessCity::CellWidthZ()
+{
+	return {};
+}
+
+uint32_t HeadlessCity::CellCountX()
+{
+	return {};
+}
+
+uint32_t HeadlessCity::CellCountZ()
+{
+	return {};
+}
+
+int32_t HeadlessCity::PositionToCell(float fX, float fZ, int& cX, int& cZ)
+{
+	return {};
+}
+
+int32_t HeadlessCity::CellCornerToPosition(int cX, int cZ, float& fX, float& fZ)
+{
+	return {};
+}
+
+int32_t HeadlessCity::CellCenterToPosition(int cX, int cZ, float& fX, float& fZ)
+{
+	return {};
+}
+
+bool HeadlessCity::LocationIsInBounds(float fX, float fZ)
+{
+	return {};
+}
+
+bool HeadlessCity::CellIsInBounds(int cX, int cZ)
+{
+	return {};
+}
+
+bool HeadlessCity::CellCornerIsInBounds(int cX, int cZ)
+{
+	return {};
+}
+
+void HeadlessCity::ToggleSimulationMode()
+{
+}
+
+bool HeadlessCity::IsInCityTimeSimulationMode()
+{
+	return {};
+}
+
+int32_t HeadlessCity::EnableSave()
+{
+	return {};
+}
+
+int32_t HeadlessCity::DisableSave()
+{
+	return {};
+}
+
+bool HeadlessCity::IsSaveDisabled()
+{
+	return {};
+}
+
+cISC4City* HeadlessCity::UIIncreaseLockCount()
+{
+	return {};
+}
+
+int32_t HeadlessCity::UIDecreaseLockCount()
+{
+	return {};
+}
+
+int32_t HeadlessCity::UIGetLockCount()
+{
+	return {};
+}
+
+bool HeadlessCity::SaveObliterated(cIGZPersistDBSegment* pSegment)
+{
+	return {};
+}
@@ -0,0 +1,327 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessDBSegment.h"
+#include "HeadlessDBSegmentIStream.h"
+#include "HeadlessDBSegmentOStream.h"
+#include "cGZPersistResourceKey.h"
+#include <cstring>
+
+HeadlessDBSegment::HeadlessDBSegment()
+	: refCount(0),
+	  records()
+{
+}
+
+bool HeadlessDBSegment::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZPersistDBSegment)
+	{
+		*ppvObj = static_cast<cIGZPersistDBSegment*>(this);
+		AddRef();
+
+		return true;
+	}
+	else if (riid == GZIID_cISC4DBSegment)
+	{
+		*ppvObj = static_cast<cISC4DBSegment*>(this);
+		AddRef();
+
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(static_cast<cISC4DBSegment*>(this));
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessDBSegment::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessDBSegment::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool HeadlessDBSegment::Init()
+{
+	return true;
+}
+
+bool HeadlessDBSegment::Shutdown()
+{
+	return true;
+}
+
+bool HeadlessDBSegment::Open(bool openRead, bool openWrite)
+{
+	return true;
+}
+
+bool HeadlessDBSegment::IsOpen() const
+{
+	return true;
+}
+
+bool HeadlessDBSegment::Close()
+{
+	return true;
+}
+
+bool HeadlessDBSegment::Flush()
+{
+	return true;
+}
+
+void HeadlessDBSegment::GetPath(cIGZString& path) const
+{
+}
+
+bool HeadlessDBSegment::SetPath(cIGZString const& path)
+{
+	return {};
+}
+
+bool HeadlessDBSegment::Lock()
+{
+	return true;
+}
+
+bool HeadlessDBSegment::Unlock()
+{
+	return true;
+}
+
+uint32_t HeadlessDBSegment::GetSegmentID() const
+{
+	return {};
+}
+
+bool HeadlessDBSegment::SetSegmentID(uint32_t const& segmentID)
+{
+	return {};
+}
+
+uint32_t HeadlessDBSegment::GetRecordCount(cIGZPersistResourceKeyFilter* filter)
+{
+	return filter ? 0 : static_cast<uint32_t>(records.size());
+}
+
+uint32_t HeadlessDBSegment::GetResourceKeyList(cIGZPersistResourceKeyList* list, cIGZPersistResourceKeyFilter* filter)
+{
+	return {};
+}
+
+bool HeadlessDBSegment::GetResourceKeyList(cIGZPersistResourceKeyList& list)
+{
+	return {};
+}
+
+bool HeadlessDBSegment::TestForRecord(cGZPersistResourceKey const& key)
+{
+	return records.contains(MakeRecordKey(key));
+}
+
+uint32_t HeadlessDBSegment::GetRecordSize(cGZPersistResourceKey const& key)
+{
+	uint32_t size = 0;
+
+	const auto& item = records.find(MakeRecordKey(key));
+
+	if (item != records.end())
+	{
+		size = static_cast<uint32_t>(item->second.size());
+	}
+
+	return size;
+}
+
+bool HeadlessDBSegment::OpenRecord(cGZPersistResourceKey const& key, cIGZPersistDBRecord** record, uint32_t accessMode)
+{
+	return {};
+}
+
+bool HeadlessDBSegment::CreateNewRecord(cGZPersistResourceKey const& key, cIGZPersistDBRecord** record)
+{
+	return {};
+}
+
+bool HeadlessDBSegment::CloseRecord(cIGZPersistDBRecord* record)
+{
+	return {};
+}
+
+bool HeadlessDBSegment::CloseRecord(cIGZPersistDBRecord** record)
+{
+	return {};
+}
+
+bool HeadlessDBSegment::AbortRecord(cIGZPersistDBRecord* record)
+{
+	return {};
+}
+
+bool HeadlessDBSegment::AbortRecord(cIGZPersistDBRecord** record)
+{
+	return {};
+}
+
+bool HeadlessDBSegment::DeleteRecord(cGZPersistResourceKey const& key)
+{
+	return records.erase(MakeRecordKey(key)) == 1;
+}
+
+uint32_t HeadlessDBSegment::ReadRecord(cGZPersistResourceKey const& key, void* buffer, uint32_t& recordSize)
+{
+	uint32_t bytesRead = 0;
+
+	const auto& item = records.find(MakeRecordKey(key));
+
+	if (item != records.end())
+	{
+		const std::vector<uint8_t>& data = item->second;
+
+		if (buffer && recordSize >= data.size())
+		{
+			std::memcpy(buffer, data.data(), data.size());
+			bytesRead = static_cast<uint32_t>(data.size());
+		}
+
+		recordSize = static_cast<uint32_t>(data.size());
+	}
+
+	return bytesRead;
+}
+
+bool HeadlessDBSegment::WriteRecord(cGZPersistResourceKey const& key, void* buffer, uint32_t recordSize)
+{
+	bool result = false;
+
+	if (buffer || recordSize == 0)
+	{
+		const uint8_t* data = static_cast<const uint8_t*>(buffer);
+
+		records.insert_or_assign(MakeRecordKey(key), std::vector<uint8_t>(data, data + recordSize));
+		result = true;
+	}
+
+	return result;
+}
+
+bool HeadlessDBSegment::Init(uint32_t segmentID, cIGZString const& path, bool unknown2)
+{
+	return true;
+}
+
+cIGZPersistDBSegment* HeadlessDBSegment::AsIGZPersistDBSegment()
+{
+	return this;
+}
+
+cISC4COMSerializer* HeadlessDBSegment::GetCOMSerializer()
+{
+	return {};
+}
+
+bool HeadlessDBSegment::OpenIStream(cGZPersistResourceKey const& key, cISC4DBSegmentIStream** ppStream)
+{
+	bool result = false;
+
+	if (ppStream)
+	{
+		const auto& item = records.find(MakeRecordKey(key));
+
+		if (item != records.end())
+		{
+			HeadlessDBSegmentIStream* pStream = new HeadlessDBSegmentIStream(item->second.data(), item->second.size());
+			pStream->AddRef();
+
+			*ppStream = pStream;
+			result = true;
+		}
+	}
+
+	return result;
+}
+
+void HeadlessDBSegment::CloseIStream(cISC4DBSegmentIStream* pStream)
+{
+}
+
+bool HeadlessDBSegment::LoadClassObjects()
+{
+	return true;
+}
+
+bool HeadlessDBSegment::OpenOStream(cGZPersistResourceKey const& key, cISC4DBSegmentOStream** ppStream, bool truncate)
+{
+	bool result = false;
+
+	if (ppStream)
+	{
+		std::vector<uint8_t>& data = records[MakeRecordKey(key)];
+
+		if (truncate)
+		{
+			data.clear();
+		}
+
+		HeadlessDBSegmentOStream* pStream = new HeadlessDBSegmentOStream(data);
+		pStream->AddRef();
+
+		*ppStream = pStream;
+		result = true;
+	}
+
+	return result;
+}
+
+void HeadlessDBSegment::CloseOStream(cISC4DBSegmentOStream* pStream)
+{
+}
+
+bool HeadlessDBSegment::SaveClassObjects()
+{
+	return true;
+}
+
+uint32_t HeadlessDBSegment::GetLastError()
+{
+	return {};
+}
+
+float HeadlessDBSegment::GetPercentageCompletion()
+{
+	return {};
+}
+
+void HeadlessDBSegment::SetPercentageCompletion(float percentage)
+{
+}
+
+HeadlessDBSegment::RecordKey HeadlessDBSegment::MakeRecordKey(cGZPersistResourceKey const& key)
+{
+	return std::make_tuple(key.type, key.group, key.instance);
+}
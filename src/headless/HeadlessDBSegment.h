@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cIGZPersistDBSegment.h"
+#include "cISC4DBSegment.h"
+#include <map>
+#include <tuple>
+#include <vector>
+
+/**
+ * @brief An in-memory save game DB segment, each record is stored as a byte array.
+ */
+class HeadlessDBSegment final : public cIGZPersistDBSegment, public cISC4DBSegment
+{
+public:
+	HeadlessDBSegment();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cIGZPersistDBSegment
+
+	bool Init() override;
+	bool Shutdown() override;
+	bool Open(bool openRead, bool openWrite) override;
+	bool IsOpen() const override;
+	bool Close() override;
+	bool Flush() override;
+	void GetPath(cIGZString& path) const override;
+	bool SetPath(cIGZString const& path) override;
+	bool Lock() override;
+	bool Unlock() override;
+	uint32_t GetSegmentID() const override;
+	bool SetSegmentID(uint32_t const& segmentID) override;
+	uint32_t GetRecordCount(cIGZPersistResourceKeyFilter* filter) override;
+	uint32_t GetResourceKeyList(cIGZPersistResourceKeyList* list, cIGZPersistResourceKeyFilter* filter) override;
+	bool GetResourceKeyList(cIGZPersistResourceKeyList& list) override;
+	bool TestForRecord(cGZPersistResourceKey const& key) override;
+	uint32_t GetRecordSize(cGZPersistResourceKey const& key) override;
+	bool OpenRecord(cGZPersistResourceKey const& key, cIGZPersistDBRecord** record, uint32_t accessMode) override;
+	bool CreateNewRecord(cGZPersistResourceKey const& key, cIGZPersistDBRecord** record) override;
+	bool CloseRecord(cIGZPersistDBRecord* record) override;
+	bool CloseRecord(cIGZPersistDBRecord** record) override;
+	bool AbortRecord(cIGZPersistDBRecord* record) override;
+	bool AbortRecord(cIGZPersistDBRecord** record) override;
+	bool DeleteRecord(cGZPersistResourceKey const& key) override;
+	uint32_t ReadRecord(cGZPersistResourceKey const& key, void* buffer, uint32_t& recordSize) override;
+	bool WriteRecord(cGZPersistResourceKey const& key, void* buffer, uint32_t recordSize) override;
+	bool Init(uint32_t segmentID, cIGZString const& path, bool unknown2) override;
+	// cISC4DBSegment
+
+	cIGZPersistDBSegment* AsIGZPersistDBSegment() override;
+	cISC4COMSerializer* GetCOMSerializer() override;
+	bool OpenIStream(cGZPersistResourceKey const& key, cISC4DBSegmentIStream** ppStream) override;
+	void CloseIStream(cISC4DBSegmentIStream* pStream) override;
+	bool LoadClassObjects() override;
+	bool OpenOStream(cGZPersistResourceKey const& key, cISC4DBSegmentOStream** ppStream, bool truncate) override;
+	void CloseOStream(cISC4DBSegmentOStream* pStream) override;
+	bool SaveClassObjects() override;
+	uint32_t GetLastError() override;
+	float GetPercentageCompletion() override;
+	void SetPercentageCompletion(float percentage) override;
+
+private:
+	typedef std::tuple<uint32_t, uint32_t, uint32_t> RecordKey;
+
+	static RecordKey MakeRecordKey(cGZPersistResourceKey const& key);
+
+	uint32_t refCount;
+	std::map<RecordKey, std::vector<uint8_t>> records;
+};
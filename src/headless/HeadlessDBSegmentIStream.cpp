@@ -0,0 +1,227 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessDBSegmentIStream.h"
+#include <cstring>
+
+HeadlessDBSegmentIStream::HeadlessDBSegmentIStream(const uint8_t* data, size_t size)
+	: refCount(0),
+	  data(data),
+	  size(size),
+	  position(0),
+	  error(0)
+{
+}
+
+bool HeadlessDBSegmentIStream::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cISC4DBSegmentIStream)
+	{
+		*ppvObj = static_cast<cISC4DBSegmentIStream*>(this);
+		AddRef();
+
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessDBSegmentIStream::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessDBSegmentIStream::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+
+		if (refCount == 0)
+		{
+			delete this;
+			return 0;
+		}
+	}
+
+	return refCount;
+}
+
+bool HeadlessDBSegmentIStream::Skip(uint32_t dwBytes)
+{
+	bool result = false;
+
+	if (error == 0 && dwBytes <= size - position)
+	{
+		position += dwBytes;
+		result = true;
+	}
+	else
+	{
+		error = 1;
+	}
+
+	return result;
+}
+
+bool HeadlessDBSegmentIStream::GetSint8(int8_t& cValueOut)
+{
+	return Read(&cValueOut, sizeof(cValueOut));
+}
+
+bool HeadlessDBSegmentIStream::GetUint8(uint8_t& ucValueOut)
+{
+	return Read(&ucValueOut, sizeof(ucValueOut));
+}
+
+bool HeadlessDBSegmentIStream::GetSint16(int16_t& sValueOut)
+{
+	return Read(&sValueOut, sizeof(sValueOut));
+}
+
+bool HeadlessDBSegmentIStream::GetUint16(uint16_t& usValueOut)
+{
+	return Read(&usValueOut, sizeof(usValueOut));
+}
+
+bool HeadlessDBSegmentIStream::GetSint32(int32_t& lValueOut)
+{
+	return Read(&lValueOut, sizeof(lValueOut));
+}
+
+bool HeadlessDBSegmentIStream::GetUint32(uint32_t& ulValueOut)
+{
+	return Read(&ulValueOut, sizeof(ulValueOut));
+}
+
+bool HeadlessDBSegmentIStream::GetSint64(int64_t& llValueOut)
+{
+	return Read(&llValueOut, sizeof(llValueOut));
+}
+
+bool HeadlessDBSegmentIStream::GetUint64(uint64_t& ullValueOut)
+{
+	return Read(&ullValueOut, sizeof(ullValueOut));
+}
+
+bool HeadlessDBSegmentIStream::GetFloat32(float& fValueOut)
+{
+	return Read(&fValueOut, sizeof(fValueOut));
+}
+
+bool HeadlessDBSegmentIStream::GetFloat64(double& dValueOut)
+{
+	return Read(&dValueOut, sizeof(dValueOut));
+}
+
+bool HeadlessDBSegmentIStream::GetRZCharStr(char* pszDataOut, uint32_t dwMaxBytes)
+{
+	return {};
+}
+
+bool HeadlessDBSegmentIStream::GetGZStr(cIGZString& szDataOut)
+{
+	return {};
+}
+
+bool HeadlessDBSegmentIStream::GetGZSerializable(cIGZSerializable& sDataOut)
+{
+	return {};
+}
+
+bool HeadlessDBSegmentIStream::GetVoid(void* pDataOut, uint32_t dwSize)
+{
+	return Read(pDataOut, dwSize);
+}
+
+int32_t HeadlessDBSegmentIStream::GetError()
+{
+	return error;
+}
+
+int32_t HeadlessDBSegmentIStream::SetUserData(cIGZVariant* pData)
+{
+	return {};
+}
+
+int32_t HeadlessDBSegmentIStream::GetUserData()
+{
+	return {};
+}
+
+bool HeadlessDBSegmentIStream::Open(cISC4DBSegment* pSegment, cGZPersistResourceKey const& sKey, bool bUnknown)
+{
+	return {};
+}
+
+bool HeadlessDBSegmentIStream::Close()
+{
+	return true;
+}
+
+bool HeadlessDBSegmentIStream::IsOpen()
+{
+	return true;
+}
+
+int32_t HeadlessDBSegmentIStream::GetRecord()
+{
+	return {};
+}
+
+int32_t HeadlessDBSegmentIStream::GetSegment()
+{
+	return {};
+}
+
+bool HeadlessDBSegmentIStream::ReadGZSerializable(cIGZSerializable** ppSegmentOut)
+{
+	return {};
+}
+
+bool HeadlessDBSegmentIStream::ReadResKey(cGZPersistResourceKey& sKeyOut)
+{
+	return {};
+}
+
+bool HeadlessDBSegmentIStream::ReadVariant(cIGZVariant& sVariantOut)
+{
+	return {};
+}
+
+bool HeadlessDBSegmentIStream::Read(void* destination, size_t count)
+{
+	bool result = false;
+
+	// The values are stored in the native byte order, which is little-endian
+	// on the platforms that the game runs on.
+	if (error == 0 && destination && count <= size - position)
+	{
+		std::memcpy(destination, data + position, count);
+		position += count;
+		result = true;
+	}
+	else
+	{
+		error = 1;
+	}
+
+	return result;
+}
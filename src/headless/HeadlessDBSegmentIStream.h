@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4DBSegmentIStream.h"
+#include <cstddef>
+
+/**
+ * @brief Reads a HeadlessDBSegment record.
+ *
+ * The stream does not copy the record data, the segment must outlive the stream.
+ * The stream deletes itself when its reference count drops to zero.
+ */
+class HeadlessDBSegmentIStream final : public cISC4DBSegmentIStream
+{
+public:
+	HeadlessDBSegmentIStream(const uint8_t* data, size_t size);
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cIGZIStream
+
+	bool Skip(uint32_t dwBytes) override;
+	bool GetSint8(int8_t& cValueOut) override;
+	bool GetUint8(uint8_t& ucValueOut) override;
+	bool GetSint16(int16_t& sValueOut) override;
+	bool GetUint16(uint16_t& usValueOut) override;
+	bool GetSint32(int32_t& lValueOut) override;
+	bool GetUint32(uint32_t& ulValueOut) override;
+	bool GetSint64(int64_t& llValueOut) override;
+	bool GetUint64(uint64_t& ullValueOut) override;
+	bool GetFloat32(float& fValueOut) override;
+	bool GetFloat64(double& dValueOut) override;
+	bool GetRZCharStr(char* pszDataOut, uint32_t dwMaxBytes) override;
+	bool GetGZStr(cIGZString& szDataOut) override;
+	bool GetGZSerializable(cIGZSerializable& sDataOut) override;
+	bool GetVoid(void* pDataOut, uint32_t dwSize) override;
+	int32_t GetError() override;
+	int32_t SetUserData(cIGZVariant* pData) override;
+	int32_t GetUserData() override;
+	// cISC4DBSegmentIStream
+
+	bool Open(cISC4DBSegment* pSegment, cGZPersistResourceKey const& sKey, bool bUnknown) override;
+	bool Close() override;
+	bool IsOpen() override;
+	int32_t GetRecord() override;
+	int32_t GetSegment() override;
+	bool ReadGZSerializable(cIGZSerializable** ppSegmentOut) override;
+	bool ReadResKey(cGZPersistResourceKey& sKeyOut) override;
+	bool ReadVariant(cIGZVariant& sVariantOut) override;
+
+private:
+	bool Read(void* destination, size_t count);
+
+	uint32_t refCount;
+	const uint8_t* data;
+	size_t size;
+	size_t position;
+	int32_t error;
+};
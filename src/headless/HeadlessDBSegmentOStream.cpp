@@ -0,0 +1,205 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessDBSegmentOStream.h"
+
+HeadlessDBSegmentOStream::HeadlessDBSegmentOStream(std::vector<uint8_t>& data)
+	: refCount(0),
+	  data(data)
+{
+}
+
+bool HeadlessDBSegmentOStream::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cISC4DBSegmentOStream)
+	{
+		*ppvObj = static_cast<cISC4DBSegmentOStream*>(this);
+		AddRef();
+
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessDBSegmentOStream::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessDBSegmentOStream::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+
+		if (refCount == 0)
+		{
+			delete this;
+			return 0;
+		}
+	}
+
+	return refCount;
+}
+
+void HeadlessDBSegmentOStream::Flush()
+{
+}
+
+bool HeadlessDBSegmentOStream::SetSint8(int8_t cValue)
+{
+	return Write(&cValue, sizeof(cValue));
+}
+
+bool HeadlessDBSegmentOStream::SetUint8(uint8_t ucValue)
+{
+	return Write(&ucValue, sizeof(ucValue));
+}
+
+bool HeadlessDBSegmentOStream::SetSint16(int16_t sValue)
+{
+	return Write(&sValue, sizeof(sValue));
+}
+
+bool HeadlessDBSegmentOStream::SetUint16(uint16_t usValue)
+{
+	return Write(&usValue, sizeof(usValue));
+}
+
+bool HeadlessDBSegmentOStream::SetSint32(int32_t lValue)
+{
+	return Write(&lValue, sizeof(lValue));
+}
+
+bool HeadlessDBSegmentOStream::SetUint32(uint32_t ulValue)
+{
+	return Write(&ulValue, sizeof(ulValue));
+}
+
+bool HeadlessDBSegmentOStream::SetSint64(int64_t llValue)
+{
+	return Write(&llValue, sizeof(llValue));
+}
+
+bool HeadlessDBSegmentOStream::SetUint64(uint64_t ullValue)
+{
+	return Write(&ullValue, sizeof(ullValue));
+}
+
+bool HeadlessDBSegmentOStream::SetFloat32(float fValue)
+{
+	return Write(&fValue, sizeof(fValue));
+}
+
+bool HeadlessDBSegmentOStream::SetFloat64(double dValue)
+{
+	return Write(&dValue, sizeof(dValue));
+}
+
+bool HeadlessDBSegmentOStream::SetRZCharStr(char const* pszData)
+{
+	return {};
+}
+
+bool HeadlessDBSegmentOStream::SetGZStr(cIGZString const& szData)
+{
+	return {};
+}
+
+bool HeadlessDBSegmentOStream::SetGZSerializable(cIGZSerializable const& sData)
+{
+	return {};
+}
+
+bool HeadlessDBSegmentOStream::SetVoid(void const* pData, uint32_t dwSize)
+{
+	return Write(pData, dwSize);
+}
+
+int32_t HeadlessDBSegmentOStream::GetError()
+{
+	return {};
+}
+
+int32_t HeadlessDBSegmentOStream::SetUserData(cIGZVariant* pData)
+{
+	return {};
+}
+
+int32_t HeadlessDBSegmentOStream::GetUserData()
+{
+	return {};
+}
+
+bool HeadlessDBSegmentOStream::Open(cISC4DBSegment* pSegment, cGZPersistResourceKey const& sKey, bool bUnknown)
+{
+	return {};
+}
+
+bool HeadlessDBSegmentOStream::Close()
+{
+	return true;
+}
+
+bool HeadlessDBSegmentOStream::IsOpen()
+{
+	return true;
+}
+
+int32_t HeadlessDBSegmentOStream::GetRecord()
+{
+	return {};
+}
+
+int32_t HeadlessDBSegmentOStream::GetSegment()
+{
+	return {};
+}
+
+bool HeadlessDBSegmentOStream::WriteGZSerializable(cIGZSerializable const* pSegment)
+{
+	return {};
+}
+
+bool HeadlessDBSegmentOStream::WriteResKey(cGZPersistResourceKey const& sKey)
+{
+	return {};
+}
+
+bool HeadlessDBSegmentOStream::WriteVariant(cIGZVariant const& sVariant)
+{
+	return {};
+}
+
+bool HeadlessDBSegmentOStream::Write(const void* source, size_t count)
+{
+	bool result = false;
+
+	if (source || count == 0)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(source);
+
+		data.insert(data.end(), bytes, bytes + count);
+		result = true;
+	}
+
+	return result;
+}
@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4DBSegmentOStream.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Appends to a HeadlessDBSegment record.
+ *
+ * The segment must outlive the stream. The stream deletes itself when its
+ * reference count drops to zero.
+ */
+class HeadlessDBSegmentOStream final : public cISC4DBSegmentOStream
+{
+public:
+	HeadlessDBSegmentOStream(std::vector<uint8_t>& data);
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cIGZOStream
+
+	void Flush() override;
+	bool SetSint8(int8_t cValue) override;
+	bool SetUint8(uint8_t ucValue) override;
+	bool SetSint16(int16_t sValue) override;
+	bool SetUint16(uint16_t usValue) override;
+	bool SetSint32(int32_t lValue) override;
+	bool SetUint32(uint32_t ulValue) override;
+	bool SetSint64(int64_t llValue) override;
+	bool SetUint64(uint64_t ullValue) override;
+	bool SetFloat32(float fValue) override;
+	bool SetFloat64(double dValue) override;
+	bool SetRZCharStr(char const* pszData) override;
+	bool SetGZStr(cIGZString const& szData) override;
+	bool SetGZSerializable(cIGZSerializable const& sData) override;
+	bool SetVoid(void const* pData, uint32_t dwSize) override;
+	int32_t GetError() override;
+	int32_t SetUserData(cIGZVariant* pData) override;
+	int32_t GetUserData() override;
+	// cISC4DBSegmentOStream
+
+	bool Open(cISC4DBSegment* pSegment, cGZPersistResourceKey const& sKey, bool bUnknown) override;
+	bool Close() override;
+	bool IsOpen() override;
+	int32_t GetRecord() override;
+	int32_t GetSegment() override;
+	bool WriteGZSerializable(cIGZSerializable const* pSegment) override;
+	bool WriteResKey(cGZPersistResourceKey const& sKey) override;
+	bool WriteVariant(cIGZVariant const& sVariant) override;
+
+private:
+	bool Write(const void* source, size_t count);
+
+	uint32_t refCount;
+	std::vector<uint8_t>& data;
+};
@@ -0,0 +1,213 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessDemand.h"
+
+HeadlessDemand::HeadlessDemand(uint32_t id)
+	: refCount(0),
+	  id(id),
+	  supplyValue(0.0f),
+	  demandValue(0.0f)
+{
+}
+
+bool HeadlessDemand::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessDemand::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessDemand::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool HeadlessDemand::Init()
+{
+	return true;
+}
+
+bool HeadlessDemand::Shutdown()
+{
+	return true;
+}
+
+bool HeadlessDemand::SimulationBegin()
+{
+	return {};
+}
+
+uint32_t HeadlessDemand::GetId() const
+{
+	return id;
+}
+
+bool HeadlessDemand::SetId(uint32_t id)
+{
+	this->id = id;
+
+	return true;
+}
+
+float HeadlessDemand::QuerySupplyValue() const
+{
+	return supplyValue;
+}
+
+float HeadlessDemand::QueryDemandValue() const
+{
+	return demandValue;
+}
+
+float HeadlessDemand::QueryNewSupply() const
+{
+	return {};
+}
+
+float HeadlessDemand::QueryNewDemand() const
+{
+	return {};
+}
+
+float HeadlessDemand::QueryActiveDemandValue() const
+{
+	return {};
+}
+
+float HeadlessDemand::QueryEconomyModifier() const
+{
+	return {};
+}
+
+float HeadlessDemand::QueryActiveDemandMax() const
+{
+	return {};
+}
+
+float HeadlessDemand::QueryActiveDemandMin() const
+{
+	return {};
+}
+
+bool HeadlessDemand::AddToSupplyValue(float value)
+{
+	supplyValue += value;
+
+	return true;
+}
+
+bool HeadlessDemand::AddToDemandValue(float value)
+{
+	demandValue += value;
+
+	return true;
+}
+
+bool HeadlessDemand::SetSupplyValue(float value)
+{
+	supplyValue = value;
+
+	return true;
+}
+
+bool HeadlessDemand::SetDemandValue(float value)
+{
+	demandValue = value;
+
+	return true;
+}
+
+bool HeadlessDemand::SetActiveDemandMax(float value)
+{
+	return {};
+}
+
+bool HeadlessDemand::SetActiveDemandMin(float value)
+{
+	return {};
+}
+
+float HeadlessDemand::GetEconomyModifier() const
+{
+	return {};
+}
+
+bool HeadlessDemand::SetEconomyModifier()
+{
+	return {};
+}
+
+float HeadlessDemand::GetTaxModifier() const
+{
+	return {};
+}
+
+bool HeadlessDemand::SetTaxModifier(float value)
+{
+	return {};
+}
+
+SC4Percentage* HeadlessDemand::GetDemandCap() const
+{
+	return {};
+}
+
+bool HeadlessDemand::SetDemandCap(const SC4Percentage& demandCap)
+{
+	return {};
+}
+
+uint32_t HeadlessDemand::GetRegionUse()
+{
+	return {};
+}
+
+bool HeadlessDemand::SetRegionUse(uint32_t param_1)
+{
+	return {};
+}
+
+float HeadlessDemand::EndOfCycle()
+{
+	return {};
+}
+
+void HeadlessDemand::DebugLockValue(float value)
+{
+}
+
+void HeadlessDemand::DebugUnlockValue()
+{
+}
+
+bool HeadlessDemand::DebugIsValueLocked()
+{
+	return {};
+}
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessDemandSimulator.h"
+#include "SC4Percentage.h"
+
+HeadlessDemandSimulator::HeadlessDemandSimulator()
+	: refCount(0),
+	  demands()
+{
+}
+
+bool HeadlessDemandSimulator::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessDemandSimulator::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessDemandSimulator::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool HeadlessDemandSimulator::Init()
+{
+	return true;
+}
+
+bool HeadlessDemandSimulator::Shutdown()
+{
+	demands.clear();
+
+	return true;
+}
+
+uint32_t HeadlessDemandSimulator::GetSimulatorType()
+{
+	return {};
+}
+
+cISC4Demand* HeadlessDemandSimulator::GetDemand(uint32_t demandID, uint32_t demandIndex)
+{
+	// The demand index is not used by the residential population demands.
+	return GetOrCreateDemand(demandID);
+}
+
+void HeadlessDemandSimulator::UpdateOccupantEffects(SC4Percentage unknown1, SC4Percentage const& unknown2, SC4Percentage const& unknown3)
+{
+}
+
+void HeadlessDemandSimulator::CalculateJobsPerUnitOfDemand(float* jobsArray, uint32_t exemplarInstanceLow, uint32_t exemplarInstanceHigh)
+{
+}
+
+uint32_t HeadlessDemandSimulator::GetJobsBySensus(uint32_t type)
+{
+	return {};
+}
+
+float HeadlessDemandSimulator::GetNeutralTaxRate()
+{
+	return {};
+}
+
+void HeadlessDemandSimulator::GetLocalPopulationSummary(std::map<uint32_t, int32_t>& map) const
+{
+}
+
+void HeadlessDemandSimulator::SetSupplyValue(uint32_t demandID, float value)
+{
+	GetOrCreateDemand(demandID)->SetSupplyValue(value);
+}
+
+HeadlessDemand* HeadlessDemandSimulator::GetOrCreateDemand(uint32_t demandID)
+{
+	auto pair = demands.try_emplace(demandID, nullptr);
+
+	if (pair.second)
+	{
+		pair.first->second = std::make_unique<HeadlessDemand>(demandID);
+	}
+
+	return pair.first->second.get();
+}
@@ -0,0 +1,55 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4DemandSimulator.h"
+#include "HeadlessDemand.h"
+#include <memory>
+#include <unordered_map>
+
+/**
+ * @brief An in-memory demand simulator, the demand objects are created on first use.
+ */
+class HeadlessDemandSimulator final : public cISC4DemandSimulator
+{
+public:
+	HeadlessDemandSimulator();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cISC4DemandSimulator
+
+	bool Init() override;
+	bool Shutdown() override;
+	uint32_t GetSimulatorType() override;
+	cISC4Demand* GetDemand(uint32_t demandID, uint32_t demandIndex) override;
+	void UpdateOccupantEffects(SC4Percentage unknown1, SC4Percentage const& unknown2, SC4Percentage const& unknown3) override;
+	void CalculateJobsPerUnitOfDemand(float* jobsArray, uint32_t exemplarInstanceLow, uint32_t exemplarInstanceHigh) override;
+	uint32_t GetJobsBySensus(uint32_t type) override;
+	float GetNeutralTaxRate() override;
+	void GetLocalPopulationSummary(std::map<uint32_t, int32_t>& map) const override;
+
+	/**
+	 * @brief Sets the supply value of the specified demand, e.g. the city's
+	 * residential population for one of the wealth groups.
+	 */
+	void SetSupplyValue(uint32_t demandID, float value);
+
+private:
+	HeadlessDemand* GetOrCreateDemand(uint32_t demandID);
+
+	uint32_t refCount;
+	std::unordered_map<uint32_t, std::unique_ptr<HeadlessDemand>> demands;
+};
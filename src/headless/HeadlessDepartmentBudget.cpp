@@ -0,0 +1,259 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessDepartmentBudget.h"
+
+HeadlessDepartmentBudget::HeadlessDepartmentBudget(uint32_t id, uint32_t budgetGroup)
+	: refCount(0),
+	  id(id),
+	  budgetGroup(budgetGroup),
+	  nameGroupID(0),
+	  nameInstanceID(0),
+	  fixedFunding(false),
+	  totalSpending(0),
+	  lineItems()
+{
+}
+
+bool HeadlessDepartmentBudget::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessDepartmentBudget::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessDepartmentBudget::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+uint32_t HeadlessDepartmentBudget::GetDepartmentID() const
+{
+	return id;
+}
+
+bool HeadlessDepartmentBudget::GetDepartmentName(cIGZString& name)
+{
+	return {};
+}
+
+bool HeadlessDepartmentBudget::SetDepartmentName(uint32_t ltextGroupID, uint32_t ltextInstanceID)
+{
+	nameGroupID = ltextGroupID;
+	nameInstanceID = ltextInstanceID;
+
+	return true;
+}
+
+uint32_t HeadlessDepartmentBudget::GetBudgetGroup() const
+{
+	return budgetGroup;
+}
+
+bool HeadlessDepartmentBudget::SetBudgetGroup(uint32_t budgetGroup)
+{
+	this->budgetGroup = budgetGroup;
+
+	return true;
+}
+
+bool HeadlessDepartmentBudget::GetIsFixedFunding() const
+{
+	return fixedFunding;
+}
+
+bool HeadlessDepartmentBudget::SetFixedFunding(bool value)
+{
+	fixedFunding = value;
+
+	return true;
+}
+
+SC4Percentage* HeadlessDepartmentBudget::GetFundingPercentage() const
+{
+	return {};
+}
+
+bool HeadlessDepartmentBudget::SetFundingPercentage(SC4Percentage const& percentange, uint32_t lineItem)
+{
+	return {};
+}
+
+SC4Percentage* HeadlessDepartmentBudget::GetMaxAllowedFundingPercentage() const
+{
+	return {};
+}
+
+bool HeadlessDepartmentBudget::SetMaxAllowedFundingPercentage(SC4Percentage const& percentange)
+{
+	return {};
+}
+
+int64_t HeadlessDepartmentBudget::GetIdealMonthlyFunding() const
+{
+	return GetTotalExpenses();
+}
+
+int64_t HeadlessDepartmentBudget::GetTotalExpenses() const
+{
+	int64_t total = 0;
+
+	for (const auto& item : lineItems)
+	{
+		total += item.second->GetFullExpenses();
+	}
+
+	return total;
+}
+
+int64_t HeadlessDepartmentBudget::GetTotalIncome() const
+{
+	int64_t total = 0;
+
+	for (const auto& item : lineItems)
+	{
+		total += item.second->GetIncome();
+	}
+
+	return total;
+}
+
+cISC4LineItem* HeadlessDepartmentBudget::CreateLineItem(uint32_t lineNumber, bool isLocallyFunded)
+{
+	auto pair = lineItems.try_emplace(lineNumber, nullptr);
+
+	if (pair.second)
+	{
+		pair.first->second = std::make_unique<HeadlessLineItem>(lineNumber, isLocallyFunded);
+	}
+
+	return pair.first->second.get();
+}
+
+cISC4LineItem* HeadlessDepartmentBudget::CreateLineItemForBuildingType(uint32_t buildingIID, bool isLocallyFunded)
+{
+	cISC4LineItem* pLineItem = CreateLineItem(buildingIID, isLocallyFunded);
+
+	pLineItem->SetName(0, buildingIID);
+
+	return pLineItem;
+}
+
+bool HeadlessDepartmentBudget::RemoveLineItem(uint32_t lineNumber)
+{
+	return lineItems.erase(lineNumber) == 1;
+}
+
+cISC4LineItem* HeadlessDepartmentBudget::GetLineItem(uint32_t lineNumber)
+{
+	cISC4LineItem* pLineItem = nullptr;
+
+	const auto& item = lineItems.find(lineNumber);
+
+	if (item != lineItems.end())
+	{
+		pLineItem = item->second.get();
+	}
+
+	return pLineItem;
+}
+
+bool HeadlessDepartmentBudget::GetAllLineItems(eastl::vector<cISC4LineItem*>& destination)
+{
+	destination.reserve(destination.size() + lineItems.size());
+
+	for (const auto& item : lineItems)
+	{
+		destination.push_back(item.second.get());
+	}
+
+	return true;
+}
+
+bool HeadlessDepartmentBudget::AddLocallyFundedObject(cISCPropertyHolder* unknown1, uint32_t unknown2)
+{
+	return {};
+}
+
+bool HeadlessDepartmentBudget::RemoveLocallyFundedObject(cISCPropertyHolder* unknown1, uint32_t unknown2)
+{
+	return {};
+}
+
+bool HeadlessDepartmentBudget::SetLocalFundingPercent(cISCPropertyHolder* unknown1, SC4Percentage* unknown2, uint32_t unknown3)
+{
+	return {};
+}
+
+bool HeadlessDepartmentBudget::SetLocalFullFunding(cISCPropertyHolder* unknown1, int64_t unknown2, uint32_t unknown3)
+{
+	return {};
+}
+
+float HeadlessDepartmentBudget::GetLocalFundingPercent(cISCPropertyHolder* unknown1, uint32_t unknown2)
+{
+	return {};
+}
+
+int64_t HeadlessDepartmentBudget::GetLocalFullFunding(cISCPropertyHolder * unknown1, uint32_t unknown2)
+{
+	return {};
+}
+
+bool HeadlessDepartmentBudget::IsLocallyFundedObjectInDepartment(cISCPropertyHolder* unknown1, uint32_t unknown2)
+{
+	return {};
+}
+
+bool HeadlessDepartmentBudget::RecalculateAllLineItemCurrentExpenses()
+{
+	return true;
+}
+
+int64_t HeadlessDepartmentBudget::GetTotalSpending() const
+{
+	return totalSpending;
+}
+
+bool HeadlessDepartmentBudget::SetTotalSpending(int64_t value)
+{
+	totalSpending = value;
+
+	return true;
+}
+
+bool HeadlessDepartmentBudget::GetLocallyFundedItemsByPurpose(uint32_t purpose, eastl::list<cRZAutoRefCount<cISCPropertyHolder>>& unknown2)
+{
+	return {};
+}
+
+bool HeadlessDepartmentBudget::HasLocallyFundedItemsByPurpose(uint32_t purpose)
+{
+	return {};
+}
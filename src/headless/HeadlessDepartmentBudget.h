@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4DepartmentBudget.h"
+#include "HeadlessLineItem.h"
+#include <memory>
+#include <unordered_map>
+
+/**
+ * @brief An in-memory budget department that owns its line items.
+ */
+class HeadlessDepartmentBudget final : public cISC4DepartmentBudget
+{
+public:
+	HeadlessDepartmentBudget(uint32_t id, uint32_t budgetGroup);
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cISC4DepartmentBudget
+
+	uint32_t GetDepartmentID() const override;
+	bool GetDepartmentName(cIGZString& name) override;
+	bool SetDepartmentName(uint32_t ltextGroupID, uint32_t ltextInstanceID) override;
+	uint32_t GetBudgetGroup() const override;
+	bool SetBudgetGroup(uint32_t budgetGroup) override;
+	bool GetIsFixedFunding() const override;
+	bool SetFixedFunding(bool value) override;
+	SC4Percentage* GetFundingPercentage() const override;
+	bool SetFundingPercentage(SC4Percentage const& percentange, uint32_t lineItem) override;
+	SC4Percentage* GetMaxAllowedFundingPercentage() const override;
+	bool SetMaxAllowedFundingPercentage(SC4Percentage const& percentange) override;
+	int64_t GetIdealMonthlyFunding() const override;
+	int64_t GetTotalExpenses() const override;
+	int64_t GetTotalIncome() const override;
+	cISC4LineItem* CreateLineItem(uint32_t lineNumber, bool isLocallyFunded) override;
+	cISC4LineItem* CreateLineItemForBuildingType(uint32_t buildingIID, bool isLocallyFunded) override;
+	bool RemoveLineItem(uint32_t lineNumber) override;
+	cISC4LineItem* GetLineItem(uint32_t lineNumber) override;
+	bool GetAllLineItems(eastl::vector<cISC4LineItem*>& destination) override;
+	bool AddLocallyFundedObject(cISCPropertyHolder* unknown1, uint32_t unknown2) override;
+	bool RemoveLocallyFundedObject(cISCPropertyHolder* unknown1, uint32_t unknown2) override;
+	bool SetLocalFundingPercent(cISCPropertyHolder* unknown1, SC4Percentage* unknown2, uint32_t unknown3) override;
+	bool SetLocalFullFunding(cISCPropertyHolder* unknown1, int64_t unknown2, uint32_t unknown3) override;
+	float GetLocalFundingPercent(cISCPropertyHolder* unknown1, uint32_t unknown2) override;
+	int64_t GetLocalFullFunding(cISCPropertyHolder * unknown1, uint32_t unknown2) override;
+	bool IsLocallyFundedObjectInDepartment(cISCPropertyHolder* unknown1, uint32_t unknown2) override;
+	bool RecalculateAllLineItemCurrentExpenses() override;
+	int64_t GetTotalSpending() const override;
+	bool SetTotalSpending(int64_t value) override;
+	bool GetLocallyFundedItemsByPurpose(uint32_t purpose, eastl::list<cRZAutoRefCount<cISCPropertyHolder>>& unknown2) override;
+	bool HasLocallyFundedItemsByPurpose(uint32_t purpose) override;
+
+private:
+	uint32_t refCount;
+	uint32_t id;
+	uint32_t budgetGroup;
+	uint32_t nameGroupID;
+	uint32_t nameInstanceID;
+	bool fixedFunding;
+	int64_t totalSpending;
+	std::unordered_map<uint32_t, std::unique_ptr<HeadlessLineItem>> lineItems;
+};
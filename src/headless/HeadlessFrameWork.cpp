@@ -0,0 +1,259 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessFrameWork.h"
+#include "cIGZAllocatorService.h"
+#include "cIGZMessageServer2.h"
+#include "cISC4App.h"
+
+// The service ids that are used by the cRZSysServPtr types in GZServPtrs.h.
+static constexpr uint32_t kGZAllocatorServiceID = 0x3AE4BEA3;
+static constexpr uint32_t kGZMessageServer2ServiceID = 0x4FA845B;
+static constexpr uint32_t kSC4AppServiceID = 0x66;
+
+HeadlessFrameWork::HeadlessFrameWork(
+	cIGZAllocatorService* pAllocatorService,
+	cIGZMessageServer2* pMessageServer,
+	cISC4App* pApp)
+	: refCount(0),
+	  pAllocatorService(pAllocatorService),
+	  pMessageServer(pMessageServer),
+	  pApp(pApp)
+{
+}
+
+bool HeadlessFrameWork::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessFrameWork::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessFrameWork::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool HeadlessFrameWork::AddSystemService(cIGZSystemService* pService)
+{
+	return {};
+}
+
+bool HeadlessFrameWork::RemoveSystemService(cIGZSystemService* pService)
+{
+	return {};
+}
+
+bool HeadlessFrameWork::GetSystemService(uint32_t srvid, uint32_t riid, void** ppService)
+{
+	cIGZUnknown* pService = nullptr;
+
+	switch (srvid)
+	{
+	case kGZAllocatorServiceID:
+		pService = pAllocatorService;
+		break;
+	case kGZMessageServer2ServiceID:
+		pService = pMessageServer;
+		break;
+	case kSC4AppServiceID:
+		pService = pApp;
+		break;
+	}
+
+	return pService && pService->QueryInterface(riid, ppService);
+}
+
+bool HeadlessFrameWork::EnumSystemServices(void* enumerator, cIGZUnknown* pUnknown, uint32_t dwUnknown)
+{
+	return {};
+}
+
+bool HeadlessFrameWork::AddHook(cIGZFrameWorkHooks* pHooks)
+{
+	return {};
+}
+
+bool HeadlessFrameWork::RemoveHook(cIGZFrameWorkHooks* pHooks)
+{
+	return {};
+}
+
+bool HeadlessFrameWork::AddToTick(cIGZSystemService* pService)
+{
+	return {};
+}
+
+bool HeadlessFrameWork::RemoveFromTick(cIGZSystemService* pService)
+{
+	return {};
+}
+
+bool HeadlessFrameWork::AddToOnIdle(cIGZSystemService* pService)
+{
+	return {};
+}
+
+bool HeadlessFrameWork::RemoveFromOnIdle(cIGZSystemService* pService)
+{
+	return {};
+}
+
+int32_t HeadlessFrameWork::GetOnIdleInterval()
+{
+	return {};
+}
+
+bool HeadlessFrameWork::SetOnIdleInterval(int32_t nInterval)
+{
+	return {};
+}
+
+bool HeadlessFrameWork::OnTick(uint32_t dwTimeElapsed)
+{
+	return {};
+}
+
+bool HeadlessFrameWork::OnIdle()
+{
+	return {};
+}
+
+bool HeadlessFrameWork::IsTickEnabled()
+{
+	return {};
+}
+
+cIGZFrameWork* HeadlessFrameWork::ToggleTick(bool bTick)
+{
+	return {};
+}
+
+int32_t HeadlessFrameWork::Quit(int32_t nQuitReason)
+{
+	return {};
+}
+
+void HeadlessFrameWork::AbortiveQuit(int32_t nQuitReason)
+{
+}
+
+cIGZCmdLine* HeadlessFrameWork::CommandLine()
+{
+	return {};
+}
+
+bool HeadlessFrameWork::IsInstall()
+{
+	return {};
+}
+
+cIGZCOM* HeadlessFrameWork::GetCOMObject()
+{
+	return {};
+}
+
+cIGZFrameWork::FrameworkState HeadlessFrameWork::GetState()
+{
+	return cIGZFrameWork::kStatePostAppInit;
+}
+
+void* HeadlessFrameWork::GetDebugStream()
+{
+	return {};
+}
+
+int32_t HeadlessFrameWork::DefaultDebugStream()
+{
+	return {};
+}
+
+int32_t HeadlessFrameWork::DebugStream()
+{
+	return {};
+}
+
+bool HeadlessFrameWork::SetDebugStream(void* pIGZDebugStream)
+{
+	return {};
+}
+
+bool HeadlessFrameWork::SetDebugLevel(int32_t nLevel)
+{
+	return {};
+}
+
+int32_t HeadlessFrameWork::GetDebugLevel()
+{
+	return {};
+}
+
+int32_t HeadlessFrameWork::StdOut()
+{
+	return {};
+}
+
+int32_t HeadlessFrameWork::StdErr()
+{
+	return {};
+}
+
+int32_t HeadlessFrameWork::StdIn()
+{
+	return {};
+}
+
+void* HeadlessFrameWork::GetStream()
+{
+	return {};
+}
+
+bool HeadlessFrameWork::SetStream(int32_t nUnknown, cIGZUnknown* pUnknown)
+{
+	return {};
+}
+
+bool HeadlessFrameWork::SetApplication(cIGZApp* const pIGZApp)
+{
+	return {};
+}
+
+cIGZApp* HeadlessFrameWork::Application()
+{
+	return {};
+}
+
+void HeadlessFrameWork::ReportException(char const* szExcText)
+{
+}
+
+cIGZExceptionNotification* HeadlessFrameWork::ExceptionNotificationObj()
+{
+	return {};
+}
@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cIGZFrameWork.h"
+
+class cIGZAllocatorService;
+class cIGZMessageServer2;
+class cISC4App;
+
+/**
+ * @brief An in-memory cIGZFrameWork that serves the system services used by the plugin.
+ *
+ * Only the allocator, message server and SimCity 4 application services are available,
+ * the remaining methods are no-ops.
+ */
+class HeadlessFrameWork final : public cIGZFrameWork
+{
+public:
+	HeadlessFrameWork(cIGZAllocatorService* pAllocatorService, cIGZMessageServer2* pMessageServer, cISC4App* pApp);
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cIGZFrameWork
+
+	bool AddSystemService(cIGZSystemService* pService) override;
+	bool RemoveSystemService(cIGZSystemService* pService) override;
+	bool GetSystemService(uint32_t srvid, uint32_t riid, void** ppService) override;
+	bool EnumSystemServices(void* enumerator, cIGZUnknown* pUnknown, uint32_t dwUnknown) override;
+	bool AddHook(cIGZFrameWorkHooks* pHooks) override;
+	bool RemoveHook(cIGZFrameWorkHooks* pHooks) override;
+	bool AddToTick(cIGZSystemService* pService) override;
+	bool RemoveFromTick(cIGZSystemService* pService) override;
+	bool AddToOnIdle(cIGZSystemService* pService) override;
+	bool RemoveFromOnIdle(cIGZSystemService* pService) override;
+	int32_t GetOnIdleInterval() override;
+	bool SetOnIdleInterval(int32_t nInterval) override;
+	bool OnTick(uint32_t dwTimeElapsed) override;
+	bool OnIdle() override;
+	bool IsTickEnabled() override;
+	cIGZFrameWork* ToggleTick(bool bTick) override;
+	int32_t Quit(int32_t nQuitReason) override;
+	void AbortiveQuit(int32_t nQuitReason) override;
+	cIGZCmdLine* CommandLine() override;
+	bool IsInstall() override;
+	cIGZCOM* GetCOMObject() override;
+	FrameworkState GetState() override;
+	void* GetDebugStream() override;
+	int32_t DefaultDebugStream() override;
+	int32_t DebugStream() override;
+	bool SetDebugStream(void* pIGZDebugStream) override;
+	bool SetDebugLevel(int32_t nLevel) override;
+	int32_t GetDebugLevel() override;
+	int32_t StdOut() override;
+	int32_t StdErr() override;
+	int32_t StdIn() override;
+	void* GetStream() override;
+	bool SetStream(int32_t nUnknown, cIGZUnknown* pUnknown) override;
+	bool SetApplication(cIGZApp* const pIGZApp) override;
+	cIGZApp* Application() override;
+	void ReportException(char const* szExcText) override;
+	cIGZExceptionNotification* ExceptionNotificationObj() override;
+
+private:
+	uint32_t refCount;
+	cIGZAllocatorService* pAllocatorService;
+	cIGZMessageServer2* pMessageServer;
+	cISC4App* pApp;
+};
@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessGame.h"
+#include "HeadlessCOMDllDirector.h"
+#include "cISC4Occupant.h"
+#include "cRZMessage2Standard.h"
+
+static constexpr uint32_t kSC4MessagePostCityInit = 0x26D31EC1;
+static constexpr uint32_t kSC4MessagePostCityShutdown = 0x26D31EC3;
+static constexpr uint32_t kSC4MessageInsertOccupant = 0x99EF1142;
+static constexpr uint32_t kSC4MessageRemoveOccupant = 0x99EF1143;
+static constexpr uint32_t kSC4MessageLoad = 0x26C63341;
+static constexpr uint32_t kSC4MessageSave = 0x26C63344;
+static constexpr uint32_t kSC4MessageSimNewMonth = 0x66956816;
+
+// The current city is placed at the region origin.
+static constexpr int32_t kCurrentCityX = 0;
+static constexpr int32_t kCurrentCityZ = 0;
+
+HeadlessGame::HeadlessGame()
+	: allocatorService(),
+	  messageServer(),
+	  budgetSimulator(),
+	  demandSimulator(),
+	  occupantManager(),
+	  residentialSimulator(),
+	  city(&budgetSimulator, &demandSimulator, &occupantManager, &residentialSimulator),
+	  region(),
+	  pCurrentRegionalCity(region.AddCity(kCurrentCityX, kCurrentCityZ, true)),
+	  app(&city, &region, pCurrentRegionalCity),
+	  frameWork(&allocatorService, &messageServer, &app)
+{
+	static_cast<HeadlessCOMDllDirector*>(RZGetCOMDllDirector())->SetFrameWork(&frameWork);
+}
+
+HeadlessGame::~HeadlessGame()
+{
+	static_cast<HeadlessCOMDllDirector*>(RZGetCOMDllDirector())->SetFrameWork(nullptr);
+}
+
+HeadlessBudgetSimulator& HeadlessGame::GetBudgetSimulator()
+{
+	return budgetSimulator;
+}
+
+HeadlessRegion& HeadlessGame::GetRegion()
+{
+	return region;
+}
+
+HeadlessPopulationGrid& HeadlessGame::GetPopulationGrid()
+{
+	return residentialSimulator.GetPopulationGrid();
+}
+
+HeadlessOccupantManager& HeadlessGame::GetOccupantManager()
+{
+	return occupantManager;
+}
+
+void HeadlessGame::SetCityResidentialPopulation(int32_t lowWealth, int32_t mediumWealth, int32_t highWealth)
+{
+	residentialSimulator.SetPopulation(lowWealth + mediumWealth + highWealth);
+	demandSimulator.SetSupplyValue(0x1010, static_cast<float>(lowWealth));
+	demandSimulator.SetSupplyValue(0x1020, static_cast<float>(mediumWealth));
+	demandSimulator.SetSupplyValue(0x1030, static_cast<float>(highWealth));
+	pCurrentRegionalCity->SetResidentialPopulation(lowWealth, mediumWealth, highWealth);
+}
+
+void HeadlessGame::SetCityTotalResidentialPopulation(int32_t value)
+{
+	residentialSimulator.SetPopulation(value);
+	pCurrentRegionalCity->SetTotalResidentialPopulation(value);
+}
+
+void HeadlessGame::PostCityInit()
+{
+	SendGameMessage(kSC4MessagePostCityInit, static_cast<cISC4City*>(&city));
+}
+
+void HeadlessGame::PostCityShutdown()
+{
+	SendGameMessage(kSC4MessagePostCityShutdown, static_cast<cISC4City*>(&city));
+	occupantManager.Clear();
+}
+
+void HeadlessGame::InsertOccupant(cISC4Occupant* pOccupant)
+{
+	occupantManager.InsertOccupant(pOccupant, 0);
+	SendGameMessage(kSC4MessageInsertOccupant, pOccupant);
+}
+
+void HeadlessGame::RemoveOccupant(cISC4Occupant* pOccupant)
+{
+	SendGameMessage(kSC4MessageRemoveOccupant, pOccupant);
+	occupantManager.RemoveOccupant(pOccupant, false, 0);
+}
+
+void HeadlessGame::SimNewMonth()
+{
+	SendGameMessage(kSC4MessageSimNewMonth, nullptr);
+}
+
+void HeadlessGame::Load(HeadlessDBSegment& segment)
+{
+	SendGameMessage(kSC4MessageLoad, static_cast<cIGZPersistDBSegment*>(&segment));
+}
+
+void HeadlessGame::Save(HeadlessDBSegment& segment)
+{
+	SendGameMessage(kSC4MessageSave, static_cast<cIGZPersistDBSegment*>(&segment));
+}
+
+void HeadlessGame::SendGameMessage(uint32_t messageType, void* pData)
+{
+	cRZMessage2Standard message;
+	message.SetType(messageType);
+	message.SetVoid1(pData);
+
+	messageServer.MessageSend(static_cast<cIGZMessage2Standard*>(&message));
+}
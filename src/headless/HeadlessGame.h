@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "HeadlessAllocatorService.h"
+#include "HeadlessApp.h"
+#include "HeadlessBudgetSimulator.h"
+#include "HeadlessCity.h"
+#include "HeadlessDBSegment.h"
+#include "HeadlessDemandSimulator.h"
+#include "HeadlessFrameWork.h"
+#include "HeadlessMessageServer2.h"
+#include "HeadlessOccupantManager.h"
+#include "HeadlessRegion.h"
+#include "HeadlessResidentialSimulator.h"
+
+class cISC4Occupant;
+
+/**
+ * @brief Hosts the plugin outside of the game using the in-memory stand-ins.
+ *
+ * The game's framework services are available for the lifetime of the object,
+ * so only one instance can exist at a time. The messages are delivered to the
+ * targets that registered with the message server, e.g. by calling
+ * CustomBudgetDepartmentManager::Init.
+ */
+class HeadlessGame final
+{
+public:
+	HeadlessGame();
+	~HeadlessGame();
+
+	HeadlessGame(const HeadlessGame&) = delete;
+	HeadlessGame& operator=(const HeadlessGame&) = delete;
+
+	HeadlessBudgetSimulator& GetBudgetSimulator();
+	HeadlessRegion& GetRegion();
+	HeadlessPopulationGrid& GetPopulationGrid();
+
+	/**
+	 * @brief Gets the city's occupant manager.
+	 *
+	 * InsertOccupant and RemoveOccupant update the occupant manager before and after the
+	 * plugin receives the message, occupants that are inserted directly are not sent to the plugin.
+	 * The occupants are removed when the city is shut down.
+	 */
+	HeadlessOccupantManager& GetOccupantManager();
+
+	/**
+	 * @brief Sets the residential wealth group populations of the current city.
+	 */
+	void SetCityResidentialPopulation(int32_t lowWealth, int32_t mediumWealth, int32_t highWealth);
+
+	/**
+	 * @brief Sets the total residential population of the current city without changing
+	 * the wealth group populations.
+	 */
+	void SetCityTotalResidentialPopulation(int32_t value);
+
+	void PostCityInit();
+	void PostCityShutdown();
+	void InsertOccupant(cISC4Occupant* pOccupant);
+	void RemoveOccupant(cISC4Occupant* pOccupant);
+	void SimNewMonth();
+	void Load(HeadlessDBSegment& segment);
+	void Save(HeadlessDBSegment& segment);
+
+private:
+	void SendGameMessage(uint32_t messageType, void* pData);
+
+	HeadlessAllocatorService allocatorService;
+	HeadlessMessageServer2 messageServer;
+	HeadlessBudgetSimulator budgetSimulator;
+	HeadlessDemandSimulator demandSimulator;
+	HeadlessOccupantManager occupantManager;
+	HeadlessResidentialSimulator residentialSimulator;
+	HeadlessCity city;
+	HeadlessRegion region;
+	HeadlessRegionalCity* pCurrentRegionalCity;
+	HeadlessApp app;
+	HeadlessFrameWork frameWork;
+};
@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessLineItem.h"
+
+HeadlessLineItem::HeadlessLineItem(uint32_t id, bool isLocallyFunded)
+	: refCount(0),
+	  id(id),
+	  type(Type::Expense),
+	  nameGroupID(0),
+	  nameInstanceID(0),
+	  secondaryInfoField(0),
+	  fullExpenses(0),
+	  income(0),
+	  displayFlags(static_cast<uint32_t>(DisplayFlag::ShowLineItem)),
+	  isLocallyFunded(isLocallyFunded)
+{
+}
+
+bool HeadlessLineItem::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessLineItem::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessLineItem::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+uint32_t HeadlessLineItem::GetID() const
+{
+	return id;
+}
+
+cISC4LineItem::Type HeadlessLineItem::GetType() const
+{
+	return type;
+}
+
+bool HeadlessLineItem::SetType(Type value)
+{
+	type = value;
+
+	return true;
+}
+
+bool HeadlessLineItem::GetName(intptr_t& name)
+{
+	// The game's cRZString type is not available.
+	return false;
+}
+
+bool HeadlessLineItem::SetName(uint32_t groupID, uint32_t instanceID)
+{
+	nameGroupID = groupID;
+	nameInstanceID = instanceID;
+
+	return true;
+}
+
+int64_t HeadlessLineItem::GetSecondaryInfoField() const
+{
+	return secondaryInfoField;
+}
+
+bool HeadlessLineItem::SetSecondaryInfoField(int64_t value)
+{
+	secondaryInfoField = value;
+
+	return true;
+}
+
+int64_t HeadlessLineItem::GetFullExpenses() const
+{
+	return fullExpenses;
+}
+
+int64_t HeadlessLineItem::GetCurrentExpenses() const
+{
+	// The line items are always fully funded.
+	return fullExpenses;
+}
+
+bool HeadlessLineItem::SetFullExpenses(int64_t value)
+{
+	fullExpenses = value;
+
+	return true;
+}
+
+bool HeadlessLineItem::AddToFullExpenses(int64_t value)
+{
+	fullExpenses += value;
+
+	return true;
+}
+
+int64_t HeadlessLineItem::GetIncome() const
+{
+	return income;
+}
+
+bool HeadlessLineItem::SetIncome(int64_t value)
+{
+	income = value;
+
+	return true;
+}
+
+bool HeadlessLineItem::AddToIncome(int64_t value)
+{
+	income += value;
+
+	return true;
+}
+
+cISC4LineItem::DisplayFlag HeadlessLineItem::GetDisplayFlags()
+{
+	return static_cast<DisplayFlag>(displayFlags);
+}
+
+bool HeadlessLineItem::SetDisplayFlag(DisplayFlag flag, bool value)
+{
+	if (value)
+	{
+		displayFlags |= static_cast<uint32_t>(flag);
+	}
+	else
+	{
+		displayFlags &= ~static_cast<uint32_t>(flag);
+	}
+
+	return true;
+}
+
+bool HeadlessLineItem::IsLocalFundingItem() const
+{
+	return isLocallyFunded;
+}
@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4LineItem.h"
+
+/**
+ * @brief An in-memory budget department line item.
+ */
+class HeadlessLineItem final : public cISC4LineItem
+{
+public:
+	HeadlessLineItem(uint32_t id, bool isLocallyFunded);
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cISC4LineItem
+
+	uint32_t GetID() const override;
+	Type GetType() const override;
+	bool SetType(Type value) override;
+	bool GetName(intptr_t& name) override;
+	bool SetName(uint32_t groupID, uint32_t instanceID) override;
+	int64_t GetSecondaryInfoField() const override;
+	bool SetSecondaryInfoField(int64_t value) override;
+	int64_t GetFullExpenses() const override;
+	int64_t GetCurrentExpenses() const override;
+	bool SetFullExpenses(int64_t value) override;
+	bool AddToFullExpenses(int64_t value) override;
+	int64_t GetIncome() const override;
+	bool SetIncome(int64_t value) override;
+	bool AddToIncome(int64_t value) override;
+	DisplayFlag GetDisplayFlags() override;
+	bool SetDisplayFlag(DisplayFlag flag, bool value) override;
+	bool IsLocalFundingItem() const override;
+
+private:
+	uint32_t refCount;
+	uint32_t id;
+	Type type;
+	uint32_t nameGroupID;
+	uint32_t nameInstanceID;
+	int64_t secondaryInfoField;
+	int64_t fullExpenses;
+	int64_t income;
+	uint32_t displayFlags;
+	bool isLocallyFunded;
+};
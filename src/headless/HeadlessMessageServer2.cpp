@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessMessageServer2.h"
+#include "cIGZMessage2.h"
+#include "cIGZMessageTarget2.h"
+#include <algorithm>
+
+HeadlessMessageServer2::HeadlessMessageServer2()
+	: refCount(0),
+	  notifications()
+{
+}
+
+bool HeadlessMessageServer2::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == kGZIID_cIGZMessageServer2)
+	{
+		*ppvObj = static_cast<cIGZMessageServer2*>(this);
+		AddRef();
+
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessMessageServer2::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessMessageServer2::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool HeadlessMessageServer2::MessageSend(cIGZMessage2* pMessage)
+{
+	bool result = false;
+
+	if (pMessage)
+	{
+		const auto& item = notifications.find(pMessage->GetType());
+
+		if (item != notifications.end())
+		{
+			// A target may remove its notification while it is processing the message.
+			const std::vector<cIGZMessageTarget2*> targets = item->second;
+
+			for (cIGZMessageTarget2* pTarget : targets)
+			{
+				pTarget->DoMessage(pMessage);
+			}
+
+			result = true;
+		}
+	}
+
+	return result;
+}
+
+bool HeadlessMessageServer2::MessagePost(cIGZMessage2* pMessage, bool bHighPriority)
+{
+	// There is no message queue, posted messages are sent immediately.
+	return MessageSend(pMessage);
+}
+
+bool HeadlessMessageServer2::AddNotification(cIGZMessageTarget2* pTarget, uint32_t dwMessageID)
+{
+	bool result = false;
+
+	if (pTarget)
+	{
+		std::vector<cIGZMessageTarget2*>& targets = notifications[dwMessageID];
+
+		if (std::find(targets.begin(), targets.end(), pTarget) == targets.end())
+		{
+			targets.push_back(pTarget);
+			result = true;
+		}
+	}
+
+	return result;
+}
+
+bool HeadlessMessageServer2::RemoveNotification(cIGZMessageTarget2* pTarget, uint32_t dwMessageID)
+{
+	bool result = false;
+
+	const auto& item = notifications.find(dwMessageID);
+
+	if (item != notifications.end())
+	{
+		std::vector<cIGZMessageTarget2*>& targets = item->second;
+
+		const auto& target = std::find(targets.begin(), targets.end(), pTarget);
+
+		if (target != targets.end())
+		{
+			targets.erase(target);
+			result = true;
+		}
+	}
+
+	return result;
+}
+
+bool HeadlessMessageServer2::GeneralMessagePostToTarget(cIGZMessage2* pMessage, cIGZMessageTarget2* pTarget)
+{
+	return pMessage && pTarget && pTarget->DoMessage(pMessage);
+}
+
+bool HeadlessMessageServer2::CancelGeneralMessagePostsToTarget(cIGZMessageTarget2* pTarget)
+{
+	return {};
+}
+
+bool HeadlessMessageServer2::OnTick()
+{
+	return {};
+}
+
+uint32_t HeadlessMessageServer2::GetMessageQueueSize()
+{
+	return {};
+}
+
+cIGZMessageServer2* HeadlessMessageServer2::SetAlwaysClearQueueOnTick(bool bToggle)
+{
+	return {};
+}
+
+uint32_t HeadlessMessageServer2::GetRefCount()
+{
+	return refCount;
+}
+
+cIGZMessage2* HeadlessMessageServer2::CreateMessage(uint32_t clsid, uint32_t msgid, void** ppData)
+{
+	return {};
+}
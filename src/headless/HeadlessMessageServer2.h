@@ -0,0 +1,51 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cIGZMessageServer2.h"
+#include <unordered_map>
+#include <vector>
+
+static constexpr uint32_t kGZIID_cIGZMessageServer2 = 0x652294C7;
+
+/**
+ * @brief A cIGZMessageServer2 that delivers every message synchronously to the
+ * targets that registered a notification for the message type.
+ */
+class HeadlessMessageServer2 final : public cIGZMessageServer2
+{
+public:
+	HeadlessMessageServer2();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cIGZMessageServer2
+
+	bool MessageSend(cIGZMessage2* pMessage) override;
+	bool MessagePost(cIGZMessage2* pMessage, bool bHighPriority) override;
+	bool AddNotification(cIGZMessageTarget2* pTarget, uint32_t dwMessageID) override;
+	bool RemoveNotification(cIGZMessageTarget2* pTarget, uint32_t dwMessageID) override;
+	bool GeneralMessagePostToTarget(cIGZMessage2* pMessage, cIGZMessageTarget2* pTarget) override;
+	bool CancelGeneralMessagePostsToTarget(cIGZMessageTarget2* pTarget) override;
+	bool OnTick() override;
+	uint32_t GetMessageQueueSize() override;
+	cIGZMessageServer2* SetAlwaysClearQueueOnTick(bool bToggle) override;
+	uint32_t GetRefCount() override;
+	cIGZMessage2* CreateMessage(uint32_t clsid, uint32_t msgid, void** ppData) override;
+
+private:
+	uint32_t refCount;
+	std::unordered_map<uint32_t, std::vector<cIGZMessageTarget2*>> notifications;
+};
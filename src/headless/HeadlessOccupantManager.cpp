@@ -0,0 +1,347 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessOccupantManager.h"
+#include "cISC4Occupant.h"
+#include "cISC4OccupantFilter.h"
+#include "cS3DVector3.h"
+#include <algorithm>
+
+HeadlessOccupantManager::HeadlessOccupantManager()
+	: refCount(0),
+	  occupants()
+{
+}
+
+bool HeadlessOccupantManager::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessOccupantManager::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessOccupantManager::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool HeadlessOccupantManager::Init()
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::Shutdown()
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::SetCitySize(float fX, float fZ)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetOccupantManagerCellSizes(float& fX, float& fZ)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetWorldCellCount(int& nX, int& nZ)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetOccupantManagerCellCount(int& nX, int& nZ)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetOccupantManagerCellBounds(int& nTL, int& nTR, int& nBL, int& nBR)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::WorldCellToOccupantManagerCell(int nX, int nZ, int& nManagerX, int& nManagerZ)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::OccupantManagerCellToWorldCell(int nX, int nZ, int& nWorldX, int& nWorldZ)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::WorldCellToStandardCityCell(int nX, int nZ, int& nCityX, int& nCityZ)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::StandardCityCellToWorldCell(int nX, int nZ, int& nWorldX, int& nWorldZ)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::WorldCellToPosition(int nX, int nZ, float& fX, float& fZ)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::PositionToWorldCell(float fX, float fZ, int& nX, int& nZ)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::OccupantManagerCellToPosition(int nX, int nZ, float& fX, float& fZ)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::PositionToOccupantManagerCell(float fX, float fZ, int& nX, int& nZ)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::StandardCityCellToPosition(int nX, int nZ, float& fX, float& fZ)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::PositionToStandardCityCell(float fX, float fZ, int& nX, int& nZ)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::InsertOccupant(cISC4Occupant* pOccupant, uint32_t dwMsgData)
+{
+	if (std::find(occupants.begin(), occupants.end(), pOccupant) != occupants.end())
+	{
+		return false;
+	}
+
+	occupants.push_back(pOccupant);
+	return true;
+}
+
+bool HeadlessOccupantManager::RemoveOccupant(cISC4Occupant* pOccupant, bool bShutOccupantDown, uint32_t dwMsgData)
+{
+	const auto& item = std::find(occupants.begin(), occupants.end(), pOccupant);
+
+	if (item == occupants.end())
+	{
+		return false;
+	}
+
+	occupants.erase(item);
+	return true;
+}
+
+bool HeadlessOccupantManager::RemoveOccupants(int32_t dwUnknown, bool bShutOccupantsDown, uint32_t dwMsgData)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::RemoveOccupants(cISC4OccupantFilter* pFilter, bool bShutOccupantsDown, uint32_t dwMsgData)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::MoveOccupant(cISC4Occupant* pOccupant, bool bUnknown)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::IsCellEmpty(int32_t nX, int32_t nZ)
+{
+	return {};
+}
+
+int32_t HeadlessOccupantManager::GetBoundingCells(int nUnknown1, int nUnknown2, int* nUnknown3[2], int& nUnknown4)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::FindOccupant(cISC4Occupant* pOccupant, bool bUnknown, int* nX, int* nZ)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetFirstOccupantByPosition(cISC4Occupant*& ppOccupant, float fX, float fZ, uint32_t dwUnknown)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetFirstOccupantByPosition(cISC4Occupant*& ppOccupant, float fX, float fZ, cISC4OccupantFilter* pFilter)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetFirstOccupant(cISC4Occupant*& ppOccupant, int nX, int nZ, uint32_t dwUnknown)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetFirstOccupant(cISC4Occupant*& ppOccupant, int nX, int nZ, cISC4OccupantFilter* pFilter)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetFirstOccupantByStandardCityCell(cISC4Occupant*& ppOccupant, int nX, int nZ, uint32_t dwUnknown)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetFirstOccupantByStandardCityCell(cISC4Occupant*& ppOccupant, int nX, int nZ, cISC4OccupantFilter* pFilter)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetFirstOccupantByStandardCityCells(cISC4Occupant*& ppOccupant, int const* nXCells, int const* nZCells, uint32_t dwUnknown)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetFirstOccupantByStandardCityCells(cISC4Occupant*& ppOccupant, int const* nXCells, int const* nZCells, cISC4OccupantFilter* pFilter)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetOccupantsByBBox(std::list<cISC4Occupant*>& sOccupants, float const* fXCells, float const* fZCells, uint32_t dwType, uint32_t dwUnknown)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetOccupantsByBBox(std::list<cISC4Occupant*>& sOccupants, float const* fXCells, float const* fZCells, cISC4OccupantFilter* pFilter, uint32_t dwUnknown)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetOccupantsByOccupantManagerCells(std::list<cISC4Occupant*>& sOccupants, int const* fXCells, int const* fZCells, uint32_t dwType, uint32_t dwUnknown)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetOccupantsByOccupantManagerCells(std::list<cISC4Occupant*>& sOccupants, int const* fXCells, int const* fZCells, cISC4OccupantFilter* pFilter, uint32_t dwUnknown)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetOccupantsByStandardCityCells(std::list<cISC4Occupant*>& sOccupants, int const* fXCells, int const* fZCells, uint32_t dwType, uint32_t dwUnknown)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::GetOccupantsByStandardCityCells(std::list<cISC4Occupant*>& sOccupants, int const* fXCells, int const* fZCells, cISC4OccupantFilter* pFilter, uint32_t dwUnknown)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::IterateOccupantsByBBox(bool(*pfIterator)(cISC4Occupant*, void*), void* pData, float const* pfUnknown1, float const* pfUnknown2, uint32_t dwUnknown)
+{
+	return IterateOccupantsInBBox(
+		pfIterator,
+		pData,
+		pfUnknown1,
+		pfUnknown2,
+		[dwUnknown](cISC4Occupant* pOccupant) { return static_cast<uint32_t>(pOccupant->GetType()) == dwUnknown; });
+}
+
+bool HeadlessOccupantManager::IterateOccupantsByBBox(bool(*pfIterator)(cISC4Occupant*, void*), void* pData, float const* pfUnknown1, float const* pfUnknown2, cISC4OccupantFilter* pFilter)
+{
+	return IterateOccupantsInBBox(
+		pfIterator,
+		pData,
+		pfUnknown1,
+		pfUnknown2,
+		[pFilter](cISC4Occupant* pOccupant)
+		{
+			return !pFilter
+				|| (pFilter->IsOccupantTypeIncluded(static_cast<uint32_t>(pOccupant->GetType()))
+					&& pFilter->IsOccupantIncluded(pOccupant));
+		});
+}
+
+bool HeadlessOccupantManager::IterateOccupants(bool(*pfIterator)(cISC4Occupant*, void*), void* pData, int const* pnUnknown1, int const* pnUnknown2, uint32_t dwUnknown)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::IterateOccupants(bool(*pfIterator)(cISC4Occupant*, void*), void* pData, int const* pnUnknown1, int const* pnUnknown2, cISC4OccupantFilter* pFilter)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::IterateOccupantsByStandardCityCell(bool(*pfIterator)(cISC4Occupant*, void*), void* pData, int const* pnUnknown1, int const* pnUnknown2, uint32_t dwUnknown)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::IterateOccupantsByStandardCityCell(bool(*pfIterator)(cISC4Occupant*, void*), void* pData, int const* pnUnknown1, int const* pnUnknown2, cISC4OccupantFilter* pFilter)
+{
+	return {};
+}
+
+bool HeadlessOccupantManager::ReleaseOccupantList(std::list<cISC4Occupant*>& sList)
+{
+	return {};
+}
+
+void HeadlessOccupantManager::Clear()
+{
+	occupants.clear();
+}
+
+template<typename Predicate> bool HeadlessOccupantManager::IterateOccupantsInBBox(
+	bool(*pfIterator)(cISC4Occupant*, void*),
+	void* pData,
+	float const* pfXRange,
+	float const* pfZRange,
+	Predicate&& predicate)
+{
+	if (!pfIterator || !pfXRange || !pfZRange)
+	{
+		return false;
+	}
+
+	for (cISC4Occupant* pOccupant : occupants)
+	{
+		cS3DVector3 position;
+		pOccupant->GetPosition(&position);
+
+		if (position.fX >= pfXRange[0]
+			&& position.fX <= pfXRange[1]
+			&& position.fZ >= pfZRange[0]
+			&& position.fZ <= pfZRange[1]
+			&& predicate(pOccupant)
+			&& !pfIterator(pOccupant, pData))
+		{
+			break;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4OccupantManager.h"
+#include <vector>
+
+/**
+ * @brief An in-memory occupant manager that stores the occupants in insertion order.
+ *
+ * Only the occupant insertion, removal and bounding box iteration methods are implemented.
+ * The bounding box is an array with the minimum and maximum X positions and an array with the
+ * minimum and maximum Z positions, which is how the plugin calls the game's occupant manager.
+ */
+class HeadlessOccupantManager final : public cISC4OccupantManager
+{
+public:
+	HeadlessOccupantManager();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cISC4OccupantManager
+
+	bool Init() override;
+	bool Shutdown() override;
+
+	bool SetCitySize(float fX, float fZ) override;
+	bool GetOccupantManagerCellSizes(float& fX, float& fZ) override;
+	bool GetWorldCellCount(int& nX, int& nZ) override;
+	bool GetOccupantManagerCellCount(int& nX, int& nZ) override;
+	bool GetOccupantManagerCellBounds(int& nTL, int& nTR, int& nBL, int& nBR) override;
+	bool WorldCellToOccupantManagerCell(int nX, int nZ, int& nManagerX, int& nManagerZ) override;
+	bool OccupantManagerCellToWorldCell(int nX, int nZ, int& nWorldX, int& nWorldZ) override;
+	bool WorldCellToStandardCityCell(int nX, int nZ, int& nCityX, int& nCityZ) override;
+	bool StandardCityCellToWorldCell(int nX, int nZ, int& nWorldX, int& nWorldZ) override;
+	bool WorldCellToPosition(int nX, int nZ, float& fX, float& fZ) override;
+	bool PositionToWorldCell(float fX, float fZ, int& nX, int& nZ) override;
+	bool OccupantManagerCellToPosition(int nX, int nZ, float& fX, float& fZ) override;
+	bool PositionToOccupantManagerCell(float fX, float fZ, int& nX, int& nZ) override;
+	bool StandardCityCellToPosition(int nX, int nZ, float& fX, float& fZ) override;
+	bool PositionToStandardCityCell(float fX, float fZ, int& nX, int& nZ) override;
+	bool InsertOccupant(cISC4Occupant* pOccupant, uint32_t dwMsgData) override;
+	bool RemoveOccupant(cISC4Occupant* pOccupant, bool bShutOccupantDown, uint32_t dwMsgData) override;
+	bool RemoveOccupants(int32_t dwUnknown, bool bShutOccupantsDown, uint32_t dwMsgData) override;
+	bool RemoveOccupants(cISC4OccupantFilter* pFilter, bool bShutOccupantsDown, uint32_t dwMsgData) override;
+	bool MoveOccupant(cISC4Occupant* pOccupant, bool bUnknown) override;
+	bool IsCellEmpty(int32_t nX, int32_t nZ) override;
+	int32_t GetBoundingCells(int nUnknown1, int nUnknown2, int* nUnknown3[2], int& nUnknown4) override;
+	bool FindOccupant(cISC4Occupant* pOccupant, bool bUnknown, int* nX, int* nZ) override;
+	bool GetFirstOccupantByPosition(cISC4Occupant*& ppOccupant, float fX, float fZ, uint32_t dwUnknown) override;
+	bool GetFirstOccupantByPosition(cISC4Occupant*& ppOccupant, float fX, float fZ, cISC4OccupantFilter* pFilter) override;
+	bool GetFirstOccupant(cISC4Occupant*& ppOccupant, int nX, int nZ, uint32_t dwUnknown) override;
+	bool GetFirstOccupant(cISC4Occupant*& ppOccupant, int nX, int nZ, cISC4OccupantFilter* pFilter) override;
+	bool GetFirstOccupantByStandardCityCell(cISC4Occupant*& ppOccupant, int nX, int nZ, uint32_t dwUnknown) override;
+	bool GetFirstOccupantByStandardCityCell(cISC4Occupant*& ppOccupant, int nX, int nZ, cISC4OccupantFilter* pFilter) override;
+	bool GetFirstOccupantByStandardCityCells(cISC4Occupant*& ppOccupant, int const* nXCells, int const* nZCells, uint32_t dwUnknown) override;
+	bool GetFirstOccupantByStandardCityCells(cISC4Occupant*& ppOccupant, int const* nXCells, int const* nZCells, cISC4OccupantFilter* pFilter) override;
+	bool GetOccupantsByBBox(std::list<cISC4Occupant*>& sOccupants, float const* fXCells, float const* fZCells, uint32_t dwType, uint32_t dwUnknown) override;
+	bool GetOccupantsByBBox(std::list<cISC4Occupant*>& sOccupants, float const* fXCells, float const* fZCells, cISC4OccupantFilter* pFilter, uint32_t dwUnknown) override;
+	bool GetOccupantsByOccupantManagerCells(std::list<cISC4Occupant*>& sOccupants, int const* fXCells, int const* fZCells, uint32_t dwType, uint32_t dwUnknown) override;
+	bool GetOccupantsByOccupantManagerCells(std::list<cISC4Occupant*>& sOccupants, int const* fXCells, int const* fZCells, cISC4OccupantFilter* pFilter, uint32_t dwUnknown) override;
+	bool GetOccupantsByStandardCityCells(std::list<cISC4Occupant*>& sOccupants, int const* fXCells, int const* fZCells, uint32_t dwType, uint32_t dwUnknown) override;
+	bool GetOccupantsByStandardCityCells(std::list<cISC4Occupant*>& sOccupants, int const* fXCells, int const* fZCells, cISC4OccupantFilter* pFilter, uint32_t dwUnknown) override;
+	bool IterateOccupantsByBBox(bool(*pfIterator)(cISC4Occupant*, void*), void* pData, float const* pfUnknown1, float const* pfUnknown2, uint32_t dwUnknown) override;
+	bool IterateOccupantsByBBox(bool(*pfIterator)(cISC4Occupant*, void*), void* pData, float const* pfUnknown1, float const* pfUnknown2, cISC4OccupantFilter* pFilter) override;
+	bool IterateOccupants(bool(*pfIterator)(cISC4Occupant*, void*), void* pData, int const* pnUnknown1, int const* pnUnknown2, uint32_t dwUnknown) override;
+	bool IterateOccupants(bool(*pfIterator)(cISC4Occupant*, void*), void* pData, int const* pnUnknown1, int const* pnUnknown2, cISC4OccupantFilter* pFilter) override;
+	bool IterateOccupantsByStandardCityCell(bool(*pfIterator)(cISC4Occupant*, void*), void* pData, int const* pnUnknown1, int const* pnUnknown2, uint32_t dwUnknown) override;
+	bool IterateOccupantsByStandardCityCell(bool(*pfIterator)(cISC4Occupant*, void*), void* pData, int const* pnUnknown1, int const* pnUnknown2, cISC4OccupantFilter* pFilter) override;
+	bool ReleaseOccupantList(std::list<cISC4Occupant*>& sList) override;
+
+	/**
+	 * @brief Removes all of the occupants without sending any messages.
+	 */
+	void Clear();
+
+private:
+	template<typename Predicate> bool IterateOccupantsInBBox(
+		bool(*pfIterator)(cISC4Occupant*, void*),
+		void* pData,
+		float const* pfXRange,
+		float const* pfZRange,
+		Predicate&& predicate);
+
+	uint32_t refCount;
+	std::vector<cISC4Occupant*> occupants;
+};
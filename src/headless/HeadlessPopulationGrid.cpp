@@ -0,0 +1,219 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessPopulationGrid.h"
+#include <algorithm>
+
+static constexpr float CellSizeInMeters = 16.0f;
+
+HeadlessPopulationGrid::HeadlessPopulationGrid()
+	: refCount(0),
+	  instanceID(0),
+	  tractShift(0),
+	  tractCount(0),
+	  values()
+{
+}
+
+bool HeadlessPopulationGrid::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessPopulationGrid::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessPopulationGrid::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool HeadlessPopulationGrid::Init()
+{
+	return true;
+}
+
+bool HeadlessPopulationGrid::Shutdown()
+{
+	return true;
+}
+
+uint32_t HeadlessPopulationGrid::GetInstanceID()
+{
+	return instanceID;
+}
+
+bool HeadlessPopulationGrid::SetInstanceID(uint32_t dwInstanceID)
+{
+	instanceID = dwInstanceID;
+	return true;
+}
+
+uint16_t HeadlessPopulationGrid::GetCellValue(int32_t nCellX, int32_t nCellZ)
+{
+	return GetTractValue(nCellX >> tractShift, nCellZ >> tractShift);
+}
+
+uint16_t HeadlessPopulationGrid::GetAverageValueInCellRect(int32_t nTopLeftX, int32_t nTopLeftZ, int32_t nBottomRightX, int32_t nBottomRightZ)
+{
+	return GetAverageValueInTractRect(
+		nTopLeftX >> tractShift,
+		nTopLeftZ >> tractShift,
+		nBottomRightX >> tractShift,
+		nBottomRightZ >> tractShift);
+}
+
+bool HeadlessPopulationGrid::SetTractSize(int32_t nSize)
+{
+	return false;
+}
+
+int32_t HeadlessPopulationGrid::GetTractSize()
+{
+	return 1 << tractShift;
+}
+
+int32_t HeadlessPopulationGrid::GetTractShift()
+{
+	return tractShift;
+}
+
+int32_t HeadlessPopulationGrid::GetTractCountX()
+{
+	return tractCount;
+}
+
+int32_t HeadlessPopulationGrid::GetTractCountZ()
+{
+	return tractCount;
+}
+
+float HeadlessPopulationGrid::GetTractWidthX()
+{
+	return static_cast<float>(GetTractSize()) * CellSizeInMeters;
+}
+
+float HeadlessPopulationGrid::GetTractWidthZ()
+{
+	return GetTractWidthX();
+}
+
+float HeadlessPopulationGrid::GetOneOverTractWidthX()
+{
+	return 1.0f / GetTractWidthX();
+}
+
+float HeadlessPopulationGrid::GetOneOverTractWidthZ()
+{
+	return GetOneOverTractWidthX();
+}
+
+bool HeadlessPopulationGrid::TractIsInBounds(uint32_t dwTractX, uint32_t dwTractZ)
+{
+	return dwTractX < static_cast<uint32_t>(tractCount) && dwTractZ < static_cast<uint32_t>(tractCount);
+}
+
+bool HeadlessPopulationGrid::PositionToTract(float fPosX, float fPosZ, int32_t& nTractX, int32_t& nTractZ)
+{
+	nTractX = static_cast<int32_t>(fPosX * GetOneOverTractWidthX());
+	nTractZ = static_cast<int32_t>(fPosZ * GetOneOverTractWidthZ());
+
+	return fPosX >= 0.0f && fPosZ >= 0.0f && TractIsInBounds(nTractX, nTractZ);
+}
+
+bool HeadlessPopulationGrid::TractCornerToPosition(int32_t nTractX, int32_t nTractZ, float& fPosX, float& fPosZ)
+{
+	fPosX = static_cast<float>(nTractX) * GetTractWidthX();
+	fPosZ = static_cast<float>(nTractZ) * GetTractWidthZ();
+
+	return TractIsInBounds(nTractX, nTractZ);
+}
+
+bool HeadlessPopulationGrid::TractCenterToPosition(int32_t nTractX, int32_t nTractZ, float& fPosX, float& fPosZ)
+{
+	fPosX = (static_cast<float>(nTractX) + 0.5f) * GetTractWidthX();
+	fPosZ = (static_cast<float>(nTractZ) + 0.5f) * GetTractWidthZ();
+
+	return TractIsInBounds(nTractX, nTractZ);
+}
+
+uint16_t HeadlessPopulationGrid::GetTractValue(int32_t nTractX, int32_t nTractZ)
+{
+	if (!TractIsInBounds(nTractX, nTractZ))
+	{
+		return 0;
+	}
+
+	return values[(static_cast<size_t>(nTractZ) * tractCount) + nTractX];
+}
+
+uint16_t HeadlessPopulationGrid::GetAverageValueInTractRect(int32_t nTopLeftX, int32_t nTopLeftZ, int32_t nBottomRightX, int32_t nBottomRightZ)
+{
+	uint64_t total = 0;
+	uint64_t count = 0;
+
+	for (int32_t z = std::max(nTopLeftZ, 0); z <= std::min(nBottomRightZ, tractCount - 1); z++)
+	{
+		for (int32_t x = std::max(nTopLeftX, 0); x <= std::min(nBottomRightX, tractCount - 1); x++)
+		{
+			total += GetTractValue(x, z);
+			count++;
+		}
+	}
+
+	return count > 0 ? static_cast<uint16_t>(total / count) : 0;
+}
+
+intptr_t HeadlessPopulationGrid::GetGridData()
+{
+	return reinterpret_cast<intptr_t>(values.data());
+}
+
+bool HeadlessPopulationGrid::SetTractValue(int32_t nTractX, int32_t nTractZ, uint16_t value)
+{
+	if (!TractIsInBounds(nTractX, nTractZ))
+	{
+		return false;
+	}
+
+	values[(static_cast<size_t>(nTractZ) * tractCount) + nTractX] = value;
+	return true;
+}
+
+bool HeadlessPopulationGrid::SetTractValues(uint16_t value)
+{
+	std::fill(values.begin(), values.end(), value);
+	return true;
+}
+
+void HeadlessPopulationGrid::Resize(int32_t cityCellCount, int32_t tractShift)
+{
+	this->tractShift = std::clamp(tractShift, 0, 8);
+	tractCount = std::max(cityCellCount, 0) >> this->tractShift;
+	values.assign(static_cast<size_t>(tractCount) * static_cast<size_t>(tractCount), 0);
+}
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4SimGrid.h"
+#include <vector>
+
+/**
+ * @brief An in-memory residential population grid.
+ *
+ * The grid is empty until it is resized, the tract values are stored in row-major order.
+ */
+class HeadlessPopulationGrid final : public cISC4SimGrid<uint16_t>
+{
+public:
+	HeadlessPopulationGrid();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cISC4SimGrid<uint16_t>
+
+	bool Init() override;
+	bool Shutdown() override;
+	uint32_t GetInstanceID() override;
+	bool SetInstanceID(uint32_t dwInstanceID) override;
+	uint16_t GetCellValue(int32_t nCellX, int32_t nCellZ) override;
+	uint16_t GetAverageValueInCellRect(int32_t nTopLeftX, int32_t nTopLeftZ, int32_t nBottomRightX, int32_t nBottomRightZ) override;
+	bool SetTractSize(int32_t nSize) override;
+	int32_t GetTractSize() override;
+	int32_t GetTractShift() override;
+	int32_t GetTractCountX() override;
+	int32_t GetTractCountZ() override;
+	float GetTractWidthX() override;
+	float GetTractWidthZ() override;
+	float GetOneOverTractWidthX() override;
+	float GetOneOverTractWidthZ() override;
+	bool TractIsInBounds(uint32_t dwTractX, uint32_t dwTractZ) override;
+	bool PositionToTract(float fPosX, float fPosZ, int32_t& nTractX, int32_t& nTractZ) override;
+	bool TractCornerToPosition(int32_t nTractX, int32_t nTractZ, float& fPosX, float& fPosZ) override;
+	bool TractCenterToPosition(int32_t nTractX, int32_t nTractZ, float& fPosX, float& fPosZ) override;
+	uint16_t GetTractValue(int32_t nTractX, int32_t nTractZ) override;
+	uint16_t GetAverageValueInTractRect(int32_t nTopLeftX, int32_t nTopLeftZ, int32_t nBottomRightX, int32_t nBottomRightZ) override;
+	intptr_t GetGridData() override;
+	bool SetTractValue(int32_t nTractX, int32_t nTractZ, uint16_t value) override;
+	bool SetTractValues(uint16_t value) override;
+
+	/**
+	 * @brief Resizes the grid to cover a city of the specified size, the tract values are set to zero.
+	 * @param cityCellCount The city width and height in cells.
+	 * @param tractShift The base 2 logarithm of the tract size in cells.
+	 */
+	void Resize(int32_t cityCellCount, int32_t tractShift);
+
+private:
+	uint32_t refCount;
+	uint32_t instanceID;
+	int32_t tractShift;
+	int32_t tractCount;
+	std::vector<uint16_t> values;
+};
@@ -0,0 +1,213 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessPropertyHolder.h"
+
+HeadlessPropertyHolder::HeadlessPropertyHolder()
+	: refCount(0),
+	  properties()
+{
+}
+
+bool HeadlessPropertyHolder::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cISCPropertyHolder)
+	{
+		*ppvObj = static_cast<cISCPropertyHolder*>(this);
+		AddRef();
+
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessPropertyHolder::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessPropertyHolder::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool HeadlessPropertyHolder::HasProperty(uint32_t dwProperty) const
+{
+	return properties.contains(dwProperty);
+}
+
+bool HeadlessPropertyHolder::GetPropertyList(cIGZUnknownList** ppList) const
+{
+	return {};
+}
+
+cISCProperty* HeadlessPropertyHolder::GetProperty(uint32_t dwProperty) const
+{
+	cISCProperty* pProperty = nullptr;
+
+	const auto& item = properties.find(dwProperty);
+
+	if (item != properties.end())
+	{
+		// The interface returns a non-const property from a const method.
+		pProperty = const_cast<cSCBaseProperty*>(&item->second);
+	}
+
+	return pProperty;
+}
+
+bool HeadlessPropertyHolder::GetProperty(uint32_t dwProperty, uint32_t& dwValueOut) const
+{
+	const cISCProperty* pProperty = GetProperty(dwProperty);
+
+	return pProperty && pProperty->GetPropertyValue()->GetValUint32(dwValueOut);
+}
+
+bool HeadlessPropertyHolder::GetProperty(uint32_t dwProperty, cIGZString& szValueOut) const
+{
+	return {};
+}
+
+bool HeadlessPropertyHolder::GetProperty(uint32_t dwProperty, uint32_t riid, void** ppvObj) const
+{
+	return {};
+}
+
+bool HeadlessPropertyHolder::GetProperty(uint32_t dwProperty, void* pUnknown, uint32_t& dwUnknownOut) const
+{
+	return {};
+}
+
+bool HeadlessPropertyHolder::AddProperty(cISCProperty* pProperty, bool bUnknown)
+{
+	bool result = false;
+
+	if (pProperty)
+	{
+		properties.insert_or_assign(pProperty->GetPropertyID(), cSCBaseProperty(*pProperty));
+		result = true;
+	}
+
+	return result;
+}
+
+bool HeadlessPropertyHolder::AddProperty(uint32_t dwProperty, cIGZVariant const* pVariant, bool bUnknown)
+{
+	bool result = false;
+
+	if (pVariant)
+	{
+		properties.insert_or_assign(dwProperty, cSCBaseProperty(dwProperty, pVariant));
+		result = true;
+	}
+
+	return result;
+}
+
+bool HeadlessPropertyHolder::AddProperty(uint32_t dwProperty, uint32_t dwValue, bool bUnknown)
+{
+	properties.insert_or_assign(dwProperty, cSCBaseProperty(dwProperty, dwValue));
+
+	return true;
+}
+
+bool HeadlessPropertyHolder::AddProperty(uint32_t dwProperty, cIGZString const& szValue)
+{
+	return {};
+}
+
+bool HeadlessPropertyHolder::AddProperty(uint32_t dwProperty, int32_t lValue, bool bUnknown)
+{
+	properties.insert_or_assign(dwProperty, cSCBaseProperty(dwProperty, lValue));
+
+	return true;
+}
+
+bool HeadlessPropertyHolder::AddProperty(uint32_t dwProperty, void* pUnknown, uint32_t dwUnknown, bool bUnknown)
+{
+	return {};
+}
+
+bool HeadlessPropertyHolder::CopyAddProperty(cISCProperty* pProperty, bool bUnknown)
+{
+	return AddProperty(pProperty, bUnknown);
+}
+
+bool HeadlessPropertyHolder::RemoveProperty(uint32_t dwProperty)
+{
+	return properties.erase(dwProperty) == 1;
+}
+
+bool HeadlessPropertyHolder::RemoveAllProperties()
+{
+	properties.clear();
+
+	return true;
+}
+
+bool HeadlessPropertyHolder::EnumProperties(FunctionPtr1 pFunction1, void* pData) const
+{
+	for (auto& item : properties)
+	{
+		pFunction1(const_cast<cSCBaseProperty*>(&item.second), pData);
+	}
+
+	return true;
+}
+
+bool HeadlessPropertyHolder::EnumProperties(FunctionPtr2 pFunction2, FunctionPtr1 pFunctionPipe) const
+{
+	return {};
+}
+
+bool HeadlessPropertyHolder::CompactProperties()
+{
+	return true;
+}
+
+void HeadlessPropertyHolder::SetUint32ArrayProperty(uint32_t id, const std::vector<uint32_t>& values)
+{
+	cRZBaseVariant variant;
+	variant.RefUint32(const_cast<uint32_t*>(values.data()), static_cast<uint32_t>(values.size()));
+
+	properties.insert_or_assign(id, cSCBaseProperty(id, variant));
+}
+
+void HeadlessPropertyHolder::SetSint64ArrayProperty(uint32_t id, const std::vector<int64_t>& values)
+{
+	cRZBaseVariant variant;
+	variant.RefSint64(const_cast<int64_t*>(values.data()), static_cast<uint32_t>(values.size()));
+
+	properties.insert_or_assign(id, cSCBaseProperty(id, variant));
+}
+
+void HeadlessPropertyHolder::SetStringProperty(uint32_t id, std::string_view value)
+{
+	cRZBaseVariant variant;
+	variant.RefChar(const_cast<char*>(value.data()), static_cast<uint32_t>(value.size()));
+
+	properties.insert_or_assign(id, cSCBaseProperty(id, variant));
+}
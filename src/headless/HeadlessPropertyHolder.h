@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISCPropertyHolder.h"
+#include "cSCBaseProperty.h"
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief An in-memory property holder, used in place of a building exemplar.
+ */
+class HeadlessPropertyHolder final : public cISCPropertyHolder
+{
+public:
+	HeadlessPropertyHolder();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cISCPropertyHolder
+
+	bool HasProperty(uint32_t dwProperty) const override;
+	bool GetPropertyList(cIGZUnknownList** ppList) const override;
+	cISCProperty* GetProperty(uint32_t dwProperty) const override;
+	bool GetProperty(uint32_t dwProperty, uint32_t& dwValueOut) const override;
+	bool GetProperty(uint32_t dwProperty, cIGZString& szValueOut) const override;
+	bool GetProperty(uint32_t dwProperty, uint32_t riid, void** ppvObj) const override;
+	bool GetProperty(uint32_t dwProperty, void* pUnknown, uint32_t& dwUnknownOut) const override;
+	bool AddProperty(cISCProperty* pProperty, bool bUnknown) override;
+	bool AddProperty(uint32_t dwProperty, cIGZVariant const* pVariant, bool bUnknown) override;
+	bool AddProperty(uint32_t dwProperty, uint32_t dwValue, bool bUnknown) override;
+	bool AddProperty(uint32_t dwProperty, cIGZString const& szValue) override;
+	bool AddProperty(uint32_t dwProperty, int32_t lValue, bool bUnknown) override;
+	bool AddProperty(uint32_t dwProperty, void* pUnknown, uint32_t dwUnknown, bool bUnknown) override;
+	bool CopyAddProperty(cISCProperty* pProperty, bool bUnknown) override;
+	bool RemoveProperty(uint32_t dwProperty) override;
+	bool RemoveAllProperties() override;
+	bool EnumProperties(FunctionPtr1 pFunction1, void* pData) const override;
+	bool EnumProperties(FunctionPtr2 pFunction2, FunctionPtr1 pFunctionPipe) const override;
+	bool CompactProperties() override;
+
+	/**
+	 * @brief Adds or replaces a Uint32 array property.
+	 */
+	void SetUint32ArrayProperty(uint32_t id, const std::vector<uint32_t>& values);
+
+	/**
+	 * @brief Adds or replaces a Sint64 array property.
+	 */
+	void SetSint64ArrayProperty(uint32_t id, const std::vector<int64_t>& values);
+
+	/**
+	 * @brief Adds or replaces a String property.
+	 */
+	void SetStringProperty(uint32_t id, std::string_view value);
+
+private:
+	uint32_t refCount;
+	std::unordered_map<uint32_t, cSCBaseProperty> properties;
+};
@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessRegion.h"
+
+HeadlessRegion::HeadlessRegion()
+	: refCount(0),
+	  cities(),
+	  cityLocations()
+{
+}
+
+bool HeadlessRegion::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessRegion::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessRegion::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+char* HeadlessRegion::GetName()
+{
+	return {};
+}
+
+bool HeadlessRegion::SetName(const cIGZString& szName)
+{
+	return {};
+}
+
+char* HeadlessRegion::GetDirectoryName()
+{
+	return {};
+}
+
+bool HeadlessRegion::SetDirectoryName(const cIGZString& szName)
+{
+	return {};
+}
+
+bool HeadlessRegion::LoadConfig()
+{
+	return {};
+}
+
+bool HeadlessRegion::Init()
+{
+	return {};
+}
+
+bool HeadlessRegion::Shutdown()
+{
+	return {};
+}
+
+bool HeadlessRegion::Delete()
+{
+	return {};
+}
+
+cISC4RegionalCity** HeadlessRegion::GetCity(uint32_t x, uint32_t y)
+{
+	cISC4RegionalCity** ppCity = nullptr;
+
+	const auto& item = cityLocations.find(std::make_pair(x, y));
+
+	if (item != cityLocations.end())
+	{
+		ppCity = &item->second;
+	}
+
+	return ppCity;
+}
+
+cISC4RegionalCity**& HeadlessRegion::InsertCity(cISC4RegionalCity* pCity)
+{
+	static cISC4RegionalCity** pNoCity = nullptr;
+
+	return pNoCity;
+}
+
+bool HeadlessRegion::RemoveCity(cISC4RegionalCity*& pCity)
+{
+	return {};
+}
+
+bool HeadlessRegion::DeleteCity(cISC4RegionalCity*& pCity)
+{
+	return {};
+}
+
+bool HeadlessRegion::ReloadCity(cISC4RegionalCity*& pCity)
+{
+	return {};
+}
+
+bool HeadlessRegion::MoveCity(cISC4Region* pRegion, cISC4RegionalCity* pCity, int32_t x, int32_t y)
+{
+	return {};
+}
+
+bool HeadlessRegion::GetAllCities(eastl::list<cRZAutoRefCount<cISC4RegionalCity>>& pList)
+{
+	return {};
+}
+
+int HeadlessRegion::GetBaseTerrainType()
+{
+	return {};
+}
+
+cISC4Region* HeadlessRegion::SetBaseTerrainType(int nType)
+{
+	return {};
+}
+
+int HeadlessRegion::GetBaseTerrainHeight()
+{
+	return {};
+}
+
+int32_t HeadlessRegion::GetWaterPrefs(uint8_t& cUnknown1, uint8_t& cUnknown2)
+{
+	return {};
+}
+
+bool HeadlessRegion::ResetTutorialCity(uint32_t dwTutorialCityID)
+{
+	return {};
+}
+
+void HeadlessRegion::GetCityLocations(eastl::vector<cLocation>& cityLocations)
+{
+	cityLocations.reserve(this->cityLocations.size());
+
+	for (const auto& item : this->cityLocations)
+	{
+		cLocation location{};
+		location.x = item.first.first;
+		location.z = item.first.second;
+		location.cityTileSize = eCityTileSize::Small;
+
+		cityLocations.push_back(location);
+	}
+}
+
+int32_t HeadlessRegion::GetBoundingRect(intptr_t pRectLongs)
+{
+	return {};
+}
+
+HeadlessRegionalCity* HeadlessRegion::AddCity(int32_t x, int32_t z, bool established)
+{
+	std::unique_ptr<HeadlessRegionalCity> city = std::make_unique<HeadlessRegionalCity>(x, z, established);
+	HeadlessRegionalCity* pCity = city.get();
+
+	cityLocations.insert_or_assign(
+		std::make_pair(static_cast<uint32_t>(x), static_cast<uint32_t>(z)),
+		static_cast<cISC4RegionalCity*>(pCity));
+	cities.push_back(std::move(city));
+
+	return pCity;
+}
@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4Region.h"
+#include "HeadlessRegionalCity.h"
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief An in-memory region that owns the region view cities.
+ */
+class HeadlessRegion final : public cISC4Region
+{
+public:
+	HeadlessRegion();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cISC4Region
+
+	char* GetName() override;
+	bool SetName(const cIGZString& szName) override;
+	char* GetDirectoryName() override;
+	bool SetDirectoryName(const cIGZString& szName) override;
+	bool LoadConfig() override;
+	bool Init() override;
+	bool Shutdown() override;
+	bool Delete() override;
+	cISC4RegionalCity** GetCity(uint32_t x, uint32_t y) override;
+	cISC4RegionalCity**& InsertCity(cISC4RegionalCity* pCity) override;
+	bool RemoveCity(cISC4RegionalCity*& pCity) override;
+	bool DeleteCity(cISC4RegionalCity*& pCity) override;
+	bool ReloadCity(cISC4RegionalCity*& pCity) override;
+	bool MoveCity(cISC4Region* pRegion, cISC4RegionalCity* pCity, int32_t x, int32_t y) override;
+	bool GetAllCities(eastl::list<cRZAutoRefCount<cISC4RegionalCity>>& pList) override;
+	int GetBaseTerrainType() override;
+	cISC4Region* SetBaseTerrainType(int nType) override;
+	int GetBaseTerrainHeight() override;
+	int32_t GetWaterPrefs(uint8_t& cUnknown1, uint8_t& cUnknown2) override;
+	bool ResetTutorialCity(uint32_t dwTutorialCityID) override;
+	void GetCityLocations(eastl::vector<cLocation>& cityLocations) override;
+	int32_t GetBoundingRect(intptr_t pRectLongs) override;
+
+	/**
+	 * @brief Adds a city to the region, an existing city at the same position is replaced.
+	 */
+	HeadlessRegionalCity* AddCity(int32_t x, int32_t z, bool established);
+
+private:
+	uint32_t refCount;
+	std::vector<std::unique_ptr<HeadlessRegionalCity>> cities;
+	// The game returns a pointer to the city pointer, the map nodes provide the
+	// stable storage for those pointers.
+	std::map<std::pair<uint32_t, uint32_t>, cISC4RegionalCity*> cityLocations;
+};
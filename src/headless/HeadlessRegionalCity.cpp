@@ -0,0 +1,432 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessRegionalCity.h"
+
+HeadlessRegionalCity::HeadlessRegionalCity(int32_t x, int32_t z, bool established)
+	: refCount(0),
+	  x(x),
+	  z(z),
+	  established(established),
+	  residentialPopulation(0),
+	  populations()
+{
+}
+
+bool HeadlessRegionalCity::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessRegionalCity::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessRegionalCity::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool HeadlessRegionalCity::Init()
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::Shutdown()
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::GetPosition(int32_t& nX, int32_t& nZ)
+{
+	nX = x;
+	nZ = z;
+
+	return true;
+}
+
+bool HeadlessRegionalCity::SetPosition(int32_t nX, int32_t nZ, bool bDoRearrange)
+{
+	x = nX;
+	z = nZ;
+
+	return true;
+}
+
+bool HeadlessRegionalCity::GetCitySize(int32_t& nX, int32_t& nZ)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetCitySize(int32_t nX, int32_t nZ)
+{
+	return {};
+}
+
+int32_t HeadlessRegionalCity::GetPopulation()
+{
+	return residentialPopulation;
+}
+
+int32_t HeadlessRegionalCity::GetCommercialJobs()
+{
+	return {};
+}
+
+int32_t HeadlessRegionalCity::GetIndustrialJobs()
+{
+	return {};
+}
+
+SC4Percentage* HeadlessRegionalCity::GetWorkforcePercentage()
+{
+	return {};
+}
+
+int8_t HeadlessRegionalCity::GetMayorRating()
+{
+	return {};
+}
+
+int32_t HeadlessRegionalCity::GetDifficultyLevel()
+{
+	return {};
+}
+
+float HeadlessRegionalCity::GetTaxRate(uint32_t dwTaxType)
+{
+	return {};
+}
+
+int32_t HeadlessRegionalCity::GetPopulation(uint32_t dwPopulationType)
+{
+	int32_t value = 0;
+
+	const auto& item = populations.find(dwPopulationType);
+
+	if (item != populations.end())
+	{
+		value = item->second;
+	}
+
+	return value;
+}
+
+int32_t HeadlessRegionalCity::GetExtrapolatedPopulation(uint32_t dwPopulationType)
+{
+	return {};
+}
+
+int32_t HeadlessRegionalCity::GetAllowableExtrapolation(uint32_t dwPopulationType)
+{
+	return {};
+}
+
+int32_t HeadlessRegionalCity::ExtrapolateGrowth(uint32_t dwPopulationType, float fAddedPop)
+{
+	return {};
+}
+
+cISC4RegionalCity* HeadlessRegionalCity::FindConnection(int32_t nUnknown1, int32_t nUnknown2, int32_t nUnknown3)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::GetAllConnections(std::list<cISC4NeighborConnection*>& sList)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::ChangeSymmetricConnection(cISC4NeighborConnection* pConnection, bool bUnknown)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetupPreferences(SC4NewCityPreferences* pPreferences)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::UpdateCityCache(SC4NewCityPreferences* pPreferences)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetupCity(cISC4City* pCity)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::UpdateCityCache(cISC4City* pCity)
+{
+	return {};
+}
+
+uint32_t HeadlessRegionalCity::GetCitySerialNumber()
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetCitySerialNumber(uint32_t dwSerialNumber)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::GetOriginalLanguageAndCountry(int32_t& nLanguage, int32_t& nCountry)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::GetLastLanguageAndCountry(int32_t& nLanguage, int32_t& nCountry)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::GetCitySaveFilePath(cIGZString& sPath)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetCitySaveFilePath(cIGZString const& sPath)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::GetCityName(cIGZString& sName)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetCityName(cIGZString const& sName)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::GetMayorName(cIGZString& sName)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetMayorName(cIGZString const& sName)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::GetUtilityAdvisorName(cIGZString& sName)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetUtilityAdvisorName(cIGZString const& sName)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::GetCityDescription(cIGZString& sDescription)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetCityDescription(cIGZString const& sDescription)
+{
+	return {};
+}
+
+uint32_t HeadlessRegionalCity::GetBirthDate()
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetBirthDate(uint32_t dwBirthDate)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::GetEstablished()
+{
+	return established;
+}
+
+bool HeadlessRegionalCity::SetEstablished(bool bEstablished)
+{
+	established = bEstablished;
+
+	return true;
+}
+
+bool HeadlessRegionalCity::GetWorldPosition(float& fX, float& fZ)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetWorldPosition(float fX, float fZ)
+{
+	return {};
+}
+
+float HeadlessRegionalCity::GetWorldBaseElevation()
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::GetWorldBaseElevation(float fElevation)
+{
+	return {};
+}
+
+int32_t HeadlessRegionalCity::GetWorldHemisphere()
+{
+	return {};
+}
+
+float HeadlessRegionalCity::GetBudget()
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetBudget(float fBudget)
+{
+	return {};
+}
+
+float HeadlessRegionalCity::GetIncome()
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetIncome(float fIncome)
+{
+	return {};
+}
+
+float HeadlessRegionalCity::GetExported(int32_t nCommodity)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetExported(int32_t nCommodity, float fExports)
+{
+	return {};
+}
+
+float HeadlessRegionalCity::GetImported(int32_t nCommodity)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetImported(int32_t nCommodity, float fImports)
+{
+	return {};
+}
+
+float HeadlessRegionalCity::GetProduced(int32_t nCommodity)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetProduced(int32_t nCommodity, float fProduced)
+{
+	return {};
+}
+
+float HeadlessRegionalCity::GetDemanded(int32_t nCommodity)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetDemanded(int32_t nCommodity, float fDemanded)
+{
+	return {};
+}
+
+float HeadlessRegionalCity::GetCostPerUnit(int32_t nCommodity)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetCostPerUnit(int32_t nCommodity, float fCostPerUnit)
+{
+	return {};
+}
+
+float HeadlessRegionalCity::GetCommodityBalance(int32_t nCommodity)
+{
+	return {};
+}
+
+uint32_t HeadlessRegionalCity::GetTutorialGUID()
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetTutorialGUID(uint32_t dwGUID)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::IsTutorial()
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::UpdateLocalDeals()
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::SetLocalDeals(std::list<cISC4NeighborDeal*>& sList)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::GetLocalDeals(std::list<cISC4NeighborDeal*>& sList)
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::UpdateImportExport()
+{
+	return {};
+}
+
+bool HeadlessRegionalCity::GetPointsOfInterest(uint32_t dwPointOfInterestType, eastl::vector<uint32_t>& sList)
+{
+	return {};
+}
+
+void HeadlessRegionalCity::SetResidentialPopulation(int32_t lowWealth, int32_t mediumWealth, int32_t highWealth)
+{
+	populations[0x1010] = lowWealth;
+	populations[0x1020] = mediumWealth;
+	populations[0x1030] = highWealth;
+	residentialPopulation = lowWealth + mediumWealth + highWealth;
+}
+
+void HeadlessRegionalCity::SetTotalResidentialPopulation(int32_t value)
+{
+	residentialPopulation = value;
+}
@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4RegionalCity.h"
+#include <unordered_map>
+
+/**
+ * @brief An in-memory region view city that only tracks its position and populations.
+ */
+class HeadlessRegionalCity final : public cISC4RegionalCity
+{
+public:
+	HeadlessRegionalCity(int32_t x, int32_t z, bool established);
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cISC4RegionalCity
+
+	bool Init() override;
+	bool Shutdown() override;
+	bool GetPosition(int32_t& nX, int32_t& nZ) override;
+	bool SetPosition(int32_t nX, int32_t nZ, bool bDoRearrange) override;
+	bool GetCitySize(int32_t& nX, int32_t& nZ) override;
+	bool SetCitySize(int32_t nX, int32_t nZ) override;
+	int32_t GetPopulation() override;
+	int32_t GetCommercialJobs() override;
+	int32_t GetIndustrialJobs() override;
+	SC4Percentage* GetWorkforcePercentage() override;
+	int8_t GetMayorRating() override;
+	int32_t GetDifficultyLevel() override;
+	float GetTaxRate(uint32_t dwTaxType) override;
+	int32_t GetPopulation(uint32_t dwPopulationType) override;
+	int32_t GetExtrapolatedPopulation(uint32_t dwPopulationType) override;
+	int32_t GetAllowableExtrapolation(uint32_t dwPopulationType) override;
+	int32_t ExtrapolateGrowth(uint32_t dwPopulationType, float fAddedPop) override;
+	cISC4RegionalCity* FindConnection(int32_t nUnknown1, int32_t nUnknown2, int32_t nUnknown3) override;
+	bool GetAllConnections(std::list<cISC4NeighborConnection*>& sList) override;
+	bool ChangeSymmetricConnection(cISC4NeighborConnection* pConnection, bool bUnknown) override;
+	bool SetupPreferences(SC4NewCityPreferences* pPreferences) override;
+	bool UpdateCityCache(SC4NewCityPreferences* pPreferences) override;
+	bool SetupCity(cISC4City* pCity) override;
+	bool UpdateCityCache(cISC4City* pCity) override;
+	uint32_t GetCitySerialNumber() override;
+	bool SetCitySerialNumber(uint32_t dwSerialNumber) override;
+	bool GetOriginalLanguageAndCountry(int32_t& nLanguage, int32_t& nCountry) override;
+	bool GetLastLanguageAndCountry(int32_t& nLanguage, int32_t& nCountry) override;
+	bool GetCitySaveFilePath(cIGZString& sPath) override;
+	bool SetCitySaveFilePath(cIGZString const& sPath) override;
+	bool GetCityName(cIGZString& sName) override;
+	bool SetCityName(cIGZString const& sName) override;
+	bool GetMayorName(cIGZString& sName) override;
+	bool SetMayorName(cIGZString const& sName) override;
+	bool GetUtilityAdvisorName(cIGZString& sName) override;
+	bool SetUtilityAdvisorName(cIGZString const& sName) override;
+	bool GetCityDescription(cIGZString& sDescription) override;
+	bool SetCityDescription(cIGZString const& sDescription) override;
+	uint32_t GetBirthDate() override;
+	bool SetBirthDate(uint32_t dwBirthDate) override;
+	bool GetEstablished() override;
+	bool SetEstablished(bool bEstablished) override;
+	bool GetWorldPosition(float& fX, float& fZ) override;
+	bool SetWorldPosition(float fX, float fZ) override;
+	float GetWorldBaseElevation() override;
+	bool GetWorldBaseElevation(float fElevation) override;
+	int32_t GetWorldHemisphere() override;
+	float GetBudget() override;
+	bool SetBudget(float fBudget) override;
+	float GetIncome() override;
+	bool SetIncome(float fIncome) override;
+	float GetExported(int32_t nCommodity) override;
+	bool SetExported(int32_t nCommodity, float fExports) override;
+	float GetImported(int32_t nCommodity) override;
+	bool SetImported(int32_t nCommodity, float fImports) override;
+	float GetProduced(int32_t nCommodity) override;
+	bool SetProduced(int32_t nCommodity, float fProduced) override;
+	float GetDemanded(int32_t nCommodity) override;
+	bool SetDemanded(int32_t nCommodity, float fDemanded) override;
+	float GetCostPerUnit(int32_t nCommodity) override;
+	bool SetCostPerUnit(int32_t nCommodity, float fCostPerUnit) override;
+	float GetCommodityBalance(int32_t nCommodity) override;
+	uint32_t GetTutorialGUID() override;
+	bool SetTutorialGUID(uint32_t dwGUID) override;
+	bool IsTutorial() override;
+	bool UpdateLocalDeals() override;
+	bool SetLocalDeals(std::list<cISC4NeighborDeal*>& sList) override;
+	bool GetLocalDeals(std::list<cISC4NeighborDeal*>& sList) override;
+	bool UpdateImportExport() override;
+	bool GetPointsOfInterest(uint32_t dwPointOfInterestType, eastl::vector<uint32_t>& sList) override;
+
+	/**
+	 * @brief Sets the residential wealth group populations, the total residential
+	 * population is the sum of the wealth groups.
+	 */
+	void SetResidentialPopulation(int32_t lowWealth, int32_t mediumWealth, int32_t highWealth);
+
+	/**
+	 * @brief Sets the total residential population without changing the wealth group populations.
+	 */
+	void SetTotalResidentialPopulation(int32_t value);
+
+private:
+	uint32_t refCount;
+	int32_t x;
+	int32_t z;
+	bool established;
+	int32_t residentialPopulation;
+	std::unordered_map<uint32_t, int32_t> populations;
+};
@@ -0,0 +1,344 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessResidentialSimulator.h"
+
+HeadlessResidentialSimulator::HeadlessResidentialSimulator()
+	: refCount(0),
+	  population(0),
+	  populationGrid()
+{
+}
+
+bool HeadlessResidentialSimulator::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t HeadlessResidentialSimulator::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t HeadlessResidentialSimulator::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool HeadlessResidentialSimulator::Init()
+{
+	return true;
+}
+
+bool HeadlessResidentialSimulator::Shutdown()
+{
+	return true;
+}
+
+intptr_t HeadlessResidentialSimulator::GetProximityMap(uint8_t cWealthType)
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::SchoolIsOnStrike()
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::HealthIsOnStrike()
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::EndSchoolStrike()
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::EndHealthStrike()
+{
+	return {};
+}
+
+float HeadlessResidentialSimulator::ChanceOfSchoolStrike()
+{
+	return {};
+}
+
+float HeadlessResidentialSimulator::ChanceOfHealthStrike()
+{
+	return {};
+}
+
+float HeadlessResidentialSimulator::GetSchoolSystemRating()
+{
+	return {};
+}
+
+float HeadlessResidentialSimulator::GetHealthSystemRating()
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetSchoolSystemTotals(std::list<int32_t> const& sData)
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetHospitalSystemTotals(std::list<int32_t> const& sData)
+{
+	return {};
+}
+
+int32_t HeadlessResidentialSimulator::GetPopulation()
+{
+	return population;
+}
+
+int32_t HeadlessResidentialSimulator::GetTotalCityEducationUpkeepCost()
+{
+	return {};
+}
+
+int32_t HeadlessResidentialSimulator::GetTotalCityHealthUpkeepCost()
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::SetOccupantFundingPercentages(cISC4Occupant* pOccupant, SC4Percentage const& sSchoolFunding, SC4Percentage const& sHealthFunding, bool bUnknown)
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetOccupantFundingPercentages(cISC4Occupant* pOccupant, SC4Percentage& sSchoolFunding, SC4Percentage& sHealthFunding, bool bUnknown)
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetAverageEQGrid(cISC4SimGrid<float>*& pGrid, float* fMin, float* fMax)
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetAverageHQGrid(cISC4SimGrid<float>*& pGrid, float* fMin, float* fMax)
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetEQGrids(cISC4SimGrid<float>*& pGrid, cISC4SimGrid<float>* pUnknown1, cISC4SimGrid<float>* pUnknown2)
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetHQGrids(cISC4SimGrid<float>*& pGrid, cISC4SimGrid<float>* pUnknown1, cISC4SimGrid<float>* pUnknown2)
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetPopulationGrids(cISC4SimGrid<uint16_t>*& pGrid, cISC4SimGrid<uint16_t>* pUnknown1, cISC4SimGrid<uint16_t>* pUnknown2)
+{
+	pGrid = &populationGrid;
+	return true;
+}
+
+bool HeadlessResidentialSimulator::GetSchoolQueryData(cISC4Occupant* pOccupant, intptr_t pQueryData)
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetHospitalQueryData(cISC4Occupant* pOccupant, intptr_t pQueryData)
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::EstimateCurrentOccupantCapacity(cISC4Occupant* pOccupant, uint32_t& dwUnknown1, uint32_t& dwUnknown2)
+{
+	return {};
+}
+
+int32_t HeadlessResidentialSimulator::GetCellLifeExpectancy(uint32_t dwCellX, uint32_t dwCellZ)
+{
+	return {};
+}
+
+float HeadlessResidentialSimulator::GetCellWorkforcePercent(uint32_t dwCellX, uint32_t dwCellZ)
+{
+	return {};
+}
+
+float HeadlessResidentialSimulator::GetGlobalWorkforcePercent()
+{
+	return {};
+}
+
+float HeadlessResidentialSimulator::GetGlobalEQ()
+{
+	return {};
+}
+
+float HeadlessResidentialSimulator::GetGlobalHQ()
+{
+	return {};
+}
+
+float HeadlessResidentialSimulator::GetGlobalLE()
+{
+	return {};
+}
+
+float HeadlessResidentialSimulator::GetCellEQ(uint32_t dwCellX, uint32_t dwCellZ)
+{
+	return {};
+}
+
+float HeadlessResidentialSimulator::GetCellHQ(uint32_t dwCellX, uint32_t dwCellZ)
+{
+	return {};
+}
+
+float HeadlessResidentialSimulator::GetCellEQByWealth(uint32_t dwCellX, uint32_t dwCellZ, uint8_t cWealthType)
+{
+	return {};
+}
+
+float HeadlessResidentialSimulator::GetCellHQByWealth(uint32_t dwCellX, uint32_t dwCellZ, uint8_t cWealthType)
+{
+	return {};
+}
+
+int32_t HeadlessResidentialSimulator::GetSchoolAverageGradeMap()
+{
+	return {};
+}
+
+int32_t HeadlessResidentialSimulator::GetHospitalAverageGradeMap()
+{
+	return {};
+}
+
+int32_t HeadlessResidentialSimulator::GetAverageAgeMap()
+{
+	return {};
+}
+
+int32_t HeadlessResidentialSimulator::GetAverageNewAgeByWealth(uint8_t cWealthType)
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetEQMinAndMaxCellCoords(uint32_t& dwMinCellX, uint32_t& dwMinCellZ, uint32_t& dwMaxCellX, uint32_t& dwMaxCellZ, float& fMin, float& fMax)
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetHQMinAndMaxCellCoords(uint32_t& dwMinCellX, uint32_t& dwMinCellZ, uint32_t& dwMaxCellX, uint32_t& dwMaxCellZ, float& fMin, float& fMax)
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetOccupantCoverage(cISC4Occupant* pOccupant, SC4Percentage const& sEffectiveness, float& fRangeX, float& fRangeZ)
+{
+	return {};
+}
+
+int32_t HeadlessResidentialSimulator::GetSchoolBuildingCount()
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetSchoolBuildings(std::list<cISC4Occupant*>& sBuildings, eastl::vector<uint32_t>& sUnknown)
+{
+	return {};
+}
+
+int32_t HeadlessResidentialSimulator::GetHospitalBuildingCount()
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetHospitalBuildings(std::list<cISC4Occupant*>& sBuildings, eastl::vector<uint32_t>& sUnknown)
+{
+	return {};
+}
+
+int32_t HeadlessResidentialSimulator::GetMaxEQ()
+{
+	return {};
+}
+
+int32_t HeadlessResidentialSimulator::GetMaxHQ()
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetGlobalAutoBudgetForSchools()
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::SetGlobalAutoBudgetForSchools(bool bEnable)
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetGlobalAutoBudgetForHospitals()
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::SetGlobalAutoBudgetForHospitals(bool bEnable)
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::GetAutoBudget()
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::SetAutoBudget(bool bEnable)
+{
+	return {};
+}
+
+bool HeadlessResidentialSimulator::EstimateIdealFunding(cISC4Occupant* pOccupant, SC4Percentage& sFunding)
+{
+	return {};
+}
+
+void HeadlessResidentialSimulator::ToggleTractTracking(int32_t nUnknown1, int32_t nUnknown2)
+{
+}
+
+void HeadlessResidentialSimulator::SetPopulation(int32_t value)
+{
+	population = value;
+}
+
+HeadlessPopulationGrid& HeadlessResidentialSimulator::GetPopulationGrid()
+{
+	return populationGrid;
+}
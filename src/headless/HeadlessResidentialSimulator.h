@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4ResidentialSimulator.h"
+#include "HeadlessPopulationGrid.h"
+
+/**
+ * @brief An in-memory residential simulator that only tracks the city population and population grid.
+ */
+class HeadlessResidentialSimulator final : public cISC4ResidentialSimulator
+{
+public:
+	HeadlessResidentialSimulator();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	// cISC4ResidentialSimulator
+
+	bool Init() override;
+	bool Shutdown() override;
+	intptr_t GetProximityMap(uint8_t cWealthType) override;
+	bool SchoolIsOnStrike() override;
+	bool HealthIsOnStrike() override;
+	bool EndSchoolStrike() override;
+	bool EndHealthStrike() override;
+	float ChanceOfSchoolStrike() override;
+	float ChanceOfHealthStrike() override;
+	float GetSchoolSystemRating() override;
+	float GetHealthSystemRating() override;
+	bool GetSchoolSystemTotals(std::list<int32_t> const& sData) override;
+	bool GetHospitalSystemTotals(std::list<int32_t> const& sData) override;
+	int32_t GetPopulation() override;
+	int32_t GetTotalCityEducationUpkeepCost() override;
+	int32_t GetTotalCityHealthUpkeepCost() override;
+	bool SetOccupantFundingPercentages(cISC4Occupant* pOccupant, SC4Percentage const& sSchoolFunding, SC4Percentage const& sHealthFunding, bool bUnknown) override;
+	bool GetOccupantFundingPercentages(cISC4Occupant* pOccupant, SC4Percentage& sSchoolFunding, SC4Percentage& sHealthFunding, bool bUnknown) override;
+	bool GetAverageEQGrid(cISC4SimGrid<float>*& pGrid, float* fMin, float* fMax) override;
+	bool GetAverageHQGrid(cISC4SimGrid<float>*& pGrid, float* fMin, float* fMax) override;
+	bool GetEQGrids(cISC4SimGrid<float>*& pGrid, cISC4SimGrid<float>* pUnknown1, cISC4SimGrid<float>* pUnknown2) override;
+	bool GetHQGrids(cISC4SimGrid<float>*& pGrid, cISC4SimGrid<float>* pUnknown1, cISC4SimGrid<float>* pUnknown2) override;
+	bool GetPopulationGrids(cISC4SimGrid<uint16_t>*& pGrid, cISC4SimGrid<uint16_t>* pUnknown1, cISC4SimGrid<uint16_t>* pUnknown2) override;
+	bool GetSchoolQueryData(cISC4Occupant* pOccupant, intptr_t pQueryData) override;
+	bool GetHospitalQueryData(cISC4Occupant* pOccupant, intptr_t pQueryData) override;
+	bool EstimateCurrentOccupantCapacity(cISC4Occupant* pOccupant, uint32_t& dwUnknown1, uint32_t& dwUnknown2) override;
+	int32_t GetCellLifeExpectancy(uint32_t dwCellX, uint32_t dwCellZ) override;
+	float GetCellWorkforcePercent(uint32_t dwCellX, uint32_t dwCellZ) override;
+	float GetGlobalWorkforcePercent() override;
+	float GetGlobalEQ() override;
+	float GetGlobalHQ() override;
+	float GetGlobalLE() override;
+	float GetCellEQ(uint32_t dwCellX, uint32_t dwCellZ) override;
+	float GetCellHQ(uint32_t dwCellX, uint32_t dwCellZ) override;
+	float GetCellEQByWealth(uint32_t dwCellX, uint32_t dwCellZ, uint8_t cWealthType) override;
+	float GetCellHQByWealth(uint32_t dwCellX, uint32_t dwCellZ, uint8_t cWealthType) override;
+	int32_t GetSchoolAverageGradeMap() override;
+	int32_t GetHospitalAverageGradeMap() override;
+	int32_t GetAverageAgeMap() override;
+	int32_t GetAverageNewAgeByWealth(uint8_t cWealthType) override;
+	bool GetEQMinAndMaxCellCoords(uint32_t& dwMinCellX, uint32_t& dwMinCellZ, uint32_t& dwMaxCellX, uint32_t& dwMaxCellZ, float& fMin, float& fMax) override;
+	bool GetHQMinAndMaxCellCoords(uint32_t& dwMinCellX, uint32_t& dwMinCellZ, uint32_t& dwMaxCellX, uint32_t& dwMaxCellZ, float& fMin, float& fMax) override;
+	bool GetOccupantCoverage(cISC4Occupant* pOccupant, SC4Percentage const& sEffectiveness, float& fRangeX, float& fRangeZ) override;
+	int32_t GetSchoolBuildingCount() override;
+	bool GetSchoolBuildings(std::list<cISC4Occupant*>& sBuildings, eastl::vector<uint32_t>& sUnknown) override;
+	int32_t GetHospitalBuildingCount() override;
+	bool GetHospitalBuildings(std::list<cISC4Occupant*>& sBuildings, eastl::vector<uint32_t>& sUnknown) override;
+	int32_t GetMaxEQ() override;
+	int32_t GetMaxHQ() override;
+	bool GetGlobalAutoBudgetForSchools() override;
+	bool SetGlobalAutoBudgetForSchools(bool bEnable) override;
+	bool GetGlobalAutoBudgetForHospitals() override;
+	bool SetGlobalAutoBudgetForHospitals(bool bEnable) override;
+	bool GetAutoBudget() override;
+	bool SetAutoBudget(bool bEnable) override;
+	bool EstimateIdealFunding(cISC4Occupant* pOccupant, SC4Percentage& sFunding) override;
+	void ToggleTractTracking(int32_t nUnknown1, int32_t nUnknown2) override;
+
+	void SetPopulation(int32_t value);
+	HeadlessPopulationGrid& GetPopulationGrid();
+
+private:
+	uint32_t refCount;
+	int32_t population;
+	HeadlessPopulationGrid populationGrid;
+};
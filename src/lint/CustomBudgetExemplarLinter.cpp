@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "CustomBudgetExemplarLinter.h"
+#include "CustomBudgetExemplarReader.h"
+#include "TransactionAlgorithmFactory.h"
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+
+namespace
+{
+	class ProblemListErrorReporter final : public ICustomBudgetExemplarErrorReporter
+	{
+	public:
+		ProblemListErrorReporter(std::vector<std::string>& problems) : problems(problems)
+		{
+		}
+
+		void ReportError(const char* message) override
+		{
+			problems.emplace_back(message);
+		}
+
+	private:
+		std::vector<std::string>& problems;
+	};
+
+	// TransactionAlgorithmFactory shares the algorithm instances, formula programs and
+	// tiered tables through caches that are not thread-safe.
+	std::mutex transactionAlgorithmFactoryMutex;
+
+	void CheckLineItemAlgorithm(
+		const cISCPropertyHolder* pPropertyHolder,
+		const CustomBudgetDepartmentInfo& item,
+		std::vector<std::string>& problems)
+	{
+		const TransactionAlgorithmType type = CustomBudgetExemplarReader::GetLineItemAlgorithmType(
+			pPropertyHolder,
+			item.lineNumber);
+
+		if (type > TransactionAlgorithmType::ResidentialCatchment)
+		{
+			// The plugin does not reject the unknown algorithm types, the line item uses the Fixed cost.
+			char buffer[256]{};
+			std::snprintf(
+				buffer,
+				sizeof(buffer),
+				"Unknown Custom Budget Line Item Algorithm %u for line item 0x%08X, the line item uses the Fixed algorithm.",
+				static_cast<uint32_t>(type),
+				item.lineNumber);
+
+			problems.emplace_back(buffer);
+		}
+
+		std::scoped_lock lock(transactionAlgorithmFactoryMutex);
+
+		try
+		{
+			TransactionAlgorithmFactory::Create(pPropertyHolder, type, item.lineNumber);
+			TransactionAlgorithmFactory::CreateConditions(pPropertyHolder, item.lineNumber);
+		}
+		catch (const CreateTransactionAlgorithmException& e)
+		{
+			problems.emplace_back(e.what());
+		}
+	}
+}
+
+bool CustomBudgetExemplarLinter::Check(
+	const cISCPropertyHolder* pPropertyHolder,
+	const DepartmentDefinitionTable* pDefinitions,
+	std::vector<std::string>& problems)
+{
+	if (!CustomBudgetExemplarReader::HasCustomBudgetDepartmentItems(pPropertyHolder))
+	{
+		return false;
+	}
+
+	ProblemListErrorReporter errorReporter(problems);
+
+	const std::vector<CustomBudgetDepartmentInfo> items = CustomBudgetExemplarReader::ReadLineItems(
+		pPropertyHolder,
+		pDefinitions,
+		errorReporter);
+
+	// The budget group is checked once for each department, it is shared by the department's line items.
+	std::vector<uint32_t> checkedDepartments;
+
+	for (const CustomBudgetDepartmentInfo& item : items)
+	{
+		if (std::find(checkedDepartments.begin(), checkedDepartments.end(), item.department) == checkedDepartments.end())
+		{
+			checkedDepartments.push_back(item.department);
+
+			if (!CustomBudgetExemplarReader::IsValidBudgetGroup(item.budgetGroup))
+			{
+				char buffer[256]{};
+				std::snprintf(
+					buffer,
+					sizeof(buffer),
+					"Invalid budget group 0x%08X for department id 0x%08X.",
+					item.budgetGroup,
+					item.department);
+
+				problems.emplace_back(buffer);
+			}
+		}
+
+		CheckLineItemAlgorithm(pPropertyHolder, item, problems);
+	}
+
+	return true;
+}
+
+void CustomBudgetExemplarLinter::ReadDepartmentDefinitions(
+	const cISCPropertyHolder* pPropertyHolder,
+	std::vector<DepartmentDefinition>& definitions,
+	std::vector<std::string>& problems)
+{
+	ProblemListErrorReporter errorReporter(problems);
+
+	definitions = CustomBudgetExemplarReader::ReadDepartmentDefinitions(pPropertyHolder, errorReporter);
+}
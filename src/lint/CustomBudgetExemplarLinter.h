@@ -0,0 +1,52 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "DepartmentDefinitionTable.h"
+#include <string>
+#include <vector>
+
+class cISCPropertyHolder;
+
+/**
+ * @brief Checks the custom budget department properties of a building exemplar.
+ *
+ * The exemplar is validated with the same code that the plugin uses when a building
+ * is placed: CustomBudgetExemplarReader reads the line items and TransactionAlgorithmFactory
+ * creates each line item's algorithm and conditions.
+ */
+namespace CustomBudgetExemplarLinter
+{
+	/**
+	 * @brief Checks an exemplar, this can be called from multiple threads.
+	 * @param pPropertyHolder The exemplar.
+	 * @param pDefinitions The shared department definitions of the plugin folder. Can be null.
+	 * @param problems Receives the problems that were found in the exemplar.
+	 * @return True if the exemplar has custom budget department line items; otherwise, false.
+	 */
+	bool Check(
+		const cISCPropertyHolder* pPropertyHolder,
+		const DepartmentDefinitionTable* pDefinitions,
+		std::vector<std::string>& problems);
+
+	/**
+	 * @brief Reads a shared department definition exemplar, this can be called from multiple threads.
+	 * @param pPropertyHolder The definition exemplar.
+	 * @param definitions Receives the valid department definitions.
+	 * @param problems Receives the problems that were found in the exemplar.
+	 */
+	void ReadDepartmentDefinitions(
+		const cISCPropertyHolder* pPropertyHolder,
+		std::vector<DepartmentDefinition>& definitions,
+		std::vector<std::string>& problems);
+}
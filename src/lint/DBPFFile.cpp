@@ -0,0 +1,276 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "DBPFFile.h"
+#include "QFSDecompressor.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <optional>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <tuple>
+#include <unistd.h>
+
+namespace
+{
+	constexpr size_t HeaderSize = 96;
+	constexpr uint32_t DBPFSignature = 0x46504244; // DBPF
+
+	constexpr size_t IndexMajorVersionOffset = 32;
+	constexpr size_t IndexEntryCountOffset = 36;
+	constexpr size_t IndexOffsetOffset = 40;
+	constexpr size_t IndexSizeOffset = 44;
+	constexpr size_t IndexMinorVersionOffset = 60;
+
+	// The directory entry lists the compressed entries and their uncompressed size.
+	constexpr uint32_t DirectoryType = 0xE86B1EEF;
+
+	uint32_t ReadUint32(const uint8_t* pData)
+	{
+		uint32_t value = 0;
+		std::memcpy(&value, pData, sizeof(value));
+
+		return value;
+	}
+
+	std::tuple<uint32_t, uint32_t, uint32_t> GetTGI(const DBPFEntry& entry)
+	{
+		return std::make_tuple(entry.type, entry.group, entry.instance);
+	}
+}
+
+DBPFFile::DBPFFile()
+	: pMapping(nullptr),
+	  mappingSize(0),
+	  entries()
+{
+}
+
+DBPFFile::~DBPFFile()
+{
+	Close();
+}
+
+bool DBPFFile::Open(const std::filesystem::path& path, std::string& errorMessage)
+{
+	Close();
+
+	const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+	if (fd == -1)
+	{
+		errorMessage = "Failed to open the file.";
+		return false;
+	}
+
+	bool result = false;
+
+	struct stat fileStatus{};
+
+	if (fstat(fd, &fileStatus) == 0)
+	{
+		if (static_cast<size_t>(fileStatus.st_size) >= HeaderSize)
+		{
+			void* const pView = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+			if (pView != MAP_FAILED)
+			{
+				pMapping = static_cast<const uint8_t*>(pView);
+				mappingSize = static_cast<size_t>(fileStatus.st_size);
+
+				// Most of a plugin file is models and textures that are never read, the read-ahead
+				// would load the pages around the small exemplar entries that are read.
+				madvise(pView, mappingSize, MADV_RANDOM);
+
+				result = ReadIndex(errorMessage);
+			}
+			else
+			{
+				errorMessage = "Failed to map the file.";
+			}
+		}
+		else
+		{
+			errorMessage = "The file is too small to be a DBPF file.";
+		}
+	}
+	else
+	{
+		errorMessage = "Failed to get the file size.";
+	}
+
+	// The mapping stays valid after the file descriptor is closed.
+	close(fd);
+
+	if (!result)
+	{
+		Close();
+	}
+
+	return result;
+}
+
+void DBPFFile::Close()
+{
+	if (pMapping)
+	{
+		munmap(const_cast<uint8_t*>(pMapping), mappingSize);
+		pMapping = nullptr;
+		mappingSize = 0;
+	}
+
+	entries.clear();
+}
+
+bool DBPFFile::HasSignature(const std::filesystem::path& path)
+{
+	bool result = false;
+
+	const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+	if (fd != -1)
+	{
+		uint32_t signature = 0;
+
+		if (read(fd, &signature, sizeof(signature)) == sizeof(signature))
+		{
+			result = signature == DBPFSignature;
+		}
+
+		close(fd);
+	}
+
+	return result;
+}
+
+const std::vector<DBPFEntry>& DBPFFile::GetEntries() const
+{
+	return entries;
+}
+
+bool DBPFFile::GetEntryData(const DBPFEntry& entry, std::vector<uint8_t>& buffer, const uint8_t*& pData, size_t& size) const
+{
+	const uint8_t* const pEntryData = pMapping + entry.offset;
+
+	if (entry.isCompressed)
+	{
+		if (!QFSDecompressor::Decompress(pEntryData, entry.size, buffer))
+		{
+			return false;
+		}
+
+		pData = buffer.data();
+		size = buffer.size();
+	}
+	else
+	{
+		pData = pEntryData;
+		size = entry.size;
+	}
+
+	return true;
+}
+
+bool DBPFFile::ReadIndex(std::string& errorMessage)
+{
+	if (ReadUint32(pMapping) != DBPFSignature)
+	{
+		errorMessage = "The file does not have a DBPF signature.";
+		return false;
+	}
+
+	const uint32_t indexMajorVersion = ReadUint32(pMapping + IndexMajorVersionOffset);
+	const uint32_t indexMinorVersion = ReadUint32(pMapping + IndexMinorVersionOffset);
+	const size_t indexEntryCount = ReadUint32(pMapping + IndexEntryCountOffset);
+	const size_t indexOffset = ReadUint32(pMapping + IndexOffsetOffset);
+	const size_t indexSize = ReadUint32(pMapping + IndexSizeOffset);
+
+	if (indexMajorVersion != 7)
+	{
+		errorMessage = "Unsupported DBPF index version.";
+		return false;
+	}
+
+	// Version 7.1 adds a second instance id to the index and directory entries.
+	const bool hasInstanceHigh = indexMinorVersion == 1;
+	const size_t indexEntrySize = hasInstanceHigh ? 24 : 20;
+
+	if (indexOffset > mappingSize
+		|| indexSize > mappingSize - indexOffset
+		|| indexEntryCount > indexSize / indexEntrySize)
+	{
+		errorMessage = "The DBPF index is truncated.";
+		return false;
+	}
+
+	entries.reserve(indexEntryCount);
+
+	std::optional<DBPFEntry> directory;
+
+	for (size_t i = 0; i < indexEntryCount; i++)
+	{
+		const uint8_t* const pIndexEntry = pMapping + indexOffset + (i * indexEntrySize);
+		const size_t fieldOffset = hasInstanceHigh ? 16 : 12;
+
+		DBPFEntry entry{};
+		entry.type = ReadUint32(pIndexEntry);
+		entry.group = ReadUint32(pIndexEntry + 4);
+		entry.instance = ReadUint32(pIndexEntry + 8);
+		entry.offset = ReadUint32(pIndexEntry + fieldOffset);
+		entry.size = ReadUint32(pIndexEntry + fieldOffset + 4);
+		entry.isCompressed = false;
+
+		if (entry.offset > mappingSize || entry.size > mappingSize - entry.offset)
+		{
+			errorMessage = "A DBPF index entry is outside of the file.";
+			return false;
+		}
+
+		if (entry.type == DirectoryType)
+		{
+			directory = entry;
+		}
+
+		entries.push_back(entry);
+	}
+
+	if (directory)
+	{
+		const size_t directoryEntrySize = hasInstanceHigh ? 20 : 16;
+		const size_t directoryEntryCount = directory->size / directoryEntrySize;
+		const uint8_t* const pDirectoryData = pMapping + directory->offset;
+
+		std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> compressedEntries;
+		compressedEntries.reserve(directoryEntryCount);
+
+		for (size_t i = 0; i < directoryEntryCount; i++)
+		{
+			const uint8_t* const pDirectoryEntry = pDirectoryData + (i * directoryEntrySize);
+
+			compressedEntries.emplace_back(
+				ReadUint32(pDirectoryEntry),
+				ReadUint32(pDirectoryEntry + 4),
+				ReadUint32(pDirectoryEntry + 8));
+		}
+
+		std::sort(compressedEntries.begin(), compressedEntries.end());
+
+		for (DBPFEntry& entry : entries)
+		{
+			entry.isCompressed = std::binary_search(compressedEntries.begin(), compressedEntries.end(), GetTGI(entry));
+		}
+	}
+
+	return true;
+}
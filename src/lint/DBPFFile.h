@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+struct DBPFEntry
+{
+	uint32_t type;
+	uint32_t group;
+	uint32_t instance;
+	uint32_t offset;
+	uint32_t size;
+	bool isCompressed;
+};
+
+/**
+ * @brief A read-only DBPF file.
+ *
+ * The file is memory mapped, so only the pages of the header, the index and
+ * the entries that are read are loaded from the disk.
+ */
+class DBPFFile
+{
+public:
+	DBPFFile();
+	~DBPFFile();
+
+	DBPFFile(const DBPFFile&) = delete;
+	DBPFFile& operator=(const DBPFFile&) = delete;
+
+	/**
+	 * @brief Maps the file and reads the index.
+	 * @param path The file path.
+	 * @param errorMessage Receives the error message if the file is not a valid DBPF file.
+	 * @return True on success; otherwise, false.
+	 */
+	bool Open(const std::filesystem::path& path, std::string& errorMessage);
+	void Close();
+
+	/**
+	 * @brief Checks if the file starts with the DBPF signature, without reading the index.
+	 */
+	static bool HasSignature(const std::filesystem::path& path);
+
+	const std::vector<DBPFEntry>& GetEntries() const;
+
+	/**
+	 * @brief Gets the uncompressed data of an entry.
+	 * @param entry The entry.
+	 * @param buffer The buffer that receives the data of a compressed entry.
+	 * @param pData Receives a pointer to the data, either in the mapped file or in the buffer.
+	 * @param size Receives the data size.
+	 * @return True on success, or false if the entry is truncated or corrupt.
+	 */
+	bool GetEntryData(const DBPFEntry& entry, std::vector<uint8_t>& buffer, const uint8_t*& pData, size_t& size) const;
+
+private:
+	bool ReadIndex(std::string& errorMessage);
+
+	const uint8_t* pMapping;
+	size_t mappingSize;
+	std::vector<DBPFEntry> entries;
+};
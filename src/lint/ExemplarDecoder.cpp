@@ -0,0 +1,309 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "ExemplarDecoder.h"
+#include "cRZBaseVariant.h"
+#include "HeadlessPropertyHolder.h"
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+namespace
+{
+	constexpr size_t SignatureLength = 8;
+	// The signature is followed by the parent cohort TGI and the property count.
+	constexpr size_t HeaderSize = SignatureLength + 16;
+	constexpr uint32_t MaxValueCount = 0x100000;
+
+	constexpr uint16_t ValueTypeUint8 = 0x100;
+	constexpr uint16_t ValueTypeUint16 = 0x200;
+	constexpr uint16_t ValueTypeUint32 = 0x300;
+	constexpr uint16_t ValueTypeSint32 = 0x700;
+	constexpr uint16_t ValueTypeSint64 = 0x800;
+	constexpr uint16_t ValueTypeFloat32 = 0x900;
+	constexpr uint16_t ValueTypeBool = 0xB00;
+	constexpr uint16_t ValueTypeString = 0xC00;
+
+	constexpr uint16_t KeyTypeSingleValue = 0x00;
+	constexpr uint16_t KeyTypeArray = 0x80;
+
+	size_t GetValueSize(uint16_t valueType)
+	{
+		switch (valueType)
+		{
+		case ValueTypeUint8:
+		case ValueTypeBool:
+		case ValueTypeString:
+			return 1;
+		case ValueTypeUint16:
+			return 2;
+		case ValueTypeUint32:
+		case ValueTypeSint32:
+		case ValueTypeFloat32:
+			return 4;
+		case ValueTypeSint64:
+			return 8;
+		default:
+			return 0;
+		}
+	}
+
+	template <typename T>
+	T ReadValue(const uint8_t* pData)
+	{
+		T value{};
+		std::memcpy(&value, pData, sizeof(T));
+
+		return value;
+	}
+
+	template <typename T>
+	std::vector<T> ReadValues(const uint8_t* pData, uint32_t count)
+	{
+		std::vector<T> values(count);
+		std::memcpy(values.data(), pData, count * sizeof(T));
+
+		return values;
+	}
+}
+
+ExemplarDecoder::ExemplarDecoder()
+	: properties()
+{
+}
+
+ExemplarFormat ExemplarDecoder::Parse(const uint8_t* pData, size_t size, std::string& errorMessage)
+{
+	properties.clear();
+
+	if (size < SignatureLength)
+	{
+		errorMessage = "The exemplar is truncated.";
+		return ExemplarFormat::Invalid;
+	}
+
+	const std::string_view signature(reinterpret_cast<const char*>(pData), SignatureLength);
+
+	// The exemplars use EQZ and the cohorts use CQZ, followed by B for binary or T for text.
+	if (signature == "EQZT1###" || signature == "CQZT1###")
+	{
+		return ExemplarFormat::Text;
+	}
+	else if (signature != "EQZB1###" && signature != "CQZB1###")
+	{
+		errorMessage = "The exemplar does not have a valid signature.";
+		return ExemplarFormat::Invalid;
+	}
+
+	if (size < HeaderSize)
+	{
+		errorMessage = "The exemplar is truncated.";
+		return ExemplarFormat::Invalid;
+	}
+
+	const uint32_t propertyCount = ReadValue<uint32_t>(pData + HeaderSize - 4);
+	size_t position = HeaderSize;
+
+	for (uint32_t i = 0; i < propertyCount; i++)
+	{
+		// The property id, value type, key type and an unused byte.
+		if (size - position < 9)
+		{
+			errorMessage = "The exemplar is truncated.";
+			return ExemplarFormat::Invalid;
+		}
+
+		Property property{};
+		property.id = ReadValue<uint32_t>(pData + position);
+		property.valueType = ReadValue<uint16_t>(pData + position + 4);
+
+		const uint16_t keyType = ReadValue<uint16_t>(pData + position + 6);
+		position += 9;
+
+		const size_t valueSize = GetValueSize(property.valueType);
+
+		if (valueSize == 0)
+		{
+			char buffer[128]{};
+			std::snprintf(
+				buffer,
+				sizeof(buffer),
+				"Property 0x%08X has an unknown value type: 0x%04X.",
+				property.id,
+				property.valueType);
+
+			errorMessage = buffer;
+			return ExemplarFormat::Invalid;
+		}
+
+		if (keyType == KeyTypeArray)
+		{
+			if (size - position < 4)
+			{
+				errorMessage = "The exemplar is truncated.";
+				return ExemplarFormat::Invalid;
+			}
+
+			property.isArray = true;
+			property.count = ReadValue<uint32_t>(pData + position);
+			position += 4;
+
+			if (property.count > MaxValueCount)
+			{
+				errorMessage = "The exemplar has a property with too many values.";
+				return ExemplarFormat::Invalid;
+			}
+		}
+		else if (keyType == KeyTypeSingleValue)
+		{
+			property.isArray = false;
+			property.count = 1;
+		}
+		else
+		{
+			errorMessage = "The exemplar has a property with an unknown key type.";
+			return ExemplarFormat::Invalid;
+		}
+
+		const size_t valuesSize = valueSize * property.count;
+
+		if (size - position < valuesSize)
+		{
+			errorMessage = "The exemplar is truncated.";
+			return ExemplarFormat::Invalid;
+		}
+
+		property.pValues = pData + position;
+		position += valuesSize;
+
+		properties.push_back(property);
+	}
+
+	return ExemplarFormat::Binary;
+}
+
+bool ExemplarDecoder::HasProperty(uint32_t id) const
+{
+	return FindProperty(id) != nullptr;
+}
+
+bool ExemplarDecoder::GetStringProperty(uint32_t id, std::string& value) const
+{
+	bool result = false;
+
+	const Property* pProperty = FindProperty(id);
+
+	if (pProperty && pProperty->valueType == ValueTypeString)
+	{
+		value.assign(reinterpret_cast<const char*>(pProperty->pValues), pProperty->count);
+		result = true;
+	}
+
+	return result;
+}
+
+void ExemplarDecoder::CopyProperties(HeadlessPropertyHolder& destination) const
+{
+	for (const Property& property : properties)
+	{
+		cRZBaseVariant variant;
+
+		// The string properties are always stored as a char array.
+		if (property.isArray || property.valueType == ValueTypeString)
+		{
+			switch (property.valueType)
+			{
+			case ValueTypeUint8:
+				variant.RefUint8(ReadValues<uint8_t>(property.pValues, property.count).data(), property.count);
+				break;
+			case ValueTypeUint16:
+				variant.RefUint16(ReadValues<uint16_t>(property.pValues, property.count).data(), property.count);
+				break;
+			case ValueTypeUint32:
+				variant.RefUint32(ReadValues<uint32_t>(property.pValues, property.count).data(), property.count);
+				break;
+			case ValueTypeSint32:
+				variant.RefSint32(ReadValues<int32_t>(property.pValues, property.count).data(), property.count);
+				break;
+			case ValueTypeSint64:
+				variant.RefSint64(ReadValues<int64_t>(property.pValues, property.count).data(), property.count);
+				break;
+			case ValueTypeFloat32:
+				variant.RefFloat32(ReadValues<float>(property.pValues, property.count).data(), property.count);
+				break;
+			case ValueTypeBool:
+			{
+				std::vector<uint8_t> bytes = ReadValues<uint8_t>(property.pValues, property.count);
+				std::unique_ptr<bool[]> values = std::make_unique<bool[]>(property.count);
+
+				for (uint32_t i = 0; i < property.count; i++)
+				{
+					values[i] = bytes[i] != 0;
+				}
+
+				variant.RefBool(values.get(), property.count);
+				break;
+			}
+			case ValueTypeString:
+				variant.RefChar(ReadValues<char>(property.pValues, property.count).data(), property.count);
+				break;
+			}
+		}
+		else
+		{
+			switch (property.valueType)
+			{
+			case ValueTypeUint8:
+				variant.SetValUint8(ReadValue<uint8_t>(property.pValues));
+				break;
+			case ValueTypeUint16:
+				variant.SetValUint16(ReadValue<uint16_t>(property.pValues));
+				break;
+			case ValueTypeUint32:
+				variant.SetValUint32(ReadValue<uint32_t>(property.pValues));
+				break;
+			case ValueTypeSint32:
+				variant.SetValSint32(ReadValue<int32_t>(property.pValues));
+				break;
+			case ValueTypeSint64:
+				variant.SetValSint64(ReadValue<int64_t>(property.pValues));
+				break;
+			case ValueTypeFloat32:
+				variant.SetValFloat32(ReadValue<float>(property.pValues));
+				break;
+			case ValueTypeBool:
+				variant.SetValBool(ReadValue<uint8_t>(property.pValues) != 0);
+				break;
+			}
+		}
+
+		destination.AddProperty(property.id, &variant, false);
+	}
+}
+
+const ExemplarDecoder::Property* ExemplarDecoder::FindProperty(uint32_t id) const
+{
+	const Property* result = nullptr;
+
+	for (const Property& property : properties)
+	{
+		if (property.id == id)
+		{
+			result = &property;
+			break;
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class HeadlessPropertyHolder;
+
+enum class ExemplarFormat
+{
+	Invalid,
+	Binary,
+	Text
+};
+
+/**
+ * @brief Decodes the binary exemplar and cohort entries of a DBPF file.
+ *
+ * Parse only reads the property headers, the property values are copied to a property
+ * holder when the exemplar is checked. The parent cohort properties are not resolved.
+ */
+class ExemplarDecoder
+{
+public:
+	static constexpr uint32_t ExemplarType = 0x6534284A;
+
+	ExemplarDecoder();
+
+	/**
+	 * @brief Reads the property headers of an exemplar.
+	 * @param pData The uncompressed entry data, it must remain valid until the next call to Parse.
+	 * @param size The data size.
+	 * @param errorMessage Receives the error message if the exemplar is not valid.
+	 * @return The exemplar format. The text exemplar properties are not read.
+	 */
+	ExemplarFormat Parse(const uint8_t* pData, size_t size, std::string& errorMessage);
+
+	bool HasProperty(uint32_t id) const;
+	bool GetStringProperty(uint32_t id, std::string& value) const;
+
+	/**
+	 * @brief Copies the exemplar properties to a property holder, using the variant types that the game uses.
+	 */
+	void CopyProperties(HeadlessPropertyHolder& destination) const;
+
+private:
+	struct Property
+	{
+		uint32_t id;
+		uint16_t valueType;
+		bool isArray;
+		uint32_t count;
+		const uint8_t* pValues;
+	};
+
+	const Property* FindProperty(uint32_t id) const;
+
+	std::vector<Property> properties;
+};
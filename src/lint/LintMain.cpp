@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "PluginScanner.h"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: CustomBudgetDepartmentsLint <plugin file or folder>... [options]\n"
+			"  --threads <n>   The number of worker threads, default is 4 times the number of processors.\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<std::filesystem::path> paths;
+	// The scan mostly waits for the page faults when the files are not in the
+	// file system cache, so it uses more threads than processors.
+	uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 1U) * 4;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			threadCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (argv[i][0] != '-')
+		{
+			paths.push_back(argv[i]);
+		}
+		else
+		{
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (paths.empty() || threadCount == 0)
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+
+	const std::vector<std::filesystem::path> files = PluginScanner::FindFiles(paths);
+	const std::vector<PluginFileResult> results = PluginScanner::Scan(files, threadCount);
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	uint64_t fileCount = 0;
+	uint64_t byteCount = 0;
+	uint64_t exemplarCount = 0;
+	uint64_t textExemplarCount = 0;
+	uint64_t customBudgetExemplarCount = 0;
+	uint64_t problemCount = 0;
+
+	for (const PluginFileResult& result : results)
+	{
+		if (!result.isDBPF)
+		{
+			continue;
+		}
+
+		for (const PluginProblem& problem : result.problems)
+		{
+			if (problem.type == 0 && problem.group == 0 && problem.instance == 0)
+			{
+				std::printf("%s: %s\n", result.path.string().c_str(), problem.message.c_str());
+			}
+			else if (problem.exemplarName.empty())
+			{
+				std::printf(
+					"%s: 0x%08X-0x%08X-0x%08X: %s\n",
+					result.path.string().c_str(),
+					problem.type,
+					problem.group,
+					problem.instance,
+					problem.message.c_str());
+			}
+			else
+			{
+				std::printf(
+					"%s: 0x%08X-0x%08X-0x%08X (%s): %s\n",
+					result.path.string().c_str(),
+					problem.type,
+					problem.group,
+					problem.instance,
+					problem.exemplarName.c_str(),
+					problem.message.c_str());
+			}
+		}
+
+		fileCount++;
+		byteCount += result.byteCount;
+		exemplarCount += result.exemplarCount;
+		textExemplarCount += result.textExemplarCount;
+		customBudgetExemplarCount += result.customBudgetExemplarCount;
+		problemCount += result.problems.size();
+	}
+
+	std::printf(
+		"Scanned %" PRIu64 " DBPF files (%.1f MB) in %.3f s with %u threads: %" PRIu64 " exemplars, %" PRIu64
+		" with custom budget departments, %" PRIu64 " problems.\n",
+		fileCount,
+		static_cast<double>(byteCount) / (1024.0 * 1024.0),
+		seconds,
+		threadCount,
+		exemplarCount,
+		customBudgetExemplarCount,
+		problemCount);
+
+	if (textExemplarCount > 0)
+	{
+		std::printf("%" PRIu64 " text exemplars were not checked.\n", textExemplarCount);
+	}
+
+	return problemCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
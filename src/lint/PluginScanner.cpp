@@ -0,0 +1,374 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "PluginScanner.h"
+#include "CustomBudgetExemplarLinter.h"
+#include "DBPFFile.h"
+#include "CustomBudgetExemplarReader.h"
+#include "ExemplarDecoder.h"
+#include "HeadlessPropertyHolder.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <numeric>
+#include <thread>
+
+namespace
+{
+	constexpr uint32_t kExemplarNameProperty = 0x20;
+	constexpr uint32_t kBudgetItemPurpose = 0xEA54D285;
+
+	void AddProblem(PluginFileResult& result, const DBPFEntry& entry, std::string exemplarName, std::string message)
+	{
+		PluginProblem problem{};
+		problem.type = entry.type;
+		problem.group = entry.group;
+		problem.instance = entry.instance;
+		problem.exemplarName = std::move(exemplarName);
+		problem.message = std::move(message);
+
+		result.problems.push_back(std::move(problem));
+	}
+
+	struct ScanContext
+	{
+		DBPFFile file;
+		ExemplarDecoder decoder;
+		HeadlessPropertyHolder propertyHolder;
+		std::vector<uint8_t> buffer;
+		std::vector<std::string> problems;
+		const DepartmentDefinitionTable* pDefinitions;
+	};
+
+	bool IsDepartmentDefinitionEntry(const DBPFEntry& entry)
+	{
+		return entry.type == ExemplarDecoder::ExemplarType
+			&& entry.group == CustomBudgetExemplarReader::DepartmentDefinitionExemplarGroup;
+	}
+
+	void ReadDepartmentDefinitionEntry(
+		ScanContext& context,
+		const DBPFEntry& entry,
+		PluginFileResult& result,
+		std::vector<DepartmentDefinition>& definitions)
+	{
+		const uint8_t* pData = nullptr;
+		size_t size = 0;
+
+		if (!context.file.GetEntryData(entry, context.buffer, pData, size))
+		{
+			AddProblem(result, entry, std::string(), "The compressed entry is truncated or corrupt.");
+			return;
+		}
+
+		std::string errorMessage;
+		const ExemplarFormat format = context.decoder.Parse(pData, size, errorMessage);
+
+		if (format == ExemplarFormat::Text)
+		{
+			AddProblem(result, entry, std::string(), "The department definition text exemplar was not read, the buildings that use it may report missing department properties.");
+		}
+		else if (format == ExemplarFormat::Invalid)
+		{
+			AddProblem(result, entry, std::string(), std::move(errorMessage));
+		}
+		else
+		{
+			context.propertyHolder.RemoveAllProperties();
+			context.decoder.CopyProperties(context.propertyHolder);
+			context.problems.clear();
+
+			std::vector<DepartmentDefinition> entryDefinitions;
+			CustomBudgetExemplarLinter::ReadDepartmentDefinitions(&context.propertyHolder, entryDefinitions, context.problems);
+
+			if (!context.problems.empty())
+			{
+				std::string exemplarName;
+				context.decoder.GetStringProperty(kExemplarNameProperty, exemplarName);
+
+				for (std::string& problem : context.problems)
+				{
+					AddProblem(result, entry, exemplarName, std::move(problem));
+				}
+			}
+
+			result.departmentDefinitionCount += entryDefinitions.size();
+			definitions.insert(definitions.end(), entryDefinitions.begin(), entryDefinitions.end());
+		}
+	}
+
+	void ReadDepartmentDefinitionFile(
+		ScanContext& context,
+		PluginFileResult& result,
+		std::vector<DepartmentDefinition>& definitions)
+	{
+		if (!DBPFFile::HasSignature(result.path))
+		{
+			return;
+		}
+
+		std::string errorMessage;
+
+		// The errors for the files that cannot be opened are reported by ScanFile.
+		if (context.file.Open(result.path, errorMessage))
+		{
+			for (const DBPFEntry& entry : context.file.GetEntries())
+			{
+				if (IsDepartmentDefinitionEntry(entry))
+				{
+					ReadDepartmentDefinitionEntry(context, entry, result, definitions);
+				}
+			}
+
+			context.file.Close();
+		}
+	}
+
+	template<typename Function> void RunWorkers(
+		const std::vector<size_t>& scanOrder,
+		uint32_t threadCount,
+		const DepartmentDefinitionTable* pDefinitions,
+		Function function)
+	{
+		std::atomic<size_t> nextFile = 0;
+
+		auto worker = [&]()
+		{
+			ScanContext context;
+			context.pDefinitions = pDefinitions;
+
+			for (size_t i = nextFile.fetch_add(1); i < scanOrder.size(); i = nextFile.fetch_add(1))
+			{
+				function(context, scanOrder[i]);
+			}
+		};
+
+		std::vector<std::thread> threads;
+		threadCount = std::max(threadCount, 1U);
+		threads.reserve(threadCount);
+
+		for (uint32_t i = 0; i < threadCount; i++)
+		{
+			threads.emplace_back(worker);
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	DepartmentDefinitionTable CreateDepartmentDefinitionTable(
+		std::vector<PluginFileResult>& results,
+		const std::vector<std::vector<DepartmentDefinition>>& fileDefinitions)
+	{
+		std::vector<DepartmentDefinition> definitions;
+		std::map<uint32_t, DepartmentDefinition> firstDefinitions;
+
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			for (const DepartmentDefinition& definition : fileDefinitions[i])
+			{
+				auto item = firstDefinitions.try_emplace(definition.department, definition);
+
+				if (item.second)
+				{
+					definitions.push_back(definition);
+				}
+				else
+				{
+					const DepartmentDefinition& first = item.first->second;
+
+					if (first.budgetGroup != definition.budgetGroup
+						|| first.nameKey.groupID != definition.nameKey.groupID
+						|| first.nameKey.instanceID != definition.nameKey.instanceID)
+					{
+						char buffer[256]{};
+						std::snprintf(
+							buffer,
+							sizeof(buffer),
+							"Department 0x%08X is defined more than once with different values, the building exemplars use one of the definitions.",
+							definition.department);
+
+						PluginProblem problem{};
+						problem.message = buffer;
+
+						results[i].problems.push_back(std::move(problem));
+					}
+				}
+			}
+		}
+
+		return DepartmentDefinitionTable(std::move(definitions));
+	}
+
+	void ScanEntry(ScanContext& context, const DBPFEntry& entry, PluginFileResult& result)
+	{
+		const uint8_t* pData = nullptr;
+		size_t size = 0;
+
+		if (!context.file.GetEntryData(entry, context.buffer, pData, size))
+		{
+			AddProblem(result, entry, std::string(), "The compressed entry is truncated or corrupt.");
+			return;
+		}
+
+		result.exemplarCount++;
+
+		std::string errorMessage;
+		const ExemplarFormat format = context.decoder.Parse(pData, size, errorMessage);
+
+		if (format == ExemplarFormat::Text)
+		{
+			result.textExemplarCount++;
+		}
+		else if (format == ExemplarFormat::Invalid)
+		{
+			AddProblem(result, entry, std::string(), std::move(errorMessage));
+		}
+		else if (context.decoder.HasProperty(kBudgetItemPurpose))
+		{
+			// Only the exemplars with a Budget Item: Purpose property are copied to a property
+			// holder, the other exemplars cannot have custom budget department line items.
+			context.propertyHolder.RemoveAllProperties();
+			context.decoder.CopyProperties(context.propertyHolder);
+			context.problems.clear();
+
+			if (CustomBudgetExemplarLinter::Check(&context.propertyHolder, context.pDefinitions, context.problems))
+			{
+				result.customBudgetExemplarCount++;
+
+				if (!context.problems.empty())
+				{
+					std::string exemplarName;
+					context.decoder.GetStringProperty(kExemplarNameProperty, exemplarName);
+
+					for (std::string& problem : context.problems)
+					{
+						AddProblem(result, entry, exemplarName, std::move(problem));
+					}
+				}
+			}
+		}
+	}
+
+	void ScanFile(ScanContext& context, PluginFileResult& result)
+	{
+		if (!DBPFFile::HasSignature(result.path))
+		{
+			return;
+		}
+
+		result.isDBPF = true;
+
+		std::string errorMessage;
+
+		if (!context.file.Open(result.path, errorMessage))
+		{
+			PluginProblem problem{};
+			problem.message = std::move(errorMessage);
+
+			result.problems.push_back(std::move(problem));
+			return;
+		}
+
+		for (const DBPFEntry& entry : context.file.GetEntries())
+		{
+			if (entry.type == ExemplarDecoder::ExemplarType)
+			{
+				ScanEntry(context, entry, result);
+			}
+		}
+
+		context.file.Close();
+	}
+}
+
+std::vector<std::filesystem::path> PluginScanner::FindFiles(const std::vector<std::filesystem::path>& paths)
+{
+	std::vector<std::filesystem::path> files;
+
+	for (const std::filesystem::path& path : paths)
+	{
+		std::error_code errorCode;
+
+		if (std::filesystem::is_directory(path, errorCode))
+		{
+			const auto options = std::filesystem::directory_options::follow_directory_symlink
+				| std::filesystem::directory_options::skip_permission_denied;
+
+			for (const auto& item : std::filesystem::recursive_directory_iterator(path, options, errorCode))
+			{
+				if (item.is_regular_file(errorCode))
+				{
+					files.push_back(item.path());
+				}
+			}
+		}
+		else if (std::filesystem::is_regular_file(path, errorCode))
+		{
+			files.push_back(path);
+		}
+	}
+
+	std::sort(files.begin(), files.end());
+
+	return files;
+}
+
+std::vector<PluginFileResult> PluginScanner::Scan(const std::vector<std::filesystem::path>& files, uint32_t threadCount)
+{
+	std::vector<PluginFileResult> results(files.size());
+
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		std::error_code errorCode;
+		const uintmax_t fileSize = std::filesystem::file_size(files[i], errorCode);
+
+		results[i].path = files[i];
+		results[i].byteCount = errorCode ? 0 : fileSize;
+	}
+
+	std::vector<size_t> scanOrder(files.size());
+	std::iota(scanOrder.begin(), scanOrder.end(), 0);
+	std::stable_sort(
+		scanOrder.begin(),
+		scanOrder.end(),
+		[&](size_t left, size_t right) { return results[left].byteCount > results[right].byteCount; });
+
+	// Only the definition exemplars are decoded in the first pass, they are found from the DBPF index.
+	std::vector<std::vector<DepartmentDefinition>> fileDefinitions(files.size());
+
+	RunWorkers(
+		scanOrder,
+		threadCount,
+		nullptr,
+		[&](ScanContext& context, size_t index)
+		{
+			ReadDepartmentDefinitionFile(context, results[index], fileDefinitions[index]);
+		});
+
+	const DepartmentDefinitionTable definitions = CreateDepartmentDefinitionTable(results, fileDefinitions);
+
+	RunWorkers(
+		scanOrder,
+		threadCount,
+		&definitions,
+		[&](ScanContext& context, size_t index)
+		{
+			ScanFile(context, results[index]);
+		});
+
+	return results;
+}
@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+struct PluginProblem
+{
+	// The TGI of the entry, or all zero for the problems with the file itself.
+	uint32_t type;
+	uint32_t group;
+	uint32_t instance;
+	std::string exemplarName;
+	std::string message;
+};
+
+struct PluginFileResult
+{
+	std::filesystem::path path;
+	uint64_t byteCount;
+	bool isDBPF;
+	uint64_t exemplarCount;
+	uint64_t textExemplarCount;
+	uint64_t customBudgetExemplarCount;
+	uint64_t departmentDefinitionCount;
+	std::vector<PluginProblem> problems;
+};
+
+/**
+ * @brief Scans the DBPF files of a plugin folder for custom budget department exemplar problems.
+ *
+ * The files are divided between the worker threads, the largest files are scanned first
+ * so that one large file does not delay the end of the scan. The shared department definitions
+ * are read from all of the files before the building exemplars are checked.
+ */
+class PluginScanner
+{
+public:
+	/**
+	 * @brief Finds the files in the specified files and folders, the folders are searched recursively.
+	 */
+	static std::vector<std::filesystem::path> FindFiles(const std::vector<std::filesystem::path>& paths);
+
+	/**
+	 * @brief Scans the files.
+	 * @param files The files.
+	 * @param threadCount The number of worker threads.
+	 * @return The results, in the same order as the files. The files that are not DBPF files are skipped.
+	 */
+	static std::vector<PluginFileResult> Scan(const std::vector<std::filesystem::path>& files, uint32_t threadCount);
+};
@@ -0,0 +1,178 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "QFSDecompressor.h"
+
+namespace
+{
+	// The DBPF entries start with the compressed size, the QFS header follows it.
+	constexpr size_t QFSHeaderOffset = 4;
+	constexpr uint8_t QFSMagic = 0xFB;
+
+	uint32_t ReadBigEndian(const uint8_t* pData, size_t byteCount)
+	{
+		uint32_t value = 0;
+
+		for (size_t i = 0; i < byteCount; i++)
+		{
+			value = (value << 8) | pData[i];
+		}
+
+		return value;
+	}
+}
+
+bool QFSDecompressor::IsCompressed(const uint8_t* pData, size_t size)
+{
+	return size >= QFSHeaderOffset + 5 && pData[QFSHeaderOffset + 1] == QFSMagic;
+}
+
+bool QFSDecompressor::Decompress(const uint8_t* pData, size_t size, std::vector<uint8_t>& destination)
+{
+	if (!IsCompressed(pData, size))
+	{
+		return false;
+	}
+
+	const uint8_t* const pEnd = pData + size;
+	const uint8_t* pInput = pData + QFSHeaderOffset;
+
+	// Bit 0x80 of the flags selects 4-byte sizes, bit 0x01 indicates that
+	// the compressed size is stored before the uncompressed size.
+	const uint8_t flags = pInput[0];
+	const size_t sizeFieldLength = (flags & 0x80) ? 4 : 3;
+
+	pInput += 2;
+
+	if (flags & 0x01)
+	{
+		pInput += sizeFieldLength;
+	}
+
+	if (static_cast<size_t>(pEnd - pInput) < sizeFieldLength)
+	{
+		return false;
+	}
+
+	const size_t uncompressedSize = ReadBigEndian(pInput, sizeFieldLength);
+	pInput += sizeFieldLength;
+
+	if (uncompressedSize > MaxUncompressedSize)
+	{
+		return false;
+	}
+
+	destination.resize(uncompressedSize);
+
+	uint8_t* const pOutputStart = destination.data();
+	uint8_t* const pOutputEnd = pOutputStart + uncompressedSize;
+	uint8_t* pOutput = pOutputStart;
+
+	while (pInput < pEnd)
+	{
+		const uint8_t control = pInput[0];
+		size_t literalLength = 0;
+		size_t copyLength = 0;
+		size_t copyOffset = 0;
+		size_t controlLength = 0;
+		bool isEndOfStream = false;
+
+		if (control < 0x80)
+		{
+			controlLength = 2;
+		}
+		else if (control < 0xC0)
+		{
+			controlLength = 3;
+		}
+		else if (control < 0xE0)
+		{
+			controlLength = 4;
+		}
+		else
+		{
+			controlLength = 1;
+		}
+
+		if (static_cast<size_t>(pEnd - pInput) < controlLength)
+		{
+			return false;
+		}
+
+		if (control < 0x80)
+		{
+			literalLength = control & 0x03;
+			copyLength = ((control & 0x1C) >> 2) + 3;
+			copyOffset = ((control & 0x60) << 3) + pInput[1] + 1;
+		}
+		else if (control < 0xC0)
+		{
+			literalLength = (pInput[1] >> 6) & 0x03;
+			copyLength = (control & 0x3F) + 4;
+			copyOffset = ((pInput[1] & 0x3F) << 8) + pInput[2] + 1;
+		}
+		else if (control < 0xE0)
+		{
+			literalLength = control & 0x03;
+			copyLength = ((control & 0x0C) << 6) + pInput[3] + 5;
+			copyOffset = ((control & 0x10) << 12) + (pInput[1] << 8) + pInput[2] + 1;
+		}
+		else if (control < 0xFC)
+		{
+			literalLength = ((control & 0x1F) << 2) + 4;
+		}
+		else
+		{
+			literalLength = control & 0x03;
+			isEndOfStream = true;
+		}
+
+		pInput += controlLength;
+
+		if (static_cast<size_t>(pEnd - pInput) < literalLength
+			|| static_cast<size_t>(pOutputEnd - pOutput) < literalLength)
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < literalLength; i++)
+		{
+			*pOutput++ = *pInput++;
+		}
+
+		if (isEndOfStream)
+		{
+			break;
+		}
+
+		if (copyLength > 0)
+		{
+			if (static_cast<size_t>(pOutput - pOutputStart) < copyOffset
+				|| static_cast<size_t>(pOutputEnd - pOutput) < copyLength)
+			{
+				return false;
+			}
+
+			// The source and destination can overlap, the bytes are copied one at a time
+			// so that the copy repeats the most recent output.
+			const uint8_t* pSource = pOutput - copyOffset;
+
+			for (size_t i = 0; i < copyLength; i++)
+			{
+				*pOutput++ = *pSource++;
+			}
+		}
+	}
+
+	return pOutput == pOutputEnd;
+}
@@ -0,0 +1,41 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Decompresses the QFS (RefPack) compressed DBPF entries.
+ */
+namespace QFSDecompressor
+{
+	// A limit for the uncompressed size in the entry header, a corrupt
+	// entry could otherwise make us allocate an arbitrarily large buffer.
+	constexpr size_t MaxUncompressedSize = 64 * 1024 * 1024;
+
+	/**
+	 * @brief Checks if the entry data starts with a QFS header.
+	 */
+	bool IsCompressed(const uint8_t* pData, size_t size);
+
+	/**
+	 * @brief Decompresses a DBPF entry.
+	 * @param pData The entry data, including the 4-byte compressed size that precedes the QFS header.
+	 * @param size The entry size.
+	 * @param destination Receives the uncompressed data.
+	 * @return True on success, or false if the data is truncated or corrupt.
+	 */
+	bool Decompress(const uint8_t* pData, size_t size, std::vector<uint8_t>& destination);
+}
@@ -0,0 +1,168 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "RegionSaveScanner.h"
+#include "DBPFFile.h"
+#include "MemoryStream.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <numeric>
+#include <thread>
+
+namespace
+{
+	// The record keys that CustomBudgetDepartmentManager writes to the save game.
+	constexpr uint32_t CustomBudgetDepartmentManagerTypeId = 0xFE005706;
+	constexpr uint32_t CustomBudgetDepartmentManagerGroupId = 0xFE005707;
+	constexpr uint32_t CustomBudgetDepartmentManagerInstanceId = 0;
+	constexpr uint32_t CustomBudgetCitySummaryInstanceId = 1;
+
+	bool IsSaveFile(const std::filesystem::path& path)
+	{
+		std::string extension = path.extension().string();
+		std::transform(
+			extension.begin(),
+			extension.end(),
+			extension.begin(),
+			[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+		return extension == ".sc4";
+	}
+
+	struct ScanContext
+	{
+		DBPFFile file;
+		std::vector<uint8_t> buffer;
+	};
+
+	void ScanFile(ScanContext& context, CitySaveResult& result)
+	{
+		if (!DBPFFile::HasSignature(result.path))
+		{
+			return;
+		}
+
+		result.isDBPF = true;
+
+		if (!context.file.Open(result.path, result.errorMessage))
+		{
+			return;
+		}
+
+		for (const DBPFEntry& entry : context.file.GetEntries())
+		{
+			if (entry.type == CustomBudgetDepartmentManagerTypeId && entry.group == CustomBudgetDepartmentManagerGroupId)
+			{
+				if (entry.instance == CustomBudgetDepartmentManagerInstanceId)
+				{
+					result.hasLineItems = true;
+				}
+				else if (entry.instance == CustomBudgetCitySummaryInstanceId)
+				{
+					const uint8_t* pData = nullptr;
+					size_t size = 0;
+
+					if (context.file.GetEntryData(entry, context.buffer, pData, size))
+					{
+						MemoryIStream stream(pData, size);
+
+						if (result.summary.Read(stream))
+						{
+							result.hasSummary = true;
+						}
+						else
+						{
+							result.errorMessage = "The custom budget city summary is invalid.";
+						}
+					}
+					else
+					{
+						result.errorMessage = "The compressed entry is truncated or corrupt.";
+					}
+				}
+			}
+		}
+
+		context.file.Close();
+	}
+}
+
+std::vector<std::filesystem::path> RegionSaveScanner::FindSaveFiles(const std::filesystem::path& regionFolder)
+{
+	std::vector<std::filesystem::path> files;
+
+	std::error_code errorCode;
+
+	// The game stores the city save games directly in the region folder.
+	for (const auto& item : std::filesystem::directory_iterator(regionFolder, errorCode))
+	{
+		if (item.is_regular_file(errorCode) && IsSaveFile(item.path()))
+		{
+			files.push_back(item.path());
+		}
+	}
+
+	std::sort(files.begin(), files.end());
+
+	return files;
+}
+
+std::vector<CitySaveResult> RegionSaveScanner::Scan(const std::vector<std::filesystem::path>& files, uint32_t threadCount)
+{
+	std::vector<CitySaveResult> results(files.size());
+
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		std::error_code errorCode;
+		const uintmax_t fileSize = std::filesystem::file_size(files[i], errorCode);
+
+		results[i].path = files[i];
+		results[i].byteCount = errorCode ? 0 : fileSize;
+	}
+
+	std::vector<size_t> scanOrder(files.size());
+	std::iota(scanOrder.begin(), scanOrder.end(), 0);
+	std::stable_sort(
+		scanOrder.begin(),
+		scanOrder.end(),
+		[&](size_t left, size_t right) { return results[left].byteCount > results[right].byteCount; });
+
+	std::atomic<size_t> nextFile = 0;
+
+	auto worker = [&]()
+	{
+		ScanContext context;
+
+		for (size_t i = nextFile.fetch_add(1); i < scanOrder.size(); i = nextFile.fetch_add(1))
+		{
+			ScanFile(context, results[scanOrder[i]]);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threadCount = std::max(threadCount, 1U);
+	threads.reserve(threadCount);
+
+	for (uint32_t i = 0; i < threadCount; i++)
+	{
+		threads.emplace_back(worker);
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	return results;
+}
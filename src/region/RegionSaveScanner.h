@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "RegionalBudgetSummary.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+struct CitySaveResult
+{
+	std::filesystem::path path;
+	uint64_t byteCount;
+	bool isDBPF;
+	// The save game has custom budget department line items.
+	bool hasLineItems;
+	// The save game has the city summary record, it is written by the plugin versions that
+	// support the region summary.
+	bool hasSummary;
+	CustomBudgetCitySummary summary;
+	std::string errorMessage;
+};
+
+/**
+ * @brief Reads the custom budget department city summaries from the save games of a region.
+ *
+ * The save games are memory mapped and divided between the worker threads, only the pages
+ * of the DBPF index and the summary record are read.
+ */
+class RegionSaveScanner
+{
+public:
+	/**
+	 * @brief Finds the city save games (.sc4 files) in a region folder.
+	 */
+	static std::vector<std::filesystem::path> FindSaveFiles(const std::filesystem::path& regionFolder);
+
+	/**
+	 * @brief Scans the save games.
+	 * @param files The save game files.
+	 * @param threadCount The number of worker threads.
+	 * @return The results, in the same order as the files.
+	 */
+	static std::vector<CitySaveResult> Scan(const std::vector<std::filesystem::path>& files, uint32_t threadCount);
+};
@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "RegionSaveScanner.h"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+	constexpr const char* RegionalBudgetSummaryFileName = "SC4CustomBudgetDepartments.region.bin";
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: CustomBudgetDepartmentsRegionScan <region folder> [options]\n"
+			"  --output <path>   The summary file, default is %s in the region folder.\n"
+			"  --threads <n>     The number of worker threads, default is 4 times the number of processors.\n",
+			RegionalBudgetSummaryFileName);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::filesystem::path regionFolder;
+	std::filesystem::path outputPath;
+	// The scan mostly waits for the page faults when the files are not in the
+	// file system cache, so it uses more threads than processors.
+	uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 1U) * 4;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+		{
+			outputPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			threadCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (argv[i][0] != '-' && regionFolder.empty())
+		{
+			regionFolder = argv[i];
+		}
+		else
+		{
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (regionFolder.empty() || threadCount == 0)
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	if (outputPath.empty())
+	{
+		outputPath = regionFolder / RegionalBudgetSummaryFileName;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+
+	const std::vector<std::filesystem::path> files = RegionSaveScanner::FindSaveFiles(regionFolder);
+	const std::vector<CitySaveResult> results = RegionSaveScanner::Scan(files, threadCount);
+
+	std::vector<CustomBudgetCitySummary> summaries;
+	uint64_t cityCount = 0;
+	uint64_t byteCount = 0;
+	uint64_t legacyCount = 0;
+	uint64_t errorCount = 0;
+
+	for (const CitySaveResult& result : results)
+	{
+		if (!result.isDBPF)
+		{
+			continue;
+		}
+
+		if (!result.errorMessage.empty())
+		{
+			std::printf("%s: %s\n", result.path.string().c_str(), result.errorMessage.c_str());
+			errorCount++;
+		}
+
+		if (result.hasSummary)
+		{
+			summaries.push_back(result.summary);
+		}
+		else if (result.hasLineItems && result.errorMessage.empty())
+		{
+			// The city was last saved by a plugin version that did not write the summary.
+			std::printf("%s: The city does not have a custom budget summary, load and save it once to add it.\n", result.path.string().c_str());
+			legacyCount++;
+		}
+
+		cityCount++;
+		byteCount += result.byteCount;
+	}
+
+	if (!RegionalBudgetSummary::Write(outputPath, summaries))
+	{
+		std::printf("Failed to write %s.\n", outputPath.string().c_str());
+		return EXIT_FAILURE;
+	}
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::printf(
+		"Scanned %" PRIu64 " city save games (%.1f MB) in %.3f s with %u threads: %zu with custom budget departments, %" PRIu64
+		" without a summary, %" PRIu64 " errors.\n",
+		cityCount,
+		static_cast<double>(byteCount) / (1024.0 * 1024.0),
+		seconds,
+		threadCount,
+		summaries.size(),
+		legacyCount,
+		errorCount);
+	std::printf("Wrote %s.\n", outputPath.string().c_str());
+
+	return errorCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "MessageStreamReader.h"
+#include "MessageStreamFormat.h"
+#include <cstring>
+#include <fstream>
+
+MessageStreamReader::MessageStreamReader()
+	: data(),
+	  position(0)
+{
+}
+
+bool MessageStreamReader::Open(const std::filesystem::path& path)
+{
+	data.clear();
+	position = 0;
+
+	std::ifstream stream(path, std::ifstream::in | std::ifstream::binary);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	stream.seekg(0, std::ifstream::end);
+	const std::streamoff length = stream.tellg();
+	stream.seekg(0, std::ifstream::beg);
+
+	if (length <= 0)
+	{
+		return false;
+	}
+
+	data.resize(static_cast<size_t>(length));
+
+	if (!stream.read(reinterpret_cast<char*>(data.data()), length))
+	{
+		data.clear();
+		return false;
+	}
+
+	uint32_t signature = 0;
+	uint32_t version = 0;
+
+	return GetUint32(signature)
+		&& GetUint32(version)
+		&& signature == MessageStreamSignature
+		&& version == MessageStreamVersion;
+}
+
+bool MessageStreamReader::IsEndOfStream() const
+{
+	return position >= data.size();
+}
+
+size_t MessageStreamReader::GetPosition() const
+{
+	return position;
+}
+
+size_t MessageStreamReader::GetLength() const
+{
+	return data.size();
+}
+
+bool MessageStreamReader::GetUint8(uint8_t& value)
+{
+	return Read(&value, sizeof(value));
+}
+
+bool MessageStreamReader::GetUint16(uint16_t& value)
+{
+	return Read(&value, sizeof(value));
+}
+
+bool MessageStreamReader::GetUint32(uint32_t& value)
+{
+	return Read(&value, sizeof(value));
+}
+
+bool MessageStreamReader::GetSint32(int32_t& value)
+{
+	return Read(&value, sizeof(value));
+}
+
+bool MessageStreamReader::GetUint64(uint64_t& value)
+{
+	return Read(&value, sizeof(value));
+}
+
+bool MessageStreamReader::GetSint64(int64_t& value)
+{
+	return Read(&value, sizeof(value));
+}
+
+bool MessageStreamReader::GetBytes(std::vector<uint8_t>& destination, size_t count)
+{
+	if (count > data.size() - position)
+	{
+		return false;
+	}
+
+	destination.assign(data.begin() + position, data.begin() + position + count);
+	position += count;
+
+	return true;
+}
+
+bool MessageStreamReader::Read(void* destination, size_t count)
+{
+	if (count > data.size() - position)
+	{
+		return false;
+	}
+
+	std::memcpy(destination, data.data() + position, count);
+	position += count;
+
+	return true;
+}
@@ -0,0 +1,52 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+/**
+ * @brief Reads a message stream log that was written by MessageStreamRecorder.
+ *
+ * The entire log is read into memory by Open.
+ */
+class MessageStreamReader
+{
+public:
+	MessageStreamReader();
+
+	/**
+	 * @brief Reads the log file and validates the header.
+	 * @return True on success; otherwise, false.
+	 */
+	bool Open(const std::filesystem::path& path);
+
+	bool IsEndOfStream() const;
+	size_t GetPosition() const;
+	size_t GetLength() const;
+
+	bool GetUint8(uint8_t& value);
+	bool GetUint16(uint16_t& value);
+	bool GetUint32(uint32_t& value);
+	bool GetSint32(int32_t& value);
+	bool GetUint64(uint64_t& value);
+	bool GetSint64(int64_t& value);
+	bool GetBytes(std::vector<uint8_t>& destination, size_t count);
+
+private:
+	bool Read(void* destination, size_t count);
+
+	std::vector<uint8_t> data;
+	size_t position;
+};
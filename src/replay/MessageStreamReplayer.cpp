@@ -0,0 +1,608 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "MessageStreamReplayer.h"
+#include "BuildingInstanceArray.h"
+#include "cGZPersistResourceKey.h"
+#include "cISC4DepartmentBudget.h"
+#include "cISC4LineItem.h"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <limits>
+
+static constexpr uint32_t CustomBudgetDepartmentManagerTypeId = 0xFE005706;
+static constexpr uint32_t CustomBudgetDepartmentManagerGroupId = 0xFE005707;
+static constexpr uint32_t CustomBudgetDepartmentManagerInstanceId = 0;
+
+// The remaining region population is placed in cities to the east of the current city.
+static constexpr int32_t kFirstRegionCityX = 1;
+
+// The limits of the in-memory population grid, a large city is 256 cells wide.
+static constexpr int32_t MaxPopulationGridTractShift = 8;
+static constexpr uint32_t MaxPopulationGridTractCount = 256;
+
+// Limits the number of mismatched line items that are printed.
+static constexpr uint64_t MaxReportedMismatches = 20;
+
+MessageStreamReplayer::MessageStreamReplayer(bool verify)
+	: verify(verify),
+	  regionCityCount(0),
+	  game(),
+	  manager(),
+	  segment(),
+	  exemplars(),
+	  occupants(),
+	  statistics()
+{
+	manager.Init();
+}
+
+MessageStreamReplayer::~MessageStreamReplayer()
+{
+	manager.Shutdown();
+}
+
+bool MessageStreamReplayer::OpenIndex(const std::filesystem::path& path, uint64_t pluginFingerprint)
+{
+	return manager.OpenIndex(path, pluginFingerprint);
+}
+
+bool MessageStreamReplayer::Replay(MessageStreamReader& reader)
+{
+	bool result = true;
+
+	while (result && !reader.IsEndOfStream())
+	{
+		uint8_t type = 0;
+
+		if (!reader.GetUint8(type))
+		{
+			return false;
+		}
+
+		switch (static_cast<MessageStreamRecordType>(type))
+		{
+		case MessageStreamRecordType::PostCityInit:
+			result = ReplayPostCityInit(reader);
+			break;
+		case MessageStreamRecordType::PostCityShutdown:
+			result = ReplayPostCityShutdown();
+			break;
+		case MessageStreamRecordType::Exemplar:
+			result = ReadExemplar(reader);
+			break;
+		case MessageStreamRecordType::InsertOccupant:
+			result = ReplayInsertOccupant(reader);
+			break;
+		case MessageStreamRecordType::RemoveOccupant:
+			result = ReplayRemoveOccupant(reader);
+			break;
+		case MessageStreamRecordType::SimNewMonth:
+			result = ReplaySimNewMonth(reader);
+			break;
+		case MessageStreamRecordType::Load:
+			result = ReplayLoad(reader);
+			break;
+		case MessageStreamRecordType::Save:
+			result = ReplaySave();
+			break;
+		default:
+			std::fprintf(stderr, "Unknown record type %u at offset %zu.\n", type, reader.GetPosition() - 1);
+			result = false;
+			break;
+		}
+	}
+
+	return result;
+}
+
+const MessageStreamReplayStatistics& MessageStreamReplayer::GetStatistics() const
+{
+	return statistics;
+}
+
+bool MessageStreamReplayer::ReplayPostCityInit(MessageStreamReader& reader)
+{
+	int64_t total = 0;
+	int64_t lowWealth = 0;
+	int64_t mediumWealth = 0;
+	int64_t highWealth = 0;
+
+	if (!reader.GetSint64(total)
+		|| !reader.GetSint64(lowWealth)
+		|| !reader.GetSint64(mediumWealth)
+		|| !reader.GetSint64(highWealth))
+	{
+		return false;
+	}
+
+	SetRegionPopulation(total, lowWealth, mediumWealth, highWealth);
+
+	uint32_t lineItemCount = 0;
+
+	if (!reader.GetUint32(lineItemCount))
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < lineItemCount; i++)
+	{
+		if (!RestoreLineItem(reader))
+		{
+			return false;
+		}
+	}
+
+	Measure(MessageStreamRecordType::PostCityInit, [this]() { game.PostCityInit(); });
+
+	return true;
+}
+
+bool MessageStreamReplayer::RestoreLineItem(MessageStreamReader& reader)
+{
+	uint32_t department = 0;
+	uint32_t budgetGroup = 0;
+	uint32_t lineNumber = 0;
+	uint8_t isIncome = 0;
+	int64_t expenses = 0;
+	int64_t income = 0;
+	int64_t buildingCount = 0;
+
+	if (!reader.GetUint32(department)
+		|| !reader.GetUint32(budgetGroup)
+		|| !reader.GetUint32(lineNumber)
+		|| !reader.GetUint8(isIncome)
+		|| !reader.GetSint64(expenses)
+		|| !reader.GetSint64(income)
+		|| !reader.GetSint64(buildingCount))
+	{
+		return false;
+	}
+
+	// The game restores the line items from the save game before the city is initialized.
+
+	HeadlessBudgetSimulator& budgetSimulator = game.GetBudgetSimulator();
+
+	cISC4DepartmentBudget* pDepartment = budgetSimulator.GetDepartmentBudget(department);
+
+	if (!pDepartment)
+	{
+		pDepartment = budgetSimulator.CreateDepartmentBudget(department, budgetGroup);
+	}
+
+	cISC4LineItem* pLineItem = pDepartment->GetLineItem(lineNumber);
+
+	if (!pLineItem)
+	{
+		pLineItem = pDepartment->CreateLineItem(lineNumber, false);
+	}
+
+	if (isIncome)
+	{
+		pLineItem->SetType(cISC4LineItem::Type::Income);
+	}
+
+	pLineItem->SetFullExpenses(expenses);
+	pLineItem->SetIncome(income);
+	pLineItem->SetSecondaryInfoField(buildingCount);
+	pLineItem->SetDisplayFlag(cISC4LineItem::DisplayFlag::ShowSecondaryInfoField, buildingCount > 1);
+
+	return true;
+}
+
+bool MessageStreamReplayer::ReplayPostCityShutdown()
+{
+	Measure(MessageStreamRecordType::PostCityShutdown, [this]() { game.PostCityShutdown(); });
+
+	// The occupant and exemplar ids are only valid for a single city.
+	occupants.clear();
+	exemplars.clear();
+	game.GetBudgetSimulator().Clear();
+
+	return true;
+}
+
+bool MessageStreamReplayer::ReadExemplar(MessageStreamReader& reader)
+{
+	uint32_t exemplarIndex = 0;
+	uint32_t propertyCount = 0;
+
+	if (!reader.GetUint32(exemplarIndex) || !reader.GetUint32(propertyCount))
+	{
+		return false;
+	}
+
+	std::unique_ptr<HeadlessPropertyHolder> exemplar = std::make_unique<HeadlessPropertyHolder>();
+
+	for (uint32_t i = 0; i < propertyCount; i++)
+	{
+		uint32_t id = 0;
+		uint8_t type = 0;
+		uint32_t count = 0;
+
+		if (!reader.GetUint32(id) || !reader.GetUint8(type) || !reader.GetUint32(count))
+		{
+			return false;
+		}
+
+		switch (static_cast<MessageStreamPropertyType>(type))
+		{
+		case MessageStreamPropertyType::Uint32Array:
+		{
+			std::vector<uint32_t> values(count);
+
+			for (uint32_t& value : values)
+			{
+				if (!reader.GetUint32(value))
+				{
+					return false;
+				}
+			}
+
+			exemplar->SetUint32ArrayProperty(id, values);
+			break;
+		}
+		case MessageStreamPropertyType::Sint64Array:
+		{
+			std::vector<int64_t> values(count);
+
+			for (int64_t& value : values)
+			{
+				if (!reader.GetSint64(value))
+				{
+					return false;
+				}
+			}
+
+			exemplar->SetSint64ArrayProperty(id, values);
+			break;
+		}
+		case MessageStreamPropertyType::String:
+		{
+			std::vector<uint8_t> values;
+
+			if (!reader.GetBytes(values, count))
+			{
+				return false;
+			}
+
+			exemplar->SetStringProperty(id, std::string_view(reinterpret_cast<const char*>(values.data()), values.size()));
+			break;
+		}
+		default:
+			return false;
+		}
+	}
+
+	exemplars.insert_or_assign(exemplarIndex, std::move(exemplar));
+
+	return true;
+}
+
+bool MessageStreamReplayer::ReplayInsertOccupant(MessageStreamReader& reader)
+{
+	uint32_t occupantId = 0;
+	uint32_t exemplarIndex = 0;
+	uint64_t buildingKey = 0;
+	int32_t buildingAge = 0;
+
+	if (!reader.GetUint32(occupantId)
+		|| !reader.GetUint32(exemplarIndex)
+		|| !reader.GetUint64(buildingKey)
+		|| !reader.GetSint32(buildingAge))
+	{
+		return false;
+	}
+
+	const auto& exemplar = exemplars.find(exemplarIndex);
+
+	if (exemplar == exemplars.end())
+	{
+		std::fprintf(stderr, "Occupant %u uses an unknown exemplar index: %u.\n", occupantId, exemplarIndex);
+		return false;
+	}
+
+	auto& occupant = occupants[occupantId];
+	occupant = std::make_unique<HeadlessBuildingOccupant>(exemplarIndex, exemplar->second.get());
+
+	cS3DVector3 position;
+	BuildingInstanceArray::GetKeyPosition(buildingKey, position.fX, position.fZ);
+	occupant->SetPosition(&position);
+	occupant->SetBuildingAge(buildingAge);
+
+	HeadlessBuildingOccupant* pOccupant = occupant.get();
+
+	Measure(MessageStreamRecordType::InsertOccupant, [this, pOccupant]() { game.InsertOccupant(pOccupant); });
+
+	return true;
+}
+
+bool MessageStreamReplayer::ReplayRemoveOccupant(MessageStreamReader& reader)
+{
+	uint32_t occupantId = 0;
+
+	if (!reader.GetUint32(occupantId))
+	{
+		return false;
+	}
+
+	const auto& item = occupants.find(occupantId);
+
+	if (item == occupants.end())
+	{
+		std::fprintf(stderr, "Unknown occupant id: %u.\n", occupantId);
+		return false;
+	}
+
+	HeadlessBuildingOccupant* pOccupant = item->second.get();
+
+	Measure(MessageStreamRecordType::RemoveOccupant, [this, pOccupant]() { game.RemoveOccupant(pOccupant); });
+
+	occupants.erase(item);
+
+	return true;
+}
+
+bool MessageStreamReplayer::ReplaySimNewMonth(MessageStreamReader& reader)
+{
+	int32_t total = 0;
+	int32_t lowWealth = 0;
+	int32_t mediumWealth = 0;
+	int32_t highWealth = 0;
+	uint32_t lineItemCount = 0;
+
+	if (!reader.GetSint32(total)
+		|| !reader.GetSint32(lowWealth)
+		|| !reader.GetSint32(mediumWealth)
+		|| !reader.GetSint32(highWealth))
+	{
+		return false;
+	}
+
+	game.SetCityResidentialPopulation(lowWealth, mediumWealth, highWealth);
+	game.SetCityTotalResidentialPopulation(total);
+
+	if (!RestorePopulationGrid(reader))
+	{
+		return false;
+	}
+
+	Measure(MessageStreamRecordType::SimNewMonth, [this]() { game.SimNewMonth(); });
+
+	statistics.monthCount++;
+
+	if (!reader.GetUint32(lineItemCount))
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < lineItemCount; i++)
+	{
+		uint32_t department = 0;
+		uint32_t lineNumber = 0;
+		int64_t expenses = 0;
+		int64_t income = 0;
+
+		if (!reader.GetUint32(department)
+			|| !reader.GetUint32(lineNumber)
+			|| !reader.GetSint64(expenses)
+			|| !reader.GetSint64(income))
+		{
+			return false;
+		}
+
+		if (verify)
+		{
+			statistics.lineItemValueCount++;
+
+			if (!VerifyLineItem(department, lineNumber, expenses, income))
+			{
+				statistics.lineItemValueMismatchCount++;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool MessageStreamReplayer::RestorePopulationGrid(MessageStreamReader& reader)
+{
+	int32_t tractShift = 0;
+	uint32_t tractCountX = 0;
+	uint32_t tractCountZ = 0;
+
+	if (!reader.GetSint32(tractShift)
+		|| !reader.GetUint32(tractCountX)
+		|| !reader.GetUint32(tractCountZ))
+	{
+		return false;
+	}
+
+	// The game cities are square, which is the only shape that the in-memory grid supports.
+	if (tractShift < 0
+		|| tractShift > MaxPopulationGridTractShift
+		|| tractCountX != tractCountZ
+		|| tractCountX > MaxPopulationGridTractCount)
+	{
+		std::fprintf(
+			stderr,
+			"Unsupported population grid: tract shift %d, %u by %u tracts.\n",
+			tractShift,
+			tractCountX,
+			tractCountZ);
+		return false;
+	}
+
+	HeadlessPopulationGrid& grid = game.GetPopulationGrid();
+	grid.Resize(static_cast<int32_t>(tractCountX) << tractShift, tractShift);
+
+	for (uint32_t z = 0; z < tractCountZ; z++)
+	{
+		for (uint32_t x = 0; x < tractCountX; x++)
+		{
+			uint16_t value = 0;
+
+			if (!reader.GetUint16(value))
+			{
+				return false;
+			}
+
+			grid.SetTractValue(static_cast<int32_t>(x), static_cast<int32_t>(z), value);
+		}
+	}
+
+	return true;
+}
+
+bool MessageStreamReplayer::ReplayLoad(MessageStreamReader& reader)
+{
+	uint8_t hasRecord = 0;
+	uint32_t recordSize = 0;
+	std::vector<uint8_t> record;
+
+	if (!reader.GetUint8(hasRecord)
+		|| !reader.GetUint32(recordSize)
+		|| !reader.GetBytes(record, recordSize))
+	{
+		return false;
+	}
+
+	const cGZPersistResourceKey key(
+		CustomBudgetDepartmentManagerTypeId,
+		CustomBudgetDepartmentManagerGroupId,
+		CustomBudgetDepartmentManagerInstanceId);
+
+	if (hasRecord)
+	{
+		segment.WriteRecord(key, record.data(), recordSize);
+	}
+	else
+	{
+		segment.DeleteRecord(key);
+	}
+
+	Measure(MessageStreamRecordType::Load, [this]() { game.Load(segment); });
+
+	return true;
+}
+
+bool MessageStreamReplayer::ReplaySave()
+{
+	Measure(MessageStreamRecordType::Save, [this]() { game.Save(segment); });
+
+	return true;
+}
+
+void MessageStreamReplayer::SetRegionPopulation(
+	int64_t total,
+	int64_t lowWealth,
+	int64_t mediumWealth,
+	int64_t highWealth)
+{
+	// The population is split across as many cities as necessary to fit
+	// the values into the Sint32 regional city populations.
+	constexpr int64_t MaxCityPopulation = std::numeric_limits<int32_t>::max();
+
+	HeadlessRegion& region = game.GetRegion();
+
+	int32_t cityCount = 0;
+
+	while (total > 0 || lowWealth > 0 || mediumWealth > 0 || highWealth > 0 || cityCount == 0)
+	{
+		const int64_t cityTotal = std::clamp<int64_t>(total, 0, MaxCityPopulation);
+		const int64_t cityLowWealth = std::clamp<int64_t>(lowWealth, 0, MaxCityPopulation);
+		const int64_t cityMediumWealth = std::clamp<int64_t>(mediumWealth, 0, MaxCityPopulation);
+		const int64_t cityHighWealth = std::clamp<int64_t>(highWealth, 0, MaxCityPopulation);
+
+		HeadlessRegionalCity* pCity = region.AddCity(kFirstRegionCityX + cityCount, 0, true);
+		pCity->SetResidentialPopulation(
+			static_cast<int32_t>(cityLowWealth),
+			static_cast<int32_t>(cityMediumWealth),
+			static_cast<int32_t>(cityHighWealth));
+		pCity->SetTotalResidentialPopulation(static_cast<int32_t>(cityTotal));
+
+		total -= cityTotal;
+		lowWealth -= cityLowWealth;
+		mediumWealth -= cityMediumWealth;
+		highWealth -= cityHighWealth;
+		cityCount++;
+	}
+
+	// Clear the cities that were used by a previous city session.
+	for (int32_t i = cityCount; i < regionCityCount; i++)
+	{
+		region.AddCity(kFirstRegionCityX + i, 0, false);
+	}
+
+	regionCityCount = std::max(regionCityCount, cityCount);
+}
+
+bool MessageStreamReplayer::VerifyLineItem(
+	uint32_t department,
+	uint32_t lineNumber,
+	int64_t expenses,
+	int64_t income)
+{
+	int64_t actualExpenses = 0;
+	int64_t actualIncome = 0;
+	bool found = false;
+
+	cISC4DepartmentBudget* pDepartment = game.GetBudgetSimulator().GetDepartmentBudget(department);
+
+	if (pDepartment)
+	{
+		const cISC4LineItem* pLineItem = pDepartment->GetLineItem(lineNumber);
+
+		if (pLineItem)
+		{
+			actualExpenses = pLineItem->GetFullExpenses();
+			actualIncome = pLineItem->GetIncome();
+			found = true;
+		}
+	}
+
+	const bool result = found && actualExpenses == expenses && actualIncome == income;
+
+	if (!result && statistics.lineItemValueMismatchCount < MaxReportedMismatches)
+	{
+		std::printf(
+			"Month %" PRIu64 ": department 0x%08X line item 0x%08X expected expenses %" PRId64 " and income %" PRId64
+			", replay %s expenses %" PRId64 " and income %" PRId64 ".\n",
+			statistics.monthCount,
+			department,
+			lineNumber,
+			expenses,
+			income,
+			found ? "has" : "is missing the line item,",
+			actualExpenses,
+			actualIncome);
+	}
+
+	return result;
+}
+
+template<typename Callable> void MessageStreamReplayer::Measure(MessageStreamRecordType type, Callable&& callable)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	callable();
+
+	const auto end = std::chrono::steady_clock::now();
+
+	MessageStreamReplayStatistics::MessageTiming& timing = statistics.messageTimings[static_cast<size_t>(type)];
+	timing.count++;
+	timing.totalNanoseconds += static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
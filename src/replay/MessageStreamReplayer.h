@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "CustomBudgetDepartmentManager.h"
+#include "HeadlessBuildingOccupant.h"
+#include "HeadlessGame.h"
+#include "HeadlessPropertyHolder.h"
+#include "MessageStreamFormat.h"
+#include "MessageStreamReader.h"
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <unordered_map>
+
+struct MessageStreamReplayStatistics
+{
+	struct MessageTiming
+	{
+		uint64_t count;
+		uint64_t totalNanoseconds;
+	};
+
+	// Indexed by MessageStreamRecordType.
+	std::array<MessageTiming, 9> messageTimings;
+	uint64_t monthCount;
+	uint64_t lineItemValueCount;
+	uint64_t lineItemValueMismatchCount;
+};
+
+/**
+ * @brief Drives the plugin with the messages from a recorded message stream log.
+ *
+ * When verification is enabled the line item values of each month are compared
+ * with the values that were recorded in the game.
+ */
+class MessageStreamReplayer
+{
+public:
+	MessageStreamReplayer(bool verify);
+	~MessageStreamReplayer();
+
+	MessageStreamReplayer(const MessageStreamReplayer&) = delete;
+	MessageStreamReplayer& operator=(const MessageStreamReplayer&) = delete;
+
+	/**
+	 * @brief Uses a custom budget index file for the building type lookups, see CustomBudgetDepartmentManager::OpenIndex.
+	 */
+	bool OpenIndex(const std::filesystem::path& path, uint64_t pluginFingerprint);
+
+	/**
+	 * @brief Replays the log from the current reader position to the end of the stream.
+	 * @return True on success, or false if the log is invalid.
+	 */
+	bool Replay(MessageStreamReader& reader);
+
+	const MessageStreamReplayStatistics& GetStatistics() const;
+
+private:
+	bool ReplayPostCityInit(MessageStreamReader& reader);
+	bool RestoreLineItem(MessageStreamReader& reader);
+	bool ReplayPostCityShutdown();
+	bool ReadExemplar(MessageStreamReader& reader);
+	bool ReplayInsertOccupant(MessageStreamReader& reader);
+	bool ReplayRemoveOccupant(MessageStreamReader& reader);
+	bool ReplaySimNewMonth(MessageStreamReader& reader);
+	bool RestorePopulationGrid(MessageStreamReader& reader);
+	bool ReplayLoad(MessageStreamReader& reader);
+	bool ReplaySave();
+
+	void SetRegionPopulation(int64_t total, int64_t lowWealth, int64_t mediumWealth, int64_t highWealth);
+	bool VerifyLineItem(uint32_t department, uint32_t lineNumber, int64_t expenses, int64_t income);
+
+	template<typename Callable> void Measure(MessageStreamRecordType type, Callable&& callable);
+
+	bool verify;
+	int32_t regionCityCount;
+	HeadlessGame game;
+	CustomBudgetDepartmentManager manager;
+	HeadlessDBSegment segment;
+	std::unordered_map<uint32_t, std::unique_ptr<HeadlessPropertyHolder>> exemplars;
+	std::unordered_map<uint32_t, std::unique_ptr<HeadlessBuildingOccupant>> occupants;
+	MessageStreamReplayStatistics statistics;
+};
@@ -0,0 +1,177 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "MessageStreamReader.h"
+#include "MessageStreamReplayer.h"
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+namespace
+{
+	const char* GetRecordTypeName(size_t type)
+	{
+		switch (static_cast<MessageStreamRecordType>(type))
+		{
+		case MessageStreamRecordType::PostCityInit:
+			return "PostCityInit";
+		case MessageStreamRecordType::PostCityShutdown:
+			return "PostCityShutdown";
+		case MessageStreamRecordType::InsertOccupant:
+			return "InsertOccupant";
+		case MessageStreamRecordType::RemoveOccupant:
+			return "RemoveOccupant";
+		case MessageStreamRecordType::SimNewMonth:
+			return "SimNewMonth";
+		case MessageStreamRecordType::Load:
+			return "Load";
+		case MessageStreamRecordType::Save:
+			return "Save";
+		default:
+			return nullptr;
+		}
+	}
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: CustomBudgetDepartmentsReplay <message log> [options]\n"
+			"  --iterations <n>   The number of times the log is replayed, default 1.\n"
+			"  --no-verify        Do not compare the line item values with the recorded values.\n"
+			"  --index <path>     Uses a custom budget index file, it is written by the first iteration if it does\n"
+			"                     not exist. The exemplar indices restart in each recorded city, so the index is\n"
+			"                     only valid for the logs that contain a single city.\n");
+	}
+
+	uint64_t GetLogFingerprint(const std::filesystem::path& logPath)
+	{
+		// The recorded exemplars are the replay's plugin set, the index
+		// is rebuilt when the message log changes.
+		std::error_code errorCode;
+
+		const uint64_t size = std::filesystem::file_size(logPath, errorCode);
+		const uint64_t lastWriteTime = static_cast<uint64_t>(
+			std::filesystem::last_write_time(logPath, errorCode).time_since_epoch().count());
+
+		return (size * 0x9E3779B97F4A7C15) ^ lastWriteTime;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::filesystem::path logPath;
+	std::filesystem::path indexPath;
+	uint32_t iterations = 1;
+	bool verify = true;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+		{
+			iterations = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (std::strcmp(argv[i], "--index") == 0 && i + 1 < argc)
+		{
+			indexPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--no-verify") == 0)
+		{
+			verify = false;
+		}
+		else if (argv[i][0] != '-' && logPath.empty())
+		{
+			logPath = argv[i];
+		}
+		else
+		{
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (logPath.empty() || iterations == 0)
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	MessageStreamReader reader;
+	MessageStreamReplayStatistics totals{};
+	uint64_t mismatchCount = 0;
+
+	for (uint32_t i = 0; i < iterations; i++)
+	{
+		if (!reader.Open(logPath))
+		{
+			std::fprintf(stderr, "%s is not a valid message log.\n", logPath.string().c_str());
+			return EXIT_FAILURE;
+		}
+
+		// Each iteration uses a new game and plugin instance.
+		MessageStreamReplayer replayer(verify);
+
+		if (!indexPath.empty())
+		{
+			replayer.OpenIndex(indexPath, GetLogFingerprint(logPath));
+		}
+
+		if (!replayer.Replay(reader))
+		{
+			std::fprintf(stderr, "The message log is truncated or corrupt at offset %zu.\n", reader.GetPosition());
+			return EXIT_FAILURE;
+		}
+
+		const MessageStreamReplayStatistics& statistics = replayer.GetStatistics();
+
+		for (size_t type = 0; type < totals.messageTimings.size(); type++)
+		{
+			totals.messageTimings[type].count += statistics.messageTimings[type].count;
+			totals.messageTimings[type].totalNanoseconds += statistics.messageTimings[type].totalNanoseconds;
+		}
+
+		totals.monthCount = statistics.monthCount;
+		totals.lineItemValueCount = statistics.lineItemValueCount;
+		mismatchCount += statistics.lineItemValueMismatchCount;
+	}
+
+	std::printf("%-20s %12s %16s %14s\n", "Message", "Count", "Total ms", "ns/message");
+
+	for (size_t type = 0; type < totals.messageTimings.size(); type++)
+	{
+		const char* const name = GetRecordTypeName(type);
+		const MessageStreamReplayStatistics::MessageTiming& timing = totals.messageTimings[type];
+
+		if (name && timing.count > 0)
+		{
+			std::printf(
+				"%-20s %12" PRIu64 " %16.3f %14.1f\n",
+				name,
+				timing.count,
+				static_cast<double>(timing.totalNanoseconds) / 1e6,
+				static_cast<double>(timing.totalNanoseconds) / static_cast<double>(timing.count));
+		}
+	}
+
+	if (verify)
+	{
+		std::printf(
+			"Verified %" PRIu64 " line item values over %" PRIu64 " months: %" PRIu64 " mismatches.\n",
+			totals.lineItemValueCount,
+			totals.monthCount,
+			mismatchCount);
+	}
+
+	return mismatchCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
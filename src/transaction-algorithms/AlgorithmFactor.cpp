@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "AlgorithmFactor.h"
+#include "cIGZIStream.h"
+#include "cIGZOStream.h"
+#include <cstring>
+
+AlgorithmFactor::AlgorithmFactor()
+	: storageType(StorageType::Rational),
+	  numerator(0),
+	  denominator(1),
+	  legacyValue(0.0f)
+{
+}
+
+AlgorithmFactor::AlgorithmFactor(int32_t numerator, int32_t denominator)
+	: storageType(StorageType::Rational),
+	  numerator(numerator),
+	  denominator(denominator),
+	  legacyValue(0.0f)
+{
+}
+
+bool AlgorithmFactor::IsLegacyFloat32() const
+{
+	return storageType == StorageType::Float32;
+}
+
+int32_t AlgorithmFactor::GetNumerator() const
+{
+	return numerator;
+}
+
+int32_t AlgorithmFactor::GetDenominator() const
+{
+	return denominator;
+}
+
+int64_t AlgorithmFactor::Multiply(int64_t value) const
+{
+	if (storageType == StorageType::Float32)
+	{
+		// This matches the calculation that the older plugin versions used.
+		return static_cast<int64_t>(static_cast<double>(value) * legacyValue);
+	}
+
+	// The value is split into the quotient and remainder of the division by the
+	// denominator, value = (quotient * denominator) + remainder.
+	// Both products have the same sign and the remainder product is less than 2^62,
+	// so the result is exact as long as it fits in an int64_t.
+	const int64_t quotient = value / denominator;
+	const int64_t remainder = value % denominator;
+
+	return (quotient * numerator) + ((remainder * numerator) / denominator);
+}
+
+uint64_t AlgorithmFactor::GetHash() const
+{
+	if (storageType == StorageType::Float32)
+	{
+		uint32_t legacyValueBits = 0;
+		std::memcpy(&legacyValueBits, &legacyValue, sizeof(legacyValueBits));
+
+		return (static_cast<uint64_t>(1) << 63) | legacyValueBits;
+	}
+
+	return (static_cast<uint64_t>(static_cast<uint32_t>(numerator)) << 32) | static_cast<uint32_t>(denominator);
+}
+
+bool AlgorithmFactor::operator==(const AlgorithmFactor& other) const
+{
+	if (storageType != other.storageType)
+	{
+		return false;
+	}
+
+	if (storageType == StorageType::Float32)
+	{
+		// The legacy values are compared bitwise, the same as the hash.
+		return std::memcmp(&legacyValue, &other.legacyValue, sizeof(legacyValue)) == 0;
+	}
+
+	return numerator == other.numerator && denominator == other.denominator;
+}
+
+bool AlgorithmFactor::Read(cIGZIStream& stream, bool legacyFloat32)
+{
+	if (legacyFloat32)
+	{
+		storageType = StorageType::Float32;
+		numerator = 0;
+		denominator = 1;
+
+		return stream.GetFloat32(legacyValue);
+	}
+
+	// We use GetVoid because GetUint8 always returns false.
+	uint8_t type = 0;
+
+	if (!stream.GetVoid(&type, 1))
+	{
+		return false;
+	}
+
+	switch (static_cast<StorageType>(type))
+	{
+	case StorageType::Rational:
+		storageType = StorageType::Rational;
+		legacyValue = 0.0f;
+
+		return stream.GetSint32(numerator)
+			&& stream.GetSint32(denominator)
+			&& denominator > 0;
+	case StorageType::Float32:
+		storageType = StorageType::Float32;
+		numerator = 0;
+		denominator = 1;
+
+		return stream.GetFloat32(legacyValue);
+	default:
+		return false;
+	}
+}
+
+bool AlgorithmFactor::Write(cIGZOStream& stream) const
+{
+	const uint8_t type = static_cast<uint8_t>(storageType);
+
+	if (!stream.SetVoid(&type, 1))
+	{
+		return false;
+	}
+
+	if (storageType == StorageType::Float32)
+	{
+		return stream.SetFloat32(legacyValue);
+	}
+
+	return stream.SetSint32(numerator) && stream.SetSint32(denominator);
+}
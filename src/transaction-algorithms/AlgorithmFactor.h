@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstdint>
+
+class cIGZIStream;
+class cIGZOStream;
+
+/**
+ * @brief A cost algorithm factor that is stored as an exact rational number.
+ *
+ * The factor is evaluated with integer arithmetic, so the results are the same
+ * for every compiler. Factors that were loaded from a save game that stored the
+ * factors as Float32 values keep using the Float32 value, this ensures that the
+ * existing cities produce the same line item values.
+ */
+class AlgorithmFactor
+{
+public:
+	AlgorithmFactor();
+	AlgorithmFactor(int32_t numerator, int32_t denominator);
+
+	bool IsLegacyFloat32() const;
+	int32_t GetNumerator() const;
+	int32_t GetDenominator() const;
+
+	/**
+	 * @brief Multiplies the value by the factor, the result is truncated toward zero.
+	 */
+	int64_t Multiply(int64_t value) const;
+
+	/**
+	 * @brief Gets a hash of the factor value, used to find algorithms with the same parameters.
+	 */
+	uint64_t GetHash() const;
+
+	bool operator==(const AlgorithmFactor& other) const;
+
+	/**
+	 * @brief Reads the factor.
+	 * @param stream The stream.
+	 * @param legacyFloat32 true if the save game stored the factor as a Float32 value; otherwise, false.
+	 */
+	bool Read(cIGZIStream& stream, bool legacyFloat32);
+	bool Write(cIGZOStream& stream) const;
+
+private:
+	enum class StorageType : uint8_t
+	{
+		Rational = 0,
+		Float32 = 1,
+	};
+
+	StorageType storageType;
+	int32_t numerator;
+	int32_t denominator;
+	float legacyValue;
+};
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "AlgorithmInput.h"
+#include "TransactionAlgorithmStaticPointers.h"
+
+int64_t GetAlgorithmInputValue(AlgorithmInput input, int64_t initialTotal, int64_t buildingCount)
+{
+	int64_t value = 0;
+
+	switch (input)
+	{
+	case AlgorithmInput::BuildingCount:
+		value = buildingCount;
+		break;
+	case AlgorithmInput::FixedCost:
+		value = initialTotal;
+		break;
+	case AlgorithmInput::CityPopulation:
+		value = spPopulationProvider->GetCityResidentialPopulation();
+		break;
+	case AlgorithmInput::CityLowWealthPopulation:
+		value = spPopulationProvider->GetCityPopulation(0x1010);
+		break;
+	case AlgorithmInput::CityMediumWealthPopulation:
+		value = spPopulationProvider->GetCityPopulation(0x1020);
+		break;
+	case AlgorithmInput::CityHighWealthPopulation:
+		value = spPopulationProvider->GetCityPopulation(0x1030);
+		break;
+	case AlgorithmInput::RegionPopulation:
+		value = spPopulationProvider->GetRegionResidentialPopulation();
+		break;
+	case AlgorithmInput::RegionLowWealthPopulation:
+		value = spPopulationProvider->GetRegionPopulation(0x1010);
+		break;
+	case AlgorithmInput::RegionMediumWealthPopulation:
+		value = spPopulationProvider->GetRegionPopulation(0x1020);
+		break;
+	case AlgorithmInput::RegionHighWealthPopulation:
+		value = spPopulationProvider->GetRegionPopulation(0x1030);
+		break;
+	case AlgorithmInput::RegionCustomBudgetExpenses:
+		// The region summary is optional, the value is zero when it has not been generated.
+		value = spRegionalBudgetProvider ? spRegionalBudgetProvider->GetRegionCustomBudgetExpenses() : 0;
+		break;
+	case AlgorithmInput::RegionCustomBudgetIncome:
+		value = spRegionalBudgetProvider ? spRegionalBudgetProvider->GetRegionCustomBudgetIncome() : 0;
+		break;
+	case AlgorithmInput::Count:
+	default:
+		break;
+	}
+
+	return value;
+}
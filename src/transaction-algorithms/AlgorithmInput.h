@@ -0,0 +1,55 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief The city values that the Formula and Tiered algorithms can use.
+ */
+enum class AlgorithmInput : uint8_t
+{
+	BuildingCount = 0,
+	FixedCost,
+	CityPopulation,
+	CityLowWealthPopulation,
+	CityMediumWealthPopulation,
+	CityHighWealthPopulation,
+	RegionPopulation,
+	RegionLowWealthPopulation,
+	RegionMediumWealthPopulation,
+	RegionHighWealthPopulation,
+	RegionCustomBudgetExpenses,
+	RegionCustomBudgetIncome,
+	Count
+};
+
+static constexpr size_t AlgorithmInputCount = static_cast<size_t>(AlgorithmInput::Count);
+
+typedef std::array<int64_t, AlgorithmInputCount> AlgorithmInputs;
+
+// The inputs that depend on the line item instead of the city/region state,
+// as a bit mask of the AlgorithmInput values.
+static constexpr uint32_t LineItemAlgorithmInputs = (1U << static_cast<uint32_t>(AlgorithmInput::BuildingCount))
+												  | (1U << static_cast<uint32_t>(AlgorithmInput::FixedCost));
+
+/**
+ * @brief Gets the current value of an algorithm input.
+ * @param input The input.
+ * @param initialTotal The line item's fixed expense/income for all of its buildings.
+ * @param buildingCount The number of buildings that use the line item.
+ * @return The input value.
+ */
+int64_t GetAlgorithmInputValue(AlgorithmInput input, int64_t initialTotal, int64_t buildingCount);
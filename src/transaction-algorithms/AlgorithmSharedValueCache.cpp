@@ -0,0 +1,42 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "AlgorithmSharedValueCache.h"
+
+AlgorithmSharedValueCache::AlgorithmSharedValueCache()
+	: values()
+{
+}
+
+int64_t AlgorithmSharedValueCache::GetOrCalculate(const ITransactionAlgorithm& algorithm)
+{
+	auto item = values.find(&algorithm);
+
+	if (item == values.end())
+	{
+		item = values.emplace(&algorithm, algorithm.CalculateSharedValue()).first;
+	}
+
+	return item->second;
+}
+
+void AlgorithmSharedValueCache::Clear()
+{
+	// The buckets are kept so that the next update doesn't need to rehash.
+	values.clear();
+}
+
+size_t AlgorithmSharedValueCache::GetEvaluationCount() const
+{
+	return values.size();
+}
@@ -0,0 +1,42 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "ITransactionAlgorithm.h"
+#include <cstddef>
+#include <unordered_map>
+
+/**
+ * @brief Caches the ITransactionAlgorithm shared values during a monthly update.
+ *
+ * Each shared algorithm instance is evaluated once, and its value is used for all
+ * of the line items that reference it. The cache must be cleared before the next
+ * update because the values depend on the city/region state.
+ */
+class AlgorithmSharedValueCache
+{
+public:
+	AlgorithmSharedValueCache();
+
+	int64_t GetOrCalculate(const ITransactionAlgorithm& algorithm);
+
+	void Clear();
+
+	/**
+	 * @brief Gets the number of algorithm instances that were evaluated since the cache was cleared.
+	 */
+	size_t GetEvaluationCount() const;
+
+private:
+	std::unordered_map<const ITransactionAlgorithm*, int64_t> values;
+};
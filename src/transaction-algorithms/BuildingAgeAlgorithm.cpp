@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "BuildingAgeAlgorithm.h"
+#include "cIGZIStream.h"
+#include "cIGZOStream.h"
+
+BuildingAgeAlgorithm::BuildingAgeAlgorithm()
+	: ageFactor(),
+	  maxAge(0)
+{
+}
+
+BuildingAgeAlgorithm::BuildingAgeAlgorithm(AlgorithmFactor ageFactor, uint32_t maxAge)
+	: ageFactor(ageFactor),
+	  maxAge(maxAge)
+{
+}
+
+TransactionAlgorithmType BuildingAgeAlgorithm::GetAlgorithmType() const
+{
+	return TransactionAlgorithmType::BuildingAge;
+}
+
+int64_t BuildingAgeAlgorithm::CalculateSharedValue() const
+{
+	// The cost only depends on the line item's buildings.
+	return 0;
+}
+
+int64_t BuildingAgeAlgorithm::Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const
+{
+	// The LineItemTransaction adds the age cost using the building ages that it tracks.
+	return initialTotal;
+}
+
+uint64_t BuildingAgeAlgorithm::GetParameterHash() const
+{
+	return (ageFactor.GetHash() * 31) + maxAge;
+}
+
+bool BuildingAgeAlgorithm::HasSameParameters(const ITransactionAlgorithm& other) const
+{
+	if (other.GetAlgorithmType() != GetAlgorithmType())
+	{
+		return false;
+	}
+
+	const BuildingAgeAlgorithm& otherAlgorithm = static_cast<const BuildingAgeAlgorithm&>(other);
+
+	return otherAlgorithm.ageFactor == ageFactor && otherAlgorithm.maxAge == maxAge;
+}
+
+bool BuildingAgeAlgorithm::Read(cIGZIStream& stream, uint32_t transactionVersion)
+{
+	return ageFactor.Read(stream, transactionVersion < 2)
+		&& stream.GetUint32(maxAge)
+		&& maxAge <= MaxAgeLimit;
+}
+
+bool BuildingAgeAlgorithm::Write(cIGZOStream& stream) const
+{
+	return ageFactor.Write(stream) && stream.SetUint32(maxAge);
+}
+
+uint32_t BuildingAgeAlgorithm::GetMaxAge() const
+{
+	return maxAge;
+}
+
+int64_t BuildingAgeAlgorithm::CalculateAgeCost(int64_t ageTotal) const
+{
+	return ageFactor.Multiply(ageTotal);
+}
@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "AlgorithmFactor.h"
+#include "ITransactionAlgorithm.h"
+
+/**
+ * @brief Varies the line item cost based on the age of each building that uses it.
+ *
+ * The building ages are tracked by the LineItemTransaction, because the algorithm
+ * instance is shared by all of the line items that use the same parameters.
+ */
+class BuildingAgeAlgorithm : public ITransactionAlgorithm
+{
+public:
+	static constexpr uint32_t MaxAgeLimit = 1200;
+
+	BuildingAgeAlgorithm();
+	BuildingAgeAlgorithm(AlgorithmFactor ageFactor, uint32_t maxAge);
+
+	TransactionAlgorithmType GetAlgorithmType() const override;
+
+	int64_t CalculateSharedValue() const override;
+	int64_t Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const override;
+
+	uint64_t GetParameterHash() const override;
+	bool HasSameParameters(const ITransactionAlgorithm& other) const override;
+
+	bool Read(cIGZIStream& stream, uint32_t transactionVersion) override;
+	bool Write(cIGZOStream& stream) const override;
+
+	/**
+	 * @brief Gets the age in months after which a building's cost stops changing.
+	 */
+	uint32_t GetMaxAge() const;
+
+	/**
+	 * @brief Calculates the variable expense/income for the buildings.
+	 * @param ageTotal The sum of the building ages in months, each limited to the maximum age.
+	 * @return The variable expense/income.
+	 */
+	int64_t CalculateAgeCost(int64_t ageTotal) const;
+
+private:
+	AlgorithmFactor ageFactor;
+	uint32_t maxAge;
+};
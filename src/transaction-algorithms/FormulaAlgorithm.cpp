@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "FormulaAlgorithm.h"
+#include "FormulaProgramCache.h"
+#include "cIGZIStream.h"
+#include "cIGZOStream.h"
+#include "TransactionAlgorithmStaticPointers.h"
+#include <utility>
+
+FormulaAlgorithm::FormulaAlgorithm()
+	: program()
+{
+}
+
+FormulaAlgorithm::FormulaAlgorithm(std::shared_ptr<const FormulaProgram> program)
+	: program(std::move(program))
+{
+}
+
+TransactionAlgorithmType FormulaAlgorithm::GetAlgorithmType() const
+{
+	return TransactionAlgorithmType::Formula;
+}
+
+int64_t FormulaAlgorithm::CalculateSharedValue() const
+{
+	int64_t sharedValue = 0;
+
+	// Formulas that only use the city/region inputs have the same result for every line item.
+	if (program && spPopulationProvider && (program->GetUsedInputs() & LineItemAlgorithmInputs) == 0)
+	{
+		sharedValue = Evaluate(0, 0);
+	}
+
+	return sharedValue;
+}
+
+int64_t FormulaAlgorithm::Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const
+{
+	// The formula result replaces the fixed cost, the formula can
+	// use the fixedCost input to include it.
+	int64_t newTotal = initialTotal;
+
+	if (program && spPopulationProvider)
+	{
+		if ((program->GetUsedInputs() & LineItemAlgorithmInputs) != 0)
+		{
+			newTotal = Evaluate(initialTotal, buildingCount);
+		}
+		else
+		{
+			newTotal = sharedValue;
+		}
+	}
+
+	return newTotal;
+}
+
+uint64_t FormulaAlgorithm::GetParameterHash() const
+{
+	// The programs are shared by the FormulaProgramCache, so the
+	// algorithms that use the same expression have the same program.
+	return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(program.get()));
+}
+
+bool FormulaAlgorithm::HasSameParameters(const ITransactionAlgorithm& other) const
+{
+	return other.GetAlgorithmType() == GetAlgorithmType()
+		&& static_cast<const FormulaAlgorithm&>(other).program == program;
+}
+
+bool FormulaAlgorithm::Read(cIGZIStream& stream, uint32_t transactionVersion)
+{
+	program = FormulaProgramCache::Read(stream);
+
+	return program != nullptr;
+}
+
+bool FormulaAlgorithm::Write(cIGZOStream& stream) const
+{
+	return program && program->Write(stream);
+}
+
+int64_t FormulaAlgorithm::Evaluate(int64_t initialTotal, int64_t buildingCount) const
+{
+	const uint32_t usedInputs = program->GetUsedInputs();
+
+	// Only the input values that the formula uses are queried.
+	AlgorithmInputs inputs{};
+
+	for (size_t i = 0; i < AlgorithmInputCount; i++)
+	{
+		if ((usedInputs & (1U << i)) != 0)
+		{
+			inputs[i] = GetAlgorithmInputValue(static_cast<AlgorithmInput>(i), initialTotal, buildingCount);
+		}
+	}
+
+	return program->Evaluate(inputs);
+}
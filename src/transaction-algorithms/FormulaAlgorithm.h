@@ -0,0 +1,41 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "FormulaProgram.h"
+#include "ITransactionAlgorithm.h"
+#include <memory>
+
+class FormulaAlgorithm : public ITransactionAlgorithm
+{
+public:
+	FormulaAlgorithm();
+	FormulaAlgorithm(std::shared_ptr<const FormulaProgram> program);
+
+	TransactionAlgorithmType GetAlgorithmType() const override;
+
+	int64_t CalculateSharedValue() const override;
+	int64_t Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const override;
+
+	uint64_t GetParameterHash() const override;
+	bool HasSameParameters(const ITransactionAlgorithm& other) const override;
+
+	bool Read(cIGZIStream& stream, uint32_t transactionVersion) override;
+	bool Write(cIGZOStream& stream) const override;
+
+private:
+	int64_t Evaluate(int64_t initialTotal, int64_t buildingCount) const;
+
+	std::shared_ptr<const FormulaProgram> program;
+};
+
@@ -0,0 +1,633 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "FormulaCompiler.h"
+#include <array>
+#include <cctype>
+#include <cstdio>
+
+namespace
+{
+	struct InputName
+	{
+		const char* name;
+		AlgorithmInput input;
+	};
+
+	static constexpr std::array<InputName, AlgorithmInputCount> InputNames =
+	{
+		InputName{ "buildingCount", AlgorithmInput::BuildingCount },
+		InputName{ "fixedCost", AlgorithmInput::FixedCost },
+		InputName{ "cityPopulation", AlgorithmInput::CityPopulation },
+		InputName{ "cityLowWealthPopulation", AlgorithmInput::CityLowWealthPopulation },
+		InputName{ "cityMediumWealthPopulation", AlgorithmInput::CityMediumWealthPopulation },
+		InputName{ "cityHighWealthPopulation", AlgorithmInput::CityHighWealthPopulation },
+		InputName{ "regionPopulation", AlgorithmInput::RegionPopulation },
+		InputName{ "regionLowWealthPopulation", AlgorithmInput::RegionLowWealthPopulation },
+		InputName{ "regionMediumWealthPopulation", AlgorithmInput::RegionMediumWealthPopulation },
+		InputName{ "regionHighWealthPopulation", AlgorithmInput::RegionHighWealthPopulation },
+		InputName{ "regionCustomBudgetExpenses", AlgorithmInput::RegionCustomBudgetExpenses },
+		InputName{ "regionCustomBudgetIncome", AlgorithmInput::RegionCustomBudgetIncome },
+	};
+
+	// Limits the parser recursion for deeply nested expressions.
+	static constexpr uint32_t MaxNestingDepth = 32;
+
+	enum class NodeType : uint8_t
+	{
+		Constant,
+		Input,
+		Operation
+	};
+
+	struct Node
+	{
+		NodeType type;
+		FormulaOpCode opCode;
+		int64_t value;
+		size_t left;
+		size_t right;
+	};
+
+	// A recursive descent parser that builds the expression tree, constant sub-expressions
+	// are folded as the tree is built.
+	//
+	// expression = term { ("+" | "-") term }
+	// term       = unary { ("*" | "/" | "%") unary }
+	// unary      = "-" unary | primary
+	// primary    = number | input | ("min" | "max") "(" expression "," expression ")" | "(" expression ")"
+	class FormulaParser
+	{
+	public:
+		FormulaParser(std::string_view expression)
+			: expression(expression),
+			  position(0),
+			  depth(0),
+			  nodes(),
+			  errorMessage()
+		{
+		}
+
+		bool Parse(size_t& root)
+		{
+			if (!ParseExpression(root))
+			{
+				return false;
+			}
+
+			SkipWhitespace();
+
+			if (position != expression.size())
+			{
+				return SetError("Unexpected character");
+			}
+
+			return true;
+		}
+
+		const std::vector<Node>& GetNodes() const
+		{
+			return nodes;
+		}
+
+		const std::string& GetErrorMessage() const
+		{
+			return errorMessage;
+		}
+
+	private:
+		bool SetError(const char* message)
+		{
+			if (errorMessage.empty())
+			{
+				char buffer[128]{};
+				std::snprintf(buffer, sizeof(buffer), "%s at position %zu.", message, position);
+
+				errorMessage = buffer;
+			}
+
+			return false;
+		}
+
+		void SkipWhitespace()
+		{
+			while (position < expression.size() && std::isspace(static_cast<unsigned char>(expression[position])))
+			{
+				position++;
+			}
+		}
+
+		bool Match(char c)
+		{
+			SkipWhitespace();
+
+			if (position < expression.size() && expression[position] == c)
+			{
+				position++;
+				return true;
+			}
+
+			return false;
+		}
+
+		size_t AddConstant(int64_t value)
+		{
+			nodes.push_back(Node{ NodeType::Constant, FormulaOpCode::Add, value, 0, 0 });
+			return nodes.size() - 1;
+		}
+
+		size_t AddOperation(FormulaOpCode opCode, size_t left, size_t right)
+		{
+			const Node& leftNode = nodes[left];
+			const Node& rightNode = nodes[right];
+
+			if (leftNode.type == NodeType::Constant && rightNode.type == NodeType::Constant)
+			{
+				return AddConstant(FormulaProgram::ExecuteOperation(opCode, leftNode.value, rightNode.value));
+			}
+
+			// Remove the operations that do not change the other operand.
+			if (rightNode.type == NodeType::Constant)
+			{
+				const int64_t value = rightNode.value;
+
+				if ((value == 0 && (opCode == FormulaOpCode::Add || opCode == FormulaOpCode::Subtract))
+					|| (value == 1 && (opCode == FormulaOpCode::Multiply || opCode == FormulaOpCode::Divide)))
+				{
+					return left;
+				}
+			}
+			else if (leftNode.type == NodeType::Constant)
+			{
+				const int64_t value = leftNode.value;
+
+				if ((value == 0 && opCode == FormulaOpCode::Add)
+					|| (value == 1 && opCode == FormulaOpCode::Multiply))
+				{
+					return right;
+				}
+			}
+
+			nodes.push_back(Node{ NodeType::Operation, opCode, 0, left, right });
+			return nodes.size() - 1;
+		}
+
+		bool ParseExpression(size_t& result)
+		{
+			if (++depth > MaxNestingDepth)
+			{
+				return SetError("The expression is nested too deeply");
+			}
+
+			if (!ParseTerm(result))
+			{
+				return false;
+			}
+
+			while (true)
+			{
+				FormulaOpCode opCode;
+
+				if (Match('+'))
+				{
+					opCode = FormulaOpCode::Add;
+				}
+				else if (Match('-'))
+				{
+					opCode = FormulaOpCode::Subtract;
+				}
+				else
+				{
+					break;
+				}
+
+				size_t right = 0;
+
+				if (!ParseTerm(right))
+				{
+					return false;
+				}
+
+				result = AddOperation(opCode, result, right);
+			}
+
+			depth--;
+			return true;
+		}
+
+		bool ParseTerm(size_t& result)
+		{
+			if (!ParseUnary(result))
+			{
+				return false;
+			}
+
+			while (true)
+			{
+				FormulaOpCode opCode;
+
+				if (Match('*'))
+				{
+					opCode = FormulaOpCode::Multiply;
+				}
+				else if (Match('/'))
+				{
+					opCode = FormulaOpCode::Divide;
+				}
+				else if (Match('%'))
+				{
+					opCode = FormulaOpCode::Remainder;
+				}
+				else
+				{
+					break;
+				}
+
+				size_t right = 0;
+
+				if (!ParseUnary(right))
+				{
+					return false;
+				}
+
+				result = AddOperation(opCode, result, right);
+			}
+
+			return true;
+		}
+
+		bool ParseUnary(size_t& result)
+		{
+			if (Match('-'))
+			{
+				if (++depth > MaxNestingDepth)
+				{
+					return SetError("The expression is nested too deeply");
+				}
+
+				size_t operand = 0;
+
+				if (!ParseUnary(operand))
+				{
+					return false;
+				}
+
+				depth--;
+
+				// The operand is also used as the right value, Negate ignores it.
+				result = AddOperation(FormulaOpCode::Negate, operand, operand);
+				return true;
+			}
+
+			return ParsePrimary(result);
+		}
+
+		bool ParsePrimary(size_t& result)
+		{
+			SkipWhitespace();
+
+			if (position >= expression.size())
+			{
+				return SetError("Unexpected end of expression");
+			}
+
+			const char c = expression[position];
+
+			if (std::isdigit(static_cast<unsigned char>(c)))
+			{
+				return ParseNumber(result);
+			}
+			else if (std::isalpha(static_cast<unsigned char>(c)))
+			{
+				return ParseIdentifier(result);
+			}
+			else if (Match('('))
+			{
+				if (!ParseExpression(result))
+				{
+					return false;
+				}
+
+				if (!Match(')'))
+				{
+					return SetError("Expected ')'");
+				}
+
+				return true;
+			}
+
+			return SetError("Unexpected character");
+		}
+
+		bool ParseNumber(size_t& result)
+		{
+			uint64_t base = 10;
+
+			if (expression.size() - position > 2
+				&& expression[position] == '0'
+				&& (expression[position + 1] == 'x' || expression[position + 1] == 'X'))
+			{
+				base = 16;
+				position += 2;
+			}
+
+			const size_t start = position;
+			uint64_t value = 0;
+
+			while (position < expression.size())
+			{
+				const char c = expression[position];
+				uint64_t digit = 0;
+
+				if (c >= '0' && c <= '9')
+				{
+					digit = static_cast<uint64_t>(c - '0');
+				}
+				else if (base == 16 && c >= 'a' && c <= 'f')
+				{
+					digit = static_cast<uint64_t>(c - 'a') + 10;
+				}
+				else if (base == 16 && c >= 'A' && c <= 'F')
+				{
+					digit = static_cast<uint64_t>(c - 'A') + 10;
+				}
+				else
+				{
+					break;
+				}
+
+				if (value > (static_cast<uint64_t>(INT64_MAX) - digit) / base)
+				{
+					return SetError("The number is outside the range of a Sint64 value");
+				}
+
+				value = (value * base) + digit;
+				position++;
+			}
+
+			if (position == start)
+			{
+				return SetError("Expected a number");
+			}
+
+			result = AddConstant(static_cast<int64_t>(value));
+			return true;
+		}
+
+		bool ParseIdentifier(size_t& result)
+		{
+			const size_t start = position;
+
+			while (position < expression.size() && std::isalnum(static_cast<unsigned char>(expression[position])))
+			{
+				position++;
+			}
+
+			const std::string_view name = expression.substr(start, position - start);
+
+			if (name == "min" || name == "max")
+			{
+				const FormulaOpCode opCode = name == "min" ? FormulaOpCode::Min : FormulaOpCode::Max;
+
+				size_t left = 0;
+				size_t right = 0;
+
+				if (!Match('('))
+				{
+					return SetError("Expected '('");
+				}
+
+				if (!ParseExpression(left))
+				{
+					return false;
+				}
+
+				if (!Match(','))
+				{
+					return SetError("Expected ','");
+				}
+
+				if (!ParseExpression(right))
+				{
+					return false;
+				}
+
+				if (!Match(')'))
+				{
+					return SetError("Expected ')'");
+				}
+
+				result = AddOperation(opCode, left, right);
+				return true;
+			}
+
+			for (const InputName& item : InputNames)
+			{
+				if (name == item.name)
+				{
+					nodes.push_back(Node{ NodeType::Input, FormulaOpCode::Add, static_cast<int64_t>(item.input), 0, 0 });
+					result = nodes.size() - 1;
+					return true;
+				}
+			}
+
+			position = start;
+			return SetError("Unknown identifier");
+		}
+
+		std::string_view expression;
+		size_t position;
+		uint32_t depth;
+		std::vector<Node> nodes;
+		std::string errorMessage;
+	};
+
+	// Assigns the registers and emits the instructions for the folded expression tree.
+	// The temporary registers are allocated as a stack, the operands of an operation
+	// are released before its result register is allocated.
+	class FormulaCodeGenerator
+	{
+	public:
+		FormulaCodeGenerator(const std::vector<Node>& nodes)
+			: nodes(nodes),
+			  constants(),
+			  instructions(),
+			  nextTemporaryRegister(0)
+		{
+		}
+
+		bool Generate(size_t root, uint8_t& resultRegister, std::string& errorMessage)
+		{
+			// The constant registers follow the input registers, so they must be
+			// collected before the temporary registers can be assigned.
+			CollectConstants(root);
+
+			if (AlgorithmInputCount + constants.size() > FormulaProgram::MaxRegisterCount)
+			{
+				errorMessage = "The expression has too many constants.";
+				return false;
+			}
+
+			nextTemporaryRegister = AlgorithmInputCount + constants.size();
+
+			if (!Emit(root, resultRegister))
+			{
+				errorMessage = "The expression is too complex.";
+				return false;
+			}
+
+			return true;
+		}
+
+		std::vector<int64_t>& GetConstants()
+		{
+			return constants;
+		}
+
+		std::vector<FormulaInstruction>& GetInstructions()
+		{
+			return instructions;
+		}
+
+	private:
+		void CollectConstants(size_t index)
+		{
+			const Node& node = nodes[index];
+
+			if (node.type == NodeType::Constant)
+			{
+				GetConstantRegister(node.value);
+			}
+			else if (node.type == NodeType::Operation)
+			{
+				CollectConstants(node.left);
+				CollectConstants(node.right);
+			}
+		}
+
+		size_t GetConstantRegister(int64_t value)
+		{
+			for (size_t i = 0; i < constants.size(); i++)
+			{
+				if (constants[i] == value)
+				{
+					return AlgorithmInputCount + i;
+				}
+			}
+
+			constants.push_back(value);
+			return AlgorithmInputCount + constants.size() - 1;
+		}
+
+		bool IsTemporaryRegister(uint8_t reg) const
+		{
+			return reg >= AlgorithmInputCount + constants.size();
+		}
+
+		bool Emit(size_t index, uint8_t& resultRegister)
+		{
+			const Node& node = nodes[index];
+
+			switch (node.type)
+			{
+			case NodeType::Constant:
+				resultRegister = static_cast<uint8_t>(GetConstantRegister(node.value));
+				return true;
+			case NodeType::Input:
+				resultRegister = static_cast<uint8_t>(node.value);
+				return true;
+			case NodeType::Operation:
+			default:
+				break;
+			}
+
+			uint8_t left = 0;
+			uint8_t right = 0;
+
+			if (!Emit(node.left, left))
+			{
+				return false;
+			}
+
+			if (node.opCode == FormulaOpCode::Negate)
+			{
+				right = left;
+			}
+			else if (!Emit(node.right, right))
+			{
+				return false;
+			}
+
+			// The right operand was allocated last, so it is released first.
+			if (node.opCode != FormulaOpCode::Negate && IsTemporaryRegister(right))
+			{
+				nextTemporaryRegister--;
+			}
+
+			if (IsTemporaryRegister(left))
+			{
+				nextTemporaryRegister--;
+			}
+
+			if (nextTemporaryRegister >= FormulaProgram::MaxRegisterCount
+				|| instructions.size() >= FormulaProgram::MaxInstructionCount)
+			{
+				return false;
+			}
+
+			resultRegister = static_cast<uint8_t>(nextTemporaryRegister++);
+			instructions.push_back(FormulaInstruction{ node.opCode, resultRegister, left, right });
+
+			return true;
+		}
+
+		const std::vector<Node>& nodes;
+		std::vector<int64_t> constants;
+		std::vector<FormulaInstruction> instructions;
+		size_t nextTemporaryRegister;
+	};
+}
+
+bool FormulaCompiler::Compile(std::string_view expression, FormulaProgram& program, std::string& errorMessage)
+{
+	if (expression.empty() || expression.size() > FormulaProgram::MaxExpressionLength)
+	{
+		errorMessage = "The expression length must be in the range of 1 to 4096 characters.";
+		return false;
+	}
+
+	FormulaParser parser(expression);
+	size_t root = 0;
+
+	if (!parser.Parse(root))
+	{
+		errorMessage = parser.GetErrorMessage();
+		return false;
+	}
+
+	FormulaCodeGenerator generator(parser.GetNodes());
+	uint8_t resultRegister = 0;
+
+	if (!generator.Generate(root, resultRegister, errorMessage))
+	{
+		return false;
+	}
+
+	program = FormulaProgram(
+		std::string(expression),
+		std::move(generator.GetConstants()),
+		std::move(generator.GetInstructions()),
+		resultRegister);
+
+	return program.IsValid();
+}
@@ -0,0 +1,29 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "FormulaProgram.h"
+#include <string>
+#include <string_view>
+
+namespace FormulaCompiler
+{
+	/**
+	 * @brief Parses the expression, folds the constant sub-expressions and compiles it to a FormulaProgram.
+	 * @param expression The expression.
+	 * @param program Receives the compiled program.
+	 * @param errorMessage Receives the error message if the expression is not valid.
+	 * @return True on success; otherwise, false.
+	 */
+	bool Compile(std::string_view expression, FormulaProgram& program, std::string& errorMessage);
+}
@@ -0,0 +1,350 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "FormulaProgram.h"
+#include "cIGZIStream.h"
+#include "cIGZOStream.h"
+#include <algorithm>
+#include <bitset>
+#include <utility>
+
+namespace
+{
+	// The arithmetic is performed on unsigned values so that overflow wraps
+	// around instead of being undefined behavior.
+
+	int64_t WrappingAdd(int64_t left, int64_t right)
+	{
+		return static_cast<int64_t>(static_cast<uint64_t>(left) + static_cast<uint64_t>(right));
+	}
+
+	int64_t WrappingSubtract(int64_t left, int64_t right)
+	{
+		return static_cast<int64_t>(static_cast<uint64_t>(left) - static_cast<uint64_t>(right));
+	}
+
+	int64_t WrappingMultiply(int64_t left, int64_t right)
+	{
+		return static_cast<int64_t>(static_cast<uint64_t>(left) * static_cast<uint64_t>(right));
+	}
+
+	int64_t WrappingNegate(int64_t value)
+	{
+		return static_cast<int64_t>(0 - static_cast<uint64_t>(value));
+	}
+
+	int64_t SafeDivide(int64_t left, int64_t right)
+	{
+		if (right == 0)
+		{
+			return 0;
+		}
+		else if (right == -1)
+		{
+			// INT64_MIN / -1 overflows.
+			return WrappingNegate(left);
+		}
+
+		return left / right;
+	}
+
+	int64_t SafeRemainder(int64_t left, int64_t right)
+	{
+		if (right == 0 || right == -1)
+		{
+			return 0;
+		}
+
+		return left % right;
+	}
+
+	uint32_t EncodeInstruction(const FormulaInstruction& instruction)
+	{
+		return static_cast<uint32_t>(instruction.opCode)
+			| (static_cast<uint32_t>(instruction.destination) << 8)
+			| (static_cast<uint32_t>(instruction.left) << 16)
+			| (static_cast<uint32_t>(instruction.right) << 24);
+	}
+
+	FormulaInstruction DecodeInstruction(uint32_t value)
+	{
+		FormulaInstruction instruction{};
+		instruction.opCode = static_cast<FormulaOpCode>(value & 0xff);
+		instruction.destination = static_cast<uint8_t>((value >> 8) & 0xff);
+		instruction.left = static_cast<uint8_t>((value >> 16) & 0xff);
+		instruction.right = static_cast<uint8_t>((value >> 24) & 0xff);
+
+		return instruction;
+	}
+}
+
+FormulaProgram::FormulaProgram()
+	: expression(),
+	  constants(),
+	  instructions(),
+	  resultRegister(0),
+	  usedInputs(0)
+{
+}
+
+FormulaProgram::FormulaProgram(
+	std::string expression,
+	std::vector<int64_t> constants,
+	std::vector<FormulaInstruction> instructions,
+	uint8_t resultRegister)
+	: expression(std::move(expression)),
+	  constants(std::move(constants)),
+	  instructions(std::move(instructions)),
+	  resultRegister(resultRegister),
+	  usedInputs(0)
+{
+	UpdateUsedInputs();
+}
+
+const std::string& FormulaProgram::GetExpression() const
+{
+	return expression;
+}
+
+uint32_t FormulaProgram::GetUsedInputs() const
+{
+	return usedInputs;
+}
+
+int64_t FormulaProgram::Evaluate(const AlgorithmInputs& inputs) const
+{
+	int64_t registers[MaxRegisterCount];
+
+	std::copy(inputs.begin(), inputs.end(), registers);
+	std::copy(constants.begin(), constants.end(), registers + AlgorithmInputCount);
+
+	for (const FormulaInstruction& instruction : instructions)
+	{
+		const int64_t left = registers[instruction.left];
+		const int64_t right = registers[instruction.right];
+
+		registers[instruction.destination] = ExecuteOperation(instruction.opCode, left, right);
+	}
+
+	return registers[resultRegister];
+}
+
+int64_t FormulaProgram::ExecuteOperation(FormulaOpCode opCode, int64_t left, int64_t right)
+{
+	switch (opCode)
+	{
+	case FormulaOpCode::Add:
+		return WrappingAdd(left, right);
+	case FormulaOpCode::Subtract:
+		return WrappingSubtract(left, right);
+	case FormulaOpCode::Multiply:
+		return WrappingMultiply(left, right);
+	case FormulaOpCode::Divide:
+		return SafeDivide(left, right);
+	case FormulaOpCode::Remainder:
+		return SafeRemainder(left, right);
+	case FormulaOpCode::Negate:
+		return WrappingNegate(left);
+	case FormulaOpCode::Min:
+		return std::min(left, right);
+	case FormulaOpCode::Max:
+		return std::max(left, right);
+	default:
+		return 0;
+	}
+}
+
+bool FormulaProgram::IsValid() const
+{
+	const size_t fixedRegisterCount = AlgorithmInputCount + constants.size();
+
+	if (fixedRegisterCount > MaxRegisterCount || instructions.size() > MaxInstructionCount)
+	{
+		return false;
+	}
+
+	// The input and constant registers are initialized before the program runs,
+	// the temporary registers must be written before they are read.
+	std::bitset<MaxRegisterCount> initialized;
+
+	for (size_t i = 0; i < fixedRegisterCount; i++)
+	{
+		initialized.set(i);
+	}
+
+	for (const FormulaInstruction& instruction : instructions)
+	{
+		if (instruction.opCode >= FormulaOpCode::Count
+			|| instruction.destination < fixedRegisterCount
+			|| instruction.destination >= MaxRegisterCount
+			|| instruction.left >= MaxRegisterCount
+			|| instruction.right >= MaxRegisterCount
+			|| !initialized.test(instruction.left)
+			|| !initialized.test(instruction.right))
+		{
+			return false;
+		}
+
+		initialized.set(instruction.destination);
+	}
+
+	return resultRegister < MaxRegisterCount && initialized.test(resultRegister);
+}
+
+bool FormulaProgram::ReadHeader(
+	cIGZIStream& stream,
+	uint32_t& bytecodeVersion,
+	std::string& expression,
+	uint32_t& bytecodeSize)
+{
+	uint32_t expressionLength = 0;
+
+	if (!stream.GetUint32(bytecodeVersion)
+		|| !stream.GetUint32(expressionLength)
+		|| expressionLength == 0
+		|| expressionLength > MaxExpressionLength)
+	{
+		return false;
+	}
+
+	expression.resize(expressionLength);
+
+	return stream.GetVoid(expression.data(), expressionLength)
+		&& stream.GetUint32(bytecodeSize);
+}
+
+bool FormulaProgram::ReadBytecode(cIGZIStream& stream, std::string expression)
+{
+	uint32_t constantCount = 0;
+
+	if (!stream.GetUint32(constantCount) || constantCount > (MaxRegisterCount - AlgorithmInputCount))
+	{
+		return false;
+	}
+
+	std::vector<int64_t> newConstants(constantCount);
+
+	for (int64_t& constant : newConstants)
+	{
+		if (!stream.GetSint64(constant))
+		{
+			return false;
+		}
+	}
+
+	uint32_t instructionCount = 0;
+
+	if (!stream.GetUint32(instructionCount) || instructionCount > MaxInstructionCount)
+	{
+		return false;
+	}
+
+	std::vector<FormulaInstruction> newInstructions;
+	newInstructions.reserve(instructionCount);
+
+	for (uint32_t i = 0; i < instructionCount; i++)
+	{
+		uint32_t value = 0;
+
+		if (!stream.GetUint32(value))
+		{
+			return false;
+		}
+
+		newInstructions.push_back(DecodeInstruction(value));
+	}
+
+	uint32_t newResultRegister = 0;
+
+	if (!stream.GetUint32(newResultRegister) || newResultRegister >= MaxRegisterCount)
+	{
+		return false;
+	}
+
+	*this = FormulaProgram(
+		std::move(expression),
+		std::move(newConstants),
+		std::move(newInstructions),
+		static_cast<uint8_t>(newResultRegister));
+
+	return IsValid();
+}
+
+bool FormulaProgram::Write(cIGZOStream& stream) const
+{
+	const uint32_t bytecodeSize = static_cast<uint32_t>(
+		sizeof(uint32_t) + (constants.size() * sizeof(int64_t))
+		+ sizeof(uint32_t) + (instructions.size() * sizeof(uint32_t))
+		+ sizeof(uint32_t));
+
+	if (!stream.SetUint32(BytecodeVersion)
+		|| !stream.SetUint32(static_cast<uint32_t>(expression.size()))
+		|| !stream.SetVoid(expression.data(), static_cast<uint32_t>(expression.size()))
+		|| !stream.SetUint32(bytecodeSize))
+	{
+		return false;
+	}
+
+	if (!stream.SetUint32(static_cast<uint32_t>(constants.size())))
+	{
+		return false;
+	}
+
+	for (int64_t constant : constants)
+	{
+		if (!stream.SetSint64(constant))
+		{
+			return false;
+		}
+	}
+
+	if (!stream.SetUint32(static_cast<uint32_t>(instructions.size())))
+	{
+		return false;
+	}
+
+	for (const FormulaInstruction& instruction : instructions)
+	{
+		if (!stream.SetUint32(EncodeInstruction(instruction)))
+		{
+			return false;
+		}
+	}
+
+	return stream.SetUint32(resultRegister);
+}
+
+void FormulaProgram::UpdateUsedInputs()
+{
+	usedInputs = 0;
+
+	auto markInput = [this](uint8_t reg)
+	{
+		if (reg < AlgorithmInputCount)
+		{
+			usedInputs |= 1U << reg;
+		}
+	};
+
+	for (const FormulaInstruction& instruction : instructions)
+	{
+		markInput(instruction.left);
+
+		if (instruction.opCode != FormulaOpCode::Negate)
+		{
+			markInput(instruction.right);
+		}
+	}
+
+	markInput(resultRegister);
+}
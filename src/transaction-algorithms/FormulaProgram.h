@@ -0,0 +1,114 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "AlgorithmInput.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class cIGZIStream;
+class cIGZOStream;
+
+enum class FormulaOpCode : uint8_t
+{
+	Add = 0,
+	Subtract,
+	Multiply,
+	Divide,
+	Remainder,
+	Negate,
+	Min,
+	Max,
+	Count
+};
+
+struct FormulaInstruction
+{
+	FormulaOpCode opCode;
+	uint8_t destination;
+	uint8_t left;
+	uint8_t right;
+};
+
+/**
+ * @brief A compiled Formula algorithm expression.
+ *
+ * The program uses a fixed register file, the first registers hold the AlgorithmInput values
+ * and are followed by the constants and the temporary values. Each instruction reads its operands
+ * from two registers and writes the result to a third, so the evaluation does not allocate.
+ * All arithmetic is performed on int64_t values, overflow wraps around and division by zero produces zero.
+ */
+class FormulaProgram
+{
+public:
+	static constexpr size_t MaxRegisterCount = 64;
+	static constexpr size_t MaxInstructionCount = 256;
+	static constexpr size_t MaxExpressionLength = 4096;
+
+	FormulaProgram();
+	FormulaProgram(
+		std::string expression,
+		std::vector<int64_t> constants,
+		std::vector<FormulaInstruction> instructions,
+		uint8_t resultRegister);
+
+	const std::string& GetExpression() const;
+
+	/**
+	 * @brief Gets a bit mask of the AlgorithmInput values that the program reads.
+	 */
+	uint32_t GetUsedInputs() const;
+
+	int64_t Evaluate(const AlgorithmInputs& inputs) const;
+
+	/**
+	 * @brief Applies a single operation, the constant folding uses this to match the program results.
+	 */
+	static int64_t ExecuteOperation(FormulaOpCode opCode, int64_t left, int64_t right);
+
+	/**
+	 * @brief Checks that the program only reads registers that have been initialized.
+	 */
+	bool IsValid() const;
+
+	/**
+	 * @brief Reads the bytecode version and expression that precede the program bytecode.
+	 * @param stream The stream.
+	 * @param bytecodeVersion Receives the bytecode version.
+	 * @param expression Receives the expression.
+	 * @param bytecodeSize Receives the size of the bytecode that follows the header.
+	 * @return True on success; otherwise, false.
+	 */
+	static bool ReadHeader(
+		cIGZIStream& stream,
+		uint32_t& bytecodeVersion,
+		std::string& expression,
+		uint32_t& bytecodeSize);
+	bool ReadBytecode(cIGZIStream& stream, std::string expression);
+	bool Write(cIGZOStream& stream) const;
+
+	// Incremented when the instruction encoding changes, programs
+	// with a different version are recompiled from the expression.
+	// Version 2 added the region custom budget inputs, which moved the constant registers.
+	static constexpr uint32_t BytecodeVersion = 2;
+
+private:
+	void UpdateUsedInputs();
+
+	std::string expression;
+	std::vector<int64_t> constants;
+	std::vector<FormulaInstruction> instructions;
+	uint8_t resultRegister;
+	uint32_t usedInputs;
+};
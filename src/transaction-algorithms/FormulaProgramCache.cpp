@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "FormulaProgramCache.h"
+#include "FormulaCompiler.h"
+#include "cIGZIStream.h"
+#include <unordered_map>
+
+namespace
+{
+	uint64_t HashExpression(std::string_view expression)
+	{
+		// 64-bit FNV-1a
+		uint64_t hash = 0xcbf29ce484222325;
+
+		for (char c : expression)
+		{
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 0x100000001b3;
+		}
+
+		return hash;
+	}
+
+	std::unordered_map<uint64_t, std::shared_ptr<const FormulaProgram>>& GetPrograms()
+	{
+		static std::unordered_map<uint64_t, std::shared_ptr<const FormulaProgram>> programs;
+
+		return programs;
+	}
+
+	std::shared_ptr<const FormulaProgram> Find(uint64_t hash, std::string_view expression)
+	{
+		const auto& programs = GetPrograms();
+		const auto& item = programs.find(hash);
+
+		if (item != programs.end() && item->second->GetExpression() == expression)
+		{
+			return item->second;
+		}
+
+		return nullptr;
+	}
+
+	std::shared_ptr<const FormulaProgram> Insert(uint64_t hash, std::shared_ptr<const FormulaProgram> program)
+	{
+		// An expression whose hash collides with a cached expression is not cached,
+		// the line items that use it get their own copy of the program.
+		GetPrograms().try_emplace(hash, program);
+
+		return program;
+	}
+}
+
+std::shared_ptr<const FormulaProgram> FormulaProgramCache::GetOrCompile(std::string_view expression, std::string& errorMessage)
+{
+	const uint64_t hash = HashExpression(expression);
+
+	std::shared_ptr<const FormulaProgram> program = Find(hash, expression);
+
+	if (!program)
+	{
+		std::shared_ptr<FormulaProgram> newProgram = std::make_shared<FormulaProgram>();
+
+		if (FormulaCompiler::Compile(expression, *newProgram, errorMessage))
+		{
+			program = Insert(hash, std::move(newProgram));
+		}
+	}
+
+	return program;
+}
+
+std::shared_ptr<const FormulaProgram> FormulaProgramCache::Read(cIGZIStream& stream)
+{
+	uint32_t bytecodeVersion = 0;
+	std::string expression;
+	uint32_t bytecodeSize = 0;
+
+	if (!FormulaProgram::ReadHeader(stream, bytecodeVersion, expression, bytecodeSize))
+	{
+		return nullptr;
+	}
+
+	const uint64_t hash = HashExpression(expression);
+
+	std::shared_ptr<const FormulaProgram> program = Find(hash, expression);
+
+	if (program)
+	{
+		return stream.Skip(bytecodeSize) ? program : nullptr;
+	}
+
+	if (bytecodeVersion != FormulaProgram::BytecodeVersion)
+	{
+		std::string errorMessage;
+
+		return stream.Skip(bytecodeSize) ? GetOrCompile(expression, errorMessage) : nullptr;
+	}
+
+	std::shared_ptr<FormulaProgram> newProgram = std::make_shared<FormulaProgram>();
+
+	if (!newProgram->ReadBytecode(stream, std::move(expression)))
+	{
+		return nullptr;
+	}
+
+	return Insert(hash, std::move(newProgram));
+}
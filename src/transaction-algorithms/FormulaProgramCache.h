@@ -0,0 +1,48 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "FormulaProgram.h"
+#include <memory>
+#include <string>
+#include <string_view>
+
+class cIGZIStream;
+
+/**
+ * @brief Shares the compiled Formula programs between the line items that use the same expression.
+ *
+ * The programs are keyed by a hash of the expression text, so each expression is only parsed
+ * and compiled once no matter how many building types or save game records use it.
+ */
+namespace FormulaProgramCache
+{
+	/**
+	 * @brief Gets the cached program for the expression, compiling it if necessary.
+	 * @param expression The expression.
+	 * @param errorMessage Receives the error message if the expression is not valid.
+	 * @return The program, or nullptr if the expression is not valid.
+	 */
+	std::shared_ptr<const FormulaProgram> GetOrCompile(std::string_view expression, std::string& errorMessage);
+
+	/**
+	 * @brief Reads a program that was written by FormulaProgram::Write.
+	 *
+	 * If the expression is already cached or the bytecode was written by a different
+	 * plugin version, the bytecode is skipped and the cached or recompiled program is used.
+	 *
+	 * @param stream The stream.
+	 * @return The program, or nullptr if the data is not valid.
+	 */
+	std::shared_ptr<const FormulaProgram> Read(cIGZIStream& stream);
+}
@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "HistoryAlgorithm.h"
+#include "cIGZIStream.h"
+#include "cIGZOStream.h"
+#include "TransactionAlgorithmStaticPointers.h"
+#include <cmath>
+
+namespace
+{
+	int64_t HistoryValueToInt64(float value)
+	{
+		// The value is limited to the range where every integer is exactly
+		// representable as a double, this also excludes NaN and infinity.
+		constexpr double MaxValue = 9007199254740992.0;
+
+		const double rounded = std::round(static_cast<double>(value));
+
+		if (!(rounded >= -MaxValue && rounded <= MaxValue))
+		{
+			return 0;
+		}
+
+		return static_cast<int64_t>(rounded);
+	}
+}
+
+HistoryAlgorithm::HistoryAlgorithm()
+	: historyType(0),
+	  monthCount(0),
+	  statistic(HistoryStatistic::Average),
+	  factor()
+{
+}
+
+HistoryAlgorithm::HistoryAlgorithm(
+	uint32_t historyType,
+	uint32_t monthCount,
+	HistoryStatistic statistic,
+	AlgorithmFactor factor)
+	: historyType(historyType),
+	  monthCount(monthCount),
+	  statistic(statistic),
+	  factor(factor)
+{
+}
+
+TransactionAlgorithmType HistoryAlgorithm::GetAlgorithmType() const
+{
+	return TransactionAlgorithmType::History;
+}
+
+int64_t HistoryAlgorithm::CalculateSharedValue() const
+{
+	int64_t variableTransaction = 0;
+
+	HistoryStatistics statistics{};
+
+	if (spHistoryProvider && spHistoryProvider->GetStatistics(historyType, monthCount, statistics))
+	{
+		float value = 0.0f;
+
+		switch (statistic)
+		{
+		case HistoryStatistic::Average:
+			value = statistics.average;
+			break;
+		case HistoryStatistic::Minimum:
+			value = statistics.minimum;
+			break;
+		case HistoryStatistic::Maximum:
+			value = statistics.maximum;
+			break;
+		case HistoryStatistic::TrendChange:
+			value = statistics.trendChange;
+			break;
+		default:
+			break;
+		}
+
+		variableTransaction = factor.Multiply(HistoryValueToInt64(value));
+	}
+
+	return variableTransaction;
+}
+
+int64_t HistoryAlgorithm::Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const
+{
+	return initialTotal + sharedValue;
+}
+
+uint64_t HistoryAlgorithm::GetParameterHash() const
+{
+	uint64_t hash = (static_cast<uint64_t>(historyType) << 32) | monthCount;
+	hash = (hash * 31) + static_cast<uint64_t>(statistic);
+	hash = (hash * 31) + factor.GetHash();
+
+	return hash;
+}
+
+bool HistoryAlgorithm::HasSameParameters(const ITransactionAlgorithm& other) const
+{
+	if (other.GetAlgorithmType() != GetAlgorithmType())
+	{
+		return false;
+	}
+
+	const HistoryAlgorithm& otherAlgorithm = static_cast<const HistoryAlgorithm&>(other);
+
+	return otherAlgorithm.historyType == historyType
+		&& otherAlgorithm.monthCount == monthCount
+		&& otherAlgorithm.statistic == statistic
+		&& otherAlgorithm.factor == factor;
+}
+
+bool HistoryAlgorithm::Read(cIGZIStream& stream, uint32_t transactionVersion)
+{
+	uint32_t statisticAsUInt32 = 0;
+
+	if (!stream.GetUint32(historyType)
+		|| !stream.GetUint32(monthCount)
+		|| !stream.GetUint32(statisticAsUInt32)
+		|| monthCount == 0
+		|| monthCount > MaxMonthCount
+		|| statisticAsUInt32 >= static_cast<uint32_t>(HistoryStatistic::Count))
+	{
+		return false;
+	}
+
+	statistic = static_cast<HistoryStatistic>(statisticAsUInt32);
+
+	return factor.Read(stream, transactionVersion < 2);
+}
+
+bool HistoryAlgorithm::Write(cIGZOStream& stream) const
+{
+	return stream.SetUint32(historyType)
+		&& stream.SetUint32(monthCount)
+		&& stream.SetUint32(static_cast<uint32_t>(statistic))
+		&& factor.Write(stream);
+}
@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "AlgorithmFactor.h"
+#include "ITransactionAlgorithm.h"
+
+enum class HistoryStatistic : uint32_t
+{
+	Average = 0,
+	Minimum = 1,
+	Maximum = 2,
+	// The change in the trend line value over the month range.
+	TrendChange = 3,
+	Count
+};
+
+class HistoryAlgorithm : public ITransactionAlgorithm
+{
+public:
+	static constexpr uint32_t MaxMonthCount = 240;
+
+	HistoryAlgorithm();
+	HistoryAlgorithm(
+		uint32_t historyType,
+		uint32_t monthCount,
+		HistoryStatistic statistic,
+		AlgorithmFactor factor);
+
+	TransactionAlgorithmType GetAlgorithmType() const override;
+
+	int64_t CalculateSharedValue() const override;
+	int64_t Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const override;
+
+	uint64_t GetParameterHash() const override;
+	bool HasSameParameters(const ITransactionAlgorithm& other) const override;
+
+	bool Read(cIGZIStream& stream, uint32_t transactionVersion) override;
+	bool Write(cIGZOStream& stream) const override;
+
+private:
+	uint32_t historyType;
+	uint32_t monthCount;
+	HistoryStatistic statistic;
+	AlgorithmFactor factor;
+};
@@ -20,15 +20,45 @@ class cIGZOStream;
 class ITransactionAlgorithm
 {
 public:
+	virtual ~ITransactionAlgorithm() = default;
+
 	virtual TransactionAlgorithmType GetAlgorithmType() const = 0;
 
+	/**
+	 * @brief Calculates the part of the line item total that only depends on the algorithm
+	 * parameters and the city/region state.
+	 *
+	 * The line items that use the same algorithm parameters share one algorithm instance,
+	 * so this value can be calculated once and used for all of them.
+	 * @return The shared value.
+	 */
+	virtual int64_t CalculateSharedValue() const = 0;
+
 	/**
 	 * @brief Calculates the line item's total income or expense.
 	 * @param initialTotal The initial total income or expense for the line item.
+	 * @param buildingCount The number of buildings that use the line item.
+	 * @param sharedValue The value returned by CalculateSharedValue.
 	 * @return The calculated total income or expense for the line item.
 	 */
-	virtual int64_t Calculate(int64_t initialTotal) = 0;
+	virtual int64_t Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const = 0;
+
+	/**
+	 * @brief Gets a hash of the algorithm parameters.
+	 */
+	virtual uint64_t GetParameterHash() const = 0;
+
+	/**
+	 * @brief Determines if the other algorithm has the same type and parameters.
+	 */
+	virtual bool HasSameParameters(const ITransactionAlgorithm& other) const = 0;
 
-	virtual bool Read(cIGZIStream& stream) = 0;
+	/**
+	 * @brief Reads the algorithm data.
+	 * @param stream The stream.
+	 * @param transactionVersion The LineItemTransaction data version.
+	 * @return True on success; otherwise, false.
+	 */
+	virtual bool Read(cIGZIStream& stream, uint32_t transactionVersion) = 0;
 	virtual bool Write(cIGZOStream& stream) const = 0;
 };
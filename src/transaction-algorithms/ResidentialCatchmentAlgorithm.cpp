@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "ResidentialCatchmentAlgorithm.h"
+#include "BuildingInstanceArray.h"
+#include "TransactionAlgorithmStaticPointers.h"
+#include "cIGZIStream.h"
+#include "cIGZOStream.h"
+
+static constexpr float CellSizeInMeters = 16.0f;
+
+ResidentialCatchmentAlgorithm::ResidentialCatchmentAlgorithm()
+	: populationFactor(),
+	  radius(0)
+{
+}
+
+ResidentialCatchmentAlgorithm::ResidentialCatchmentAlgorithm(AlgorithmFactor populationFactor, uint32_t radius)
+	: populationFactor(populationFactor),
+	  radius(radius)
+{
+}
+
+TransactionAlgorithmType ResidentialCatchmentAlgorithm::GetAlgorithmType() const
+{
+	return TransactionAlgorithmType::ResidentialCatchment;
+}
+
+int64_t ResidentialCatchmentAlgorithm::CalculateSharedValue() const
+{
+	// The cost only depends on the line item's buildings.
+	return 0;
+}
+
+int64_t ResidentialCatchmentAlgorithm::Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const
+{
+	// The LineItemTransaction adds the catchment cost using the building positions that it tracks.
+	return initialTotal;
+}
+
+uint64_t ResidentialCatchmentAlgorithm::GetParameterHash() const
+{
+	return (populationFactor.GetHash() * 31) + radius;
+}
+
+bool ResidentialCatchmentAlgorithm::HasSameParameters(const ITransactionAlgorithm& other) const
+{
+	if (other.GetAlgorithmType() != GetAlgorithmType())
+	{
+		return false;
+	}
+
+	const ResidentialCatchmentAlgorithm& otherAlgorithm = static_cast<const ResidentialCatchmentAlgorithm&>(other);
+
+	return otherAlgorithm.populationFactor == populationFactor && otherAlgorithm.radius == radius;
+}
+
+bool ResidentialCatchmentAlgorithm::Read(cIGZIStream& stream, uint32_t transactionVersion)
+{
+	return populationFactor.Read(stream, transactionVersion < 2)
+		&& stream.GetUint32(radius)
+		&& radius <= MaxRadius;
+}
+
+bool ResidentialCatchmentAlgorithm::Write(cIGZOStream& stream) const
+{
+	return populationFactor.Write(stream) && stream.SetUint32(radius);
+}
+
+int64_t ResidentialCatchmentAlgorithm::CalculateCatchmentCost(const BuildingInstanceArray& buildings) const
+{
+	if (!spResidentialCatchmentProvider)
+	{
+		return 0;
+	}
+
+	const float radiusInMeters = static_cast<float>(radius) * CellSizeInMeters;
+
+	int64_t populationTotal = 0;
+
+	for (uint64_t key : buildings.GetKeys())
+	{
+		float x = 0.0f;
+		float z = 0.0f;
+		BuildingInstanceArray::GetKeyPosition(key, x, z);
+
+		populationTotal += spResidentialCatchmentProvider->GetResidentialPopulation(x, z, radiusInMeters);
+	}
+
+	return populationFactor.Multiply(populationTotal);
+}
@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "AlgorithmFactor.h"
+#include "ITransactionAlgorithm.h"
+
+class BuildingInstanceArray;
+
+/**
+ * @brief Varies the line item cost based on the residential population around each building that uses it.
+ *
+ * The building positions are tracked by the LineItemTransaction, because the algorithm
+ * instance is shared by all of the line items that use the same parameters.
+ */
+class ResidentialCatchmentAlgorithm : public ITransactionAlgorithm
+{
+public:
+	// The width of a large city in cells.
+	static constexpr uint32_t MaxRadius = 256;
+
+	ResidentialCatchmentAlgorithm();
+	ResidentialCatchmentAlgorithm(AlgorithmFactor populationFactor, uint32_t radius);
+
+	TransactionAlgorithmType GetAlgorithmType() const override;
+
+	int64_t CalculateSharedValue() const override;
+	int64_t Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const override;
+
+	uint64_t GetParameterHash() const override;
+	bool HasSameParameters(const ITransactionAlgorithm& other) const override;
+
+	bool Read(cIGZIStream& stream, uint32_t transactionVersion) override;
+	bool Write(cIGZOStream& stream) const override;
+
+	/**
+	 * @brief Calculates the variable expense/income for the buildings.
+	 * @param buildings The buildings, the building keys hold their positions.
+	 * @return The variable expense/income.
+	 */
+	int64_t CalculateCatchmentCost(const BuildingInstanceArray& buildings) const;
+
+private:
+	AlgorithmFactor populationFactor;
+	// The catchment radius in cells.
+	uint32_t radius;
+};
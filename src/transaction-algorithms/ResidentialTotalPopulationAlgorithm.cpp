@@ -17,11 +17,11 @@
 #include "TransactionAlgorithmStaticPointers.h"
 
 ResidentialTotalPopulationAlgorithm::ResidentialTotalPopulationAlgorithm()
-	: populationFactor(0.005f)
+	: populationFactor(1, 200)
 {
 }
 
-ResidentialTotalPopulationAlgorithm::ResidentialTotalPopulationAlgorithm(float factor)
+ResidentialTotalPopulationAlgorithm::ResidentialTotalPopulationAlgorithm(AlgorithmFactor factor)
 	: populationFactor(factor)
 {
 }
@@ -31,27 +31,42 @@ TransactionAlgorithmType ResidentialTotalPopulationAlgorithm::GetAlgorithmType()
 	return TransactionAlgorithmType::ResidentialTotalPopulation;
 }
 
-int64_t ResidentialTotalPopulationAlgorithm::Calculate(int64_t initialTotal)
+int64_t ResidentialTotalPopulationAlgorithm::CalculateSharedValue() const
 {
-	int64_t newTotal = initialTotal;
+	int64_t variableTransaction = 0;
 
 	if (spPopulationProvider)
 	{
-		const double cityPopulation = static_cast<double>(spPopulationProvider->GetCityResidentialPopulation());
-		const double variableTotal = cityPopulation * populationFactor;
+		const int64_t cityPopulation = static_cast<int64_t>(spPopulationProvider->GetCityResidentialPopulation());
 
-		newTotal += static_cast<int64_t>(variableTotal);
+		variableTransaction = populationFactor.Multiply(cityPopulation);
 	}
 
-	return newTotal;
+	return variableTransaction;
 }
 
-bool ResidentialTotalPopulationAlgorithm::Read(cIGZIStream& stream)
+int64_t ResidentialTotalPopulationAlgorithm::Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const
 {
-	return stream.GetFloat32(populationFactor);
+	return initialTotal + sharedValue;
+}
+
+uint64_t ResidentialTotalPopulationAlgorithm::GetParameterHash() const
+{
+	return populationFactor.GetHash();
+}
+
+bool ResidentialTotalPopulationAlgorithm::HasSameParameters(const ITransactionAlgorithm& other) const
+{
+	return other.GetAlgorithmType() == GetAlgorithmType()
+		&& static_cast<const ResidentialTotalPopulationAlgorithm&>(other).populationFactor == populationFactor;
+}
+
+bool ResidentialTotalPopulationAlgorithm::Read(cIGZIStream& stream, uint32_t transactionVersion)
+{
+	return populationFactor.Read(stream, transactionVersion < 2);
 }
 
 bool ResidentialTotalPopulationAlgorithm::Write(cIGZOStream& stream) const
 {
-	return stream.SetFloat32(populationFactor);
+	return populationFactor.Write(stream);
 }
@@ -12,6 +12,7 @@
 ////////////////////////////////////////////////////////////////////////
 
 #pragma once
+#include "AlgorithmFactor.h"
 #include "ITransactionAlgorithm.h"
 
 class cISC4ResidentialSimulator;
@@ -20,16 +21,20 @@ class ResidentialTotalPopulationAlgorithm : public ITransactionAlgorithm
 {
 public:
 	ResidentialTotalPopulationAlgorithm();
-	ResidentialTotalPopulationAlgorithm(float factor);
+	ResidentialTotalPopulationAlgorithm(AlgorithmFactor factor);
 
 	TransactionAlgorithmType GetAlgorithmType() const override;
 
-	int64_t Calculate(int64_t fixedCashFlow) override;
+	int64_t CalculateSharedValue() const override;
+	int64_t Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const override;
 
-	bool Read(cIGZIStream& stream) override;
+	uint64_t GetParameterHash() const override;
+	bool HasSameParameters(const ITransactionAlgorithm& other) const override;
+
+	bool Read(cIGZIStream& stream, uint32_t transactionVersion) override;
 	bool Write(cIGZOStream& stream) const override;
 
 private:
-	float populationFactor;
+	AlgorithmFactor populationFactor;
 };
 
@@ -17,16 +17,16 @@
 #include "TransactionAlgorithmStaticPointers.h"
 
 ResidentialWealthGroupPopulationAlgorithm::ResidentialWealthGroupPopulationAlgorithm()
-	: lowWealthPopulationFactor(0),
-	  mediumWealthPopulationFactor(0),
-	  highWealthPopulationFactor(0)
+	: lowWealthPopulationFactor(),
+	  mediumWealthPopulationFactor(),
+	  highWealthPopulationFactor()
 {
 }
 
 ResidentialWealthGroupPopulationAlgorithm::ResidentialWealthGroupPopulationAlgorithm(
-	float lowWealthFactor,
-	float mediumWealthFactor,
-	float highWealthFactor)
+	AlgorithmFactor lowWealthFactor,
+	AlgorithmFactor mediumWealthFactor,
+	AlgorithmFactor highWealthFactor)
 	: lowWealthPopulationFactor(lowWealthFactor),
 	  mediumWealthPopulationFactor(mediumWealthFactor),
 	  highWealthPopulationFactor(highWealthFactor)
@@ -39,41 +39,68 @@ TransactionAlgorithmType ResidentialWealthGroupPopulationAlgorithm::GetAlgorithm
 	return TransactionAlgorithmType::ResidentialWealthGroupPopulation;
 }
 
-int64_t ResidentialWealthGroupPopulationAlgorithm::Calculate(int64_t initialTotal)
+int64_t ResidentialWealthGroupPopulationAlgorithm::CalculateSharedValue() const
 {
-	int64_t newTotal = initialTotal;
+	int64_t variableTransaction = 0;
 
 	if (spPopulationProvider)
 	{
-		const double lowWealthPopulation = static_cast<double>(spPopulationProvider->GetCityPopulation(0x1010));
-		const double lowWealthVariableTotal = lowWealthPopulation * lowWealthPopulationFactor;
+		const int64_t lowWealthPopulation = static_cast<int64_t>(spPopulationProvider->GetCityPopulation(0x1010));
 
-		newTotal += static_cast<int64_t>(lowWealthVariableTotal);
+		variableTransaction += lowWealthPopulationFactor.Multiply(lowWealthPopulation);
 
-		const double mediumWealthPopulation = static_cast<double>(spPopulationProvider->GetCityPopulation(0x1020));
-		const double mediumWealthVariableTotal = mediumWealthPopulation * mediumWealthPopulationFactor;
+		const int64_t mediumWealthPopulation = static_cast<int64_t>(spPopulationProvider->GetCityPopulation(0x1020));
 
-		newTotal += static_cast<int64_t>(mediumWealthVariableTotal);
+		variableTransaction += mediumWealthPopulationFactor.Multiply(mediumWealthPopulation);
 
-		const double highWealthPopulation = static_cast<double>(spPopulationProvider->GetCityPopulation(0x1030));
-		const double highWealthVariableTotal = highWealthPopulation * highWealthPopulationFactor;
+		const int64_t highWealthPopulation = static_cast<int64_t>(spPopulationProvider->GetCityPopulation(0x1030));
 
-		newTotal += static_cast<int64_t>(highWealthVariableTotal);
+		variableTransaction += highWealthPopulationFactor.Multiply(highWealthPopulation);
 	}
 
-	return newTotal;
+	return variableTransaction;
 }
 
-bool ResidentialWealthGroupPopulationAlgorithm::Read(cIGZIStream& stream)
+int64_t ResidentialWealthGroupPopulationAlgorithm::Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const
 {
-	return stream.GetFloat32(lowWealthPopulationFactor)
-		&& stream.GetFloat32(mediumWealthPopulationFactor)
-		&& stream.GetFloat32(highWealthPopulationFactor);
+	return initialTotal + sharedValue;
+}
+
+uint64_t ResidentialWealthGroupPopulationAlgorithm::GetParameterHash() const
+{
+	uint64_t hash = lowWealthPopulationFactor.GetHash();
+	hash = (hash * 31) + mediumWealthPopulationFactor.GetHash();
+	hash = (hash * 31) + highWealthPopulationFactor.GetHash();
+
+	return hash;
+}
+
+bool ResidentialWealthGroupPopulationAlgorithm::HasSameParameters(const ITransactionAlgorithm& other) const
+{
+	if (other.GetAlgorithmType() != GetAlgorithmType())
+	{
+		return false;
+	}
+
+	const ResidentialWealthGroupPopulationAlgorithm& otherAlgorithm = static_cast<const ResidentialWealthGroupPopulationAlgorithm&>(other);
+
+	return otherAlgorithm.lowWealthPopulationFactor == lowWealthPopulationFactor
+		&& otherAlgorithm.mediumWealthPopulationFactor == mediumWealthPopulationFactor
+		&& otherAlgorithm.highWealthPopulationFactor == highWealthPopulationFactor;
+}
+
+bool ResidentialWealthGroupPopulationAlgorithm::Read(cIGZIStream& stream, uint32_t transactionVersion)
+{
+	const bool legacyFloat32 = transactionVersion < 2;
+
+	return lowWealthPopulationFactor.Read(stream, legacyFloat32)
+		&& mediumWealthPopulationFactor.Read(stream, legacyFloat32)
+		&& highWealthPopulationFactor.Read(stream, legacyFloat32);
 }
 
 bool ResidentialWealthGroupPopulationAlgorithm::Write(cIGZOStream& stream) const
 {
-	return stream.SetFloat32(lowWealthPopulationFactor)
-		&& stream.SetFloat32(mediumWealthPopulationFactor)
-		&& stream.SetFloat32(highWealthPopulationFactor);
+	return lowWealthPopulationFactor.Write(stream)
+		&& mediumWealthPopulationFactor.Write(stream)
+		&& highWealthPopulationFactor.Write(stream);
 }
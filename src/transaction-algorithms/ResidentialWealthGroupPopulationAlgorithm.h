@@ -12,6 +12,7 @@
 ////////////////////////////////////////////////////////////////////////
 
 #pragma once
+#include "AlgorithmFactor.h"
 #include "ITransactionAlgorithm.h"
 
 class ResidentialWealthGroupPopulationAlgorithm : public ITransactionAlgorithm
@@ -19,20 +20,24 @@ class ResidentialWealthGroupPopulationAlgorithm : public ITransactionAlgorithm
 public:
 	ResidentialWealthGroupPopulationAlgorithm();
 	ResidentialWealthGroupPopulationAlgorithm(
-		float residentialLowWealthFactor,
-		float residentialMediumWealthFactor,
-		float residentialHighWealthFactor);
+		AlgorithmFactor residentialLowWealthFactor,
+		AlgorithmFactor residentialMediumWealthFactor,
+		AlgorithmFactor residentialHighWealthFactor);
 
 	TransactionAlgorithmType GetAlgorithmType() const override;
 
-	int64_t Calculate(int64_t initialTotal) override;
+	int64_t CalculateSharedValue() const override;
+	int64_t Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const override;
 
-	bool Read(cIGZIStream& stream) override;
+	uint64_t GetParameterHash() const override;
+	bool HasSameParameters(const ITransactionAlgorithm& other) const override;
+
+	bool Read(cIGZIStream& stream, uint32_t transactionVersion) override;
 	bool Write(cIGZOStream& stream) const override;
 
 private:
-	float lowWealthPopulationFactor;
-	float mediumWealthPopulationFactor;
-	float highWealthPopulationFactor;
+	AlgorithmFactor lowWealthPopulationFactor;
+	AlgorithmFactor mediumWealthPopulationFactor;
+	AlgorithmFactor highWealthPopulationFactor;
 };
 
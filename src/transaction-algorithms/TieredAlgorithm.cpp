@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "TieredAlgorithm.h"
+#include "TransactionAlgorithmStaticPointers.h"
+#include <utility>
+
+TieredAlgorithm::TieredAlgorithm()
+	: table()
+{
+}
+
+TieredAlgorithm::TieredAlgorithm(std::shared_ptr<const TieredTable> table)
+	: table(std::move(table))
+{
+}
+
+TransactionAlgorithmType TieredAlgorithm::GetAlgorithmType() const
+{
+	return TransactionAlgorithmType::Tiered;
+}
+
+int64_t TieredAlgorithm::CalculateSharedValue() const
+{
+	int64_t sharedValue = 0;
+
+	// Tables that use a city/region input have the same value for every line item.
+	if (table && spPopulationProvider && !UsesLineItemInput())
+	{
+		sharedValue = table->Evaluate(GetAlgorithmInputValue(table->GetInput(), 0, 0));
+	}
+
+	return sharedValue;
+}
+
+int64_t TieredAlgorithm::Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const
+{
+	int64_t newTotal = initialTotal;
+
+	if (table && spPopulationProvider)
+	{
+		if (UsesLineItemInput())
+		{
+			newTotal += table->Evaluate(GetAlgorithmInputValue(table->GetInput(), initialTotal, buildingCount));
+		}
+		else
+		{
+			newTotal += sharedValue;
+		}
+	}
+
+	return newTotal;
+}
+
+uint64_t TieredAlgorithm::GetParameterHash() const
+{
+	// The tables are shared by TieredTable::GetOrCreate, so the
+	// algorithms that use the same table data have the same table.
+	return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(table.get()));
+}
+
+bool TieredAlgorithm::HasSameParameters(const ITransactionAlgorithm& other) const
+{
+	return other.GetAlgorithmType() == GetAlgorithmType()
+		&& static_cast<const TieredAlgorithm&>(other).table == table;
+}
+
+bool TieredAlgorithm::Read(cIGZIStream& stream, uint32_t transactionVersion)
+{
+	table = TieredTable::Read(stream);
+
+	return table != nullptr;
+}
+
+bool TieredAlgorithm::Write(cIGZOStream& stream) const
+{
+	return table && table->Write(stream);
+}
+
+bool TieredAlgorithm::UsesLineItemInput() const
+{
+	return (LineItemAlgorithmInputs & (1U << static_cast<uint32_t>(table->GetInput()))) != 0;
+}
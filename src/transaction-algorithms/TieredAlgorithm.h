@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "ITransactionAlgorithm.h"
+#include "TieredTable.h"
+#include <memory>
+
+class TieredAlgorithm : public ITransactionAlgorithm
+{
+public:
+	TieredAlgorithm();
+	TieredAlgorithm(std::shared_ptr<const TieredTable> table);
+
+	TransactionAlgorithmType GetAlgorithmType() const override;
+
+	int64_t CalculateSharedValue() const override;
+	int64_t Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const override;
+
+	uint64_t GetParameterHash() const override;
+	bool HasSameParameters(const ITransactionAlgorithm& other) const override;
+
+	bool Read(cIGZIStream& stream, uint32_t transactionVersion) override;
+	bool Write(cIGZOStream& stream) const override;
+
+private:
+	bool UsesLineItemInput() const;
+
+	std::shared_ptr<const TieredTable> table;
+};
@@ -0,0 +1,309 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "TieredTable.h"
+#include "cIGZIStream.h"
+#include "cIGZOStream.h"
+#include <limits>
+#include <unordered_map>
+
+namespace
+{
+	constexpr size_t InputsPerBlock = 8;
+
+	constexpr int64_t MaxBreakpointInput = std::numeric_limits<int32_t>::max();
+	constexpr int64_t MinBreakpointValue = std::numeric_limits<int32_t>::min();
+	constexpr int64_t MaxBreakpointValue = std::numeric_limits<int32_t>::max();
+
+	uint64_t HashTableData(
+		AlgorithmInput input,
+		TieredInterpolation interpolation,
+		const std::vector<TieredBreakpoint>& breakpoints)
+	{
+		// 64-bit FNV-1a
+		uint64_t hash = 0xcbf29ce484222325;
+
+		auto hashValue = [&hash](uint64_t value)
+		{
+			for (size_t i = 0; i < sizeof(value); i++)
+			{
+				hash ^= (value >> (i * 8)) & 0xff;
+				hash *= 0x100000001b3;
+			}
+		};
+
+		hashValue(static_cast<uint64_t>(input));
+		hashValue(static_cast<uint64_t>(interpolation));
+
+		for (const TieredBreakpoint& breakpoint : breakpoints)
+		{
+			hashValue(static_cast<uint64_t>(breakpoint.input));
+			hashValue(static_cast<uint64_t>(breakpoint.value));
+		}
+
+		return hash;
+	}
+
+	bool ValidateTableData(
+		AlgorithmInput input,
+		TieredInterpolation interpolation,
+		const std::vector<TieredBreakpoint>& breakpoints,
+		std::string& errorMessage)
+	{
+		if (input >= AlgorithmInput::Count)
+		{
+			errorMessage = "The table input is not valid.";
+			return false;
+		}
+
+		if (interpolation != TieredInterpolation::Step && interpolation != TieredInterpolation::Linear)
+		{
+			errorMessage = "The table interpolation mode is not valid.";
+			return false;
+		}
+
+		if (breakpoints.empty() || breakpoints.size() > TieredTable::MaxBreakpointCount)
+		{
+			errorMessage = "The table must have between 1 and 256 breakpoints.";
+			return false;
+		}
+
+		// Limiting the breakpoints to the int32_t range ensures that the
+		// linear interpolation product cannot overflow an int64_t.
+		for (size_t i = 0; i < breakpoints.size(); i++)
+		{
+			const TieredBreakpoint& breakpoint = breakpoints[i];
+
+			if (breakpoint.input < 0 || breakpoint.input > MaxBreakpointInput)
+			{
+				errorMessage = "The breakpoint inputs must be between 0 and 2147483647.";
+				return false;
+			}
+
+			if (breakpoint.value < MinBreakpointValue || breakpoint.value > MaxBreakpointValue)
+			{
+				errorMessage = "The breakpoint values must be between -2147483648 and 2147483647.";
+				return false;
+			}
+
+			if (i > 0 && breakpoint.input <= breakpoints[i - 1].input)
+			{
+				errorMessage = "The breakpoint inputs must be in ascending order without duplicates.";
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	std::unordered_map<uint64_t, std::shared_ptr<const TieredTable>>& GetTables()
+	{
+		static std::unordered_map<uint64_t, std::shared_ptr<const TieredTable>> tables;
+
+		return tables;
+	}
+}
+
+TieredTable::TieredTable(
+	AlgorithmInput input,
+	TieredInterpolation interpolation,
+	const std::vector<TieredBreakpoint>& breakpoints)
+	: input(input),
+	  interpolation(interpolation),
+	  breakpointCount(breakpoints.size()),
+	  inputBlocks((breakpoints.size() + InputsPerBlock - 1) / InputsPerBlock),
+	  segments(breakpoints.size())
+{
+	// The inputs are stored separately from the segment data so that
+	// the search only touches the cache lines that hold the inputs.
+	int64_t* inputs = inputBlocks.front().values;
+
+	for (size_t i = 0; i < breakpointCount; i++)
+	{
+		inputs[i] = breakpoints[i].input;
+
+		Segment& segment = segments[i];
+		segment.value = breakpoints[i].value;
+
+		if ((i + 1) < breakpointCount)
+		{
+			segment.valueDelta = breakpoints[i + 1].value - breakpoints[i].value;
+			segment.inputDelta = breakpoints[i + 1].input - breakpoints[i].input;
+		}
+		else
+		{
+			// Inputs above the last breakpoint use its value.
+			segment.valueDelta = 0;
+			segment.inputDelta = 1;
+		}
+	}
+}
+
+std::shared_ptr<const TieredTable> TieredTable::GetOrCreate(
+	AlgorithmInput input,
+	TieredInterpolation interpolation,
+	const std::vector<TieredBreakpoint>& breakpoints,
+	std::string& errorMessage)
+{
+	if (!ValidateTableData(input, interpolation, breakpoints, errorMessage))
+	{
+		return nullptr;
+	}
+
+	const uint64_t hash = HashTableData(input, interpolation, breakpoints);
+
+	auto& tables = GetTables();
+	const auto& item = tables.find(hash);
+
+	if (item != tables.end() && item->second->Equals(input, interpolation, breakpoints))
+	{
+		return item->second;
+	}
+
+	std::shared_ptr<const TieredTable> table(new TieredTable(input, interpolation, breakpoints));
+
+	// A table whose hash collides with a cached table is not cached,
+	// the line items that use it get their own copy of the table.
+	tables.try_emplace(hash, table);
+
+	return table;
+}
+
+std::shared_ptr<const TieredTable> TieredTable::Read(cIGZIStream& stream)
+{
+	uint32_t input = 0;
+	uint32_t interpolation = 0;
+	uint32_t breakpointCount = 0;
+
+	if (!stream.GetUint32(input)
+		|| !stream.GetUint32(interpolation)
+		|| !stream.GetUint32(breakpointCount)
+		|| breakpointCount == 0
+		|| breakpointCount > MaxBreakpointCount)
+	{
+		return nullptr;
+	}
+
+	std::vector<TieredBreakpoint> breakpoints(breakpointCount);
+
+	for (TieredBreakpoint& breakpoint : breakpoints)
+	{
+		if (!stream.GetSint64(breakpoint.input) || !stream.GetSint64(breakpoint.value))
+		{
+			return nullptr;
+		}
+	}
+
+	std::string errorMessage;
+
+	return GetOrCreate(
+		static_cast<AlgorithmInput>(input),
+		static_cast<TieredInterpolation>(interpolation),
+		breakpoints,
+		errorMessage);
+}
+
+bool TieredTable::Write(cIGZOStream& stream) const
+{
+	if (!stream.SetUint32(static_cast<uint32_t>(input))
+		|| !stream.SetUint32(static_cast<uint32_t>(interpolation))
+		|| !stream.SetUint32(static_cast<uint32_t>(breakpointCount)))
+	{
+		return false;
+	}
+
+	const int64_t* inputs = GetInputs();
+
+	for (size_t i = 0; i < breakpointCount; i++)
+	{
+		if (!stream.SetSint64(inputs[i]) || !stream.SetSint64(segments[i].value))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+AlgorithmInput TieredTable::GetInput() const
+{
+	return input;
+}
+
+int64_t TieredTable::Evaluate(int64_t inputValue) const
+{
+	const int64_t* inputs = GetInputs();
+
+	if (inputValue <= inputs[0])
+	{
+		return segments[0].value;
+	}
+
+	// Find the last breakpoint that is less than or equal to the input value.
+	// The conditional is compiled to a conditional move, so the loop always runs
+	// log2(breakpointCount) iterations without any mispredicted branches.
+	const int64_t* first = inputs;
+	size_t count = breakpointCount;
+
+	while (count > 1)
+	{
+		const size_t half = count / 2;
+		first = first[half] <= inputValue ? first + half : first;
+		count -= half;
+	}
+
+	const size_t index = static_cast<size_t>(first - inputs);
+	const Segment& segment = segments[index];
+
+	if (interpolation == TieredInterpolation::Step)
+	{
+		return segment.value;
+	}
+
+	// The input offset is less than the segment's input delta, except for the last breakpoint
+	// where the value delta is zero. The breakpoints are limited to the int32_t range, so the
+	// product cannot overflow.
+	const int64_t inputOffset = inputValue - *first;
+
+	return segment.value + ((segment.valueDelta * inputOffset) / segment.inputDelta);
+}
+
+bool TieredTable::Equals(
+	AlgorithmInput input,
+	TieredInterpolation interpolation,
+	const std::vector<TieredBreakpoint>& breakpoints) const
+{
+	if (this->input != input
+		|| this->interpolation != interpolation
+		|| breakpointCount != breakpoints.size())
+	{
+		return false;
+	}
+
+	const int64_t* inputs = GetInputs();
+
+	for (size_t i = 0; i < breakpointCount; i++)
+	{
+		if (inputs[i] != breakpoints[i].input || segments[i].value != breakpoints[i].value)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+const int64_t* TieredTable::GetInputs() const
+{
+	return inputBlocks.front().values;
+}
@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-custom-budget-departments, a DLL Plugin for
+// SimCity 4 that allows new budget departments to be added to the game
+// using a building's exemplar.
+//
+// Copyright (c) 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "AlgorithmInput.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class cIGZIStream;
+class cIGZOStream;
+
+enum class TieredInterpolation : uint8_t
+{
+	// The value of the last breakpoint that is less than or equal to the input.
+	Step = 0,
+	// The value is interpolated between the breakpoints that surround the input.
+	Linear = 1,
+};
+
+struct TieredBreakpoint
+{
+	int64_t input;
+	int64_t value;
+};
+
+/**
+ * @brief The breakpoint table of a Tiered algorithm line item.
+ *
+ * The breakpoints are validated and converted to sorted, cache-aligned arrays when the table is created.
+ * The tables are shared between all of the line items that use the same exemplar data.
+ * Inputs below the first breakpoint use the first value and inputs above the last breakpoint use the last value.
+ */
+class TieredTable
+{
+public:
+	static constexpr size_t MaxBreakpointCount = 256;
+
+	/**
+	 * @brief Gets the shared table for the specified data, creating it if necessary.
+	 * @param input The algorithm input that the table is indexed by.
+	 * @param interpolation The interpolation mode.
+	 * @param breakpoints The breakpoints, the inputs must be in ascending order.
+	 * @param errorMessage Receives the error message if the table data is not valid.
+	 * @return The table, or nullptr if the data is not valid.
+	 */
+	static std::shared_ptr<const TieredTable> GetOrCreate(
+		AlgorithmInput input,
+		TieredInterpolation interpolation,
+		const std::vector<TieredBreakpoint>& breakpoints,
+		std::string& errorMessage);
+
+	static std::shared_ptr<const TieredTable> Read(cIGZIStream& stream);
+	bool Write(cIGZOStream& stream) const;
+
+	AlgorithmInput GetInput() const;
+
+	int64_t Evaluate(int64_t inputValue) const;
+
+private:
+	struct alignas(64) InputBlock
+	{
+		int64_t values[8];
+	};
+
+	struct alignas(32) Segment
+	{
+		int64_t value;
+		int64_t valueDelta;
+		int64_t inputDelta;
+	};
+
+	TieredTable(
+		AlgorithmInput input,
+		TieredInterpolation interpolation,
+		const std::vector<TieredBreakpoint>& breakpoints);
+
+	bool Equals(
+		AlgorithmInput input,
+		TieredInterpolation interpolation,
+		const std::vector<TieredBreakpoint>& breakpoints) const;
+
+	const int64_t* GetInputs() const;
+
+	AlgorithmInput input;
+	TieredInterpolation interpolation;
+	size_t breakpointCount;
+	std::vector<InputBlock> inputBlocks;
+	std::vector<Segment> segments;
+};
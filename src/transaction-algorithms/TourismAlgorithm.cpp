@@ -17,13 +17,13 @@
 #include "TransactionAlgorithmStaticPointers.h"
 
 TourismAlgorithm::TourismAlgorithm()
-	: nationalAndInternationalTourismFactor(0),
+	: nationalAndInternationalTourismFactor(),
 	  geopoliticsFactor(0)
 {
 }
 
 TourismAlgorithm::TourismAlgorithm(
-	float nationalAndInternationalTourismFactor,
+	AlgorithmFactor nationalAndInternationalTourismFactor,
 	int64_t geopoliticsFactor)
 	: nationalAndInternationalTourismFactor(nationalAndInternationalTourismFactor),
 	  geopoliticsFactor(geopoliticsFactor)
@@ -35,9 +35,9 @@ TransactionAlgorithmType TourismAlgorithm::GetAlgorithmType() const
 	return TransactionAlgorithmType::Tourism;
 }
 
-int64_t TourismAlgorithm::Calculate(int64_t initialTotal)
+int64_t TourismAlgorithm::CalculateSharedValue() const
 {
-	int64_t newTotal = initialTotal;
+	int64_t variableTransaction = 0;
 
 	if (spPopulationProvider)
 	{
@@ -69,29 +69,48 @@ int64_t TourismAlgorithm::Calculate(int64_t initialTotal)
 									+ regionMediumWealthTourismPopulation
 									+ regionHighWealthTourismPopulation;
 
-		const int64_t variableTransaction = populationSum / geopoliticsFactor;
+		variableTransaction = populationSum / geopoliticsFactor;
+	}
+
+	return variableTransaction;
+}
 
-		newTotal += variableTransaction;
+int64_t TourismAlgorithm::Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const
+{
+	return initialTotal + sharedValue;
+}
+
+uint64_t TourismAlgorithm::GetParameterHash() const
+{
+	return (nationalAndInternationalTourismFactor.GetHash() * 31) + static_cast<uint64_t>(geopoliticsFactor);
+}
+
+bool TourismAlgorithm::HasSameParameters(const ITransactionAlgorithm& other) const
+{
+	if (other.GetAlgorithmType() != GetAlgorithmType())
+	{
+		return false;
 	}
 
-	return newTotal;
+	const TourismAlgorithm& otherAlgorithm = static_cast<const TourismAlgorithm&>(other);
+
+	return otherAlgorithm.nationalAndInternationalTourismFactor == nationalAndInternationalTourismFactor
+		&& otherAlgorithm.geopoliticsFactor == geopoliticsFactor;
 }
 
-bool TourismAlgorithm::Read(cIGZIStream& stream)
+bool TourismAlgorithm::Read(cIGZIStream& stream, uint32_t transactionVersion)
 {
-	return stream.GetFloat32(nationalAndInternationalTourismFactor)
+	return nationalAndInternationalTourismFactor.Read(stream, transactionVersion < 2)
 		&& stream.GetSint64(geopoliticsFactor);
 }
 
 bool TourismAlgorithm::Write(cIGZOStream& stream) const
 {
-	return stream.SetFloat32(nationalAndInternationalTourismFactor)
+	return nationalAndInternationalTourismFactor.Write(stream)
 		&& stream.SetSint64(geopoliticsFactor);
 }
 
 int64_t TourismAlgorithm::GetRegionalTourismPopulation(uint32_t demandId) const
 {
-	const double population = static_cast<double>(spPopulationProvider->GetRegionPopulation(demandId));
-
-	return static_cast<int64_t>(population * static_cast<double>(nationalAndInternationalTourismFactor));
+	return nationalAndInternationalTourismFactor.Multiply(spPopulationProvider->GetRegionPopulation(demandId));
 }
@@ -12,6 +12,7 @@
 ////////////////////////////////////////////////////////////////////////
 
 #pragma once
+#include "AlgorithmFactor.h"
 #include "ITransactionAlgorithm.h"
 
 class TourismAlgorithm : public ITransactionAlgorithm
@@ -19,20 +20,24 @@ class TourismAlgorithm : public ITransactionAlgorithm
 public:
 	TourismAlgorithm();
 	TourismAlgorithm(
-		float nationalAndInternationalTourismFactor,
+		AlgorithmFactor nationalAndInternationalTourismFactor,
 		int64_t geopoliticsFactor);
 
 	TransactionAlgorithmType GetAlgorithmType() const override;
 
-	int64_t Calculate(int64_t initialTotal) override;
+	int64_t CalculateSharedValue() const override;
+	int64_t Calculate(int64_t initialTotal, int64_t buildingCount, int64_t sharedValue) const override;
 
-	bool Read(cIGZIStream& stream) override;
+	uint64_t GetParameterHash() const override;
+	bool HasSameParameters(const ITransactionAlgorithm& other) const override;
+
+	bool Read(cIGZIStream& stream, uint32_t transactionVersion) override;
 	bool Write(cIGZOStream& stream) const override;
 
 private:
 	int64_t GetRegionalTourismPopulation(uint32_t demandId) const;
 
-	float nationalAndInternationalTourismFactor;
+	AlgorithmFactor nationalAndInternationalTourismFactor;
 	int64_t geopoliticsFactor;
 };
 
@@ -16,16 +16,31 @@
 #include "cISCProperty.h"
 #include "cISCPropertyHolder.h"
 #include "SCPropertyUtil.h"
+#include "BuildingAgeAlgorithm.h"
+#include "FormulaAlgorithm.h"
+#include "FormulaProgramCache.h"
+#include "HistoryAlgorithm.h"
+#include "ResidentialCatchmentAlgorithm.h"
 #include "ResidentialTotalPopulationAlgorithm.h"
 #include "ResidentialWealthGroupPopulationAlgorithm.h"
+#include "TieredAlgorithm.h"
 #include "TourismAlgorithm.h"
 
+#include <algorithm>
 #include <cstdarg>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 static constexpr uint32_t ResidentialTotalPopulationFactorPropertyId = 0x9EE12410;
 static constexpr uint32_t ResidentialWealthGroupPopulationFactorsPropertyId = 0x9EE12411;
 static constexpr uint32_t ResidentialTourismPopulationFactorsPropertyId = 0x9EE12412;
+static constexpr uint32_t FormulaPropertyId = 0x9EE12413;
+static constexpr uint32_t TieredPropertyId = 0x9EE12414;
+static constexpr uint32_t HistoryPropertyId = 0x9EE12415;
+static constexpr uint32_t BuildingAgePropertyId = 0x9EE12416;
+static constexpr uint32_t ResidentialCatchmentPropertyId = 0x9EE12417;
+static constexpr uint32_t LineItemConditionPropertyId = 0x9EE12418;
 
 namespace
 {
@@ -130,12 +145,13 @@ namespace
 						{
 							ThrowCreateImageExceptionFormatted(
 								"The %s property does not contain line item 0x%08x.",
-								lineNumber);
+								propertyName,
+								static_cast<uint32_t>(lineNumber));
 						}
 
 						lineItemData.reserve(groupCountWithLineNumber - 1);
 
-						for (size_t i = lineItemStartIndex + 1; i < groupCountWithLineNumber; i++)
+						for (size_t i = lineItemStartIndex + 1; i < lineItemStartIndex + groupCountWithLineNumber; i++)
 						{
 							lineItemData.push_back(pData[i]);
 						}
@@ -163,7 +179,232 @@ namespace
 		return lineItemData;
 	}
 
-	float Rational64ToFloat(
+	bool ParseFormulaLineNumber(std::string_view value, uint32_t& lineNumber)
+	{
+		uint64_t base = 10;
+
+		if (value.size() > 2 && value[0] == '0' && (value[1] == 'x' || value[1] == 'X'))
+		{
+			base = 16;
+			value.remove_prefix(2);
+		}
+
+		if (value.empty())
+		{
+			return false;
+		}
+
+		uint64_t result = 0;
+
+		for (char c : value)
+		{
+			uint64_t digit = 0;
+
+			if (c >= '0' && c <= '9')
+			{
+				digit = static_cast<uint64_t>(c - '0');
+			}
+			else if (base == 16 && c >= 'a' && c <= 'f')
+			{
+				digit = static_cast<uint64_t>(c - 'a') + 10;
+			}
+			else if (base == 16 && c >= 'A' && c <= 'F')
+			{
+				digit = static_cast<uint64_t>(c - 'A') + 10;
+			}
+			else
+			{
+				return false;
+			}
+
+			result = (result * base) + digit;
+
+			if (result > UINT32_MAX)
+			{
+				return false;
+			}
+		}
+
+		lineNumber = static_cast<uint32_t>(result);
+		return true;
+	}
+
+	std::string_view TrimWhitespace(std::string_view value)
+	{
+		constexpr std::string_view Whitespace = " \t\r\n";
+
+		const size_t start = value.find_first_not_of(Whitespace);
+
+		if (start == std::string_view::npos)
+		{
+			return std::string_view();
+		}
+
+		const size_t end = value.find_last_not_of(Whitespace);
+
+		return value.substr(start, end - start + 1);
+	}
+
+	std::string_view GetLineItemFormula(
+		const cISCPropertyHolder* pPropertyHolder,
+		uint32_t lineNumber)
+	{
+		static const char* const GenericErrorFormat = "Failed to get the %s property value.";
+		static const char* const PropertyName = "Formula";
+
+		const cISCProperty* property = pPropertyHolder ? pPropertyHolder->GetProperty(FormulaPropertyId) : nullptr;
+
+		if (!property)
+		{
+			ThrowCreateImageExceptionFormatted(GenericErrorFormat, PropertyName);
+		}
+
+		const cIGZVariant* pVariant = property->GetPropertyValue();
+
+		if (!pVariant)
+		{
+			ThrowCreateImageExceptionFormatted(GenericErrorFormat, PropertyName);
+		}
+
+		if (pVariant->GetType() != cIGZVariant::Type::CharArray)
+		{
+			ThrowCreateImageExceptionFormatted("The %s property type is not String.", PropertyName);
+		}
+
+		// The property is a list of <line item id> = <expression> items separated by semicolons.
+		std::string_view remaining(pVariant->RefChar(), pVariant->GetCount());
+
+		while (!remaining.empty())
+		{
+			const size_t separator = remaining.find(';');
+			const std::string_view item = remaining.substr(0, separator);
+
+			remaining = separator == std::string_view::npos ? std::string_view() : remaining.substr(separator + 1);
+
+			const size_t equals = item.find('=');
+
+			if (equals != std::string_view::npos)
+			{
+				uint32_t itemLineNumber = 0;
+
+				if (ParseFormulaLineNumber(TrimWhitespace(item.substr(0, equals)), itemLineNumber)
+					&& itemLineNumber == lineNumber)
+				{
+					return TrimWhitespace(item.substr(equals + 1));
+				}
+			}
+		}
+
+		ThrowCreateImageExceptionFormatted(
+			"The %s property does not contain line item 0x%08x.",
+			PropertyName,
+			lineNumber);
+		return std::string_view();
+	}
+
+	std::shared_ptr<const TieredTable> GetLineItemTieredTable(
+		const cISCPropertyHolder* pPropertyHolder,
+		uint32_t lineNumber)
+	{
+		static const char* const GenericErrorFormat = "Failed to get the %s property value.";
+		static const char* const PropertyName = "Tiered";
+
+		const cISCProperty* property = pPropertyHolder ? pPropertyHolder->GetProperty(TieredPropertyId) : nullptr;
+
+		if (!property)
+		{
+			ThrowCreateImageExceptionFormatted(GenericErrorFormat, PropertyName);
+		}
+
+		const cIGZVariant* pVariant = property->GetPropertyValue();
+
+		if (!pVariant)
+		{
+			ThrowCreateImageExceptionFormatted(GenericErrorFormat, PropertyName);
+		}
+
+		if (pVariant->GetType() != cIGZVariant::Type::Sint64Array)
+		{
+			ThrowCreateImageExceptionFormatted("The %s property type is not Sint64Array.", PropertyName);
+		}
+
+		// The property is a list of variable length item groups:
+		// <line item id>, <input>, <interpolation>, <breakpoint count>, followed by the
+		// <breakpoint input>, <breakpoint value> pairs.
+		constexpr size_t HeaderCount = 4;
+
+		const size_t count = pVariant->GetCount();
+		const int64_t* pData = pVariant->RefSint64();
+
+		size_t index = 0;
+
+		while ((count - index) >= HeaderCount)
+		{
+			const int64_t itemLineNumber = pData[index];
+			const int64_t input = pData[index + 1];
+			const int64_t interpolation = pData[index + 2];
+			const int64_t breakpointCount = pData[index + 3];
+
+			if (breakpointCount < 0
+				|| breakpointCount > static_cast<int64_t>(TieredTable::MaxBreakpointCount)
+				|| static_cast<size_t>(breakpointCount) > ((count - index - HeaderCount) / 2))
+			{
+				ThrowCreateImageExceptionFormatted(
+					"The %s property line item 0x%08llx has an invalid breakpoint count.",
+					PropertyName,
+					static_cast<unsigned long long>(itemLineNumber));
+			}
+
+			const int64_t* pBreakpoints = pData + index + HeaderCount;
+
+			if (itemLineNumber == lineNumber)
+			{
+				if (input < 0 || input >= static_cast<int64_t>(AlgorithmInputCount) || interpolation < 0 || interpolation > 1)
+				{
+					ThrowCreateImageExceptionFormatted(
+						"Error parsing the %s property line item 0x%08x: The input or interpolation value is not valid.",
+						PropertyName,
+						lineNumber);
+				}
+
+				std::vector<TieredBreakpoint> breakpoints(static_cast<size_t>(breakpointCount));
+
+				for (size_t i = 0; i < breakpoints.size(); i++)
+				{
+					breakpoints[i].input = pBreakpoints[i * 2];
+					breakpoints[i].value = pBreakpoints[(i * 2) + 1];
+				}
+
+				std::string errorMessage;
+				std::shared_ptr<const TieredTable> table = TieredTable::GetOrCreate(
+					static_cast<AlgorithmInput>(input),
+					static_cast<TieredInterpolation>(interpolation),
+					breakpoints,
+					errorMessage);
+
+				if (!table)
+				{
+					ThrowCreateImageExceptionFormatted(
+						"Error parsing the %s property line item 0x%08x: %s",
+						PropertyName,
+						lineNumber,
+						errorMessage.c_str());
+				}
+
+				return table;
+			}
+
+			index += HeaderCount + (static_cast<size_t>(breakpointCount) * 2);
+		}
+
+		ThrowCreateImageExceptionFormatted(
+			"The %s property does not contain line item 0x%08x.",
+			PropertyName,
+			lineNumber);
+		return nullptr;
+	}
+
+	AlgorithmFactor Rational64ToFactor(
 		int64_t numerator,
 		int64_t denominator,
 		const char* const propertyName,
@@ -171,7 +412,7 @@ namespace
 		uint32_t lineNumber)
 	{
 		// We limit the rational values to the range of int32_t.
-		// This is done to ensure the values fit in a double.
+		// This keeps the intermediate products of the factor multiplication in the range of int64_t.
 		if (numerator < INT32_MIN || numerator > INT32_MAX)
 		{
 			ThrowCreateImageExceptionFormatted(
@@ -180,7 +421,7 @@ namespace
 				valueName,
 				propertyName,
 				lineNumber);
-			return 0.0f;
+			return AlgorithmFactor();
 		}
 		else if (denominator <= 0 || denominator > INT32_MAX)
 		{
@@ -190,22 +431,41 @@ namespace
 				valueName,
 				propertyName,
 				lineNumber);
-			return 0.0f;
+			return AlgorithmFactor();
 		}
 
-		float value = 0.0f;
+		return AlgorithmFactor(static_cast<int32_t>(numerator), static_cast<int32_t>(denominator));
+	}
 
-		if (numerator == 0)
-		{
-			value = 0.0f;
-		}
-		else
-		{
-			double temp = static_cast<double>(static_cast<int32_t>(numerator)) / static_cast<double>(static_cast<int32_t>(denominator));
-			value = static_cast<float>(temp);
-		}
+	struct AlgorithmInstance
+	{
+		std::weak_ptr<const ITransactionAlgorithm> instance;
+		// Set for the instances that are kept alive by RetainRecentInstances.
+		std::shared_ptr<const ITransactionAlgorithm> retained;
+		uint64_t lastUsed;
+	};
+
+	typedef std::unordered_multimap<uint64_t, AlgorithmInstance> AlgorithmInstanceMap;
 
-		return value;
+	AlgorithmInstanceMap& GetAlgorithmInstances()
+	{
+		// The instances are held as weak references, an instance is destroyed when the
+		// last line item that uses it is removed unless it is retained.
+		static AlgorithmInstanceMap instances;
+
+		return instances;
+	}
+
+	uint64_t& GetAlgorithmInstanceUseCounter()
+	{
+		static uint64_t useCounter = 0;
+
+		return useCounter;
+	}
+
+	uint64_t GetAlgorithmInstanceKey(const ITransactionAlgorithm& algorithm)
+	{
+		return (algorithm.GetParameterHash() * 31) + static_cast<uint64_t>(algorithm.GetAlgorithmType());
 	}
 }
 
@@ -222,12 +482,22 @@ std::unique_ptr<ITransactionAlgorithm> TransactionAlgorithmFactory::Create(Trans
 		return std::make_unique<ResidentialWealthGroupPopulationAlgorithm>();
 	case TransactionAlgorithmType::Tourism:
 		return std::make_unique<TourismAlgorithm>();
+	case TransactionAlgorithmType::Formula:
+		return std::make_unique<FormulaAlgorithm>();
+	case TransactionAlgorithmType::Tiered:
+		return std::make_unique<TieredAlgorithm>();
+	case TransactionAlgorithmType::History:
+		return std::make_unique<HistoryAlgorithm>();
+	case TransactionAlgorithmType::BuildingAge:
+		return std::make_unique<BuildingAgeAlgorithm>();
+	case TransactionAlgorithmType::ResidentialCatchment:
+		return std::make_unique<ResidentialCatchmentAlgorithm>();
 	default:
 		throw CreateTransactionAlgorithmException("Unknown TransactionAlgorithmType value.");
 	}
 }
 
-std::unique_ptr<ITransactionAlgorithm> TransactionAlgorithmFactory::Create(
+std::shared_ptr<const ITransactionAlgorithm> TransactionAlgorithmFactory::Create(
 	const cISCPropertyHolder* pPropertyHolder,
 	TransactionAlgorithmType type,
 	uint32_t lineNumber)
@@ -244,7 +514,7 @@ std::unique_ptr<ITransactionAlgorithm> TransactionAlgorithmFactory::Create(
 			3,
 			"ResidentialTotalPopulation");
 
-		float factor = Rational64ToFloat(
+		AlgorithmFactor factor = Rational64ToFactor(
 			lineItemData[0],
 			lineItemData[1],
 			"ResidentialTotalPopulation",
@@ -262,21 +532,21 @@ std::unique_ptr<ITransactionAlgorithm> TransactionAlgorithmFactory::Create(
 			7,
 			"ResidentialWealthGroupPopulation");
 
-		float lowWealthFactor = Rational64ToFloat(
+		AlgorithmFactor lowWealthFactor = Rational64ToFactor(
 			lineItemData[0],
 			lineItemData[1],
 			"ResidentialWealthGroupPopulation",
 			"low wealth",
 			lineNumber);
 
-		float mediumWealthFactor = Rational64ToFloat(
+		AlgorithmFactor mediumWealthFactor = Rational64ToFactor(
 			lineItemData[2],
 			lineItemData[3],
 			"ResidentialWealthGroupPopulation",
 			"medium wealth",
 			lineNumber);
 
-		float highWealthFactor = Rational64ToFloat(
+		AlgorithmFactor highWealthFactor = Rational64ToFactor(
 			lineItemData[4],
 			lineItemData[5],
 			"ResidentialWealthGroupPopulation",
@@ -297,7 +567,7 @@ std::unique_ptr<ITransactionAlgorithm> TransactionAlgorithmFactory::Create(
 			4,
 			"ResidentialTourismPopulation");
 
-		float nationalAndInternationalTourismFactor = Rational64ToFloat(
+		AlgorithmFactor nationalAndInternationalTourismFactor = Rational64ToFactor(
 			lineItemData[0],
 			lineItemData[1],
 			"ResidentialTourismPopulation",
@@ -308,6 +578,352 @@ std::unique_ptr<ITransactionAlgorithm> TransactionAlgorithmFactory::Create(
 
 		algorithm = std::make_unique<TourismAlgorithm>(nationalAndInternationalTourismFactor, geopoliticsFactor);
 	}
+	else if (type == TransactionAlgorithmType::Formula)
+	{
+		const std::string_view expression = GetLineItemFormula(pPropertyHolder, lineNumber);
+
+		std::string errorMessage;
+		std::shared_ptr<const FormulaProgram> program = FormulaProgramCache::GetOrCompile(expression, errorMessage);
+
+		if (!program)
+		{
+			ThrowCreateImageExceptionFormatted(
+				"Error parsing the Formula property line item 0x%08x: %s",
+				lineNumber,
+				errorMessage.c_str());
+		}
+
+		algorithm = std::make_unique<FormulaAlgorithm>(std::move(program));
+	}
+	else if (type == TransactionAlgorithmType::Tiered)
+	{
+		algorithm = std::make_unique<TieredAlgorithm>(GetLineItemTieredTable(pPropertyHolder, lineNumber));
+	}
+	else if (type == TransactionAlgorithmType::History)
+	{
+		std::vector<int64_t> lineItemData = GetLineItemData(
+			pPropertyHolder,
+			HistoryPropertyId,
+			lineNumber,
+			6,
+			"History");
+
+		const int64_t historyType = lineItemData[0];
+		const int64_t monthCount = lineItemData[1];
+		const int64_t statistic = lineItemData[2];
+
+		if (historyType < 0 || historyType > UINT32_MAX)
+		{
+			ThrowCreateImageExceptionFormatted(
+				"Error parsing the History property line item 0x%08x: "
+				"The history type must be in the range of 0 to 0xFFFFFFFF.",
+				lineNumber);
+		}
+		else if (monthCount < 1 || monthCount > HistoryAlgorithm::MaxMonthCount)
+		{
+			ThrowCreateImageExceptionFormatted(
+				"Error parsing the History property line item 0x%08x: "
+				"The month count must be in the range of 1 to %u.",
+				lineNumber,
+				HistoryAlgorithm::MaxMonthCount);
+		}
+		else if (statistic < 0 || statistic >= static_cast<int64_t>(HistoryStatistic::Count))
+		{
+			ThrowCreateImageExceptionFormatted(
+				"Error parsing the History property line item 0x%08x: "
+				"The statistic must be in the range of 0 to 3.",
+				lineNumber);
+		}
+
+		AlgorithmFactor factor = Rational64ToFactor(
+			lineItemData[3],
+			lineItemData[4],
+			"History",
+			"history",
+			lineNumber);
+
+		algorithm = std::make_unique<HistoryAlgorithm>(
+			static_cast<uint32_t>(historyType),
+			static_cast<uint32_t>(monthCount),
+			static_cast<HistoryStatistic>(statistic),
+			factor);
+	}
+	else if (type == TransactionAlgorithmType::BuildingAge)
+	{
+		std::vector<int64_t> lineItemData = GetLineItemData(
+			pPropertyHolder,
+			BuildingAgePropertyId,
+			lineNumber,
+			4,
+			"BuildingAge");
+
+		AlgorithmFactor ageFactor = Rational64ToFactor(
+			lineItemData[0],
+			lineItemData[1],
+			"BuildingAge",
+			"building age",
+			lineNumber);
+
+		const int64_t maxAge = lineItemData[2];
+
+		if (maxAge < 0 || maxAge > BuildingAgeAlgorithm::MaxAgeLimit)
+		{
+			ThrowCreateImageExceptionFormatted(
+				"Error parsing the BuildingAge property line item 0x%08x: "
+				"The maximum age must be in the range of 0 to %u.",
+				lineNumber,
+				BuildingAgeAlgorithm::MaxAgeLimit);
+		}
+
+		algorithm = std::make_unique<BuildingAgeAlgorithm>(ageFactor, static_cast<uint32_t>(maxAge));
+	}
+	else if (type == TransactionAlgorithmType::ResidentialCatchment)
+	{
+		std::vector<int64_t> lineItemData = GetLineItemData(
+			pPropertyHolder,
+			ResidentialCatchmentPropertyId,
+			lineNumber,
+			4,
+			"ResidentialCatchment");
+
+		AlgorithmFactor populationFactor = Rational64ToFactor(
+			lineItemData[0],
+			lineItemData[1],
+			"ResidentialCatchment",
+			"population",
+			lineNumber);
+
+		const int64_t radius = lineItemData[2];
+
+		if (radius < 0 || radius > ResidentialCatchmentAlgorithm::MaxRadius)
+		{
+			ThrowCreateImageExceptionFormatted(
+				"Error parsing the ResidentialCatchment property line item 0x%08x: "
+				"The radius must be in the range of 0 to %u.",
+				lineNumber,
+				ResidentialCatchmentAlgorithm::MaxRadius);
+		}
+
+		algorithm = std::make_unique<ResidentialCatchmentAlgorithm>(populationFactor, static_cast<uint32_t>(radius));
+	}
+
+	return Intern(std::move(algorithm));
+}
+
+std::shared_ptr<const ITransactionAlgorithm> TransactionAlgorithmFactory::Intern(std::unique_ptr<ITransactionAlgorithm> algorithm)
+{
+	if (!algorithm)
+	{
+		return nullptr;
+	}
+
+	AlgorithmInstanceMap& instances = GetAlgorithmInstances();
+
+	const uint64_t key = GetAlgorithmInstanceKey(*algorithm);
+	auto range = instances.equal_range(key);
+
+	const uint64_t lastUsed = ++GetAlgorithmInstanceUseCounter();
+
+	for (auto it = range.first; it != range.second;)
+	{
+		std::shared_ptr<const ITransactionAlgorithm> instance = it->second.instance.lock();
+
+		if (!instance)
+		{
+			it = instances.erase(it);
+		}
+		else if (instance->HasSameParameters(*algorithm))
+		{
+			it->second.lastUsed = lastUsed;
+			return instance;
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	std::shared_ptr<const ITransactionAlgorithm> instance(std::move(algorithm));
+	instances.emplace(key, AlgorithmInstance{ instance, nullptr, lastUsed });
+
+	return instance;
+}
+
+void TransactionAlgorithmFactory::RetainRecentInstances(size_t maxCount)
+{
+	AlgorithmInstanceMap& instances = GetAlgorithmInstances();
+
+	std::vector<AlgorithmInstance*> liveInstances;
+	liveInstances.reserve(instances.size());
+
+	for (auto it = instances.begin(); it != instances.end();)
+	{
+		if (it->second.instance.expired())
+		{
+			it = instances.erase(it);
+		}
+		else
+		{
+			liveInstances.push_back(&it->second);
+			++it;
+		}
+	}
+
+	const size_t retainedCount = std::min(maxCount, liveInstances.size());
+
+	std::partial_sort(
+		liveInstances.begin(),
+		liveInstances.begin() + retainedCount,
+		liveInstances.end(),
+		[](const AlgorithmInstance* left, const AlgorithmInstance* right)
+		{
+			return left->lastUsed > right->lastUsed;
+		});
+
+	for (size_t i = 0; i < liveInstances.size(); i++)
+	{
+		AlgorithmInstance* const pInstance = liveInstances[i];
+
+		if (i < retainedCount)
+		{
+			pInstance->retained = pInstance->instance.lock();
+		}
+		else
+		{
+			// The entry is removed by a later call if the instance is destroyed.
+			pInstance->retained.reset();
+		}
+	}
+}
+
+TransactionAlgorithmInstanceStatistics TransactionAlgorithmFactory::GetInstanceStatistics()
+{
+	TransactionAlgorithmInstanceStatistics statistics{};
+
+	AlgorithmInstanceMap& instances = GetAlgorithmInstances();
+
+	for (auto it = instances.begin(); it != instances.end();)
+	{
+		const long useCount = it->second.instance.use_count();
+
+		if (useCount == 0)
+		{
+			it = instances.erase(it);
+		}
+		else
+		{
+			// The retained reference is not a line item.
+			const long lineItemCount = it->second.retained ? useCount - 1 : useCount;
+
+			if (lineItemCount > 0)
+			{
+				statistics.distinctInstances++;
+				statistics.totalInstances += static_cast<size_t>(lineItemCount);
+			}
+
+			++it;
+		}
+	}
+
+	return statistics;
+}
+
+std::unique_ptr<LineItemConditions> TransactionAlgorithmFactory::CreateConditions(
+	const cISCPropertyHolder* pPropertyHolder,
+	uint32_t lineNumber)
+{
+	// The conditions are optional, a line item can have multiple condition groups.
+	constexpr size_t GroupCount = 6;
+
+	std::unique_ptr<LineItemConditions> conditions;
+
+	const cISCProperty* property = pPropertyHolder ? pPropertyHolder->GetProperty(LineItemConditionPropertyId) : nullptr;
+
+	if (!property)
+	{
+		return conditions;
+	}
+
+	const cIGZVariant* pVariant = property->GetPropertyValue();
+
+	if (!pVariant || pVariant->GetType() != cIGZVariant::Type::Sint64Array)
+	{
+		ThrowCreateImageExceptionFormatted("The %s property type is not Sint64Array.", "Condition");
+	}
+
+	const uint32_t count = pVariant->GetCount();
+	const int64_t* pData = pVariant->RefSint64();
+
+	if ((count % GroupCount) != 0)
+	{
+		ThrowCreateImageExceptionFormatted(
+			"The Condition property must contain groups of %u values.",
+			static_cast<uint32_t>(GroupCount));
+	}
+
+	for (size_t i = 0; i < count; i += GroupCount)
+	{
+		if (pData[i] != lineNumber)
+		{
+			continue;
+		}
+
+		const int64_t type = pData[i + 1];
+		const int64_t id = pData[i + 2];
+		const int64_t threshold = pData[i + 3];
+
+		if (type < 0 || type >= static_cast<int64_t>(ConditionPredicateType::Count))
+		{
+			ThrowCreateImageExceptionFormatted(
+				"Error parsing the Condition property line item 0x%08x: "
+				"The predicate type must be in the range of 0 to 3.",
+				lineNumber);
+		}
+		else if (id < 0 || id > UINT32_MAX)
+		{
+			ThrowCreateImageExceptionFormatted(
+				"Error parsing the Condition property line item 0x%08x: "
+				"The ordinance or tax group id must be in the range of 0 to 0xFFFFFFFF.",
+				lineNumber);
+		}
+		else if (threshold < 0 || threshold > ConditionPredicateTable::MaxTaxRateThreshold)
+		{
+			ThrowCreateImageExceptionFormatted(
+				"Error parsing the Condition property line item 0x%08x: "
+				"The tax rate threshold must be in the range of 0 to %u.",
+				lineNumber,
+				ConditionPredicateTable::MaxTaxRateThreshold);
+		}
+
+		AlgorithmFactor multiplier = Rational64ToFactor(
+			pData[i + 4],
+			pData[i + 5],
+			"Condition",
+			"multiplier",
+			lineNumber);
+
+		if (!conditions)
+		{
+			conditions = std::make_unique<LineItemConditions>();
+		}
+		else if (conditions->GetCount() >= LineItemConditions::MaxConditionCount)
+		{
+			ThrowCreateImageExceptionFormatted(
+				"Error parsing the Condition property line item 0x%08x: "
+				"A line item can have at most %u conditions.",
+				lineNumber,
+				LineItemConditions::MaxConditionCount);
+		}
+
+		ConditionPredicate predicate{};
+		predicate.type = static_cast<ConditionPredicateType>(type);
+		predicate.id = static_cast<uint32_t>(id);
+		// The ordinance predicates do not use the threshold, it is cleared so that they share a predicate bit.
+		predicate.threshold = (predicate.type == ConditionPredicateType::TaxRateAtLeast
+			|| predicate.type == ConditionPredicateType::TaxRateBelow) ? static_cast<uint32_t>(threshold) : 0;
+
+		conditions->Add(predicate, multiplier);
+	}
 
-	return algorithm;
+	return conditions;
 }
@@ -13,6 +13,7 @@
 
 #pragma once
 #include "ITransactionAlgorithm.h"
+#include "LineItemConditions.h"
 #include <memory>
 #include <stdexcept>
 
@@ -30,12 +31,51 @@ public:
 	}
 };
 
+struct TransactionAlgorithmInstanceStatistics
+{
+	// The number of algorithm instances with distinct parameters.
+	size_t distinctInstances;
+	// The number of line items that use the algorithm instances.
+	size_t totalInstances;
+};
+
 namespace TransactionAlgorithmFactory
 {
 	std::unique_ptr<ITransactionAlgorithm> Create(TransactionAlgorithmType type);
 
-	std::unique_ptr<ITransactionAlgorithm> Create(
+	/**
+	 * @brief Creates the algorithm for a line item.
+	 *
+	 * The line items that use the same algorithm type and parameters share one instance.
+	 */
+	std::shared_ptr<const ITransactionAlgorithm> Create(
 		const cISCPropertyHolder* pPropertyHolder,
 		TransactionAlgorithmType type,
 		uint32_t lineNumber);
+
+	/**
+	 * @brief Gets the shared instance with the same algorithm type and parameters.
+	 * @param algorithm The algorithm, it is used as the shared instance if none exists.
+	 * @return The shared instance, or nullptr if the algorithm is null.
+	 */
+	std::shared_ptr<const ITransactionAlgorithm> Intern(std::unique_ptr<ITransactionAlgorithm> algorithm);
+
+	/**
+	 * @brief Keeps the most recently used shared instances alive after their line items are removed.
+	 *
+	 * The instances are only held as weak references by the line items' transactions, this is called
+	 * before a city is unloaded so that the next city can reuse the instances instead of creating them again.
+	 * The instances that were retained by a previous call and have not been used since are released.
+	 *
+	 * @param maxCount The maximum number of instances to keep.
+	 */
+	void RetainRecentInstances(size_t maxCount);
+
+	TransactionAlgorithmInstanceStatistics GetInstanceStatistics();
+
+	/**
+	 * @brief Creates the conditions for a line item.
+	 * @return The conditions, or nullptr if the line item does not have any conditions.
+	 */
+	std::unique_ptr<LineItemConditions> CreateConditions(const cISCPropertyHolder* pPropertyHolder, uint32_t lineNumber);
 }
\ No newline at end of file
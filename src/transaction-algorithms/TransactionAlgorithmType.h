@@ -20,4 +20,9 @@ enum class TransactionAlgorithmType : uint32_t
 	ResidentialTotalPopulation = 1,
 	ResidentialWealthGroupPopulation = 2,
 	Tourism = 3,
+	Formula = 4,
+	Tiered = 5,
+	History = 6,
+	BuildingAge = 7,
+	ResidentialCatchment = 8,
 };
\ No newline at end of file